@@ -0,0 +1,8 @@
+#! /usr/bin/env python3
+
+# Programs that are runnable.
+ns3_runnable_programs = ['_mtp_build/src/applications/examples/ns3-dev-three-gpp-http-example-debug', '_mtp_build/src/config-store/examples/ns3-dev-config-store-save-debug', '_mtp_build/src/core/examples/ns3-dev-main-callback-debug', '_mtp_build/src/core/examples/ns3-dev-sample-simulator-debug', '_mtp_build/src/core/examples/ns3-dev-main-ptr-debug', '_mtp_build/src/core/examples/ns3-dev-main-random-variable-stream-debug', '_mtp_build/src/core/examples/ns3-dev-sample-random-variable-debug', '_mtp_build/src/core/examples/ns3-dev-sample-random-variable-stream-debug', '_mtp_build/src/core/examples/ns3-dev-command-line-example-debug', '_mtp_build/src/core/examples/ns3-dev-hash-example-debug', '_mtp_build/src/core/examples/ns3-dev-sample-log-time-format-debug', '_mtp_build/src/core/examples/ns3-dev-test-string-value-formatting-debug', '_mtp_build/src/core/examples/ns3-dev-sample-show-progress-debug', '_mtp_build/src/core/examples/ns3-dev-empirical-random-variable-example-debug', '_mtp_build/src/core/examples/ns3-dev-system-path-examples-debug', '_mtp_build/src/core/examples/ns3-dev-fatal-example-debug', '_mtp_build/src/core/examples/ns3-dev-main-test-sync-debug', '_mtp_build/src/core/examples/ns3-dev-length-example-debug', '_mtp_build/src/internet/examples/ns3-dev-main-simple-debug', '_mtp_build/src/mtp/examples/ns3-dev-mtp-quic-pairs-debug', '_mtp_build/src/network/examples/ns3-dev-main-packet-header-debug', '_mtp_build/src/network/examples/ns3-dev-main-packet-tag-debug', '_mtp_build/src/network/examples/ns3-dev-packet-socket-apps-debug', '_mtp_build/src/network/examples/ns3-dev-lollipop-comparisions-debug', '_mtp_build/src/point-to-point/examples/ns3-dev-main-attribute-value-debug', '_mtp_build/src/quic/examples/ns3-dev-quic-variants-comparison-bulksend-debug', '_mtp_build/src/stats/examples/ns3-dev-gnuplot-example-debug', '_mtp_build/src/stats/examples/ns3-dev-double-probe-example-debug', '_mtp_build/src/stats/examples/ns3-dev-time-probe-example-debug', '_mtp_build/src/stats/examples/ns3-dev-gnuplot-aggregator-example-debug', '_mtp_build/src/stats/examples/ns3-dev-gnuplot-helper-example-debug', '_mtp_build/src/stats/examples/ns3-dev-file-aggregator-example-debug', '_mtp_build/src/stats/examples/ns3-dev-file-helper-example-debug', '_mtp_build/src/traffic-control/examples/ns3-dev-red-tests-debug', '_mtp_build/src/traffic-control/examples/ns3-dev-adaptive-red-tests-debug', '_mtp_build/src/traffic-control/examples/ns3-dev-codel-vs-pfifo-basic-test-debug', '_mtp_build/src/traffic-control/examples/ns3-dev-codel-vs-pfifo-asymmetric-debug', '_mtp_build/src/traffic-control/examples/ns3-dev-pie-example-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-large-transfer-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-nsc-lfn-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-star-server-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-bulk-send-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-pcap-nanosec-example-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-nsc-comparison-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-variants-comparison-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-pacing-debug', '_mtp_build/examples/tcp/ns3-dev-dctcp-example-debug', '_mtp_build/examples/tcp/ns3-dev-tcp-linux-reno-debug', '_mtp_build/examples/routing/ns3-dev-simple-global-routing-debug', '_mtp_build/examples/routing/ns3-dev-simple-alternate-routing-debug', '_mtp_build/examples/routing/ns3-dev-simple-multicast-flooding-debug', '_mtp_build/examples/error-model/ns3-dev-simple-error-model-debug', '_mtp_build/examples/tutorial/ns3-dev-hello-simulator-debug', '_mtp_build/examples/tutorial/ns3-dev-first-debug', '_mtp_build/examples/tutorial/ns3-dev-fourth-debug', '_mtp_build/examples/tutorial/ns3-dev-fifth-debug', '_mtp_build/examples/tutorial/ns3-dev-sixth-debug', '_mtp_build/examples/tutorial/ns3-dev-seventh-debug', '_mtp_build/examples/ipv6/ns3-dev-test-ipv6-debug', '_mtp_build/examples/traffic-control/ns3-dev-traffic-control-debug', '_mtp_build/examples/traffic-control/ns3-dev-tbf-example-debug', '_mtp_build/examples/traffic-control/ns3-dev-cobalt-vs-codel-debug', '_mtp_build/scratch/ns3-dev-MAMS-test-rr-debug', '_mtp_build/scratch/ns3-dev-MAMS-test-late-debug', '_mtp_build/scratch/ns3-dev-MAMS-test-2-debug', '_mtp_build/scratch/ns3-dev-MAMS-test-example-debug', '_mtp_build/scratch/subdir/ns3-dev-subdir-debug', '_mtp_build/scratch/ns3-dev-scratch-simulator-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['sample-simulator.py', 'first.py']
+
@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef MP_QUIC_PATH_MANAGER_H
+#define MP_QUIC_PATH_MANAGER_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class QuicSocketBase;
+
+/**
+ * \ingroup quic
+ * \brief Liveness tracking and failover for the subflows of an MP-QUIC connection
+ *
+ * The path manager keeps one state machine per subflow. Every packet or ACK
+ * frame received for a path marks it alive. A path is declared failed when
+ * either MaxPtoCount consecutive probe timeouts (TLP or RTO) expire while it
+ * has bytes in flight, or when MaxProbes keepalive PINGs sent on an idle path
+ * stay unanswered.
+ *
+ * Failing a path tears the subflow down in the socket: its timers are
+ * cancelled, its unacknowledged frames are reinjected on the surviving paths
+ * and the schedulers stop selecting it. Path identifiers are positional, so
+ * a failed subflow keeps its slot in QuicSocketBase::m_subflows. The last
+ * usable path is never failed; it is left to the regular RTO backoff and idle
+ * timeout.
+ *
+ * A handover of a path known in advance, like the handover of a LEO ground
+ * station to another satellite, can be announced with NotifyHandover. The
+ * path is drained during the HandoverLead before the handover: the
+ * schedulers prefer the other paths while one of them is usable. At the
+ * handover, the RTT estimates of the path are moved by the announced RTT
+ * change instead of being learnt again from the first samples, and the loss
+ * detection alarm of the data in flight is re-armed for the new RTT.
+ */
+class MpQuicPathManager : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// Liveness state of a path
+  typedef enum
+  {
+    PATH_ACTIVE,    //!< ACKs or packets were recently received on the path
+    PATH_PROBING,   //!< The path is idle and keepalive PINGs are outstanding
+    PATH_FAILED,    //!< The subflow has been torn down
+  } PathState_t;
+
+  /**
+   * \brief Literal names of the path states, for logging
+   */
+  static const char* const PathStateName[PATH_FAILED + 1];
+
+  /**
+   * \brief TracedCallback signature for path state changes
+   *
+   * \param [in] pathId the path identifier
+   * \param [in] oldState the previous state
+   * \param [in] newState the new state
+   */
+  typedef void (* PathStateTracedCallback)(uint8_t pathId, PathState_t oldState, PathState_t newState);
+
+  /**
+   * \brief TracedCallback signature for path failures
+   *
+   * \param [in] pathId the failed path
+   * \param [in] reinjected bytes moved back to the scheduler for the surviving paths
+   * \param [in] lastActivity time of the last packet received for the path
+   */
+  typedef void (* PathFailureTracedCallback)(uint8_t pathId, uint32_t reinjected, Time lastActivity);
+
+  /**
+   * \brief TracedCallback signature for handovers
+   *
+   * \param [in] pathId the path
+   * \param [in] rtt the RTT the path was seeded with, zero if it had no sample
+   */
+  typedef void (* HandoverTracedCallback)(uint8_t pathId, Time rtt);
+
+  MpQuicPathManager ();
+  virtual ~MpQuicPathManager ();
+
+  /**
+   * \brief Set the socket whose subflows are managed
+   *
+   * \param socket the MP-QUIC socket
+   */
+  void SetSocket (Ptr<QuicSocketBase> socket);
+
+  /**
+   * \brief Start the keepalive timer
+   */
+  void Start (void);
+
+  /**
+   * \brief Register a path, marking it alive from now on
+   *
+   * \param pathId the path identifier
+   */
+  void AddPath (uint8_t pathId);
+
+  /**
+   * \brief Notify that a packet or an ACK frame was received for a path
+   *
+   * \param pathId the path identifier
+   */
+  void NotifyPathActivity (uint8_t pathId);
+
+  /**
+   * \brief Notify that a probe timeout (TLP or RTO) expired with data in flight
+   *
+   * \param pathId the path identifier
+   * \return true if the path has been failed and its subflow torn down
+   */
+  bool NotifyTimeout (uint8_t pathId);
+
+  /**
+   * \brief Check if the schedulers may send on a path
+   *
+   * Unknown paths are considered usable.
+   *
+   * \param pathId the path identifier
+   * \return false if the path has failed
+   */
+  bool IsPathUsable (uint8_t pathId) const;
+
+  /**
+   * \param pathId the path identifier
+   * \return the state of the path
+   */
+  PathState_t GetPathState (uint8_t pathId) const;
+
+  /**
+   * \return the number of paths not in PATH_FAILED state
+   */
+  uint32_t GetNUsablePaths (void) const;
+
+  /**
+   * \brief Get the first usable path different from a given one
+   *
+   * \param pathId the path to avoid
+   * \return the first usable path, or pathId if none
+   */
+  uint8_t GetAlternatePath (uint8_t pathId) const;
+
+  /**
+   * \brief Announce a handover of a path
+   *
+   * A later announcement for the same path replaces the pending one.
+   *
+   * \param pathId the path identifier
+   * \param time the time of the handover, not in the past
+   * \param rttChange the change of the RTT of the path at the handover
+   */
+  void NotifyHandover (uint8_t pathId, Time time, Time rttChange);
+
+  /**
+   * \brief Check if a path is drained before a handover
+   *
+   * \param pathId the path identifier
+   * \return true if a handover of the path is due within HandoverLead
+   */
+  bool IsPathDraining (uint8_t pathId) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Per-path liveness information
+  struct PathInfo
+  {
+    PathInfo ();
+
+    PathState_t m_state;        //!< Current state
+    Time m_lastActivity;        //!< Time of the last packet or ACK received for the path
+    uint32_t m_ptoCount;        //!< Consecutive probe timeouts without activity
+    uint32_t m_probesSent;      //!< Keepalive PINGs sent without activity
+    Time m_handover;            //!< Time of the announced handover
+    Time m_rttChange;           //!< RTT change at the announced handover
+    EventId m_handoverEvent;    //!< Announced handover event
+  };
+
+  /**
+   * \brief Periodic keepalive check over all paths
+   */
+  void KeepaliveTimeout (void);
+
+  /**
+   * \brief Tear down a path and reinject its in-flight data
+   *
+   * \param pathId the path identifier
+   */
+  void FailPath (uint8_t pathId);
+
+  /**
+   * \brief Change the state of a path, firing the trace
+   *
+   * \param pathId the path identifier
+   * \param state the new state
+   */
+  void SetPathState (uint8_t pathId, PathState_t state);
+
+  /**
+   * \brief Seed the RTT of a path at its announced handover
+   *
+   * \param pathId the path identifier
+   */
+  void Handover (uint8_t pathId);
+
+  Ptr<QuicSocketBase> m_socket;       //!< The managed socket
+  std::vector<PathInfo> m_paths;      //!< Per-path state, indexed by path identifier
+  EventId m_keepaliveEvent;           //!< Keepalive check event
+
+  Time m_probeInterval;               //!< Idle time after which a path is probed
+  uint32_t m_maxProbes;               //!< Unanswered PINGs before failing an idle path
+  uint32_t m_maxPtoCount;             //!< Consecutive probe timeouts before failing a path
+  Time m_handoverLead;                //!< Time a path is drained before its handover
+
+  TracedCallback<uint8_t, PathState_t, PathState_t> m_pathStateTrace;  //!< Path state changes
+  TracedCallback<uint8_t, uint32_t, Time> m_pathFailureTrace;          //!< Path failures
+  TracedCallback<uint8_t, Time> m_handoverTrace;                       //!< Handovers
+};
+
+} // namespace ns3
+
+#endif /* MP_QUIC_PATH_MANAGER_H */
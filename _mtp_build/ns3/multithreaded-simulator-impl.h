@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+/**
+ * \defgroup mtp Multithreaded Simulation
+ *
+ * Conservative parallel simulation of the nodes of one process on
+ * several threads, selected with
+ * \code
+ *   GlobalValue::Bind ("SimulatorImplementationType",
+ *                      StringValue ("ns3::MultithreadedSimulatorImpl"));
+ * \endcode
+ * The module is built when ns-3 is configured with --enable-mtp, which
+ * also makes the reference counts and the packets thread safe in every
+ * module.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Conservative parallel simulator running the nodes on several threads
+ *
+ * At Run (), the nodes are split in partitions: the nodes joined by a
+ * channel which is not a point-to-point link with a fixed Delay of at
+ * least MinLookahead (a CSMA segment, a wireless channel, a short link, a
+ * link whose VariableDelay is true...) stay in the same partition; the groups of nodes are then spread over
+ * ThreadCount partitions, the largest first. Each partition has its own
+ * event queue and clock and is run by a thread. The lookahead is the
+ * smallest Delay of the links between two partitions.
+ *
+ * The partitions run in rounds: each round, the threads agree on the
+ * timestamp T of the earliest event of the simulation and run their
+ * events before T + lookahead in parallel; a packet sent on a link
+ * between two partitions in the window arrives after its end. The events
+ * a partition schedules for the node of another partition go through the
+ * lock-free mailbox of that partition, which its thread empties at the
+ * start of the next round, ordered by timestamp and sender so that runs
+ * are reproducible.
+ *
+ * Events scheduled without a node context (in the simulation script, by
+ * Simulator::Schedule outside of any event) run alone, while the
+ * partitions wait, so they can reach any node. Simulator::Stop (delay)
+ * called from the script stops all the partitions at that time;
+ * Simulator::Stop () called by an event stops its partition at once and
+ * the others at the end of the window.
+ *
+ * The simulation models must not share state between nodes, but through
+ * the links between the partitions: static counters of a model, or a
+ * callback of the script writing to a global variable from the events of
+ * several nodes, need their own synchronization. A model or a script
+ * which changes the delay of a point-to-point link only once the
+ * simulation runs must set its VariableDelay attribute beforehand: a
+ * packet sent between two partitions sooner than the lookahead aborts the
+ * simulation. Simulator::ForkAt is not supported.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /**
+   * \return the number of partitions of the last Run ()
+   */
+  uint32_t GetPartitionCount (void) const;
+  /**
+   * \param node the id of a node
+   * \return the partition of the node in the last Run ()
+   */
+  uint32_t GetPartition (uint32_t node) const;
+  /**
+   * \return the lookahead of the last Run (), the maximum simulation time
+   * if no link joins two partitions
+   */
+  Time GetLookahead (void) const;
+  /**
+   * \return the number of rounds of the last Run ()
+   */
+  uint64_t GetRoundCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event sent to a partition by another thread */
+  struct Message
+  {
+    Scheduler::Event ev;  //!< the event, without its uid
+    uint32_t source;      //!< the sending partition, the partition count for the global events
+    uint64_t seq;         //!< sequence number of the message at the sender
+    Message *next;        //!< next message of the mailbox
+  };
+
+  /** The nodes of a partition and their events */
+  struct LogicalProcess
+  {
+    uint32_t m_id;                        //!< index of the partition
+    MultithreadedSimulatorImpl *m_impl;   //!< the simulator
+    Ptr<Scheduler> m_events;              //!< the event queue
+    uint64_t m_currentTs;                 //!< timestamp of the current event
+    uint32_t m_currentContext;            //!< context of the current event
+    uint32_t m_currentUid;                //!< uid of the current event
+    uint64_t m_eventCount;                //!< events run
+    uint64_t m_sent;                      //!< messages sent to other partitions
+    uint64_t m_windowEnd;                 //!< end of the current window, excluded
+    Scheduler::EventKey m_next;           //!< key of the next event, published each round
+    bool m_stopped;                       //!< Simulator::Stop () called by an event
+    std::atomic<Message *> m_mailbox;     //!< events sent by the other threads
+    Ptr<SystemThread> m_thread;           //!< the thread, null for the main thread
+
+    /** Run the partition, on its thread */
+    void Run (void);
+  };
+
+  /**
+   * Split the nodes in partitions and compute the lookahead
+   */
+  void Partition (void);
+  /**
+   * Move the events scheduled before Run () to their partition
+   */
+  void Distribute (void);
+  /**
+   * Move the events left after Run () back to the main queue
+   */
+  void Gather (void);
+  /**
+   * Run the rounds of a partition
+   * \param lp the partition
+   */
+  void RunPartition (LogicalProcess *lp);
+  /**
+   * Run the global events preceding the events of the partitions, the
+   * partitions waiting
+   * \param bound the key of the first event of the partitions, or of the
+   * stop time
+   */
+  void ProcessGlobalEvents (const Scheduler::EventKey &bound);
+  /**
+   * Wait for all the threads
+   */
+  void Barrier (void);
+  /**
+   * \param context an event context
+   * \return the partition running the events of the context, null for
+   * the events without node
+   */
+  LogicalProcess * GetPartitionOf (uint32_t context) const;
+  /**
+   * Post an event to the mailbox of a partition
+   * \param lp the partition
+   * \param ev the event
+   */
+  void Send (LogicalProcess *lp, const Scheduler::Event &ev);
+  /**
+   * Move the events of the mailbox of a partition to its queue
+   * \param lp the partition
+   */
+  void Receive (LogicalProcess *lp);
+  /**
+   * Insert an event in the queue of the current partition, of the global
+   * events, or of the events scheduled before Run ()
+   * \param ev the event, without its uid
+   * \return the id of the event
+   */
+  EventId Insert (Scheduler::Event ev);
+
+  /** The partition run by the current thread, null out of the rounds */
+  static thread_local LogicalProcess *g_current;
+
+  uint32_t m_threadCount;   //!< threads asked for, 0 for one per core
+  Time m_minLookahead;      //!< links shorter than this do not split partitions
+
+  ObjectFactory m_schedulerFactory;     //!< creates the event queues
+  Ptr<Scheduler> m_events;              //!< events scheduled before Run () and global events
+  std::vector<LogicalProcess *> m_partitions;  //!< the partitions
+  std::vector<uint32_t> m_nodePartition;       //!< partition of each node
+  uint64_t m_lookahead;                 //!< lookahead, in time steps
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the list of events to run at Destroy. */
+  SystemMutex m_destroyMutex;
+
+  bool m_running;           //!< in Run ()
+  bool m_stop;              //!< Simulator::Stop () called out of the partitions
+  Scheduler::EventKey m_stopKey;     //!< key of the Simulator::Stop (delay) time
+  Scheduler::EventKey m_globalNext;  //!< key of the next global event, published each round
+  uint64_t m_globalSent;    //!< messages sent by global events
+  uint64_t m_currentTs;     //!< time out of the partitions
+  uint32_t m_currentUid;    //!< uid of the current global event
+  std::atomic<uint32_t> m_uid;  //!< next event uid, shared by the partitions
+  uint64_t m_eventCount;    //!< global events run
+  uint64_t m_rounds;        //!< rounds of the last Run ()
+
+  std::atomic<uint32_t> m_barrierCount;       //!< threads arrived at the barrier
+  std::atomic<uint32_t> m_barrierGeneration;  //!< barriers passed
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
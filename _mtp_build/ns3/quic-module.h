@@ -0,0 +1,36 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_QUIC
+    
+
+// Module headers:
+#include "mp-quic-congestion-ops.h"
+#include "mp-quic-fluid-model.h"
+#include "mp-quic-path-manager.h"
+#include "mp-quic-typedefs.h"
+#include "quic-bbr.h"
+#include "quic-congestion-ops.h"
+#include "quic-header.h"
+#include "quic-helper.h"
+#include "quic-l4-protocol.h"
+#include "quic-l5-protocol.h"
+#include "quic-scheduler.h"
+#include "quic-socket-base.h"
+#include "quic-socket-factory.h"
+#include "quic-socket-rx-buffer.h"
+#include "quic-socket-tx-buffer.h"
+#include "quic-socket-tx-edf-scheduler.h"
+#include "quic-socket-tx-pfifo-scheduler.h"
+#include "quic-socket-tx-scheduler.h"
+#include "quic-socket.h"
+#include "quic-stream-base.h"
+#include "quic-stream-rx-buffer.h"
+#include "quic-stream-tx-buffer.h"
+#include "quic-stream.h"
+#include "quic-subheader.h"
+#include "quic-transport-parameters.h"
+#include "windowed-filter.h"
+#endif
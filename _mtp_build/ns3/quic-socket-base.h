@@ -0,0 +1,1200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 SIGNET Lab, Department of Information Engineering, University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alvise De Biasio <alvise.debiasio@gmail.com>
+ *          Federico Chiariotti <chiariotti.federico@gmail.com>
+ *          Michele Polese <michele.polese@gmail.com>
+ *          Davide Marcato <davidemarcato@outlook.com>
+ *          Umberto Paro <umberto.paro@me.com>
+ *
+ */
+
+#ifndef QUICSOCKETBASE_H
+#define QUICSOCKETBASE_H
+
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/timer.h"
+#include "ns3/socket.h"
+#include "ns3/traced-value.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/random-variable-stream.h"
+#include "quic-socket.h"
+#include "ns3/event-id.h"
+#include "ns3/system-mutex.h"
+#include "quic-socket-rx-buffer.h"
+#include "quic-socket-tx-buffer.h"
+#include "quic-header.h"
+#include "quic-subheader.h"
+#include "quic-transport-parameters.h"
+// #include "ns3/ipv4-end-point.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "quic-socket-tx-scheduler.h"
+#include "mp-quic-typedefs.h"
+
+#include "quic-scheduler.h"
+#include "mp-quic-path-manager.h"
+#include "mp-quic-fluid-model.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+#include <stdlib.h>
+#include <unistd.h>
+#include <regex>
+
+namespace ns3 {
+
+class QuicL5Protocol;
+class QuicL4Protocol;
+
+/**
+ * \brief Data structure that records the congestion state of a connection
+ *
+ * In this data structure, basic informations that should be passed between
+ * socket and the congestion control algorithm are saved.
+ */
+class QuicSocketState : public TcpSocketState
+{
+public:
+  /**
+   * Get the type ID.
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  QuicSocketState ();
+  QuicSocketState (const QuicSocketState &other);
+  virtual  ~QuicSocketState (void)
+  {}
+
+  // Loss Detection variables of interest
+  EventId m_lossDetectionAlarm;            //!< Multi-modal alarm used for loss detection.
+  uint32_t m_handshakeCount;               /**< The number of times the handshake packets have been retransmitted
+                                            *   without receiving an ack. */
+  uint32_t m_tlpCount;                     /**< The number of times a tail loss probe has been sent without
+                                            *   receiving an ack. */
+  uint32_t m_rtoCount;                      //!< The number of times an rto has been sent without receiving an ack.
+  SequenceNumber32 m_largestSentBeforeRto;  //!< The last packet number sent prior to the first retransmission timeout.
+  Time m_timeOfLastSentPacket;              //!< The time the most recent packet was sent.
+  SequenceNumber32 m_largestAckedPacket;    //!< The largest packet number acknowledged in an ACK frame.
+  Time m_latestRtt;                         /**< The most recent RTT measurement made when receiving an ack for a
+                                             *   previously unacked packet. */
+  Time m_smoothedRtt;                       //!< The smoothed RTT of the connection, computed as described in [RFC6298].
+  Time m_rttVar;                            //!< The RTT variance, computed as described in [RFC6298].
+  Time m_minRtt;                            //!< The minimum RTT seen in the connection, ignoring ack delay.
+  Time m_maxAckDelay;                       /**< The maximum ack delay in an incoming ACK frame for this connection.
+                                             *   Excludes ack delays for ack only packets and those that create an
+                                             *   RTT sample less than m_minRtt. */
+  Time m_lossTime;                          /**< The time at which the next packet will be considered lost based
+                                             *   on early transmit or exceeding the reordering window in time. */
+
+  // Congestion Control constants of interests
+  uint32_t m_kMinimumWindow;      //!< Default minimum congestion window.
+  double m_kLossReductionFactor;  //!< Reduction in congestion window when a new loss event is detected.
+
+  // Congestion Control variables of interests
+  SequenceNumber32 m_endOfRecovery;  /**< The largest packet number sent when QUIC detects a loss. When a larger packet
+                                      *   is acknowledged, QUIC exits recovery. */
+
+  // Loss Detection constants of interest
+  uint32_t m_kMaxTLPs;                          //!< Maximum number of tail loss probes before an RTO fires.
+  uint32_t m_kReorderingThreshold;              /**< Maximum reordering in packet number space before FACK style loss
+                                                 *   detection considers a packet lost. */
+  double m_kTimeReorderingFraction;               /**< Maximum reordering in time space before time based loss detection
+                                                 *   considers a packet lost. In fraction of an RTT. */
+  bool m_kUsingTimeLossDetection;               /**< Whether time based loss detection is in use. If false, uses FACK
+                                                 *   style loss detection. */
+  Time m_kMinTLPTimeout;                        //!< Minimum time in the future a tail loss probe alarm may be set for.
+  Time m_kMinRTOTimeout;                        //!< Minimum time in the future an RTO alarm may be set for.
+  Time m_kDelayedAckTimeout;                    //!< The lenght of the peer's delayed ack timer.
+  uint8_t m_alarmType;                          //!< The type of the next alarm
+  Time m_nextAlarmTrigger;                      //<! Time of the next alarm
+  Time m_kDefaultInitialRtt;                    //!< The default RTT used before an RTT sample is taken.
+  uint32_t m_kMaxPacketsReceivedBeforeAckSend;  //!< The number of packets to be received before an ACK is triggered
+
+  // RateSample variables of interest
+  uint64_t              m_delivered       {0};              //!< The total amount of data in bytes delivered so far
+  Time                  m_deliveredTime   {Seconds (0)};    //!< Simulation time when m_delivered was last updated
+  Time                  m_firstSentTime   {Seconds (0)};    //!< The send time of the packet that was most recently marked as delivered
+  uint64_t              m_appLimitedUntil {0};              //!< Connection is application-limited until m_appLimitedUntil > m_delivered
+  uint32_t              m_txItemDelivered {0};              /**< amount of data (in bytes) delivered when last packet
+                                                                marked asdelivered was first sent */
+  uint32_t              m_lastAckedSackedBytes {0};         //!< Size of data sacked in the last ack
+  uint32_t              m_ackBytesSent    {0};              //!< amount of ACK-only bytes sent
+};
+
+/**
+ * \ingroup socket
+ * \ingroup quic
+ *
+ * \brief A base class for implementation a QUIC socket.
+ *
+ * This class mimics the TcpSocketBase class implementation (and documentation).
+ * It contains the essential components of QUIC, as well as a sockets
+ * interface for upper layers to call. This class provides capabilities to
+ * set up a connection, possibly with multiple streams, and manages the life cycle of
+ * the connection. As for the TCP implementation, congestion control
+ * is delegated to subclasses of QuicCongestionOps. In order to mimic the
+ * TcpSocketBase implementation and avoid repeating code, the implementation is
+ * not perfectly compliant with the QUIC Internet Draft; e.g., sequence numbers
+ * are 32 bits long instead of 64. Deviations from the standard are commented
+ *
+ * Congestion control interface
+ * ---------------------------
+ *
+ * Congestion control, as in the TCP implementation, has been split from
+ * QuicSocketBase. The goal is to provide compatibility with the TCP congestion
+ * control implementations, as well as the possibility of extending it with
+ * new QUIC-related capabilities
+ *
+ * Transmission Control Block (TCB)
+ * --------------------------------
+ *
+ * Taking as a reference the TCP implementation, the variables needed to congestion
+ * control classes to operate correctly have been moved inside the QuicSocketState
+ * class. Extending TcpSocketState, the class contains information on both the Quic
+ * and the TCP windows and thresholds as well as the Congestion state machine of TCP.
+ *
+ * Streams
+ * --------------------------------
+ *
+ * Streams in QUIC constitute a lightweight, ordered byte-stream abstraction within a
+ * QUIC connection. The multiplexing/demultiplexing of frames in streams is handled
+ * through L5 Protocol that plays a dispatcher role. Frames are buffered in reception
+ * and in transmission and are processed in QuicStreams according to QUIC semantics.
+ *
+ */
+
+   //int tttrtt0;
+class QuicSocketBase : public QuicSocket
+{
+public:
+  static const uint16_t MIN_INITIAL_PACKET_SIZE;
+
+  /**
+   * Get the type ID.
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Get the instance TypeId
+   * \return the instance TypeId
+   */
+  virtual TypeId GetInstanceTypeId () const;
+
+  /**
+   * \brief Build an object. InitializeScheduling() must be called after construction to instantiate the frame scheduler, or the construction will fail
+   *
+   */
+  QuicSocketBase (void);
+  QuicSocketBase (const QuicSocketBase&);
+
+
+    //ywj
+  uint8_t LookUpByAddr (Address &address);
+  std::map <Ipv4Address, uint8_t> m_addrIdPair;
+  std::vector <Ptr<MpQuicSubFlow>>     m_subflows;
+  bool vnResponse = 0; 
+  static std::vector<double> ue_sinr;
+  static std::vector<double> ue_Bmin;
+
+    //multipath
+  void SetSubsocket ();
+  bool IsSubsocket ();
+  bool m_isFast = true;
+  bool m_QUpdate = true;
+  uint8_t slowPathId;
+  bool blockSlowPath = false;
+
+  //path management
+  /**
+   * \brief Tear down a subflow whose path has failed
+   *
+   * Cancels the timers of the subflow, reinjects its unacknowledged frames
+   * and tries to send them on the surviving paths. The subflow keeps its
+   * slot in m_subflows, since path identifiers are positional.
+   *
+   * \param pathId the path to tear down
+   * \return the number of bytes reinjected
+   */
+  uint32_t RemoveSubflow (uint8_t pathId);
+  /**
+   * \brief Send an ACK-eliciting PING frame on a path
+   *
+   * \param pathId the path to probe
+   */
+  void SendPing (uint8_t pathId);
+  /**
+   * \brief Check if a path can carry data
+   *
+   * \param pathId the path identifier
+   * \return false if the path manager declared the path failed
+   */
+  bool IsPathUsable (uint8_t pathId) const;
+  /**
+   * \brief Check if the schedulers should put data on a path
+   *
+   * \param pathId the path identifier
+   * \return true if the path is usable and not drained before a handover
+   */
+  bool IsPathPreferred (uint8_t pathId) const;
+  /**
+   * \brief Get the rate of the link of a path, as known to the MAMS schedulers
+   *
+   * \param pathId the path identifier
+   * \return the LinkRate0 or LinkRate1 attribute, 0 for the other paths
+   */
+  DataRate GetLinkRate (uint8_t pathId) const;
+  /**
+   * \brief Move the RTT estimates of a path by a known change
+   *
+   * Used at a handover of the path, when the RTT of the new path is
+   * predicted: the latest RTT sample of the path and the estimates which
+   * already hold samples are moved, and the loss detection alarm of the
+   * data in flight is armed again for the new RTT. A path without RTT
+   * sample is left unchanged.
+   *
+   * \param pathId the path identifier
+   * \param rttChange the change of the RTT
+   * \return the new RTT of the path, zero if it has no sample
+   */
+  Time SeedPathRtt (uint8_t pathId, Time rttChange);
+
+  //connection migration
+  /**
+   * \brief Move a path of this endpoint to a new local address
+   *
+   * The path gets a UDP socket bound to the new address, and a PING is sent
+   * on it: the peer sees the packet come from the new address and validates
+   * it with a PATH_CHALLENGE before moving its end of the path. The
+   * congestion state of the path is kept if the old and the new address are
+   * in the same path class (see the PathClassMask attribute).
+   *
+   * \param pathId the path to move
+   * \param local the new local address
+   * \return 0 on success, -1 if the path cannot be moved
+   */
+  int MigratePath (uint8_t pathId, const Address &local);
+  /**
+   * \brief Check if the peer may move the paths of the connection to new addresses
+   *
+   * \return the value of the ConnectionMigration attribute
+   */
+  bool GetConnectionMigration (void) const;
+  /**
+   * \brief TracedCallback signature for path migrations
+   *
+   * \param [in] pathId the path
+   * \param [in] oldAddress the address the path was bound to
+   * \param [in] newAddress the address the path is bound to now
+   * \param [in] keptState true if the congestion state of the path was kept
+   */
+  typedef void (* PathMigrationTracedCallback)(uint8_t pathId, const Address &oldAddress,
+                                               const Address &newAddress, bool keptState);
+
+  //fluid fast-forward
+  /**
+   * \brief Advance the transfer on a path without sending packets
+   *
+   * Takes up to numBytes of stream frames scheduled on the path out of the tx
+   * buffer and delivers them to the peer socket after the given delay.
+   *
+   * \param pathId the path to advance
+   * \param numBytes the byte budget of the round
+   * \param delay the one-way delay of the path
+   * \return the number of bytes delivered, 0 if nothing could be sent
+   */
+  uint32_t FastForwardData (uint8_t pathId, uint32_t numBytes, Time delay);
+  /**
+   * \brief Go back to packet level at the end of a fluid window
+   *
+   * The subflows take the congestion windows reached by the fluid model.
+   */
+  void ResumePacketLevel (void);
+  /**
+   * \brief Receive stream frames delivered by the fluid model of the peer
+   *
+   * \param p the stream frames
+   * \param pathId the path they were scheduled on
+   */
+  void ReceivedFluidData (Ptr<Packet> p, uint8_t pathId);
+  std::vector<uint8_t> ackedPathList;
+  std::vector<uint8_t> sentPathList;
+
+  uint32_t m_associatedOffset;
+  uint32_t m_largestInOrderOffset;
+  std::map <SequenceNumber32, uint32_t> m_SeqOffsetPair;    // key: packet number; value: offset
+  DataRate bw_ini0;
+  DataRate bw_ini1;
+  int bwChangeCount = 0;
+  int exVarChangeCount = 0;
+
+  Time ackTime,sendTime;
+
+  Address m_from;
+  //ywj: data of amount Q that fast path can process within certain time period T
+  uint64_t Q;
+  uint64_t IntQ;
+
+  double TDiff;
+
+  std::ofstream rttLog0;
+  std::ofstream rttLog1; 
+
+  virtual ~QuicSocketBase (void);
+
+  static void NotifyConnectionEstablishedEnb (std::string context,
+                                uint64_t imsi,
+                                uint16_t cellid,
+                                uint16_t rnti);
+
+  static void NotifyHandoverEndOkEnb (std::string context,
+                        uint64_t imsi,
+                        uint16_t cellid,
+                        uint16_t rnti);
+
+  // static void NotifyHandoverStartEnb (std::string context,
+  //                       uint64_t imsi,
+  //                       uint16_t cellid,
+  //                       uint16_t rnti,
+  //                       uint16_t targetCellId);
+
+  /**
+   * \brief obtain SINR info dynamically. NOT ACTUALLY USED IN ORIGINAL CODE
+   */
+  static void ReportUeSinr (std::string context, uint16_t cellId, uint16_t rnti, double sinrLinear, uint8_t componentCarrierId);
+
+  void SetRemoteAddr (Address &address);
+  Address GetRemoteAddr ();
+
+  /**
+   * \brief Install a congestion control algorithm on this socket
+   *
+   * \param algo Algorithm to be installed
+   */
+  void SetCongestionControlAlgorithm (Ptr<TcpCongestionOps> algo);
+
+  /**
+   * \brief Common part of the two Bind(), i.e. set callback to receive data
+   *
+   * \returns 0 on success, -1 on failure
+   */
+  int SetupCallback (void);
+
+  /**
+   * \brief Send the initial handshake command to the other endpoint
+   *
+   * This method sends packets to initiate different handshakes,
+   * according to the type parameters
+   *
+   * \param type the type of handshake (from QuicHeader)
+   * \param quicHeader the QUIC header to be used
+   * \param packet a packet
+   */
+  void SendInitialHandshake (uint8_t type, const QuicHeader &quicHeader,
+                             Ptr<Packet> packet);
+
+  /**
+   * \brief Called by QuicL5Protocol to forward to the socket a control frame.
+   * In this implementation, only ACK, CONNECTION_CLOSE and APPLICATION_CLOSE
+   * are supported.
+   *
+   * \param sub the QuicSubheader of the control frame
+   */
+  void OnReceivedFrame (QuicSubheader &sub);
+
+  /**
+   * \brief Called when an ACK frame is received
+   *
+   * \param sub the QuicSubheader of the ACK frame
+   */
+  void OnReceivedAckFrame (QuicSubheader &sub);
+
+  /**
+   * \brief Called on sending an ACK frame
+   *
+   * \return the generated ACK frame
+   */
+  Ptr<Packet> OnSendingAckFrame (int pathId);
+
+  /**
+   * \brief Return an object with the transport parameters of this socket
+   *
+   * \return the transport parameters of the socket
+   */
+  QuicTransportParameters OnSendingTransportParameters ();
+
+  /**
+   * \brief Called when Quic transport parameters are received
+   *
+   * \param transportParameters the received transport parameters
+   */
+  void OnReceivedTransportParameters (QuicTransportParameters transportParameters);
+
+  /**
+   * \brief Add a stream frame to the TX buffer and call SendPendingData
+   *
+   * \param frame a smart pointer to a packet
+   * \return the size of the frame
+   */
+  int AppendingTx (Ptr<Packet> frame);
+
+  /**
+   * \brief Add a stream frame to the RX buffer and call NotifyDataRecv
+   *
+   * \param frame a smart pointer to a packet
+   * \param the RX address
+   * \return the size of the frame added, 0 if the buffer is full
+   */
+  int AppendingRx (Ptr<Packet> frame, Address &address);
+
+  /**
+   * \brief Set the L4 Protocol
+   *
+   * \param quic the L4 Protocol to be set
+   */
+  void SetQuicL4 (Ptr<QuicL4Protocol> quic);
+
+  /**
+   * \brief Initialize socket TX buffer scheduler
+   */
+  void InitializeScheduling ();
+
+  /**
+   * \brief Set the connection ID, e.g., for client-initiated connections
+   *
+   * \param connectionId the connection ID
+   */
+  void SetConnectionId (uint64_t connectionId);
+
+  /**
+   * \brief Get the connection ID
+   *
+   * \return the connection ID
+   */
+  uint64_t GetConnectionId (void) const;
+
+  /**
+   * \brief Set the Quic protocol version
+   *
+   * \param version the Quic protocol version
+   */
+  void SetVersion (uint32_t version);
+
+  /**
+   * \brief Get the available window
+   *
+   * \return the available window
+   */
+  uint32_t AvailableWindow (uint8_t pathId);
+
+  /**
+   * \brief Get the connection window
+   *
+   * \return the connection window
+   */
+  uint32_t ConnectionWindow (uint8_t pathId);
+
+
+
+  /**
+   * \brief Return total bytes in flight
+   *
+   * \returns total bytes in flight
+   */
+  uint32_t BytesInFlight (uint8_t pathId);
+
+  /**
+   * \brief Get the maximum amount of data that can be sent on the connection
+   *
+   * \return the maximum amount of data that can be sent on the connection
+   */
+  uint32_t GetConnectionMaxData () const;
+
+  /**
+   * \brief Set the maximum amount of data that can be sent on the connection
+   *
+   * \param maxData the maximum amount of data that can be sent on the connection
+   */
+  void SetConnectionMaxData (uint32_t maxData);
+
+  /**
+   * \brief Get the maximum amount of data per stream
+   *
+   * 0 means unlimited
+   *
+   * \return the maximum amount of data per stream
+   */
+  uint32_t GetInitialMaxStreamData () const;
+
+  /**
+   * \brief Get the state in the Congestion state machine
+   *
+   * \return the state in the Congestion state machine
+   */
+  QuicSocket::QuicStates_t GetSocketState () const;
+
+  /**
+   * \brief abort the connection due to an error
+   *
+   * \param transportErrorCode the error code
+   * \param a sentence explaining the error
+   * \param applicationClose a bool that signals that the application trigger the abortion
+   */
+  void AbortConnection (uint16_t transportErrorCode, const char* reasonPhrase,
+                        bool applicationClose = false);
+
+  /**
+   * \brief Check if transport parameters are ever being received
+   *
+   * \return true if received, false otherwise
+   */
+  bool GetReceivedTransportParametersFlag () const;
+
+  /**
+   * \brief check if the data received in this connection exceeds MAX_DATA
+   *
+   * \param a vector of pairs with received frames and subheaders
+   * \return a boolean, true if the limit was exceeded
+   */
+  bool CheckIfPacketOverflowMaxDataLimit (std::vector<std::pair<Ptr<Packet>, QuicSubheader> > disgregated);
+
+  /**
+   * \brief Get the maximum of stream ID (i.e., number of streams - 1)
+   *
+   * Consider the maximum between the unidirectional and bidirectional
+   * stream IDs
+   *
+   * \return the maximum stream ID
+   */
+  uint32_t GetMaxStreamId () const;
+
+  /**
+   * \brief return true if the packet that has just been received contains transport params
+   *
+   * \return a boolean, true if the packet that has just been received contains transport params
+   */
+  bool CouldContainTransportParameters () const;
+
+  /**
+   * \brief Get the maximum of stream ID for bidirectional streams (i.e., number of streams - 1)
+   *
+   * Consider bidirectional stream IDs
+   *
+   * \return the maximum bidirectional stream ID
+   */
+  uint32_t GetMaxStreamIdBidirectional () const;
+
+  /**
+   * \brief Get the maximum of stream ID for unidirectional streams (i.e., number of streams - 1)
+   *
+   * Consider unidirectional stream IDs
+   *
+   * \return the maximum unidirectional stream ID
+   */
+  uint32_t GetMaxStreamIdUnidirectional () const;
+
+  /**
+   * \brief Set the socket TX buffer size.
+   *
+   * \param size the buffer size (in bytes)
+   */
+  void SetSocketSndBufSize (uint32_t size);
+
+  /**
+   * \brief Get the socket TX buffer size.
+   é
+   * \returns the buffer size (in bytes)
+   */
+  uint32_t GetSocketSndBufSize (void) const;
+
+  /**
+   * \brief Set the socket RX buffer size.
+   *
+   * \param size the buffer size (in bytes)
+   */
+  void SetSocketRcvBufSize (uint32_t size);
+
+  /**
+   * \brief Get the socket RX buffer size.
+   *
+   * \returns the buffer size (in bytes)
+   */
+  uint32_t GetSocketRcvBufSize (void) const;
+
+  /**
+   * \brief Schedule a queue ACK has if needed
+   */
+  void MaybeQueueAck (uint8_t pathId);
+
+  /**
+   * \brief Callback function to hook to QuicSocketState congestion window
+   *
+   * \param oldValue old cWnd value
+   * \param newValue new cWnd value
+   */
+  void UpdateCwnd (uint32_t oldValue, uint32_t newValue);
+
+  void TraceCwnd0 (uint32_t oldValue, uint32_t newValue);
+  void TraceCwnd1 (uint32_t oldValue, uint32_t newValue);
+
+  void TraceThroughput0 (double oldValue, double newValue);
+  void TraceThroughput1 (double oldValue, double newValue);
+
+  void TraceRTT0 (Time oldValue, Time newValue);
+  void TraceRTT1 (Time oldValue, Time newValue);
+  /**
+   * \brief Callback function to hook to QuicSocketState slow start threshold
+   *
+   * \param oldValue old ssTh value
+   * \param newValue new ssTh value
+   */
+  void UpdateSsThresh (uint32_t oldValue, uint32_t newValue);
+
+  /**
+   * \brief Callback function to hook to QuicSocketState congestion state
+   *
+   * \param oldValue old congestion state value
+   * \param newValue new congestion state value
+   */
+  void UpdateCongState (TcpSocketState::TcpCongState_t oldValue,
+                        TcpSocketState::TcpCongState_t newValue);
+
+  /**
+   * \brief Callback function to hook to QuicSocketState high tx mark
+   *
+   * \param oldValue old high tx mark
+   * \param newValue new high tx mark
+   */
+  void UpdateHighTxMark (SequenceNumber32 oldValue, SequenceNumber32 newValue);
+
+  /**
+   * \brief Callback function to hook to QuicSocketState next tx sequence
+   *
+   * \param oldValue old nextTxSeq value
+   * \param newValue new nextTxSeq value
+   */
+  void UpdateNextTxSequence (SequenceNumber32 oldValue, SequenceNumber32 newValue);
+
+  /**
+   * \brief Set the initial Slow Start Threshold.
+   *
+   * \param threshold the Slow Start Threshold (in bytes)
+   */
+  void SetInitialSSThresh (uint32_t threshold);
+
+  /**
+   * \brief Get the initial Slow Start Threshold.
+   *
+   * \returns the Slow Start Threshold (in bytes)
+   */
+  uint32_t GetInitialSSThresh (void) const;
+
+  /**
+   * \brief Set the size of initial packet of the handshake
+   * It must be at least 1200 bytes
+   *
+   * \param the size in bytes
+   */
+  void SetInitialPacketSize (uint32_t size);
+
+  /**
+   * \brief Get the size of initial packet of the handshake
+   *
+   * \returns the size (in bytes)
+   */
+  uint32_t GetInitialPacketSize (void) const;
+
+  //ywj: a flag to create new udpSocket
+  bool m_subSocket;                        //!< If true, this subsocket allowed to be created
+  bool m_sendAnnounce;
+
+  // Implementation of ns3::Socket virtuals
+
+  /**
+   * Send a packet on a stream
+   *
+   * \param p a smart pointer for the packet
+   * \param flags the streamId
+   */
+  virtual int Send (Ptr<Packet> p, uint32_t flags);
+  /**
+   * Send a packet without specifying the stream
+   * Load balancing of the different streams will be applied
+   *
+   * \param p a smart pointer for the packet
+   */
+  virtual int Send (Ptr<Packet> p);
+  virtual int SendTo (Ptr<Packet> p, uint32_t flags, const Address &toAddress);
+  virtual Ptr<Packet> Recv (uint32_t maxSize, uint32_t flags);
+  virtual Ptr<Packet> RecvFrom (uint32_t maxSize, uint32_t flags, Address &fromAddress);
+  virtual int Bind (void);  // Bind a socket by setting up the UDP socket in QuicL4Protocol
+  virtual int Bind (const Address &address);
+  virtual int Bind6 (void);
+  virtual void BindToNetDevice (Ptr<NetDevice> netdevice);
+  virtual void SetSegSize (uint32_t size);
+  virtual uint32_t GetSegSize (void) const;
+  virtual int Listen (void);
+  virtual int Connect (const Address &address);  // Setup endpoint and create the QUIC L5 protocol
+  virtual int Close (void);
+  virtual int ShutdownSend (void);
+  virtual int ShutdownRecv (void);
+  virtual void SetNode (Ptr<Node> node);
+  virtual Ptr<Node> GetNode (void) const;
+  virtual int GetSockName (Address &address) const;
+  virtual int GetPeerName (Address &address) const;
+  virtual uint32_t GetTxAvailable (void) const;
+  virtual uint32_t GetRxAvailable (void) const;
+  virtual enum SocketErrno GetErrno (void) const;
+  virtual enum SocketType GetSocketType (void) const;
+
+  /**
+   * Set the latency bound for a specified stream
+   *
+   * \param streamId The stream ID
+   * \param latency The stream's maximum latency
+   */
+  void SetLatency (uint32_t streamId, Time latency);
+
+  /**
+   * Get the latency bound for a specified stream
+   *
+   * \param streamId The stream ID
+   * \return The stream's maximum latency, or 0 if the stream is not registered
+   */
+  Time GetLatency (uint32_t streamId);
+
+  /**
+   * Set the default latency bound
+   *
+   * \param latency The default maximum latency
+   */
+  void SetDefaultLatency (Time latency);
+
+  /**
+   * Get the default latency bound
+   *
+   * \param streamId The stream ID
+   * \return The default maximum latency
+   */
+  Time GetDefaultLatency ();
+
+  /**
+   * \brief TracedCallback signature for QUIC packet transmission or reception events.
+   *
+   * \param [in] packet The packet.
+   * \param [in] header The QuicHeaders
+   * \param [in] socket This socket
+   */
+  typedef void (*QuicTxRxTracedCallback)(const Ptr<const Packet> packet, const QuicHeader& header,
+                                         const Ptr<const QuicSocketBase> socket);
+
+protected:
+  /**
+   * \brief Dispose of the path manager and the fluid model, which hold the
+   * socket back, and release the peer socket of the fluid data
+   */
+  virtual void DoDispose (void);
+
+  // Implementation of QuicSocket virtuals
+  virtual bool SetAllowBroadcast (bool allowBroadcast);
+  virtual bool GetAllowBroadcast (void) const;
+
+  /**
+   * \brief Creates a Quic L5 Protocol
+   *
+   * \return the created Quic L5 Protocol
+   */
+  Ptr<QuicL5Protocol> CreateStreamController ();
+
+  /**
+   * \brief Set the RTO timer (called when packets or ACKs are sent)
+   */
+  void SetReTxTimeout (uint8_t pathId);
+
+  /**
+   * \brief Handle what happens in case of an RTO
+   */
+  void ReTxTimeout (uint8_t pathId);
+
+  /**
+   * \brief Handle retransmission after loss
+   */
+  void DoRetransmit (std::vector<Ptr<QuicSocketTxItem> > lostPackets, uint8_t pathId);
+
+  /**
+   * \brief Extract at most maxSize bytes from the TxBuffer at sequence packetNumber, add the
+   *        QUIC header, and send to QuicL4Protocol
+   *
+   * According to the internal state of the socket, a different header is built.
+   * Sequence numbers should be 64 bits in the QUIC standard, but we use 32 to
+   * be compatible with the TcpSocketBase class
+   *
+   * \param seq the sequence number
+   * \param maxSize the maximum data block to be transmitted (in bytes)
+   * \param withAck forces an ACK to be sent
+   * \returns the number of bytes sent
+   */
+  uint32_t SendDataPacket (SequenceNumber32 packetNumber, uint32_t maxSize,
+                           bool withAck);
+
+  uint32_t SendDataPacket (SequenceNumber32 packetNumber,
+                                uint32_t maxSize, bool withAck, int pathId);
+
+  /**
+   * \brief Send a Connection Close frame
+   *
+   * \param errorCode the error code that caused the connection close event
+   * \param phrase human-readable error description
+   * \return 0 on success
+   */
+  uint32_t SendConnectionClosePacket (uint16_t errorCode, std::string phrase);
+
+  /**
+   * \brief Send as much pending data as possible according to the Tx window.
+   *
+   * \param withAck forces an ACK to be sent
+   * \return the number of packets sent
+   */
+  uint32_t SendPendingData (bool withAck = false);
+
+  /**
+   * \brief Perform the real connection tasks: start the initial handshake for non-0-RTT
+   *
+   * \return 0 on success
+   */
+  int DoConnect (void);
+
+  int DoConnect (const Address& address);
+
+  /**
+   * \brief Perform the real connection tasks: start the initial 0-RTT handshake
+   *
+   * \return 0 on success
+   */
+  int DoFastConnect (void);
+
+  /**
+   * \brief Set the socket to IDLE, nullify the callbacks and remove this socket from the QuicL4Protocol
+   *
+   * \return 1 on success
+   */
+  int DoClose (void);
+
+  /**
+   * \brief receive a QUIC packet
+   *
+   * \param p a smart pointer to a packet
+   * \param quicHeader the header of the packet
+   * \param address the Address from which the packet was received
+   */
+  void ReceivedData (Ptr<Packet> p, const QuicHeader& quicHeader,
+                     Address &address);
+
+  /**
+   * \brief Update the state of the internal state machine
+   *
+   * \param the new state
+   */
+  void SetState (TracedValue<QuicStates_t> state);
+
+  /**
+   * \brief Check if a version is supported by the QuicSocket
+   *
+   * \param version the version to be checked
+   */
+  bool IsVersionSupported (uint32_t version);
+
+  /**
+   * \brief Check if there are missing packets in the m_receivedPacketNumbers list
+   *
+   * \return true if there are missing packets
+   */
+  bool HasReceivedMissing ();
+
+  /**
+   * \brief Send an ACK packet
+   */
+  void SendAck (uint8_t pathId);
+
+  /**
+   * \brief Attach the ACK frames to a packet about to be sent
+   *
+   * The ACK of the path of the packet is attached if withAck is set. With
+   * PiggybackPendingAcks, the ACK of any path waiting for SendAck is
+   * attached to a short packet too, and SendAck is not called.
+   *
+   * \param p the packet
+   * \param head the header of the packet
+   * \param withAck true to acknowledge the packets received on the path
+   */
+  void PiggybackAcks (Ptr<Packet> p, const QuicHeader &head, bool withAck);
+
+  /**
+   * \brief Call Socket::NotifyConnectionSucceeded()
+   */
+  void ConnectionSucceeded (void);
+
+  /**
+   * \brief Notify Pacing
+   */
+  void NotifyPacingPerformed (void);
+  /**
+   * Send the connection close packet and schedule
+   * the DoClose method
+   */
+  void ScheduleCloseAndSendConnectionClosePacket ();
+
+  //ywj: path scheduler
+  uint8_t m_lastUsedsFlowIdx = 0;
+
+  // Connections to other layers of the Stack
+  Ipv4EndPoint* m_endPoint;      //!< the IPv4 endpoint
+  Ipv6EndPoint* m_endPoint6;     //!< the IPv6 endpoint
+  Ptr<Node> m_node;              //!< The associated node
+  Ptr<QuicL4Protocol> m_quicl4;  //!< The associated L4 Protocol
+  Ptr<QuicL5Protocol> m_quicl5;  //!< The associated L5 Protocol
+
+  // Rx and Tx buffer management
+  Ptr<QuicSocketRxBuffer> m_rxBuffer;                     //!< RX buffer
+  Ptr<QuicSocketTxBuffer> m_txBuffer;                     //!< TX buffer
+  uint32_t m_socketTxBufferSize;                          //!< Size of the socket TX buffer
+  uint32_t m_socketRxBufferSize;                          //!< Size of the socket RX buffer
+  std::vector<SequenceNumber32> m_receivedPacketNumbers;  //!< Received packet number vector
+  TypeId m_schedulingTypeId;                                                      //!< The socket type of the packet scheduler
+  Time m_defaultLatency;                                                                  //!< The default latency bound (only used by the EDF scheduler)
+
+  // State-related attributes
+  TracedValue<QuicStates_t> m_socketState;  //!< State in the Congestion state machine
+  uint16_t m_transportErrorCode;            //!< Quic transport error code
+  bool m_serverBusy;                        //!< If true, server too busy to accept new connections
+  mutable enum SocketErrno m_errno;         //!< Socket error code
+  bool m_connected;                         //!< Check if connection is established
+  bool m_0RTTHandshake;                     //!< True if the client started the connection with a 0-RTT handshake
+  uint64_t m_connectionId;                  //!< Connection id
+  uint32_t m_vers;                          //!< Quic protocol version
+  QuicHeader::KeyPhase_t m_keyPhase;        //!< Key phase
+  Time m_lastReceived;                      //!< Time of last received packet
+
+  // Transport Parameters values
+  uint32_t m_initial_max_stream_data;    //!< The initial value for the maximum data that can be sent on any newly created stream
+  uint32_t m_max_data;                   //!< The maximum amount of data that can be sent on the connection
+  uint32_t m_initial_max_stream_id_bidi; //!< The the initial maximum number of application-owned bidirectional streams the peer may initiate
+  TracedValue<Time> m_idleTimeout;       //!< The idle timeout value in seconds
+  bool m_omit_connection_id;             //!< The flag that indicates if the connection id is required in the upcoming connection
+/*uint128_t  m_stateless_reset_token;*/  //!< The stateless reset token
+  uint8_t m_ack_delay_exponent;          //!< The exponent used to decode the ack delay field in the ACK frame
+  uint32_t m_initial_max_stream_id_uni;  //!< The initial maximum number of application-owned unidirectional streams the peer may initiate
+  uint32_t m_maxTrackedGaps;             //!< The maximum number of gaps in an ACK
+
+  // Transport Parameters management
+  bool m_receivedTransportParameters;      //!< Check if Transport Parameters are already been received
+  bool m_couldContainTransportParameters;  //!< Check if in the actual conditions can receive Transport Parameters
+
+  // Timers and Events
+  EventId m_sendPendingDataEvent;             //!< Micro-delay event to send pending data
+  EventId m_retxEvent;                        //!< Retransmission event
+  EventId m_idleTimeoutEvent;                 //!< Event triggered upon receiving or sending a packet, when it expires the connection closes
+  EventId m_drainingPeriodEvent;              //!< Event triggered upon idle timeout or immediate connection close, when it expires all closes
+  TracedValue<Time> m_rto;                    //!< Retransmit timeout
+  TracedValue<Time> m_drainingPeriodTimeout;  //!< Draining Period timeout
+  EventId m_sendAckEvent;                     //!< Send ACK timeout event
+  EventId m_delAckEvent;                      //!< Delayed ACK timeout event
+  bool m_flushOnClose;                        //!< Control behavior on connection close
+  bool m_closeOnEmpty;                        //!< True if the socket will close after sending the buffered packets
+
+  // Congestion Control
+  Ptr<QuicSocketState> m_tcb;                     //!< Congestion control informations
+  Ptr<TcpCongestionOps> m_congestionControl;      //!< Congestion control
+  TracedValue<Time> m_lastRtt;                                 //!< Latest measured RTT
+  bool m_quicCongestionControlLegacy;             //!< Quic Congestion control if true, TCP Congestion control if false
+  bool m_queue_ack;                               //!< Indicates a request for a queue ACK if true
+  uint32_t m_numPacketsReceivedSinceLastAckSent;  //!< Number of packets received since last ACK sent
+  uint32_t m_lastMaxData;                                                 //!< Last MaxData ACK
+  uint32_t m_maxDataInterval;                                     //!< Interval between successive MaxData frames in ACKs
+
+  uint32_t m_initialPacketSize; //!< size of the first packet to be sent durin the handshake (at least 1200 bytes, per RFC)
+
+  // Pacing timer
+  Timer m_pacingTimer       {Timer::REMOVE_ON_DESTROY}; //!< Pacing Event
+
+  /**
+  * \brief Callback pointer for cWnd trace chaining
+  */
+  TracedCallback<uint32_t, uint32_t> m_cWndTrace;
+  TracedCallback<uint32_t, uint32_t> m_cWndTrace0;
+  TracedCallback<uint32_t, uint32_t> m_cWndTrace1;
+
+  TracedCallback<double, double> m_thputTrace0;
+  TracedCallback<double, double> m_thputTrace1;
+
+  
+  TracedCallback<Time, Time> m_rttTrace0;
+  TracedCallback<Time, Time> m_rttTrace1;
+
+  /**
+  * \brief Callback pointer for ssTh trace chaining
+  */
+  TracedCallback<uint32_t, uint32_t> m_ssThTrace;
+
+  /**
+  * \brief Callback pointer for congestion state trace chaining
+  */
+  TracedCallback<TcpSocketState::TcpCongState_t, TcpSocketState::TcpCongState_t> m_congStateTrace;
+
+  /**
+  * \brief Callback pointer for high transmission mark trace chaining
+  */
+  TracedCallback<uint32_t, uint32_t> m_highTxMarkTrace;
+
+  /**
+  * \brief Callback pointer for tx sequence trace chaining
+  */
+  TracedCallback<uint32_t, uint32_t> m_nextTxSequenceTrace;
+
+  // The following two traces pass a packet with a QUIC header
+  TracedCallback<Ptr<const Packet>, const QuicHeader&,
+                 Ptr<const QuicSocketBase> > m_txTrace; //!< Trace of transmitted packets
+
+  TracedCallback<Ptr<const Packet>, const QuicHeader&,
+                 Ptr<const QuicSocketBase> > m_rxTrace; //!< Trace of received packets
+
+  void CreateScheduler ();
+  Ptr<QuicScheduler> m_scheduler;
+  /**
+   * \brief Create and start the path manager, if enabled, once the subflows are set up
+   */
+  void InitializePathManager ();
+  bool m_enablePathManager;                       //!< True if path probing and failover are enabled
+  Ptr<MpQuicPathManager> m_pathManager;           //!< The path manager
+  /**
+   * \brief Validate the source address of a packet received on a path
+   *
+   * Only the server follows the peer. A packet coming from a new port of
+   * the peer address of the path (NAT rebinding) moves the path at once.
+   * A packet coming from a new address triggers a PATH_CHALLENGE to that
+   * address; the path moves when the PATH_RESPONSE arrives. Only the
+   * packet with the highest packet number received so far on the path is
+   * checked, so a reordered packet does not move the path back.
+   *
+   * \param pathId the path the packet was received on
+   * \param from the source address of the packet
+   */
+  void CheckPeerAddress (uint8_t pathId, const Address &from);
+  /**
+   * \brief Move this end of a path to a validated peer address
+   *
+   * \param pathId the path
+   * \param peer the new peer address
+   */
+  void RebindPath (uint8_t pathId, const Address &peer);
+  /**
+   * \brief Keep or reset the congestion state of a path which moved
+   *
+   * \param pathId the path
+   * \param oldAddress the address the path was bound to
+   * \param newAddress the address the path is bound to now
+   */
+  void OnPathMigrated (uint8_t pathId, const Address &oldAddress, const Address &newAddress);
+  /**
+   * \brief Send a control frame in a packet of its own on a path
+   *
+   * \param pathId the path
+   * \param frame the frame
+   * \param to the destination, if it is not the peer address of the path
+   */
+  void SendPathFrame (uint8_t pathId, const QuicSubheader &frame, const Address &to = Address ());
+  bool m_connectionMigration;                     //!< True if the peer may move the paths to new addresses
+  Ipv4Mask m_pathClassMask;                       //!< Addresses in the same subnet under this mask are on the same path class
+  bool m_piggybackAcks;                           //!< True if the pending ACKs ride on the next short packet
+  std::map<uint8_t, std::pair<Address, uint8_t> > m_pathValidations;  //!< Per path, the address being validated and its PATH_CHALLENGE data
+  Ptr<UniformRandomVariable> m_pathChallengeData; //!< Data of the PATH_CHALLENGE frames
+  uint8_t m_rxPathId;                             //!< Path of the packet being processed
+  TracedCallback<uint8_t, const Address &, const Address &, bool> m_pathMigrationTrace; //!< Trace of path migrations
+  /**
+   * \brief Create the fluid model, if enabled, once the subflows are set up
+   */
+  void InitializeFluidModel ();
+  /**
+   * \brief Set the initial window and the traces of path 0 of a client
+   */
+  void InitializeFirstSubflow ();
+  /**
+   * \brief Announce path 1 and create the MAMS scheduler, once the client
+   * knows that the server holds the connection
+   */
+  void StartMultipath ();
+  /**
+   * \brief Find the socket at the other end of the connection
+   *
+   * Only the sockets with a fluid model are found: they are registered
+   * when it is created, so that the socket lists of the other nodes, which
+   * their own threads may change under the multithreaded simulator, are
+   * never read.
+   *
+   * \return the peer socket, or 0 if it is not found
+   */
+  Ptr<QuicSocketBase> FindPeerSocket (void) const;
+  /**
+   * \brief Remove the socket from the ends of the connections with a fluid model
+   */
+  void UnregisterFluidEnd (void);
+  bool m_enableFluidModel;                        //!< True if steady phases are fast-forwarded
+  Ptr<MpQuicFluidModel> m_fluidModel;             //!< The fluid model
+  Ptr<QuicSocketBase> m_fluidPeer;                //!< Receiver of the fluid data
+  static std::multimap<uint64_t, QuicSocketBase *> g_fluidEnds;  //!< Sockets with a fluid model, by connection id
+  static SystemMutex g_fluidEndsMutex;            //!< Guards g_fluidEnds, shared by the threads of the simulator
+
+  // MAMS Extension: scenario of the connection, copied from the QuicEchoClientHelper
+  // settings when the socket is created, so that the sockets never write them
+  Time m_owd0;                                    //!< One-way delay of path 0
+  Time m_owd1;                                    //!< One-way delay of path 1
+  DataRate m_bw0;                                 //!< Rate of the link of path 0
+  DataRate m_bw1;                                 //!< Rate of the link of path 1
+  double m_errorRate;                             //!< Error rate of the links
+  uint8_t m_scheAlgo;                             //!< Packet scheduler: 1. quic-rr, 2. mpquic-rr, 3. mpquic-ofo, 4./5. ACKs on the fastest path
+  bool m_withMob;                                 //!< True if the link rates follow a mobility scenario
+
+  /**
+   * \brief Update the out-of-order control state of the scheduler before
+   * taking data for a path
+   *
+   * \param pathId the path the data will be sent on
+   * \return false if the path is blocked
+   */
+  bool UpdateScheduleState (int pathId);
+  int FindMinRttPath();
+  double GetOliaApha(int pathId);
+  void InitialRTT ();
+  uint8_t GetSubflowToUse ();
+  //uint32_t TotalData (double T,uint32_t sFlowIdx,uint32_t cwnd,int sst,double p,double p0,int flag, double RTT, double RTO, double totalData);
+  double TotalData (double T,uint32_t sFlowIdx,double cwnd,int sst,double p,double p0, double RTT, double RTO);
+  double TotalData_noBWLimit (double T,uint32_t sFlowIdx,double cwnd,int sst,double p,double p0, double RTT, double RTO); //doesn't consider the BW changing due to mobility
+  void InitialBW ();
+   void InitialExVar ();
+};
+
+
+} //namespace ns3
+#endif /* QUIC_SOCKET_BASE_H_ */
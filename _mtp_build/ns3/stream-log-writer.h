@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef STREAM_LOG_WRITER_H
+#define STREAM_LOG_WRITER_H
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup dashStream
+ * \brief Buffered log file shared by the streaming clients
+ *
+ * There is one writer per file: all the clients logging a metric get the
+ * same writer from Get () and write their rows into it, each row starting
+ * with the id of the client. Rows are kept in memory and written to the
+ * file once the buffer holds StreamLogBufferSize bytes, when the last
+ * client releases the writer and at Simulator::Destroy ().
+ */
+class StreamLogWriter : public SimpleRefCount<StreamLogWriter>
+{
+public:
+  /**
+   * \brief Get the writer of a file, opening the file if needed
+   *
+   * \param fileName the log file
+   * \param columns the header of the columns following the client id
+   * \return the writer of the file
+   */
+  static Ptr<StreamLogWriter> Get (const std::string &fileName, const std::string &columns);
+
+  /**
+   * \brief Write the buffered rows of all the open writers to their files
+   */
+  static void FlushAll (void);
+
+  ~StreamLogWriter ();
+
+  /**
+   * \brief Start a row
+   *
+   * \param clientId the id of the client the row is about
+   * \return the stream to write the other columns of the row to, ending
+   * with a newline
+   */
+  std::ostream & Record (uint32_t clientId);
+
+  /**
+   * \brief Write the buffered rows to the file
+   */
+  void Flush (void);
+
+private:
+  /**
+   * \param fileName the log file
+   * \param columns the header of the columns following the client id
+   */
+  StreamLogWriter (const std::string &fileName, const std::string &columns);
+
+  std::string m_fileName;     //!< the log file
+  std::ofstream m_file;       //!< the open log file
+  std::ostringstream m_rows;  //!< rows not written yet
+  uint32_t m_bufferSize;      //!< bytes buffered before a write
+};
+
+} // namespace ns3
+
+#endif /* STREAM_LOG_WRITER_H */
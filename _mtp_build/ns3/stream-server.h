@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright 2016 Technische Universitaet Berlin
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef STREAM_SERVER_H
+#define STREAM_SERVER_H
+
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/traced-callback.h"
+#include <unordered_map>
+#include <chrono>
+#include "ns3/random-variable-stream.h"
+#include "ns3/quic-socket-base.h"
+
+namespace ns3 {
+
+
+
+class Socket;
+class Packet;
+class PropagationDelayModel;
+
+/**
+ * \ingroup applications
+ * \defgroup dashStream DashStream
+ */
+
+/**
+ * \ingroup dashStream
+ * \brief data strucute the server uses to manage the following data for every client separately.
+ */
+struct callbackData
+{
+  uint32_t currentSegmentIndex; //!< Index of video segment currently being transmitted
+  uint32_t currentTxBytes;//!< already sent bytes for this particular segment, set to 0 if sent bytes == packetSizeToReturn, so transmission for this segment is over
+  uint32_t packetSizeToReturn;//!< total amount of bytes that have to be returned to the client
+  bool send;//!< true as long as there are still bytes left to be sent for the current segment
+  Address peer;//!< address of the client when it connected, for logging purposes
+};
+
+/**
+ * \ingroup dashStream
+ * \brief A DASH Stream server
+ *
+ * Clients sent messages with the amount of bytes they want the server to return to them.
+ */
+
+
+class StreamServer : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  StreamServer ();
+  virtual ~StreamServer ();
+
+  /**
+   * \brief Get the time spent in the handlers of the client sockets
+   *
+   * This is the wall-clock time of the accept, receive, send and close
+   * callbacks, including the transmissions they trigger down the stack of
+   * the server. It is only measured with the TimeHandlers attribute set.
+   *
+   * \return the time spent in the handlers, in seconds
+   */
+  double GetHandlerTime (void) const;
+
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief Handle a packet reception, and set SendCallback to HandlSend.
+   *
+   * This function is called by lower layers. The received packet's content
+   * gets deserialized by GetCommand (Ptr<Packet> packet). If the packets content
+   * contains a string composed of an int with
+   * value n, then n bytes will be sent back to the sender.
+   *
+   * \param client the state of the client connected to socket.
+   * \param socket the socket the packet was received to.
+   */
+  void HandleRead (callbackData *client, Ptr<Socket> socket);
+
+  /**
+   * \brief send packetSizeToReturn bytes to the client connected to socket.
+   *
+   * This function is called once by HandleRead (Ptr<Socket> socket) after a send of n (i.e.
+   * a segment of n) bytes was requested by the client. If n > socket->GetTxAvailable (),
+   * (this is the current space available in the buffer in bytes), then socket->GetTxAvailable () bytes
+   * are written into the buffer. This function will get called again through the SendCallback when
+   * space in the buffer has freed up.
+   * The amount of sent bytes for this particular segment and for the client connected with
+   * this socket is stored in client->currentTxBytes. The state of the client is bound to the
+   * callbacks of its socket when the connection is accepted, as there is a socket instance for
+   * every connected client, so no lookup is needed.
+   * client->send indicates that the server has not yet sent client->packetSizeToReturn bytes.
+   * When the number of bytes should be sent is reached, client->send will be set to false and
+   * the server stops sending bytes to the client until he requests another segment.
+   *
+   * \param client the state of the client connected to socket.
+   * \param socket the socket the request for a segment was received to and where the server will send packetSizeToReturn bytes to.
+   * \param txSpace the available space in the Tx buffer
+   */
+  void HandleSend (callbackData *client, Ptr<Socket> socket, uint32_t txSpace);
+
+  /**
+   * \brief Set callback functions for receive, send and close.
+   * Allocate the callbackData structure of the newly connected client and bind it to the callbacks of its socket.
+   */
+  void HandleAccept (Ptr<Socket> s, const Address& from);
+
+  /**
+   * \brief Forget a client whose connection was closed, stop the simulation after the last one.
+   * \param socket the socket of the client.
+   */
+  void HandlePeerClose (Ptr<Socket> socket);
+  void HandlePeerError (Ptr<Socket> socket);
+
+  /**
+   * \brief Called when a new connection is requested.
+   * 
+   * Determine whether the request should be accepted or denied. In practice,
+   * connections will never be refused voluntarily.
+   */
+  bool HandleConnectionRequest (Ptr<Socket> socket, const Address& from);
+
+  /**
+   * \brief Deserialize what the client has sent us.
+   * \param packet the data the client has sent us
+   * \return the deserialized packet content as a string
+   */
+  int64_t GetCommand (Ptr<Packet> packet);
+
+  /**
+   * \brief Measures the outermost handler running, if TimeHandlers is set
+   */
+  class HandlerTimer
+  {
+  public:
+    /**
+     * \brief Start measuring, unless a handler is already measured
+     * \param server the server running the handler
+     */
+    HandlerTimer (StreamServer *server);
+    /// Add the time of the handler to the server, if measured
+    ~HandlerTimer ();
+
+  private:
+    StreamServer *m_server;                         //!< server running the handler
+    bool m_outer;                                   //!< true if this handler is measured
+    std::chrono::steady_clock::time_point m_start;  //!< start of the handler
+  };
+
+  uint16_t m_port; //!< Port on which we listen for incoming packets.
+  Ptr<Socket> m_socket; //!< IPv4 Socket
+  Ptr<Socket> m_socket6; //!< IPv6 Socket
+  std::unordered_map <Socket *, callbackData> m_callbackData; //!< State of the currently connected clients, by socket. Elements do not move, the receive and send callbacks of the sockets point to them.
+  std::string m_protocolName; //!< The name of the transport protocol to be used (TCP or QUIC)
+  bool m_timeHandlers; //!< Measure the time spent in the handlers
+  bool m_inHandler; //!< True while a handler is measured
+  std::chrono::steady_clock::duration m_handlerTime; //!< Time spent in the handlers
+};
+
+} // namespace ns3
+
+#endif /* STREAM_SERVER_H */
+
@@ -0,0 +1,8 @@
+#! /usr/bin/env python3
+
+# Programs that are runnable.
+ns3_runnable_programs = ['_mtp_test/src/core/examples/ns3-dev-main-callback-debug', '_mtp_test/src/core/examples/ns3-dev-sample-simulator-debug', '_mtp_test/src/core/examples/ns3-dev-main-ptr-debug', '_mtp_test/src/core/examples/ns3-dev-sample-random-variable-debug', '_mtp_test/src/core/examples/ns3-dev-sample-random-variable-stream-debug', '_mtp_test/src/core/examples/ns3-dev-command-line-example-debug', '_mtp_test/src/core/examples/ns3-dev-hash-example-debug', '_mtp_test/src/core/examples/ns3-dev-sample-log-time-format-debug', '_mtp_test/src/core/examples/ns3-dev-test-string-value-formatting-debug', '_mtp_test/src/core/examples/ns3-dev-sample-show-progress-debug', '_mtp_test/src/core/examples/ns3-dev-system-path-examples-debug', '_mtp_test/src/core/examples/ns3-dev-fatal-example-debug', '_mtp_test/src/core/examples/ns3-dev-main-test-sync-debug', '_mtp_test/src/core/examples/ns3-dev-length-example-debug', '_mtp_test/src/network/examples/ns3-dev-main-packet-header-debug', '_mtp_test/src/network/examples/ns3-dev-main-packet-tag-debug', '_mtp_test/src/network/examples/ns3-dev-packet-socket-apps-debug', '_mtp_test/src/network/examples/ns3-dev-lollipop-comparisions-debug', '_mtp_test/src/point-to-point/examples/ns3-dev-main-attribute-value-debug', '_mtp_test/src/stats/examples/ns3-dev-gnuplot-example-debug', '_mtp_test/src/stats/examples/ns3-dev-double-probe-example-debug', '_mtp_test/src/stats/examples/ns3-dev-time-probe-example-debug', '_mtp_test/src/stats/examples/ns3-dev-gnuplot-aggregator-example-debug', '_mtp_test/src/stats/examples/ns3-dev-gnuplot-helper-example-debug', '_mtp_test/src/stats/examples/ns3-dev-file-aggregator-example-debug', '_mtp_test/src/stats/examples/ns3-dev-file-helper-example-debug', '_mtp_test/examples/tutorial/ns3-dev-hello-simulator-debug', '_mtp_test/examples/tutorial/ns3-dev-fourth-debug', '_mtp_test/scratch/ns3-dev-MAMS-test-rr-debug', '_mtp_test/scratch/ns3-dev-MAMS-test-late-debug', '_mtp_test/scratch/ns3-dev-MAMS-test-2-debug', '_mtp_test/scratch/ns3-dev-MAMS-test-example-debug', '_mtp_test/scratch/subdir/ns3-dev-subdir-debug', '_mtp_test/scratch/ns3-dev-scratch-simulator-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['sample-simulator.py']
+
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_RATE_TRACE_MODEL_H
+#define LINK_RATE_TRACE_MODEL_H
+
+#include <string>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/traced-callback.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup point-to-point
+ * \brief Replay of a measured link capacity trace on a point-to-point link
+ *
+ * The trace is a binary file of consecutive Sample records (four little
+ * endian doubles: time in seconds, rate in bit/s, one-way delay in seconds,
+ * loss probability), sorted by time. It is memory-mapped, so traces with
+ * millions of samples cost neither load time nor heap; e.g. with numpy:
+ *
+ * \code
+ *   np.array (rows, dtype='<f8').tofile ("wifi.lrt")   # rows of [t, bps, delay, loss]
+ * \endcode
+ *
+ * No event is scheduled per sample. The PointToPointNetDevice owning the model
+ * calls Update () when it starts a transmission, which advances a cursor to
+ * the last sample not later than the current time and reports what changed.
+ * A sample with a zero rate is an outage: the packets sent during it are lost.
+ * A negative delay leaves the delay of the channel unchanged. With Loop set,
+ * the replay starts over once the last sample has lasted as long as the
+ * interval before it, so a trace of N samples every T seconds has a period
+ * of N * T seconds.
+ */
+class LinkRateTraceModel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// One record of the trace file
+  struct Sample
+  {
+    double m_time;   //!< Start of the sample, in seconds
+    double m_rate;   //!< Link rate, in bit/s
+    double m_delay;  //!< One-way delay, in seconds
+    double m_loss;   //!< Packet loss probability
+  };
+
+  /**
+   * \brief TracedCallback signature for link rate changes
+   *
+   * \param [in] oldRate the previous rate of the link
+   * \param [in] newRate the new rate of the link
+   */
+  typedef void (* RateTracedCallback)(DataRate oldRate, DataRate newRate);
+
+  LinkRateTraceModel ();
+  virtual ~LinkRateTraceModel ();
+
+  /**
+   * \brief Map a trace file
+   *
+   * \param filename the trace file
+   */
+  void SetTraceFile (std::string filename);
+
+  /**
+   * \return the name of the mapped trace file
+   */
+  std::string GetTraceFile (void) const;
+
+  /**
+   * \return the number of samples in the trace
+   */
+  uint64_t GetNSamples (void) const;
+
+  /**
+   * \brief Move to the sample covering the current time
+   *
+   * \return true if the rate or the delay changed since the last call
+   */
+  bool Update (void);
+
+  /**
+   * \return the rate of the current sample
+   */
+  DataRate GetRate (void) const;
+
+  /**
+   * \return the delay of the current sample, negative if unchanged
+   */
+  Time GetDelay (void) const;
+
+  /**
+   * \brief Draw whether a packet sent now is lost
+   *
+   * \return true if the packet must be dropped
+   */
+  bool IsLost (void);
+
+  /**
+   * \brief Assign a fixed random variable stream number to the loss draws
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \brief Write a trace file in the format read by the model
+   *
+   * \param filename the trace file
+   * \param samples the samples, sorted by time
+   */
+  static void WriteTraceFile (std::string filename, const std::vector<Sample> &samples);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Unmap the current trace, if any
+   */
+  void Unmap (void);
+
+  std::string m_filename;                 //!< Name of the mapped trace
+  const Sample *m_samples;                //!< Mapped samples
+  uint64_t m_nSamples;                    //!< Number of samples
+  std::size_t m_mapSize;                  //!< Size of the mapping, in bytes
+  uint64_t m_index;                       //!< Current sample
+  bool m_started;                         //!< True once the first sample was applied
+  DataRate m_rate;                        //!< Rate of the current sample
+  Time m_delay;                           //!< Delay of the current sample
+  double m_loss;                          //!< Loss probability of the current sample
+  bool m_loop;                            //!< True to replay the trace forever
+  Time m_offset;                          //!< Simulation time of trace time zero
+  Ptr<UniformRandomVariable> m_uniform;   //!< Loss draws
+
+  TracedCallback<DataRate, DataRate> m_rateTrace;   //!< Rate changes
+};
+
+} // namespace ns3
+
+#endif /* LINK_RATE_TRACE_MODEL_H */
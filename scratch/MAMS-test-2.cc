@@ -15,12 +15,15 @@
 
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 #include <boost/assign/list_of.hpp>
 
 #include <iostream>
 #include <string>
+#include <fstream>
 #include <regex>
+#include <chrono>
 
 using namespace ns3;
 
@@ -39,6 +42,12 @@ static void RttChange(Ptr<OutputStreamWrapper> stream, Time oldRtt, Time newRtt)
 }
 
 
+/**
+ * Files of the cwnd and RTT traces, by name, reopened by the branches of a forked run
+ */
+static std::vector<std::pair<std::string, Ptr<OutputStreamWrapper> > > g_traceFiles;
+
+
 static void Traces(uint32_t serverId, std::string pathVersion, std::string finalPart)
 {
     AsciiTraceHelper asciiTraceHelper;
@@ -87,6 +96,23 @@ static void Traces(uint32_t serverId, std::string pathVersion, std::string final
 
     Ptr<OutputStreamWrapper> stream1rtt = asciiTraceHelper.CreateFileStream (file1rtt.str().c_str());
     Config::ConnectWithoutContext(path1rtt.str().c_str(), MakeBoundCallback(&RttChange, stream1rtt));
+
+    g_traceFiles.push_back(std::make_pair(fileCW.str(), stream));
+    g_traceFiles.push_back(std::make_pair(file0CW.str(), stream0));
+    g_traceFiles.push_back(std::make_pair(file1CW.str(), stream1));
+    g_traceFiles.push_back(std::make_pair(file0rtt.str(), stream0rtt));
+    g_traceFiles.push_back(std::make_pair(file1rtt.str(), stream1rtt));
+}
+
+
+/**
+ * Write out the traces buffered so far, so that the branches of a forked run do not write them again
+ */
+static void FlushTraces()
+{
+    for (auto &file : g_traceFiles) {
+        file.second->GetStream()->flush();
+    }
 }
 
 
@@ -116,6 +142,110 @@ void ThroughputMonitor(FlowMonitorHelper *fmhelper, Ptr<FlowMonitor> flowMon, Gn
 }
 
 
+Time linkCutTime = Seconds(0);
+Time pathFailureTime = Seconds(0);
+
+
+static void PathFailure(uint32_t nodeId, uint8_t pathId, uint32_t reinjected, Time lastActivity)
+{
+    std::cout << Simulator::Now().GetSeconds() << " node " << nodeId << " failed path " << (int)pathId
+              << ", last activity at " << lastActivity.GetSeconds() << " s, "
+              << reinjected << " bytes reinjected" << std::endl;
+    if (pathFailureTime == Seconds(0)) {
+        pathFailureTime = Simulator::Now();
+    }
+}
+
+
+uint64_t fileRxBytes = 0;
+uint64_t fileTargetBytes = 0;
+Time fileCompletionTime = Seconds(0);
+uint32_t fluidWindows = 0;
+uint64_t fluidBytes = 0;
+Time fluidTime = Seconds(0);
+
+
+static void FileRx(Ptr<const Packet> p)
+{
+    fileRxBytes += p->GetSize();
+    if (fileCompletionTime == Seconds(0) && fileRxBytes >= fileTargetBytes) {
+        fileCompletionTime = Simulator::Now();
+    }
+}
+
+
+static void FastForward(Time start, Time duration, uint64_t bytes)
+{
+    fluidWindows++;
+    fluidBytes += bytes;
+    fluidTime += duration;
+}
+
+
+/**
+ * Listen to the fluid model of the sender, once the connection is set up
+ */
+void FluidTraces(uint32_t nodeId)
+{
+    std::ostringstream path;
+    path << "/NodeList/" << nodeId << "/$ns3::QuicL4Protocol/SocketList/*/QuicSocketBase/FluidModelObject/FastForward";
+    Config::ConnectWithoutContext(path.str().c_str(), MakeCallback(&FastForward));
+}
+
+
+/**
+ * Blackhole both directions of a p2p link and, if enabled, start listening to the path managers
+ */
+void CutLink(NetDeviceContainer *ptp, NodeContainer nodes, bool pathManager)
+{
+    Ptr<RateErrorModel> em = CreateObjectWithAttributes<RateErrorModel>("ErrorRate", DoubleValue(1.0),
+                                                                        "ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+    ptp->Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+    ptp->Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+    linkCutTime = Simulator::Now();
+    std::cout << Simulator::Now().GetSeconds() << " link cut" << std::endl;
+
+    for (uint32_t i = 0; pathManager && i < nodes.GetN(); i++) {
+        std::ostringstream pathFailure;
+        pathFailure << "/NodeList/" << nodes.Get(i)->GetId() << "/$ns3::QuicL4Protocol/SocketList/*/QuicSocketBase/PathManagerObject/PathFailure";
+        Config::ConnectWithoutContext(pathFailure.str().c_str(), MakeBoundCallback(&PathFailure, nodes.Get(i)->GetId()));
+    }
+}
+
+
+/**
+ * Hand a p2p link over as a LEO ground link moving to another satellite: the packets queued on it are lost and its delay changes
+ */
+void Handover(NetDeviceContainer *ptp, Time delay)
+{
+    ptp->Get(0)->GetChannel()->SetAttribute("Delay", TimeValue(delay));
+    for (uint32_t i = 0; i < ptp->GetN(); i++) {
+        StaticCast<PointToPointNetDevice>(ptp->Get(i))->GetQueue()->Flush();
+    }
+    std::cout << Simulator::Now().GetSeconds() << " path 0 handover, delay " << delay.GetMilliSeconds() << " ms" << std::endl;
+}
+
+
+/**
+ * Announce a handover of path 0 to the path managers of the connected sockets, as a LEO scenario does from the Handover trace of LeoSatelliteConfig
+ */
+void AnnounceHandover(NodeContainer nodes, Time time, Time rttChange)
+{
+    for (uint32_t i = 0; i < nodes.GetN(); i++) {
+        std::ostringstream path;
+        path << "/NodeList/" << nodes.Get(i)->GetId() << "/$ns3::QuicL4Protocol/SocketList/*/QuicSocketBase";
+        Config::MatchContainer sockets = Config::LookupMatches(path.str());
+        for (Config::MatchContainer::Iterator it = sockets.Begin(); it != sockets.End(); it++) {
+            PointerValue manager;
+            (*it)->GetAttribute("PathManagerObject", manager);
+            if (manager.Get<MpQuicPathManager>() != 0) {
+                manager.Get<MpQuicPathManager>()->NotifyHandover(0, time, rttChange);
+            }
+        }
+    }
+}
+
+
 void ModifyLinkRate(NetDeviceContainer *ptp, QuicEchoClientHelper echoClient, DataRate lr, uint8_t subflowId)
 {
     StaticCast<PointToPointNetDevice>(ptp->Get(0))->SetDataRate(lr);
@@ -129,6 +259,59 @@ void ModifyLinkRate(NetDeviceContainer *ptp, QuicEchoClientHelper echoClient, Da
 }
 
 
+/**
+ * Keep the bandwidth estimates of the MP-QUIC schedulers of a node in line with a replayed rate trace
+ *
+ * The rate changes are seen at transmit, in the context of the node: only its sockets are updated.
+ */
+static void TraceRateChanged(QuicEchoClientHelper *echoClient, Ptr<Node> node, uint8_t subflowId, DataRate oldRate, DataRate newRate)
+{
+    if(newRate.GetBitRate() == 0) {
+        return;     // outage, the packets are dropped by the trace
+    }
+    echoClient->SetBW(node, subflowId, newRate);
+}
+
+
+/**
+ * Move the UE to x (m) and push the capacities of both links that changed enough
+ */
+void UeMove(const LinkCapacityModel *wifi, const LinkCapacityModel *lte, LinkRateFeed *feed, double x)
+{
+    double caps[2] = {wifi->capacity(x), lte->capacity(x)};
+    feed->update(caps, 2);
+}
+
+
+/**
+ * Branch of a forked run: apply its error rate, and write its files in a directory of its own
+ */
+static void ErrorRateBranch(Ptr<RateErrorModel> em, QuicEchoClientHelper *echoClient, const std::vector<double> *errorRates, uint32_t branch)
+{
+    double errorRate = errorRates->at(branch);
+    em->SetRate(errorRate);
+    echoClient->SetER(errorRate);
+    std::string dir = "branch" + std::to_string(branch) + "-errorRate=" + std::to_string(errorRate);
+    mkdir(dir.c_str(), 0755);
+    if (chdir(dir.c_str()) != 0) {
+        NS_FATAL_ERROR("cannot enter " << dir);
+    }
+    // the traces so far are shared: copy them, then go on in the copy of the branch
+    for (auto &file : g_traceFiles) {
+        std::ofstream *out = dynamic_cast<std::ofstream *>(file.second->GetStream());
+        NS_ABORT_MSG_IF(out == 0, "trace " << file.first << " is not a file");
+        out->close();
+        {
+            std::ifstream shared("../" + file.first, std::ios::binary);
+            std::ofstream copy(file.first, std::ios::binary);
+            copy << shared.rdbuf();
+        }
+        out->open(file.first, std::ios::app);
+        NS_ABORT_MSG_IF(!out->is_open(), "cannot reopen " << file.first << " in " << dir);
+    }
+}
+
+
 /**
  * Outline:
  *   1. Create 2 nodes
@@ -159,6 +342,18 @@ int main (int argc, char *argv[])
     uint8_t schAlgo = 3;
     std::string maxBuffSize = "5p";
     uint64_t fileSize = 5e6;
+    double linkCut = 0;
+    bool pathManager = false;
+    bool fluid = false;
+    double simTime = 8;
+    double ueSpeed = 0;
+    std::vector<std::string> rateTrace(2);
+    double forkAt = 0;
+    uint32_t forkJobs = 0;
+    std::string forkErrorRates;
+    double handoverPeriod = 0;
+    std::string handoverDelay = "30ms";
+    bool announceHandovers = false;
 
     CommandLine cmd;
     cmd.Usage("Simulation of bulkSend over MPQUIC.\n");
@@ -170,7 +365,20 @@ int main (int argc, char *argv[])
     cmd.AddValue("dataRate0", "The data rate for path 0", dataRate0);
     cmd.AddValue("maxBuffSize", "max buffer size of router", maxBuffSize);
     cmd.AddValue("schAlgo", "mutipath scheduler algorithm", schAlgo); // 2, mpquic-rr, 3. MAMS, 5. LATE
-
+    cmd.AddValue("linkCut", "time (s) at which path 1 is blackholed, 0 to keep it up", linkCut);
+    cmd.AddValue("pathManager", "enable path probing and failover", pathManager);
+    cmd.AddValue("fluid", "fast-forward the steady phases with the fluid model", fluid);
+    cmd.AddValue("simTime", "simulation end time (s)", simTime);
+    cmd.AddValue("rateTrace0", "binary (time, rate, delay, loss) trace replayed on path 0", rateTrace[0]);
+    cmd.AddValue("rateTrace1", "binary (time, rate, delay, loss) trace replayed on path 1", rateTrace[1]);
+    cmd.AddValue("ueSpeed", "UE speed (m/s) along the Wi-Fi/LTE road when isMob is set, 0 for the linear rate ramp", ueSpeed);
+    cmd.AddValue("handoverPeriod", "period (s) of the LEO handovers of path 0, 0 for none", handoverPeriod);
+    cmd.AddValue("handoverDelay", "delay of path 0 after every other handover, the initial delay after the others", handoverDelay);
+    cmd.AddValue("announceHandovers", "announce the handovers of path 0 to the path managers half a period ahead (needs pathManager)", announceHandovers);
+
+    cmd.AddValue("forkAt", "time (s) at which the run is forked into one process per forkErrorRates value, 0 not to fork", forkAt);
+    cmd.AddValue("forkJobs", "number of forked branches running at once, 0 for one per processor", forkJobs);
+    cmd.AddValue("forkErrorRates", "comma separated error rates of the branches forked at forkAt", forkErrorRates);
     cmd.Parse (argc, argv);
 
     rate[0] = dataRate0;
@@ -182,6 +390,8 @@ int main (int argc, char *argv[])
     Config::SetDefault("ns3::QuicSocketBase::SocketRcvBufSize",UintegerValue(10485760));
 
     Config::SetDefault("ns3::MpQuicSubFlow::delay", DoubleValue (0.03));
+    Config::SetDefault("ns3::QuicSocketBase::PathManager", BooleanValue (pathManager));
+    Config::SetDefault("ns3::QuicSocketBase::FluidModel", BooleanValue (fluid));
     Config::SetDefault("ns3::DropTailQueue<Packet>::MaxSize", StringValue (maxBuffSize));
 
     NodeContainer nodes;
@@ -190,7 +400,7 @@ int main (int argc, char *argv[])
     auto n2 = nodes.Get(1);
 
     int sf = 2;
-    Time simulationEndTime = Seconds(8);
+    Time simulationEndTime = Seconds(simTime);
 
     int start_time = 1;
 
@@ -254,6 +464,8 @@ int main (int argc, char *argv[])
 
     ApplicationContainer serverApps = echoServer.Install(nodes.Get(1));
     serverApps.Start(Seconds(0.0));
+    fileTargetBytes = fileSize;
+    serverApps.Get(0)->TraceConnectWithoutContext("Rx", MakeCallback(&FileRx));
     serverApps.Stop(simulationEndTime);
 
     //QuicEchoClientHelper echoClient (ground_station_interfaces[1].GetAddress(0), 9);
@@ -308,44 +520,96 @@ int main (int argc, char *argv[])
     Ptr<FlowMonitor> monitor = flowmon.InstallAll();
     ThroughputMonitor(&flowmon, monitor, dataset, dataset1);
 
+    const LinkCapacityModel wifiCap(wifi_params());
+    const LinkCapacityModel lteCap(lte_params());
+    LinkRateFeed rateFeed(2, [&netDevices, &echoClient](std::size_t link, double capMbps) {
+        DataRate lr(static_cast<uint64_t>(std::max(capMbps, 0.01) * 1e6));   // no service: keep a trickle, p2p cannot take 0
+        ModifyLinkRate(&netDevices[link], echoClient, lr, link);
+    });
+
+    for(int i = 0; i < sf; i++) {
+        if(rateTrace[i].empty()) {
+            continue;
+        }
+        // one replay per end: an outage also stops the ACKs, and each model
+        // reports its changes only to the device which owns it, and to the sockets of its node
+        for(uint32_t end = 0; end < 2; end++) {
+            Ptr<NetDevice> device = netDevices[i].Get(end);
+            Ptr<LinkRateTraceModel> trace = CreateObjectWithAttributes<LinkRateTraceModel>("TraceFile", StringValue(rateTrace[i]));
+            trace->TraceConnectWithoutContext("RateChanged", MakeBoundCallback(&TraceRateChanged, &echoClient, device->GetNode(), (uint8_t)i));
+            device->SetAttribute("RateTraceModel", PointerValue(trace));
+        }
+    }
+
     if(isMob) {
         (void)bwInt;
 
-        // double UEPosition = 0.0;
-        // double UESpeed = 20.0;
-        // double APPosition = 0.0;
-        // double APRadius = 200.0;
-        // double APCapacityMbps = 5.0;
-        // double BSPosition = 400.0;
-        // double BSRadius = 400.0;
-        // double BSCapacityMbps = 5.0;
-
-        // for(double i = 0; i < 20; i+=0.1) {
-        //     double x = i*30;
-        //     // auto [wifiCap, lteCap] = capacity_wifi_lte(x);
-        //     std::pair<double,double> capacity = capacity_wifi_lte(x);
-        //     double wifiCap = capacity.first;
-        //     double lteCap = capacity.second;
-        //     std::cout << "x=" << x << " m  →  Wi-Fi " << std::to_string(wifiCap) << " Mbps,  LTE " << std::to_string(lteCap) << " Mbps\n";
-
-        //     Simulator::Schedule(Seconds(i), &ModifyLinkRate, &netDevices[0], echoClient, DataRate(std::to_string(wifiCap)+"Mbps"), 0);
-        //     Simulator::Schedule(Seconds(i), &ModifyLinkRate, &netDevices[1], echoClient, DataRate(std::to_string(lteCap)+"Mbps"), 1);
-        // }
-
-        double bwMbps[2] = {1, 8};
-        for(int i = 0; i < 100; i++) {
-            bwMbps[0] = bwMbps[0] + 0.1;
-            bwMbps[1] = bwMbps[1] - 0.06;
-            Simulator::Schedule(MilliSeconds(i*100), &ModifyLinkRate, &netDevices[0], echoClient, DataRate(std::to_string(bwMbps[0])+"Mbps"), 0);
-            Simulator::Schedule(MilliSeconds(i*100), &ModifyLinkRate, &netDevices[1], echoClient, DataRate(std::to_string(bwMbps[1])+"Mbps"), 1);
+        if(ueSpeed > 0) {
+            // UE driving from the AP (0 m) towards the BS (400 m), links follow the capacity model
+            for(int i = 0; i < simTime * 10; i++) {
+                Simulator::Schedule(MilliSeconds(i*100), &UeMove, &wifiCap, &lteCap, &rateFeed, ueSpeed * i * 0.1);
+            }
+        } else {
+            double bwMbps[2] = {1, 8};
+            for(int i = 0; i < 100; i++) {
+                bwMbps[0] = bwMbps[0] + 0.1;
+                bwMbps[1] = bwMbps[1] - 0.06;
+                Simulator::Schedule(MilliSeconds(i*100), &ModifyLinkRate, &netDevices[0], echoClient, DataRate(std::to_string(bwMbps[0])+"Mbps"), 0);
+                Simulator::Schedule(MilliSeconds(i*100), &ModifyLinkRate, &netDevices[1], echoClient, DataRate(std::to_string(bwMbps[1])+"Mbps"), 1);
+            }
         }
     }
 
+    if(linkCut > 0) {
+        Simulator::Schedule(Seconds(linkCut), &CutLink, &netDevices[1], nodes, pathManager);
+    }
+
+    if(handoverPeriod > 0) {
+        NS_ABORT_MSG_IF(announceHandovers && !pathManager, "announceHandovers needs pathManager");
+        // path 0 goes through a satellite, alternately a far one and a close one
+        Time delays[2] = {Time(delay[0]), Time(handoverDelay)};
+        netDevices[0].Get(0)->GetChannel()->SetAttribute("VariableDelay", BooleanValue(true));
+        for(int i = 1; start_time + i * handoverPeriod < simTime; i++) {
+            Time at = Seconds(start_time + i * handoverPeriod);
+            Simulator::Schedule(at, &Handover, &netDevices[0], delays[i % 2]);
+            if(announceHandovers) {
+                Simulator::Schedule(at - Seconds(handoverPeriod / 2), &AnnounceHandover, nodes, at, 2 * (delays[i % 2] - delays[(i + 1) % 2]));
+            }
+        }
+    }
+
+    if(fluid) {
+        Simulator::Schedule(Seconds(start_time+0.1), &FluidTraces, n1->GetId());
+    }
+
+    std::vector<double> forkErrors;
+    if(forkAt > 0) {
+        std::stringstream ss(forkErrorRates);
+        for(std::string item; std::getline(ss, item, ','); ) {
+            forkErrors.push_back(std::stod(item));
+        }
+        NS_ABORT_MSG_IF(forkErrors.empty(), "forkAt needs forkErrorRates");
+        // setup, handshake and slow start are simulated once, then each error rate goes on in its own process
+        Simulator::Schedule(Seconds(forkAt), &FlushTraces);
+        Simulator::ForkAt(Seconds(forkAt), forkErrors.size(), MakeBoundCallback(&ErrorRateBranch, em1, &echoClient, &forkErrors), forkJobs);
+    }
 
     Simulator::Stop(simulationEndTime);
 
     std::cout << "\n\n#################### STARTING RUN ####################\n\n";
+    auto wallStart = std::chrono::steady_clock::now();
     Simulator::Run();
+    double wallClock = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    if(forkAt > 0 && Simulator::GetForkBranch() < 0) {
+        std::cout << "forked " << forkErrors.size() << " branches at " << forkAt << " s, "
+                  << Simulator::GetForkFailures() << " failed" << std::endl;
+        Simulator::Destroy();
+        return Simulator::GetForkFailures() > 0;
+    }
+    if(forkAt > 0) {
+        std::cout << "branch " << Simulator::GetForkBranch() << " errorRate " << forkErrors[Simulator::GetForkBranch()] << std::endl;
+    }
 
     //Gnuplot ...continued
     gnuplot.AddDataset(dataset);
@@ -386,6 +650,24 @@ int main (int argc, char *argv[])
     }
 
     outfile.close();
+
+    if(linkCut > 0) {
+        if(pathFailureTime > linkCutTime) {
+            std::cout << "Recovery time after link cut: " << (pathFailureTime - linkCutTime).GetMilliSeconds() << " ms" << std::endl;
+        } else {
+            std::cout << "Recovery time after link cut: no failover" << std::endl;
+        }
+    }
+    // compare these figures between a packet-level run and a run with --fluid=1,
+    // utils/sweep.py -g fluid=0,1 does it in fluid.csv
+    std::cout << "fluid " << fluid
+              << " completion_s " << (fileCompletionTime > Seconds(0) ? (fileCompletionTime - Seconds(start_time)).GetSeconds() : -1)
+              << " rx_bytes " << fileRxBytes
+              << " wallclock_s " << wallClock
+              << " fluid_windows " << fluidWindows
+              << " fluid_s " << fluidTime.GetSeconds()
+              << " fluid_bytes " << fluidBytes
+              << " fluid_fraction " << (fileRxBytes > 0 ? (double) fluidBytes / fileRxBytes : 0) << std::endl;
     // std::cout << "\n\n#################### RUN FINISHED ####################\n\n\n";
     Simulator::Destroy ();
 
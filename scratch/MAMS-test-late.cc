@@ -139,16 +139,30 @@ int main (int argc, char *argv[])
     std::vector<std::string> delay(2);
     std::vector<NetDeviceContainer> netDevices(2);
 
-    rate[0] = "10Mbps";
+    std::string dataRate0 = "10Mbps";
+    std::string delay1 = "20ms";
     rate[1] = "10Mbps";
     delay[0] = "10ms";
-    delay[1] = "20ms";
 
     double errorRate = 0.000004;
     uint8_t schAlgo = 5;
     std::string maxBuffSize = "6p";
     uint64_t fileSize = 5e6;
 
+    CommandLine cmd;
+    cmd.Usage("Simulation of bulkSend over MPQUIC.\n");
+    cmd.AddValue("isMob", "mobility scenario", isMob);
+    cmd.AddValue("errorRate", "The percentage of packets that should be lost, expressed as a double where 1 == 100%", errorRate);
+    cmd.AddValue("fileSize", "file size", fileSize);
+    cmd.AddValue("delay1", "The initial delay for path1", delay1);
+    cmd.AddValue("dataRate0", "The data rate for path 0", dataRate0);
+    cmd.AddValue("maxBuffSize", "max buffer size of router", maxBuffSize);
+    cmd.AddValue("schAlgo", "mutipath scheduler algorithm", schAlgo); // 2, mpquic-rr, 3. MAMS, 5. LATE
+    cmd.Parse (argc, argv);
+
+    rate[0] = dataRate0;
+    delay[1] = delay1;
+
     Config::SetDefault("ns3::QuicStreamBase::StreamSndBufSize",UintegerValue(50485760));
     Config::SetDefault("ns3::QuicStreamBase::StreamRcvBufSize",UintegerValue(50485760));
     Config::SetDefault("ns3::QuicSocketBase::SocketSndBufSize",UintegerValue(50485760));
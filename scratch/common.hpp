@@ -1,7 +1,10 @@
 #pragma once
 #include <cmath>
+#include <cstddef>
 #include <utility>
 #include <algorithm>
+#include <functional>
+#include <vector>
 
 struct LinkParams {
     double txPower_dBm;      // Transmit power (dBm)
@@ -15,9 +18,10 @@ struct LinkParams {
 };
 
 // ---------- helpers ----------
-constexpr double dBm_to_mW(double dBm)   { return std::pow(10.0, dBm / 10.0); }
-constexpr double mW_to_dBm(double mW)    { return 10.0 * std::log10(mW); }
-constexpr double log2p1(double x)        { return std::log2(1.0 + x); }
+// not constexpr: std::pow/log10/log2 are not constant-evaluable
+inline double dBm_to_mW(double dBm)   { return std::pow(10.0, dBm / 10.0); }
+inline double mW_to_dBm(double mW)    { return 10.0 * std::log10(mW); }
+inline double log2p1(double x)        { return std::log2(1.0 + x); }
 
 // Eq. 15 & 16 folded together
 inline double capacity_Mbps(double x_ue, const LinkParams& p)
@@ -37,17 +41,127 @@ inline double capacity_Mbps(double x_ue, const LinkParams& p)
     return cap_bps / 1e6;                                // → Mbit/s
 }
 
-// convenience wrapper to get both links in one call
-inline std::pair<double,double> capacity_wifi_lte(double x_ue)
+/**
+ * Capacity of one link as a function of the UE position, tabulated once.
+ *
+ * capacity_Mbps() only depends on the distance to the transmitter, so it is
+ * sampled every resolution_m metres over [0, coverage_m] at construction and
+ * looked up with linear interpolation afterwards: no pow/log per position
+ * update. With the default 0.1 m step the table of a 400 m cell is ~32 kB and
+ * the interpolation error stays around 0.01% of the exact formula.
+ */
+class LinkCapacityModel {
+public:
+    explicit LinkCapacityModel(const LinkParams& p, double resolution_m = 0.1)
+        : p_(p), step_(resolution_m), invStep_(1.0 / resolution_m)
+    {
+        const std::size_t n = static_cast<std::size_t>(std::ceil(p_.coverage_m * invStep_)) + 1;
+        table_.resize(n + 1);
+        for (std::size_t i = 0; i < n; i++) {
+            table_[i] = capacity_Mbps(p_.x_tx + std::min(i * step_, p_.coverage_m), p_);
+        }
+        table_[n] = table_[n - 1];                  // guard for the interpolation
+    }
+
+    // capacity at position x_ue (Mbit/s), 0 outside coverage
+    double capacity(double x_ue) const
+    {
+        const double d = std::fabs(x_ue - p_.x_tx);
+        if (d > p_.coverage_m) return 0.0;
+        const double pos = d * invStep_;
+        const std::size_t i = static_cast<std::size_t>(pos);
+        const double frac = pos - i;
+        return table_[i] + frac * (table_[i + 1] - table_[i]);
+    }
+
+    // batched lookup for many UEs: out[k] = capacity(x_ue[k])
+    void capacity(const double* x_ue, double* out, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            out[k] = capacity(x_ue[k]);
+        }
+    }
+
+    const LinkParams& params() const { return p_; }
+    double resolution() const { return step_; }
+
+private:
+    LinkParams p_;
+    double step_;
+    double invStep_;
+    std::vector<double> table_;                     // capacity (Mbit/s) every step_ metres
+};
+
+/**
+ * Forwards capacity changes to the links (e.g. PointToPointNetDevice::SetDataRate)
+ * only when they are worth a device update: the new capacity differs from
+ * the last one applied to the link by more than relThreshold of it, or the
+ * link enters or leaves coverage.
+ */
+class LinkRateFeed {
+public:
+    typedef std::function<void(std::size_t link, double cap_Mbps)> Sink;
+
+    LinkRateFeed(std::size_t nLinks, Sink sink, double relThreshold = 0.05)
+        : sink_(sink), relThreshold_(relThreshold), applied_(nLinks, -1.0), updates_(0)
+    {
+    }
+
+    // returns true if the sink was called
+    bool update(std::size_t link, double cap_Mbps)
+    {
+        const double last = applied_[link];
+        if (last >= 0.0 && (last > 0.0) == (cap_Mbps > 0.0)
+            && std::fabs(cap_Mbps - last) <= relThreshold_ * last) {
+            return false;
+        }
+        applied_[link] = cap_Mbps;
+        updates_++;
+        sink_(link, cap_Mbps);
+        return true;
+    }
+
+    // batched form: caps[k] is the capacity of link first + k
+    void update(const double* caps, std::size_t n, std::size_t first = 0)
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            update(first + k, caps[k]);
+        }
+    }
+
+    std::size_t updates() const { return updates_; }
+
+private:
+    Sink sink_;
+    double relThreshold_;
+    std::vector<double> applied_;                   // last capacity applied per link, <0 if none
+    std::size_t updates_;
+};
+
+// Wi-Fi AP at 0 m and LTE BS at 400 m along the road
+inline const LinkParams& wifi_params()
 {
     static const LinkParams wifi {
         /*tx*/20, /*bwHz*/40e4, /*eta*/0.7, /*beta*/2.2,
         /*N*/-100, /*I*/-95, /*cov*/200, /*x_tx*/0
     };
+    return wifi;
+}
+
+inline const LinkParams& lte_params()
+{
     static const LinkParams lte {
         /*tx*/43, /*bwHz*/30e4, /*eta*/0.7, /*beta*/2.8,
         /*N*/-100, /*I*/-95, /*cov*/400, /*x_tx*/400
     };
+    return lte;
+}
+
+// convenience wrapper to get both links in one call
+inline std::pair<double,double> capacity_wifi_lte(double x_ue)
+{
+    static const LinkCapacityModel wifi(wifi_params());
+    static const LinkCapacityModel lte(lte_params());
 
-    return { capacity_Mbps(x_ue, wifi), capacity_Mbps(x_ue, lte) };
+    return { wifi.capacity(x_ue), lte.capacity(x_ue) };
 }
@@ -24,12 +24,25 @@
 #include "ns3/uinteger.h"
 #include "ns3/names.h"
 #include "ns3/log.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include <sstream>
 
 
 NS_LOG_COMPONENT_DEFINE ("QuicEchoHelper");
 
 namespace ns3 {
 
+Time owd_0;
+Time owd_1;
+DataRate bw_0;
+DataRate bw_1;
+double errorRate;
+double error_p2;
+
+uint8_t m_pktScheAlgo;
+bool withMob;
+
 QuicEchoServerHelper::QuicEchoServerHelper (uint16_t port)
 {
   m_factory.SetTypeId (QuicEchoServer::GetTypeId ());
@@ -119,12 +132,23 @@ void
 QuicEchoClientHelper::SetBW0 (DataRate bw0)
 {
   bw_0 = bw0;
+  Config::Set ("/NodeList/*/$ns3::QuicL4Protocol/SocketList/*/QuicSocketBase/LinkRate0", DataRateValue (bw0));
 }
 
 void 
 QuicEchoClientHelper::SetBW1 (DataRate bw1)
 {
   bw_1 = bw1;
+  Config::Set ("/NodeList/*/$ns3::QuicL4Protocol/SocketList/*/QuicSocketBase/LinkRate1", DataRateValue (bw1));
+}
+
+void
+QuicEchoClientHelper::SetBW (Ptr<Node> node, uint8_t pathId, DataRate bw)
+{
+  NS_ASSERT_MSG (pathId < 2, "only paths 0 and 1 have a link rate");
+  std::ostringstream path;
+  path << "/NodeList/" << node->GetId () << "/$ns3::QuicL4Protocol/SocketList/*/QuicSocketBase/LinkRate" << (uint32_t) pathId;
+  Config::Set (path.str (), DataRateValue (bw));
 }
 
 void 
@@ -101,15 +101,16 @@ private:
 
   ObjectFactory m_factory; //!< Object factory.
 };
-Time owd_0;  //one-way delay of path0
-Time owd_1;
-DataRate bw_0;
-DataRate bw_1;
-double errorRate;
-double error_p2;
+// defined in quic-echo-helper.cc, so that every file including this header shares them
+extern Time owd_0;  //one-way delay of path0
+extern Time owd_1;
+extern DataRate bw_0;
+extern DataRate bw_1;
+extern double errorRate;
+extern double error_p2;
 
-uint8_t m_pktScheAlgo;
-bool withMob;
+extern uint8_t m_pktScheAlgo;
+extern bool withMob;
 
 /**
  * \ingroup quicecho
@@ -201,10 +202,37 @@ public:
 
   void SetIniRTT1 (Time rtt1);
 
+  /**
+   * Set the rate of the link of path 0 known to the MAMS schedulers.
+   *
+   * The sockets created afterwards start from this rate, and the LinkRate0
+   * attribute of the QUIC sockets of every node is updated. Call it before
+   * the simulation or from an event without context: under the
+   * multithreaded simulator, these run alone.
+   *
+   * \param bw0 the rate of the link of path 0
+   */
   void SetBW0 (DataRate bw0);
 
+  /**
+   * Set the rate of the link of path 1 known to the MAMS schedulers.
+   *
+   * \see SetBW0
+   * \param bw1 the rate of the link of path 1
+   */
   void SetBW1 (DataRate bw1);
 
+  /**
+   * Set the rate of the link of a path, as known to the QUIC sockets of a
+   * node only. This one can be called from an event in the context of the
+   * node, e.g. a rate change of one of its devices.
+   *
+   * \param node the node
+   * \param pathId the path, 0 or 1
+   * \param bw the rate of the link of the path
+   */
+  void SetBW (Ptr<Node> node, uint8_t pathId, DataRate bw);
+
   void SetER (double error_p);
   
   void SetScheAlgo (double Algo);
@@ -26,6 +26,15 @@
 
 namespace ns3 {
 
+Time owd_0_vs;
+Time owd_1_vs;
+DataRate bw_0_vs;
+DataRate bw_1_vs;
+double errorRate_vs;
+double error_p2_vs;
+uint8_t m_pktScheAlgo_vs;
+bool withMob_vs;
+
 StreamServerHelper::StreamServerHelper (uint16_t port)
 {
   m_factory.SetTypeId (StreamServer::GetTypeId ());
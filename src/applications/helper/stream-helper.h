@@ -30,15 +30,15 @@
 
 namespace ns3 {
 
-    //ywj
-  Time owd_0_vs;  //one-way delay of path0
-  Time owd_1_vs;
-  DataRate bw_0_vs;
-  DataRate bw_1_vs;
-  double errorRate_vs;
-  double error_p2_vs;
-  uint8_t m_pktScheAlgo_vs;
-  bool withMob_vs;
+    //ywj, defined in stream-helper.cc
+  extern Time owd_0_vs;  //one-way delay of path0
+  extern Time owd_1_vs;
+  extern DataRate bw_0_vs;
+  extern DataRate bw_1_vs;
+  extern double errorRate_vs;
+  extern double error_p2_vs;
+  extern uint8_t m_pktScheAlgo_vs;
+  extern bool withMob_vs;
 
 /**
  * \ingroup dashStream
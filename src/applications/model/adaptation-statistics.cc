@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "adaptation-statistics.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+SlidingHarmonicMean::SlidingHarmonicMean (uint32_t size)
+  : m_reciprocals (size, 0.0),
+    m_next (0),
+    m_count (0),
+    m_sum (0.0),
+    m_sinceResync (0)
+{
+  NS_ASSERT_MSG (size > 0, "The window needs at least one sample");
+}
+
+void
+SlidingHarmonicMean::Add (double sample)
+{
+  NS_ASSERT_MSG (sample > 0, "Harmonic mean of a non-positive sample");
+  double reciprocal = 1 / sample;
+  m_sum += reciprocal - m_reciprocals[m_next];
+  m_reciprocals[m_next] = reciprocal;
+  m_next = (m_next + 1) % m_reciprocals.size ();
+  if (m_count < m_reciprocals.size ())
+    {
+      m_count++;
+    }
+  // recompute the sum once per window so rounding errors do not pile up
+  if (++m_sinceResync == m_reciprocals.size ())
+    {
+      m_sum = 0;
+      for (uint32_t i = 0; i < m_reciprocals.size (); i++)
+        {
+          m_sum += m_reciprocals[i];
+        }
+      m_sinceResync = 0;
+    }
+}
+
+uint32_t
+SlidingHarmonicMean::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+SlidingHarmonicMean::GetMean (void) const
+{
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  return m_count / m_sum;
+}
+
+Ewma::Ewma (double weight)
+  : m_weight (weight),
+    m_value (0),
+    m_valid (false)
+{
+}
+
+void
+Ewma::Reset (double value)
+{
+  m_value = value;
+  m_valid = true;
+}
+
+double
+Ewma::Update (double sample)
+{
+  return Update (sample, m_weight);
+}
+
+double
+Ewma::Update (double sample, double weight)
+{
+  if (!m_valid)
+    {
+      Reset (sample);
+      return m_value;
+    }
+  m_value += weight * (sample - m_value);
+  return m_value;
+}
+
+double
+Ewma::Get (void) const
+{
+  return m_value;
+}
+
+bool
+Ewma::IsValid (void) const
+{
+  return m_valid;
+}
+
+TimeWindow::TimeWindow ()
+  : m_first (0)
+{
+}
+
+uint32_t
+TimeWindow::Advance (const std::vector<int64_t> &ends, int64_t start)
+{
+  while (m_first < ends.size () && ends[m_first] < start)
+    {
+      m_first++;
+    }
+  return m_first;
+}
+
+} // namespace ns3
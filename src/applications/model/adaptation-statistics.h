@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ADAPTATION_STATISTICS_H
+#define ADAPTATION_STATISTICS_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Harmonic mean of the last samples added
+ *
+ * Keeps the reciprocals of the last samples in a ring and their running
+ * sum, so adding a sample and reading the mean are O(1) whatever the
+ * length of the session.
+ */
+class SlidingHarmonicMean
+{
+public:
+  /**
+   * \param size the number of samples of the window
+   */
+  SlidingHarmonicMean (uint32_t size);
+
+  /**
+   * \brief Add a sample, dropping the oldest one if the window is full
+   * \param sample the sample, must be positive
+   */
+  void Add (double sample);
+
+  /**
+   * \return the number of samples in the window
+   */
+  uint32_t GetCount (void) const;
+
+  /**
+   * \return the harmonic mean of the samples in the window, 0 if empty
+   */
+  double GetMean (void) const;
+
+private:
+  std::vector<double> m_reciprocals; //!< reciprocals of the samples, used as a ring
+  uint32_t m_next;                   //!< slot of the next sample
+  uint32_t m_count;                  //!< number of samples in the window
+  double m_sum;                      //!< sum of m_reciprocals
+  uint32_t m_sinceResync;            //!< samples added since m_sum was recomputed
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Exponentially weighted moving average
+ *
+ * The weight of each sample is given on update, so that averages
+ * smoothing over time (weight proportional to the elapsed time) can
+ * be expressed as well as plain per-sample ones.
+ */
+class Ewma
+{
+public:
+  /**
+   * \param weight the default weight of a new sample
+   */
+  Ewma (double weight = 0.125);
+
+  /**
+   * \brief Restart the average from a value
+   * \param value the new value of the average
+   */
+  void Reset (double value);
+
+  /**
+   * \brief Add a sample with the default weight
+   * \param sample the sample
+   * \return the new value of the average
+   */
+  double Update (double sample);
+
+  /**
+   * \brief Add a sample
+   * \param sample the sample
+   * \param weight weight of the sample against the current average
+   * \return the new value of the average
+   */
+  double Update (double sample, double weight);
+
+  /**
+   * \return the current value of the average
+   */
+  double Get (void) const;
+
+  /**
+   * \return true once a first value was set
+   */
+  bool IsValid (void) const;
+
+private:
+  double m_weight; //!< default weight of a sample
+  double m_value;  //!< current value of the average
+  bool m_valid;    //!< true once a first value was set
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Start of a time window over a history of segment downloads
+ *
+ * The history is the vector of download end times kept by the client,
+ * which only grows. As the start of the window never goes back, the
+ * first download ending in it is found by moving a cursor forward,
+ * O(1) amortized per query instead of a scan of the whole history.
+ */
+class TimeWindow
+{
+public:
+  TimeWindow ();
+
+  /**
+   * \brief Move the start of the window
+   * \param ends the end times of the downloads, in increasing order
+   * \param start the start of the window, not before the previous one
+   * \return the index of the first download ending at or after start,
+   *         ends.size () if there is none
+   */
+  uint32_t Advance (const std::vector<int64_t> &ends, int64_t start);
+
+private:
+  uint32_t m_first;   //!< first download ending in the window
+};
+
+} // namespace ns3
+
+#endif /* ADAPTATION_STATISTICS_H */
@@ -33,7 +33,9 @@ FestiveAlgorithm::FestiveAlgorithm (  const videoData &videoData,
   m_delta (m_videoData.segmentDuration),
   m_alpha (12.0),
   m_highestRepIndex (videoData.averageBitrate.size () - 1),
-  m_thrptThrsh (0.85)
+  m_thrptThrsh (0.85),
+  m_thrptEstimation (20),
+  m_thrptSamples (0)
 {
   NS_LOG_INFO (this);
   m_smooth.push_back (5);  // after how many steps switch up is possible
@@ -67,31 +69,18 @@ FestiveAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
       return answer;
     }
 
-  // compute throughput estimation
-  std::vector<double> thrptEstimationTmp;
-  for (unsigned sd = m_playbackData.playbackIndex.size (); sd-- > 0; )
+  // compute throughput estimation: harmonic mean of the last 20 segment
+  // throughputs, only the downloads done since the last call are added
+  for (; m_thrptSamples < m_playbackData.playbackIndex.size (); m_thrptSamples++)
     {
-      if (m_throughput.bytesReceived.at (sd) == 0)
+      if (m_throughput.bytesReceived.at (m_thrptSamples) == 0)
         {
           continue;
         }
-      else
-        {
-          thrptEstimationTmp.push_back ((8.0 * m_throughput.bytesReceived.at (sd))
-                                        / ((double)((m_throughput.transmissionEnd.at (sd) - m_throughput.transmissionRequested.at (sd)) / 1000000.0)));
-        }
-      if (thrptEstimationTmp.size () == 20)
-        {
-          break;
-        }
-    }
-  // calculate harmonic mean of values in thrptEstimationTmp
-  double harmonicMeanDenominator = 0;
-  for (uint i = 0; i < thrptEstimationTmp.size (); i++)
-    {
-      harmonicMeanDenominator += 1 / (thrptEstimationTmp.at (i));
+      m_thrptEstimation.Add ((8.0 * m_throughput.bytesReceived.at (m_thrptSamples))
+                             / ((double)((m_throughput.transmissionEnd.at (m_thrptSamples) - m_throughput.transmissionRequested.at (m_thrptSamples)) / 1000000.0)));
     }
-  double thrptEstimation = thrptEstimationTmp.size () / harmonicMeanDenominator;
+  double thrptEstimation = m_thrptEstimation.GetMean ();
 
   // compute b_delay
   int64_t lowerBound = m_targetBuf - m_delta;
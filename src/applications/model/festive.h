@@ -20,6 +20,7 @@
 #define FESTIVE_ALGORITHM_H
 
 #include "tcp-stream-adaptation-algorithm.h"
+#include "adaptation-statistics.h"
 
 namespace ns3 {
 
@@ -44,6 +45,8 @@ private:
   const int64_t m_highestRepIndex;
   const double m_thrptThrsh;
   std::vector<int> m_smooth;
+  SlidingHarmonicMean m_thrptEstimation; //!< harmonic mean of the last segment throughputs
+  uint32_t m_thrptSamples;               //!< downloads already added to m_thrptEstimation
 };
 
 } // namespace ns3
@@ -69,7 +69,7 @@ PandaAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
   if (segmentCounter == 1)
     {
       m_lastBandwidthShare = throughputMeasured;
-      m_lastSmoothBandwidthShare = m_lastBandwidthShare;
+      m_smoothBandwidthShare.Reset (m_lastBandwidthShare);
     }
 
   double actualInterrequestTime;
@@ -90,13 +90,7 @@ PandaAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
     }
   m_lastBandwidthShare = bandwidthShare;
 
-  double smoothBandwidthShare;
-  smoothBandwidthShare = ((-m_alpha
-                           * (m_lastSmoothBandwidthShare - bandwidthShare))
-                          * actualInterrequestTime)
-    + m_lastSmoothBandwidthShare;
-
-  m_lastSmoothBandwidthShare = smoothBandwidthShare;
+  double smoothBandwidthShare = m_smoothBandwidthShare.Update (bandwidthShare, m_alpha * actualInterrequestTime);
 
   double deltaUp = m_omega + m_epsilon * smoothBandwidthShare;
   double deltaDown = m_omega;
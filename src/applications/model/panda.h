@@ -20,6 +20,7 @@
 #define PANDA_ALGORITHM_H
 
 #include "tcp-stream-adaptation-algorithm.h"
+#include "adaptation-statistics.h"
 
 namespace ns3 {
 
@@ -49,7 +50,7 @@ private:
   int64_t m_lastBuffer;
   double m_lastTargetInterrequestTime;
   double m_lastBandwidthShare;
-  double m_lastSmoothBandwidthShare;
+  Ewma m_smoothBandwidthShare;
   double m_lastVideoIndex;
 };
 
@@ -31,6 +31,7 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
 
 #include "quic-echo-server.h"
 
@@ -57,6 +58,9 @@ QuicEchoServer::GetTypeId (void)
                    MakeUintegerAccessor (&QuicEchoServer::GetStreamId,
                                          &QuicEchoServer::SetStreamId),
                    MakeUintegerChecker<uint32_t> ())
+    .AddTraceSource ("Rx", "A packet has been received",
+                     MakeTraceSourceAccessor (&QuicEchoServer::m_rxTrace),
+                     "ns3::Packet::TracedCallback")
   ;
   return tid;
 }
@@ -167,6 +171,7 @@ QuicEchoServer::HandleRead (Ptr<Socket> socket)
                        Inet6SocketAddress::ConvertFrom (from).GetPort ());
         }
 
+      m_rxTrace (packet);
       packet->RemoveAllPacketTags ();
       packet->RemoveAllByteTags ();
 
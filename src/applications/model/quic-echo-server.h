@@ -25,6 +25,7 @@
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
 #include "ns3/address.h"
+#include "ns3/traced-callback.h"
 
 namespace ns3 {
 
@@ -92,6 +93,9 @@ private:
   Address m_local; //!< local multicast address
 
   uint32_t m_streamId;
+
+  /// Callbacks for received packets
+  TracedCallback<Ptr<const Packet> > m_rxTrace;
 };
 
 } // namespace ns3
@@ -26,6 +26,7 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "stream-client.h"
 #include "stream-utils.h"
@@ -215,6 +216,11 @@ StreamClient::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&StreamClient::m_clientId),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("PerSegmentThroughputLog",
+                   "Log the throughput once per received segment instead of once per received packet",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&StreamClient::m_perSegmentThroughputLog),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -233,6 +239,7 @@ StreamClient::StreamClient ()
   m_bytesReceived = 0;
   m_segmentsInBuffer = 0;
   m_bufferUnderrun = false;
+  m_bufferUnderrunStart = 0;
   m_currentPlaybackIndex = 0;
 
 }
@@ -346,23 +353,17 @@ StreamClient::HandleRead (Ptr<Socket> socket)
       NS_LOG_LOGIC ("Client received packet containing " << packetSize << " bytes. " << remainingBytesInSegment << " more bytes in segment.");
 
       // Validate that the data we got is for the correct segment.
-      uint8_t* packetBuff = new uint8_t [packetSize];
-      auto bytesCopied = packet->CopyData(packetBuff, packetSize);
-      NS_ASSERT_MSG(bytesCopied == packetSize, "Packet data size does not match reported packet size");
       uint8_t expectedSegmentByte = static_cast<uint8_t>(m_segmentCounter);
-      uint32_t badCount {0};
       NS_LOG_LOGIC("Checking data chunk for segment has filler value " << (int) expectedSegmentByte);
-      for (uint i = 0; i < packetSize; ++i) {
-          auto b = packetBuff[i];
-          if (b != expectedSegmentByte) {
-            ++badCount;
-            NS_LOG_ERROR("Bad filler value for segment data. Expected " << std::to_string (m_segmentCounter) << ". Received " + std::to_string((int)b));
-          }
+      uint32_t goodCount = packet->CountByte (expectedSegmentByte);
+      if (goodCount != packetSize) {
+          NS_LOG_ERROR("Bad filler value for segment data. Expected " << std::to_string (m_segmentCounter) << " in " << packetSize - goodCount << " bytes");
       }
 
-      uint32_t goodCount = packetSize - badCount;
-
-      LogThroughput (goodCount);
+      if (!m_perSegmentThroughputLog)
+        {
+          LogThroughput (goodCount);
+        }
       m_bytesReceived += goodCount;
       auto currentSegmentSize = m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter);
       if (m_bytesReceived == currentSegmentSize)
@@ -433,6 +434,11 @@ StreamClient::SegmentReceivedHandle ()
 
   LogBuffer ();
 
+  if (m_perSegmentThroughputLog)
+    {
+      LogThroughput (m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter));
+    }
+
   m_segmentsInBuffer++;
   m_bytesReceived = 0;
   if (m_segmentCounter == m_lastSegmentIndex)
@@ -455,8 +461,7 @@ StreamClient::PlaybackHandle ()
     {
       NS_LOG_LOGIC("Buffer under-run when trying to play segment " << m_segmentCounter);
       m_bufferUnderrun = true;
-      bufferUnderrunLog << std::setfill (' ') << std::setw (26) << timeNow / (double)1000000 << " ";
-      bufferUnderrunLog.flush ();
+      m_bufferUnderrunStart = timeNow;
       return true;
     }
   else if (m_segmentsInBuffer > 0)
@@ -465,8 +470,9 @@ StreamClient::PlaybackHandle ()
         {
           NS_LOG_LOGIC("Recovered from buffer under-run when trying to play segment " << m_segmentCounter);
           m_bufferUnderrun = false;
-          bufferUnderrunLog << std::setfill (' ') << std::setw (13) << timeNow / (double)1000000 << "\n";
-          bufferUnderrunLog.flush ();
+          // the row is written at once, the rows of the other clients go to the same file
+          bufferUnderrunLog->Record (m_clientId) << std::setfill (' ') << std::setw (26) << m_bufferUnderrunStart / (double)1000000 << " "
+                                                 << std::setfill (' ') << std::setw (13) << timeNow / (double)1000000 << "\n";
         }
       m_playbackData.playbackStart.push_back (timeNow);
       LogPlayback ();
@@ -506,6 +512,18 @@ void
 StreamClient::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_bufferUnderrun && bufferUnderrunLog != 0)
+    {
+      // still stalled at the end of the simulation
+      bufferUnderrunLog->Record (m_clientId) << std::setfill (' ') << std::setw (26) << m_bufferUnderrunStart / (double)1000000 << " "
+                                             << std::setfill (' ') << std::setw (13) << "-" << "\n";
+    }
+  adaptationLog = 0;
+  downloadLog = 0;
+  playbackLog = 0;
+  bufferLog = 0;
+  throughputLog = 0;
+  bufferUnderrunLog = 0;
   Application::DoDispose ();
 }
 
@@ -553,12 +571,6 @@ StreamClient::StopApplication ()
       m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
       m_socket = 0;
     }
-  downloadLog.close ();
-  playbackLog.close ();
-  adaptationLog.close ();
-  bufferLog.close ();
-  throughputLog.close ();
-  bufferUnderrunLog.close ();
 }
 
 
@@ -600,95 +612,73 @@ void
 StreamClient::LogThroughput (uint32_t packetSize)
 {
   NS_LOG_FUNCTION (this);
-  throughputLog << std::setfill (' ') << std::setw (13) << Simulator::Now ().GetMicroSeconds ()  / (double) 1000000 << " "
-                << std::setfill (' ') << std::setw (13) << packetSize << "\n";
-  throughputLog.flush ();
+  throughputLog->Record (m_clientId) << std::setfill (' ') << std::setw (13) << Simulator::Now ().GetMicroSeconds ()  / (double) 1000000 << " "
+                                     << std::setfill (' ') << std::setw (13) << packetSize << "\n";
 }
 
 void
 StreamClient::LogDownload ()
 {
   NS_LOG_FUNCTION (this);
-  downloadLog << std::setfill (' ') << std::setw (13) << m_segmentCounter << " "
-              << std::setfill (' ') << std::setw (21) << m_downloadRequestSent / (double)1000000 << " "
-              << std::setfill (' ') << std::setw (14) << m_transmissionStartReceivingSegment / (double)1000000 << " "
-              << std::setfill (' ') << std::setw (12) << m_transmissionEndReceivingSegment / (double)1000000 << " "
-              << std::setfill (' ') << std::setw (12) << m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter) << " "
-              << std::setfill (' ') << std::setw (12) << "Y\n";
-  downloadLog.flush ();
+  downloadLog->Record (m_clientId) << std::setfill (' ') << std::setw (13) << m_segmentCounter << " "
+                                   << std::setfill (' ') << std::setw (21) << m_downloadRequestSent / (double)1000000 << " "
+                                   << std::setfill (' ') << std::setw (14) << m_transmissionStartReceivingSegment / (double)1000000 << " "
+                                   << std::setfill (' ') << std::setw (12) << m_transmissionEndReceivingSegment / (double)1000000 << " "
+                                   << std::setfill (' ') << std::setw (12) << m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter) << " "
+                                   << std::setfill (' ') << std::setw (12) << "Y\n";
 }
 
 void
 StreamClient::LogBuffer ()
 {
   NS_LOG_FUNCTION (this);
-  bufferLog << std::setfill (' ') << std::setw (13) << m_transmissionEndReceivingSegment / (double)1000000 << " "
-            << std::setfill (' ') << std::setw (13) << m_bufferData.bufferLevelOld.back () / (double)1000000 << "\n"
-            << std::setfill (' ') << std::setw (13) << m_transmissionEndReceivingSegment / (double)1000000 << " "
-            << std::setfill (' ') << std::setw (13) << m_bufferData.bufferLevelNew.back () / (double)1000000 << "\n";
-  bufferLog.flush ();
+  bufferLog->Record (m_clientId) << std::setfill (' ') << std::setw (13) << m_transmissionEndReceivingSegment / (double)1000000 << " "
+                                 << std::setfill (' ') << std::setw (13) << m_bufferData.bufferLevelOld.back () / (double)1000000 << "\n";
+  bufferLog->Record (m_clientId) << std::setfill (' ') << std::setw (13) << m_transmissionEndReceivingSegment / (double)1000000 << " "
+                                 << std::setfill (' ') << std::setw (13) << m_bufferData.bufferLevelNew.back () / (double)1000000 << "\n";
 }
 
 void
 StreamClient::LogAdaptation (algorithmReply answer)
 {
   NS_LOG_FUNCTION (this << m_currentRepIndex);
-  adaptationLog << std::setfill (' ') << std::setw (13) << m_segmentCounter << " "
-                << std::setfill (' ') << std::setw (9) << m_currentRepIndex << " "
-                << std::setfill (' ') << std::setw (22) << answer.decisionTime / (double)1000000 << " "
-                << std::setfill (' ') << std::setw (4) << answer.decisionCase << " "
-                << std::setfill (' ') << std::setw (9) << answer.delayDecisionCase << "\n";
-  adaptationLog.flush ();
+  adaptationLog->Record (m_clientId) << std::setfill (' ') << std::setw (13) << m_segmentCounter << " "
+                                     << std::setfill (' ') << std::setw (9) << m_currentRepIndex << " "
+                                     << std::setfill (' ') << std::setw (22) << answer.decisionTime / (double)1000000 << " "
+                                     << std::setfill (' ') << std::setw (4) << answer.decisionCase << " "
+                                     << std::setfill (' ') << std::setw (9) << answer.delayDecisionCase << "\n";
 }
 
 void
 StreamClient::LogPlayback ()
 {
   NS_LOG_FUNCTION (this);
-  playbackLog << std::setfill (' ') << std::setw (13) << m_currentPlaybackIndex << " "
-              << std::setfill (' ') << std::setw (14) << Simulator::Now ().GetMicroSeconds ()  / (double)1000000 << " "
-              << std::setfill (' ') << std::setw (13) << m_playbackData.playbackIndex.at (m_currentPlaybackIndex) << "\n";
-  playbackLog.flush ();
+  playbackLog->Record (m_clientId) << std::setfill (' ') << std::setw (13) << m_currentPlaybackIndex << " "
+                                   << std::setfill (' ') << std::setw (14) << Simulator::Now ().GetMicroSeconds ()  / (double)1000000 << " "
+                                   << std::setfill (' ') << std::setw (13) << m_playbackData.playbackIndex.at (m_currentPlaybackIndex) << "\n";
 }
 
 std::string 
 StreamClient::LogFileName(const std::string& simId, const std::string& clientId, const std::string& logSuffix) {
-  return dashLogDirectory + m_algoName + "/" "cl" + clientId + "_"  + logSuffix + ".txt";
+  return dashLogDirectory + m_algoName + "/" "sim" + simId + "_"  + logSuffix + ".txt";
 }
 
 void
 StreamClient::InitializeLogFiles (std::string simulationId, std::string clientId, std::string numberOfClients)
 {
   NS_LOG_FUNCTION (this);
-  std::string dLog = LogFileName(simulationId, clientId, "downloadLog");
-  downloadLog.open (dLog.c_str ());
-  downloadLog << "Segment_Index Download_Request_Sent Download_Start Download_End Segment_Size Download_OK\n";
-  downloadLog.flush ();
-
-  std::string pLog = LogFileName(simulationId, clientId, "playbackLog");
-  playbackLog.open (pLog.c_str ());
-  playbackLog << "Segment_Index Playback_Start Quality_Level\n";
-  playbackLog.flush ();
-
-  std::string aLog = LogFileName(simulationId, clientId, "adaptationLog");
-  adaptationLog.open (aLog.c_str ());
-  adaptationLog << "Segment_Index Rep_Level Decision_Point_Of_Time Case DelayCase\n";
-  adaptationLog.flush ();
-
-  std::string bLog = LogFileName(simulationId, clientId, "bufferLog");
-  bufferLog.open (bLog.c_str ());
-  bufferLog << "     Time_Now  Buffer_Level \n";
-  bufferLog.flush ();
-
-  std::string tLog = LogFileName(simulationId, clientId, "throughputLog");
-  throughputLog.open (tLog.c_str ());
-  throughputLog << "     Time_Now Bytes Received \n";
-  throughputLog.flush ();
-
-  std::string buLog = LogFileName(simulationId, clientId, "bufferUnderrunLog");
-  bufferUnderrunLog.open (buLog.c_str ());
-  bufferUnderrunLog << ("Buffer_Underrun_Started_At         Until \n");
-  bufferUnderrunLog.flush ();
+  downloadLog = StreamLogWriter::Get (LogFileName (simulationId, clientId, "downloadLog"),
+                                      "Segment_Index Download_Request_Sent Download_Start Download_End Segment_Size Download_OK");
+  playbackLog = StreamLogWriter::Get (LogFileName (simulationId, clientId, "playbackLog"),
+                                      "Segment_Index Playback_Start Quality_Level");
+  adaptationLog = StreamLogWriter::Get (LogFileName (simulationId, clientId, "adaptationLog"),
+                                        "Segment_Index Rep_Level Decision_Point_Of_Time Case DelayCase");
+  bufferLog = StreamLogWriter::Get (LogFileName (simulationId, clientId, "bufferLog"),
+                                    "     Time_Now  Buffer_Level");
+  throughputLog = StreamLogWriter::Get (LogFileName (simulationId, clientId, "throughputLog"),
+                                        "     Time_Now Bytes Received");
+  bufferUnderrunLog = StreamLogWriter::Get (LogFileName (simulationId, clientId, "bufferUnderrunLog"),
+                                            "Buffer_Underrun_Started_At         Until");
 }
 
 } // Namespace ns3
@@ -26,6 +26,7 @@
 #include "ns3/traced-callback.h"
 #include <iostream>
 #include <fstream>
+#include "stream-log-writer.h"
 #include "tcp-stream-adaptation-algorithm.h"
 #include "tcp-stream-interface.h"
 #include "tobasco2.h"
@@ -283,8 +284,10 @@ private:
   /*
    * \brief Log throughput information about single arriving packets
    *
-   * - arrival time of packet
-   * - size of packet
+   * With PerSegmentThroughputLog set, it is called once per segment instead.
+   *
+   * - arrival time of packet (of the last packet of the segment)
+   * - size of packet (of the segment)
    */
   void LogThroughput (uint32_t packetSize);
 
@@ -308,15 +311,16 @@ private:
   void LogAdaptation (algorithmReply answer);
 
   /*
-   * \brief Open log output files with streams.
+   * \brief Get the shared log files of the simulation.
    *
-   * The output streams defined in StreamClient are opened,
-   * and log files containing the used adaptation algorithm are created for output.
+   * The log files of the adaptation algorithm used are shared by all the clients
+   * of the simulation which use it, one file per metric with a row per record,
+   * and are created by the first client getting them.
    */
   void InitializeLogFiles (std::string simulationId, std::string clientId, std::string numberOfClients);
 
   /*
-   * \brief Get a file path for the given logging task
+   * \brief Get a file path for the given logging task, shared by all the clients of the simulation
    */
   std::string LogFileName(const std::string& simId, const std::string& clientId, const std::string& logSuffix);
 
@@ -352,12 +356,14 @@ private:
   int64_t m_highestRepIndex; //!< This is the index of the highest representation
 
   // QoS logs and logging data
-  std::ofstream adaptationLog; //!< Output stream for logging adaptation information
-  std::ofstream downloadLog; //!< Output stream for logging download information
-  std::ofstream playbackLog; //!< Output stream for logging playback information
-  std::ofstream bufferLog; //!< Output stream for logging buffer course
-  std::ofstream throughputLog; //!< Output stream for logging throughput information
-  std::ofstream bufferUnderrunLog; //!< Output stream for logging starting and ending of buffer underruns
+  Ptr<StreamLogWriter> adaptationLog; //!< Shared log of adaptation information
+  Ptr<StreamLogWriter> downloadLog; //!< Shared log of download information
+  Ptr<StreamLogWriter> playbackLog; //!< Shared log of playback information
+  Ptr<StreamLogWriter> bufferLog; //!< Shared log of buffer course
+  Ptr<StreamLogWriter> throughputLog; //!< Shared log of throughput information
+  Ptr<StreamLogWriter> bufferUnderrunLog; //!< Shared log of starting and ending of buffer underruns
+  bool m_perSegmentThroughputLog; //!< Log the throughput once per segment instead of once per packet
+  int64_t m_bufferUnderrunStart; //!< The point in time in microseconds when the current buffer underrun started
 
   uint64_t m_downloadRequestSent; //!< Logging the point in time in microseconds when a download request was sent to the server
 
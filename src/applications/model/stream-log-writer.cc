@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "stream-log-writer.h"
+#include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include <iomanip>
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("StreamLogWriter");
+
+/**
+ * \ingroup dashStream
+ * \brief Bytes of rows buffered by a StreamLogWriter before they are written
+ */
+static GlobalValue g_streamLogBufferSize ("StreamLogBufferSize",
+                                          "Bytes of rows buffered by a streaming log file before they are written to it",
+                                          UintegerValue (1 << 20),
+                                          MakeUintegerChecker<uint32_t> ());
+
+/**
+ * \return the open writers, by file name
+ */
+static std::map<std::string, StreamLogWriter *> &
+GetWriters (void)
+{
+  static std::map<std::string, StreamLogWriter *> writers;
+  return writers;
+}
+
+Ptr<StreamLogWriter>
+StreamLogWriter::Get (const std::string &fileName, const std::string &columns)
+{
+  NS_LOG_FUNCTION (fileName);
+  std::map<std::string, StreamLogWriter *> &writers = GetWriters ();
+  std::map<std::string, StreamLogWriter *>::iterator it = writers.find (fileName);
+  if (it != writers.end ())
+    {
+      return Ptr<StreamLogWriter> (it->second);
+    }
+  if (writers.empty ())
+    {
+      Simulator::ScheduleDestroy (&StreamLogWriter::FlushAll);
+    }
+  // the registry does not own the writer: the clients do
+  StreamLogWriter *writer = new StreamLogWriter (fileName, columns);
+  writers[fileName] = writer;
+  return Ptr<StreamLogWriter> (writer, false);
+}
+
+void
+StreamLogWriter::FlushAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::map<std::string, StreamLogWriter *> &writers = GetWriters ();
+  for (std::map<std::string, StreamLogWriter *>::iterator it = writers.begin (); it != writers.end (); ++it)
+    {
+      it->second->Flush ();
+    }
+}
+
+StreamLogWriter::StreamLogWriter (const std::string &fileName, const std::string &columns)
+  : m_fileName (fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  UintegerValue bufferSize;
+  g_streamLogBufferSize.GetValue (bufferSize);
+  m_bufferSize = bufferSize.Get ();
+
+  m_file.open (fileName.c_str ());
+  if (!m_file)
+    {
+      NS_LOG_ERROR ("Cannot open log file " << fileName);
+    }
+  m_file << "Client_Id " << columns << "\n";
+}
+
+StreamLogWriter::~StreamLogWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_file.close ();
+  GetWriters ().erase (m_fileName);
+}
+
+std::ostream &
+StreamLogWriter::Record (uint32_t clientId)
+{
+  if (m_rows.tellp () >= static_cast<std::streamoff> (m_bufferSize))
+    {
+      Flush ();
+    }
+  m_rows << std::setfill (' ') << std::setw (9) << clientId << " ";
+  return m_rows;
+}
+
+void
+StreamLogWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::string rows = m_rows.str ();
+  if (rows.empty ())
+    {
+      return;
+    }
+  m_file.write (rows.data (), rows.size ());
+  m_file.flush ();
+  m_rows.str (std::string ());
+}
+
+} // namespace ns3
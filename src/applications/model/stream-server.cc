@@ -28,6 +28,7 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "stream-server.h"
 #include "ns3/global-value.h"
 #include <ns3/core-module.h>
@@ -58,11 +59,19 @@ StreamServer::GetTypeId (void)
                    StringValue ("QUIC"),
                    MakeStringAccessor (&StreamServer::m_protocolName),
                    MakeStringChecker ())
+    .AddAttribute ("TimeHandlers",
+                   "Measure the time spent in the handlers of the client sockets",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&StreamServer::m_timeHandlers),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 StreamServer::StreamServer ()
+  : m_timeHandlers (false),
+    m_inHandler (false),
+    m_handlerTime (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -81,6 +90,32 @@ StreamServer::DoDispose (void)
   Application::DoDispose ();
 }
 
+double
+StreamServer::GetHandlerTime (void) const
+{
+  return std::chrono::duration<double> (m_handlerTime).count ();
+}
+
+StreamServer::HandlerTimer::HandlerTimer (StreamServer *server)
+  : m_server (server),
+    m_outer (server->m_timeHandlers && !server->m_inHandler)
+{
+  if (m_outer)
+    {
+      m_server->m_inHandler = true;
+      m_start = std::chrono::steady_clock::now ();
+    }
+}
+
+StreamServer::HandlerTimer::~HandlerTimer ()
+{
+  if (m_outer)
+    {
+      m_server->m_handlerTime += std::chrono::steady_clock::now () - m_start;
+      m_server->m_inHandler = false;
+    }
+}
+
 void
 StreamServer::StartApplication (void)
 {
@@ -107,12 +142,10 @@ StreamServer::StartApplication (void)
       m_socket->Listen ();
     } */
 
-  // Accept connection requests from remote hosts.
+  // Accept connection requests from remote hosts. The close callbacks are
+  // set on every accepted socket, with the state of its client.
   m_socket->SetAcceptCallback (MakeCallback (&StreamServer::HandleConnectionRequest, this),
                                MakeCallback (&StreamServer::HandleAccept, this));
-  m_socket->SetCloseCallbacks (
-    MakeCallback (&StreamServer::HandlePeerClose, this),
-    MakeCallback (&StreamServer::HandlePeerError, this));
 }
 
 void
@@ -133,70 +166,55 @@ StreamServer::StopApplication ()
 }
 
 void
-StreamServer::HandleRead (Ptr<Socket> socket)
+StreamServer::HandleRead (callbackData *client, Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
-  Ptr<Packet> packet;
-  // ywj: In order to support dash over multipath QUIC, we have to obtain remote address through our newly defined function GetRemoteAddr,
-  // because currently, the code structure of MPQUIC is one quic-socket bond with two udp sockets. The variable socket here stands for quic socket 
-  // instead of udp socket, so after two udp sockets are associated with this quic socket, quic socket has no clue which udp socket the data comes from
-  Address from = socket->GetRemoteAddr();
-  packet = socket->RecvFrom (from);
-  // RecvFrom would messy the value of from again, so we should use GetRemoteAddr to get it back correct
-  from = socket->GetRemoteAddr();
+  HandlerTimer timer (this);
+  // The state of the client is bound to the socket: with multipath QUIC, the remote
+  // address of the QUIC socket depends on the UDP subflow the data came from.
+  Ptr<Packet> packet = socket->Recv ();
   int64_t packetSizeToReturn = GetCommand (packet);
 
-  NS_LOG_INFO("Server received request for segment " << m_callbackData [from].currentSegmentIndex << " of size " << packetSizeToReturn 
-              << " from address: "<< InetSocketAddress::ConvertFrom (from).GetIpv4());
-  std::cout<<"StreamServer::HandleRead "<<"Server received request for segment " << m_callbackData [from].currentSegmentIndex << " of size " << packetSizeToReturn 
-  << " from address: "<< InetSocketAddress::ConvertFrom (from).GetIpv4()<<std::endl;
+  NS_LOG_INFO("Server received request for segment " << client->currentSegmentIndex << " of size " << packetSizeToReturn 
+              << " from address: "<< InetSocketAddress::ConvertFrom (client->peer).GetIpv4());
 
-  if (m_callbackData [from].send || m_callbackData [from].currentTxBytes > 0) {
-    NS_ABORT_MSG("Server received request from " << from << " before previous one was completed");
+  if (client->send || client->currentTxBytes > 0) {
+    NS_ABORT_MSG("Server received request from " << client->peer << " before previous one was completed");
   }
 
-  // these values will be accessible by the clients Address from.
-  m_callbackData [from].currentTxBytes = 0;
-  m_callbackData [from].packetSizeToReturn = packetSizeToReturn;
-  m_callbackData [from].send = true;
+  client->currentTxBytes = 0;
+  client->packetSizeToReturn = packetSizeToReturn;
+  client->send = true;
 
   // Manually invoke the send callback. The callback will repeatedly be 
   // called by the socket as Tx space opens up following this call. 
-  HandleSend (socket, socket->GetTxAvailable ());
+  HandleSend (client, socket, socket->GetTxAvailable ());
 }
 
 
 void
-StreamServer::HandleSend (Ptr<Socket> socket, uint32_t txSpace)
+StreamServer::HandleSend (callbackData *client, Ptr<Socket> socket, uint32_t txSpace)
 {
   NS_LOG_FUNCTION (this << socket << txSpace);
+  HandlerTimer timer (this);
 
   // TODO try checking against the stream buffer available space too
-  // Address from;
-  // socket->GetPeerName (from);
-
-  //ywj: obtain remote address
-  Address from = socket->GetRemoteAddr();
-
-
-    // std::cout<<"StreamServer::HandleSend "<<" from address: "<< InetSocketAddress::ConvertFrom (from).GetIpv4()<<std::endl;
-  // look up values for the connected client and whose values are stored in from
-  if (m_callbackData [from].currentTxBytes > m_callbackData [from].packetSizeToReturn) {
+  if (client->currentTxBytes > client->packetSizeToReturn) {
     NS_ABORT_MSG("Server has sent more data than required for the current segment.");
   } 
-  else if (! m_callbackData [from].send) 
+  else if (! client->send) 
     {
-      NS_ASSERT( m_callbackData [from].currentTxBytes == 0 );
-      NS_LOG_LOGIC("Nothing to send. Current segment (" << (int)(m_callbackData [from].currentSegmentIndex) - 1 << ") marked as complete.");
+      NS_ASSERT( client->currentTxBytes == 0 );
+      NS_LOG_LOGIC("Nothing to send. Current segment (" << (int)(client->currentSegmentIndex) - 1 << ") marked as complete.");
     }
-  else if (m_callbackData [from].currentTxBytes == m_callbackData [from].packetSizeToReturn)
+  else if (client->currentTxBytes == client->packetSizeToReturn)
     {
-      NS_LOG_INFO("Marking current segment (" << (int)(m_callbackData [from].currentSegmentIndex) << ") as completed in server.");
+      NS_LOG_INFO("Marking current segment (" << (int)(client->currentSegmentIndex) << ") as completed in server.");
 
-      m_callbackData [from].currentTxBytes = 0;
-      m_callbackData [from].packetSizeToReturn = 0;
-      m_callbackData [from].send = false;
-      m_callbackData [from].currentSegmentIndex++;
+      client->currentTxBytes = 0;
+      client->packetSizeToReturn = 0;
+      client->send = false;
+      client->currentSegmentIndex++;
 
       return;
     }
@@ -206,18 +224,15 @@ StreamServer::HandleSend (Ptr<Socket> socket, uint32_t txSpace)
       // TODO it looks like QUIC's available() query only looks at the socket buffer, 
       //      but if the stream buffer cannot accomodate the new bytes, we won't be able to send
       //      the number of bytes which it claims to be available.
-      long toSend;
-      uint32_t remainingSegmentBytes = m_callbackData [from].packetSizeToReturn - m_callbackData [from].currentTxBytes;
-      toSend = std::min (txSpace, remainingSegmentBytes);
+      uint32_t remainingSegmentBytes = client->packetSizeToReturn - client->currentTxBytes;
+      uint32_t toSend = std::min (txSpace, remainingSegmentBytes);
 
       // Fill the packet with the current segment number so we can easily see
       // what is happening in Wireshark.
-      uint8_t* packetData = new uint8_t [toSend];
-      uint8_t currentSegmentBytesFiller = (uint8_t)(m_callbackData [from].currentSegmentIndex);
-      std::fill(packetData, packetData + toSend, currentSegmentBytesFiller);
-      Ptr<Packet> packet = Create<Packet> (packetData, toSend);
+      // The payload is not allocated, only its fill byte is stored.
+      uint8_t currentSegmentBytesFiller = (uint8_t)(client->currentSegmentIndex);
+      Ptr<Packet> packet = Create<Packet> (toSend, currentSegmentBytesFiller);
 
-      NS_ASSERT (packet->GetSize() == toSend);
       NS_LOG_LOGIC("Server attempting to send " << toSend << " bytes. Tx space is " << txSpace);
 
       int amountSent {0};
@@ -231,7 +246,7 @@ StreamServer::HandleSend (Ptr<Socket> socket, uint32_t txSpace)
       if (amountSent > 0)
         {
           NS_LOG_INFO("Server sent " << amountSent << " bytes");
-          m_callbackData [from].currentTxBytes += amountSent;
+          client->currentTxBytes += amountSent;
         }
       else
         {
@@ -251,36 +266,39 @@ void
 StreamServer::HandleAccept (Ptr<Socket> s, const Address& from)
 {
   NS_LOG_FUNCTION (this << s << from);
-  callbackData cbd;
+  HandlerTimer timer (this);
+  callbackData &cbd = m_callbackData [PeekPointer (s)];
   cbd.currentTxBytes = 0;
   cbd.packetSizeToReturn = 0;
   cbd.send = false;
   cbd.currentSegmentIndex = 0;
-  m_callbackData [from] = cbd;
-  m_connectedClients.push_back (from);
-  s->SetRecvCallback ( MakeCallback (&StreamServer::HandleRead, this));
-  s->SetSendCallback ( MakeCallback (&StreamServer::HandleSend, this));
+  cbd.peer = from;
+  s->SetRecvCallback (MakeCallback (&StreamServer::HandleRead, this).Bind (&cbd));
+  s->SetSendCallback (MakeCallback (&StreamServer::HandleSend, this).Bind (&cbd));
+  // The close callbacks may fire after the state of the client is erased:
+  // they look it up by socket instead.
+  s->SetCloseCallbacks (MakeCallback (&StreamServer::HandlePeerClose, this),
+                        MakeCallback (&StreamServer::HandlePeerError, this));
 }
 
 void
 StreamServer::HandlePeerClose (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
-  Address from;
-  socket->GetPeerName (from);
-  for (std::vector<Address>::iterator it = m_connectedClients.begin (); it != m_connectedClients.end (); ++it)
+  HandlerTimer timer (this);
+  std::unordered_map<Socket *, callbackData>::iterator it = m_callbackData.find (PeekPointer (socket));
+  if (it == m_callbackData.end ())
     {
-      if (*it == from)
-        {
-          m_connectedClients.erase (it);
-          // No more clients left in m_connectedClients, simulation is done.
-          if (m_connectedClients.size () == 0)
-            {
-              NS_LOG_INFO("No remaining client connections. Stopping simulator.");
-              Simulator::Stop ();
-            }
-          return;
-        }
+      return;
+    }
+  socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+  socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t > ());
+  m_callbackData.erase (it);
+  // No more clients left in m_callbackData, simulation is done.
+  if (m_callbackData.size () == 0)
+    {
+      NS_LOG_INFO("No remaining client connections. Stopping simulator.");
+      Simulator::Stop ();
     }
 }
 
@@ -302,13 +320,10 @@ StreamServer::GetCommand (Ptr<Packet> packet)
 {
   NS_LOG_FUNCTION(this << packet);
   int64_t packetSizeToReturn;
-  uint8_t *buffer = new uint8_t [packet->GetSize ()];
-  packet->CopyData (buffer, packet->GetSize ());
-  std::stringstream ss;
-  ss << buffer;
-  std::string str;
-  ss >> str;
-  std::stringstream convert (str);
+  // the request is a NUL-terminated decimal string
+  std::vector<char> buffer (packet->GetSize () + 1, '\0');
+  packet->CopyData (reinterpret_cast<uint8_t *> (buffer.data ()), packet->GetSize ());
+  std::stringstream convert (buffer.data ());
   convert >> packetSizeToReturn;
   return packetSizeToReturn;
 }
@@ -24,7 +24,8 @@
 #include "ns3/ptr.h"
 #include "ns3/address.h"
 #include "ns3/traced-callback.h"
-#include <map>
+#include <unordered_map>
+#include <chrono>
 #include "ns3/random-variable-stream.h"
 #include "ns3/quic-socket-base.h"
 
@@ -51,6 +52,7 @@ struct callbackData
   uint32_t currentTxBytes;//!< already sent bytes for this particular segment, set to 0 if sent bytes == packetSizeToReturn, so transmission for this segment is over
   uint32_t packetSizeToReturn;//!< total amount of bytes that have to be returned to the client
   bool send;//!< true as long as there are still bytes left to be sent for the current segment
+  Address peer;//!< address of the client when it connected, for logging purposes
 };
 
 /**
@@ -72,6 +74,16 @@ public:
   StreamServer ();
   virtual ~StreamServer ();
 
+  /**
+   * \brief Get the time spent in the handlers of the client sockets
+   *
+   * This is the wall-clock time of the accept, receive, send and close
+   * callbacks, including the transmissions they trigger down the stack of
+   * the server. It is only measured with the TimeHandlers attribute set.
+   *
+   * \return the time spent in the handlers, in seconds
+   */
+  double GetHandlerTime (void) const;
 
 
 protected:
@@ -89,9 +101,10 @@ private:
    * contains a string composed of an int with
    * value n, then n bytes will be sent back to the sender.
    *
+   * \param client the state of the client connected to socket.
    * \param socket the socket the packet was received to.
    */
-  void HandleRead (Ptr<Socket> socket);
+  void HandleRead (callbackData *client, Ptr<Socket> socket);
 
   /**
    * \brief send packetSizeToReturn bytes to the client connected to socket.
@@ -102,24 +115,29 @@ private:
    * are written into the buffer. This function will get called again through the SendCallback when
    * space in the buffer has freed up.
    * The amount of sent bytes for this particular segment and for the client connected with
-   * this socket is stored in m_callbackData [from].currentTxBytes, so the server can access the already sent bytes
-   * through the value of from, which is provided by socket, because there is a socket instance for every connected client.
-   * m_callbackData [from].send indicates for the client with address from that the server has not yet sent
-   * m_callbackData [from].packetSizeToReturn bytes. When the number of bytes should be sent is
-   * reached, m_callbackData [from].send will be set to false and the server stops sending
-   * bytes to the client until he requests another segment.
+   * this socket is stored in client->currentTxBytes. The state of the client is bound to the
+   * callbacks of its socket when the connection is accepted, as there is a socket instance for
+   * every connected client, so no lookup is needed.
+   * client->send indicates that the server has not yet sent client->packetSizeToReturn bytes.
+   * When the number of bytes should be sent is reached, client->send will be set to false and
+   * the server stops sending bytes to the client until he requests another segment.
    *
+   * \param client the state of the client connected to socket.
    * \param socket the socket the request for a segment was received to and where the server will send packetSizeToReturn bytes to.
    * \param txSpace the available space in the Tx buffer
    */
-  void HandleSend (Ptr<Socket> socket, uint32_t txSpace);
+  void HandleSend (callbackData *client, Ptr<Socket> socket, uint32_t txSpace);
 
   /**
-   * \brief Set callback functions for receive and send.
-   * Add the newly connected client to m_connectedClients and allocate callbackData structure for this client.
+   * \brief Set callback functions for receive, send and close.
+   * Allocate the callbackData structure of the newly connected client and bind it to the callbacks of its socket.
    */
   void HandleAccept (Ptr<Socket> s, const Address& from);
 
+  /**
+   * \brief Forget a client whose connection was closed, stop the simulation after the last one.
+   * \param socket the socket of the client.
+   */
   void HandlePeerClose (Ptr<Socket> socket);
   void HandlePeerError (Ptr<Socket> socket);
 
@@ -138,12 +156,34 @@ private:
    */
   int64_t GetCommand (Ptr<Packet> packet);
 
+  /**
+   * \brief Measures the outermost handler running, if TimeHandlers is set
+   */
+  class HandlerTimer
+  {
+  public:
+    /**
+     * \brief Start measuring, unless a handler is already measured
+     * \param server the server running the handler
+     */
+    HandlerTimer (StreamServer *server);
+    /// Add the time of the handler to the server, if measured
+    ~HandlerTimer ();
+
+  private:
+    StreamServer *m_server;                         //!< server running the handler
+    bool m_outer;                                   //!< true if this handler is measured
+    std::chrono::steady_clock::time_point m_start;  //!< start of the handler
+  };
+
   uint16_t m_port; //!< Port on which we listen for incoming packets.
   Ptr<Socket> m_socket; //!< IPv4 Socket
   Ptr<Socket> m_socket6; //!< IPv6 Socket
-  std::map <Address, callbackData> m_callbackData; //!< With this it is possible to access the currentTxBytes, the packetSizeToReturn and the send boolean through the from value of the client.
-  std::vector<Address> m_connectedClients; //!< Vector which holds the list of currently connected clients.
+  std::unordered_map <Socket *, callbackData> m_callbackData; //!< State of the currently connected clients, by socket. Elements do not move, the receive and send callbacks of the sockets point to them.
   std::string m_protocolName; //!< The name of the transport protocol to be used (TCP or QUIC)
+  bool m_timeHandlers; //!< Measure the time spent in the handlers
+  bool m_inHandler; //!< True while a handler is measured
+  std::chrono::steady_clock::duration m_handlerTime; //!< Time spent in the handlers
 };
 
 } // namespace ns3
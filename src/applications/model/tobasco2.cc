@@ -242,19 +242,15 @@ TobascoAlgorithm::AverageSegmentThroughput (int64_t t_1, int64_t t_2)
 
 
   // First, we have to find the index of the start of the download of the first downloaded segment in
-  // the interval [t_1, t_2]
-  uint index = 0;
-  for (uint i = 0; i <= m_throughput.transmissionEnd.size () - 1; i++)
+  // the interval [t_1, t_2]. t_1 never goes back, so the window only moves forward in the history.
+  uint index = m_window.Advance (m_throughput.transmissionEnd, t_1);
+  if (index == m_throughput.transmissionEnd.size ())
     {
-      if (m_throughput.transmissionEnd.at (i) < t_1)
-        {
-          continue;
-        }
-      else
-        {
-          index = i;
-          break;
-        }
+      // no download ended in the interval, only the last one is recent enough:
+      // count it as a fully completed one
+      index = m_throughput.transmissionEnd.size () - 1;
+      return (m_videoData.averageBitrate.at (m_playbackData.playbackIndex.at (index)) * m_videoData.segmentDuration)
+             / (double)(m_throughput.transmissionEnd.at (index) - m_throughput.transmissionRequested.at (index));
     }
 
   double lengthOfInterval;
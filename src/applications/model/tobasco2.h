@@ -20,6 +20,9 @@
 #define TOBASCO_ALGORITHM_H
 
 #include "tcp-stream-adaptation-algorithm.h"
+#include "adaptation-statistics.h"
+
+class TobascoThroughputTestCase;
 
 namespace ns3 {
 
@@ -29,6 +32,8 @@ namespace ns3 {
  */
 class TobascoAlgorithm : public AdaptationAlgorithm
 {
+  /// allow TobascoThroughputTestCase access
+  friend class ::TobascoThroughputTestCase;
 public:
   TobascoAlgorithm (  const videoData &videoData,
                       const playbackData & playbackData,
@@ -67,6 +72,7 @@ private:
   const int64_t m_highestRepIndex;
   int64_t m_lastRepIndex;
   bool m_runningFastStart;
+  TimeWindow m_window;   //!< downloads of the last m_deltaTime
 };
 } // namespace ns3
 #endif /* TOBASCO_ALGORITHM_H */
\ No newline at end of file
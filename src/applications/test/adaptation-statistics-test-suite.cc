@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/adaptation-statistics.h"
+#include "ns3/tobasco2.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \brief Harmonic mean over a sliding window of samples
+ */
+class SlidingHarmonicMeanTestCase : public TestCase
+{
+public:
+  SlidingHarmonicMeanTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SlidingHarmonicMeanTestCase::SlidingHarmonicMeanTestCase ()
+  : TestCase ("Sliding harmonic mean")
+{
+}
+
+void
+SlidingHarmonicMeanTestCase::DoRun (void)
+{
+  SlidingHarmonicMean mean (3);
+  NS_TEST_ASSERT_MSG_EQ (mean.GetCount (), 0, "samples in a new window");
+  NS_TEST_ASSERT_MSG_EQ (mean.GetMean (), 0, "mean of an empty window");
+
+  mean.Add (2);
+  NS_TEST_ASSERT_MSG_EQ (mean.GetCount (), 1, "samples in the window");
+  NS_TEST_ASSERT_MSG_EQ_TOL (mean.GetMean (), 2, 1e-12, "mean of one sample");
+
+  mean.Add (4);
+  mean.Add (4);
+  NS_TEST_ASSERT_MSG_EQ (mean.GetCount (), 3, "samples in the window");
+  NS_TEST_ASSERT_MSG_EQ_TOL (mean.GetMean (), 3.0, 1e-12, "mean of 2, 4 and 4");
+
+  // the 2 leaves the window
+  mean.Add (1);
+  NS_TEST_ASSERT_MSG_EQ (mean.GetCount (), 3, "a full window grew");
+  NS_TEST_ASSERT_MSG_EQ_TOL (mean.GetMean (), 2.0, 1e-12, "mean of 4, 4 and 1");
+
+  // many windows through the running sum and its recomputations
+  SlidingHarmonicMean longMean (20);
+  std::vector<double> samples;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      double sample = 1e6 + (i * 7919 % 1000) * 1e4;
+      samples.push_back (sample);
+      longMean.Add (sample);
+    }
+  double sum = 0;
+  for (uint32_t i = samples.size () - 20; i < samples.size (); i++)
+    {
+      sum += 1 / samples[i];
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (longMean.GetMean (), 20 / sum, 1e-6, "mean of the last 20 samples");
+}
+
+/**
+ * \ingroup applications-test
+ * \brief Exponentially weighted moving average
+ */
+class EwmaTestCase : public TestCase
+{
+public:
+  EwmaTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EwmaTestCase::EwmaTestCase ()
+  : TestCase ("Exponentially weighted moving average")
+{
+}
+
+void
+EwmaTestCase::DoRun (void)
+{
+  Ewma average (0.25);
+  NS_TEST_ASSERT_MSG_EQ (average.IsValid (), false, "new average is valid");
+  average.Reset (8);
+  NS_TEST_ASSERT_MSG_EQ (average.IsValid (), true, "average not valid after a reset");
+  double value = average.Update (16);
+  NS_TEST_ASSERT_MSG_EQ_TOL (value, 10, 1e-12, "sample of the default weight");
+  value = average.Update (0, 0.5);
+  NS_TEST_ASSERT_MSG_EQ_TOL (value, 5, 1e-12, "sample of a given weight");
+  NS_TEST_ASSERT_MSG_EQ_TOL (average.Get (), 5, 1e-12, "value of the average");
+}
+
+/**
+ * \ingroup applications-test
+ * \brief Forward-only cursor over the download end times
+ */
+class TimeWindowTestCase : public TestCase
+{
+public:
+  TimeWindowTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TimeWindowTestCase::TimeWindowTestCase ()
+  : TestCase ("Time window over the download history")
+{
+}
+
+void
+TimeWindowTestCase::DoRun (void)
+{
+  std::vector<int64_t> ends;
+  TimeWindow window;
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 0), 0, "window over an empty history");
+
+  ends.push_back (10);
+  ends.push_back (20);
+  ends.push_back (30);
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 0), 0, "window starting before the history");
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 15), 1, "first download ending after the start");
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 15), 1, "same start, same download");
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 20), 1, "download ending at the start");
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 31), 3, "no download ending in the window");
+
+  // a new download ends in the window
+  ends.push_back (40);
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 31), 3, "new download not found");
+  NS_TEST_ASSERT_MSG_EQ (window.Advance (ends, 41), 4, "window after the history");
+}
+
+/**
+ * \ingroup applications-test
+ * \brief Tobasco throughput estimate without a download in the window
+ *
+ * The last download, ended before the window, stands for the window:
+ * the estimate is its throughput, as if the window had covered it.
+ */
+class TobascoThroughputTestCase : public TestCase
+{
+public:
+  TobascoThroughputTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TobascoThroughputTestCase::TobascoThroughputTestCase ()
+  : TestCase ("Tobasco throughput of a window without download")
+{
+}
+
+void
+TobascoThroughputTestCase::DoRun (void)
+{
+  videoData video;
+  video.averageBitrate.push_back (1e6);
+  video.averageBitrate.push_back (4e6);
+  video.segmentDuration = 2000000;
+  playbackData playback;
+  playback.playbackIndex.push_back (1);
+  bufferData buffer;
+  throughputData throughput;
+  // 4e6 * 2 s of video downloaded in 4 s
+  throughput.transmissionRequested.push_back (1000000);
+  throughput.transmissionStart.push_back (1100000);
+  throughput.transmissionEnd.push_back (5000000);
+  throughput.bytesReceived.push_back (1000000);
+
+  Ptr<TobascoAlgorithm> covering = CreateObject<TobascoAlgorithm> (video, playback, buffer, throughput);
+  double expected = covering->AverageSegmentThroughput (0, 6000000);
+  NS_TEST_ASSERT_MSG_EQ_TOL (expected, 2e6, 1e-6, "throughput of a download in the window");
+
+  Ptr<TobascoAlgorithm> after = CreateObject<TobascoAlgorithm> (video, playback, buffer, throughput);
+  double fallback = after->AverageSegmentThroughput (8000000, 9000000);
+  NS_TEST_ASSERT_MSG_EQ_TOL (fallback, expected, 1e-6, "throughput of the last download before the window");
+}
+
+/**
+ * \ingroup applications-test
+ * \brief Adaptation statistics TestSuite
+ */
+class AdaptationStatisticsTestSuite : public TestSuite
+{
+public:
+  AdaptationStatisticsTestSuite ();
+};
+
+AdaptationStatisticsTestSuite::AdaptationStatisticsTestSuite ()
+  : TestSuite ("adaptation-statistics", UNIT)
+{
+  AddTestCase (new SlidingHarmonicMeanTestCase, TestCase::QUICK);
+  AddTestCase (new EwmaTestCase, TestCase::QUICK);
+  AddTestCase (new TimeWindowTestCase, TestCase::QUICK);
+  AddTestCase (new TobascoThroughputTestCase, TestCase::QUICK);
+}
+
+static AdaptationStatisticsTestSuite g_adaptationStatisticsTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "type-id.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("Threshold",
+                   "Maximum number of events of a bucket sorted at once, "
+                   "larger buckets are divided into a new rung",
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_threshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs of the ladder",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::m_maxRungs),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_threshold (50),
+    m_maxRungs (8),
+    m_topStart (0),
+    m_topMin (std::numeric_limits<uint64_t>::max ()),
+    m_topMax (0),
+    m_nRungs (0),
+    m_qSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart (const Rung &rung)
+{
+  return rung.start + rung.current * rung.width;
+}
+
+uint32_t
+LadderScheduler::GetBucket (const Rung &rung, uint64_t ts)
+{
+  uint64_t bucket = (ts - rung.start) / rung.width;
+  return bucket < rung.nBuckets ? bucket : rung.nBuckets - 1;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  m_qSize++;
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      return;
+    }
+  // The emptied rungs are skipped: the last bucket of the rung below
+  // takes the events up to the current bucket of the rung above.
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      Rung &rung = m_rungs[i];
+      if (rung.current < rung.nBuckets && ts >= CurrentStart (rung))
+        {
+          rung.buckets[GetBucket (rung, ts)].push_back (ev);
+          return;
+        }
+    }
+  m_bottom.insert (std::upper_bound (m_bottom.begin (), m_bottom.end (), ev), ev);
+  if (m_bottom.size () > m_threshold && m_nRungs < m_maxRungs)
+    {
+      // The events simultaneous with the first one would all go to the
+      // same bucket, and come back to the bottom.
+      Event first = m_bottom.front ();
+      first.key.m_uid = std::numeric_limits<uint32_t>::max ();
+      if (static_cast<uint32_t> (m_bottom.end () - std::upper_bound (m_bottom.begin (), m_bottom.end (), first)) > m_threshold)
+        {
+          NS_LOG_LOGIC ("bottom of " << m_bottom.size () << " events into rung " << m_nRungs);
+          Bucket events (m_bottom.begin (), m_bottom.end ());
+          m_bottom.clear ();
+          Spawn (events, events.front ().key.m_ts, events.back ().key.m_ts);
+        }
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_qSize > 0);
+  Prepare ();
+  const Event &ev = m_bottom.front ();
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_qSize > 0);
+  Prepare ();
+  Event ev = m_bottom.front ();
+  m_bottom.pop_front ();
+  m_qSize--;
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  Bucket *bucket = 0;
+  if (ts >= m_topStart)
+    {
+      bucket = &m_top;
+    }
+  else
+    {
+      for (uint32_t i = 0; i < m_nRungs; i++)
+        {
+          Rung &rung = m_rungs[i];
+          if (rung.current < rung.nBuckets && ts >= CurrentStart (rung))
+            {
+              bucket = &rung.buckets[GetBucket (rung, ts)];
+              break;
+            }
+        }
+    }
+  if (bucket == 0)
+    {
+      std::deque<Event>::iterator i = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev);
+      NS_ASSERT (i != m_bottom.end () && i->key.m_uid == ev.key.m_uid);
+      NS_ASSERT (i->impl == ev.impl);
+      m_bottom.erase (i);
+    }
+  else
+    {
+      Bucket::iterator i = bucket->begin ();
+      while (i != bucket->end () && i->key.m_uid != ev.key.m_uid)
+        {
+          i++;
+        }
+      NS_ASSERT (i != bucket->end ());
+      NS_ASSERT (i->impl == ev.impl);
+      *i = bucket->back ();
+      bucket->pop_back ();
+    }
+  m_qSize--;
+}
+
+void
+LadderScheduler::Spawn (Bucket &events, uint64_t start, uint64_t end) const
+{
+  NS_LOG_FUNCTION (this << events.size () << start << end);
+  if (m_rungs.size () == m_nRungs)
+    {
+      m_rungs.push_back (Rung ());
+    }
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  // about one event per bucket
+  rung.start = start;
+  rung.width = (end - start) / events.size () + 1;
+  rung.current = 0;
+  rung.nBuckets = (end - start) / rung.width + 1;
+  if (rung.buckets.size () < rung.nBuckets)
+    {
+      rung.buckets.resize (rung.nBuckets);
+    }
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      rung.buckets[GetBucket (rung, i->key.m_ts)].push_back (*i);
+    }
+  events.clear ();
+}
+
+void
+LadderScheduler::Settle (Bucket &events) const
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  NS_ASSERT (m_bottom.empty ());
+  std::sort (events.begin (), events.end ());
+  m_bottom.assign (events.begin (), events.end ());
+  events.clear ();
+}
+
+void
+LadderScheduler::MoveTop (void) const
+{
+  NS_LOG_FUNCTION (this << m_top.size () << m_topMin << m_topMax);
+  NS_ASSERT (!m_top.empty ());
+  if (m_top.size () <= m_threshold || m_topMin == m_topMax || m_maxRungs == 0)
+    {
+      m_topStart = m_topMax + 1;
+      Settle (m_top);
+    }
+  else
+    {
+      Spawn (m_top, m_topMin, m_topMax);
+      const Rung &rung = m_rungs[0];
+      m_topStart = rung.start + rung.nBuckets * rung.width;
+    }
+  m_topMin = std::numeric_limits<uint64_t>::max ();
+  m_topMax = 0;
+}
+
+void
+LadderScheduler::Prepare (void) const
+{
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          MoveTop ();
+          continue;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      rung.current++;
+      if (bucket.size () > m_threshold && m_nRungs < m_maxRungs)
+        {
+          uint64_t start = std::numeric_limits<uint64_t>::max ();
+          uint64_t end = 0;
+          for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); i++)
+            {
+              start = std::min (start, i->key.m_ts);
+              end = std::max (end, i->key.m_ts);
+            }
+          if (start != end)
+            {
+              NS_LOG_LOGIC ("bucket of " << bucket.size () << " events into rung " << m_nRungs);
+              Spawn (bucket, start, end);
+              continue;
+            }
+        }
+      Settle (bucket);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+#include <deque>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue of
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Tang, Goh and Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The events are kept in three tiers:
+ *
+ * - the top, an unsorted vector of the events later than all the others,
+ * - the ladder, a stack of rungs of buckets. Each rung divides one
+ *   bucket of the rung above it, or the top for the first rung, into
+ *   buckets of equal width. The buckets are not sorted.
+ * - the bottom, a short sorted deque of the earliest events.
+ *
+ * New events are appended to the top or to a bucket in constant time,
+ * and only the few events which go below the current bucket of the
+ * lowest rung are sorted into the bottom. When the bottom is empty, the
+ * next bucket of the lowest rung is sorted into it if it holds at most
+ * \c Threshold events, otherwise it is divided into a new rung; the
+ * top is moved into a new first rung when the ladder is empty. The
+ * widths of the rungs are computed from the events they receive, so the
+ * ladder adapts to skewed distributions without the global resizes of
+ * the CalendarScheduler. A bottom which grows past \c Threshold events
+ * later than its first one, from the insertion of near-future events, is
+ * moved into a new rung.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to the top or a bucket; sorted insert in the short bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | ~Constant       | Sort the next bucket into the bottom when it is empty
+ * Remove()     | Linear in the top, ~Constant otherwise | Search of the top or of a bucket
+ * RemoveNext() | ~Constant       | Pop the bottom
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | `std::vector` + `std::deque` + one `std::vector` of buckets per rung | Tiers
+ * Per Event | 0                                | `std::vector`, `std::deque`
+ *
+ * The storage of the tiers is kept and reused as the events flow
+ * through them.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Unsorted bucket type: a vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder: buckets of equal width. */
+  struct Rung
+  {
+    uint64_t start;                /**< Time stamp of the start of the first bucket. */
+    uint64_t width;                /**< Duration of a bucket, in dimensionless time units. */
+    uint32_t current;              /**< Index of the first bucket not yet emptied. */
+    uint32_t nBuckets;             /**< Number of buckets in use. */
+    std::vector<Bucket> buckets;   /**< The buckets, at least nBuckets. */
+  };
+
+  /**
+   * Create a new lowest rung with the events of a bucket.
+   *
+   * The last bucket of the rung also receives the events up to the end
+   * of the bucket the events come from.
+   *
+   * \param [in,out] events The events, emptied.
+   * \param [in] start The time stamp of the earliest event.
+   * \param [in] end The time stamp of the latest event.
+   */
+  void Spawn (Bucket &events, uint64_t start, uint64_t end) const;
+  /**
+   * Sort events into the empty bottom.
+   *
+   * \param [in,out] events The events, emptied.
+   */
+  void Settle (Bucket &events) const;
+  /**
+   * Fill the bottom if it is empty, from the ladder or the top.
+   *
+   * The order of the events is not changed, so this can be done by
+   * PeekNext.
+   */
+  void Prepare (void) const;
+  /**
+   * Move the top into a new first rung, or into the bottom if it has few
+   * events or all at the same time.
+   */
+  void MoveTop (void) const;
+  /**
+   * \param [in] rung A rung.
+   * \returns The time stamp of the start of its current bucket.
+   */
+  static uint64_t CurrentStart (const Rung &rung);
+  /**
+   * \param [in] rung A rung.
+   * \param [in] ts A time stamp not earlier than the start of the rung.
+   * \returns The index of the bucket of the time stamp in the rung, the
+   * last bucket for the time stamps after the end of the rung.
+   */
+  static uint32_t GetBucket (const Rung &rung, uint64_t ts);
+
+  /** Maximum number of events sorted into the bottom at once. */
+  uint32_t m_threshold;
+  /** Maximum number of rungs. */
+  uint32_t m_maxRungs;
+
+  // The tiers change on PeekNext without changing the order of the events.
+  /** Unsorted events not earlier than m_topStart. */
+  mutable Bucket m_top;
+  /** Time stamp of the start of the top. */
+  mutable uint64_t m_topStart;
+  /** Earliest time stamp in the top. */
+  mutable uint64_t m_topMin;
+  /** Latest time stamp in the top. */
+  mutable uint64_t m_topMax;
+  /**
+   * The rungs, the first m_nRungs in use, the lowest last. A deque keeps
+   * the buckets in place while a rung is added.
+   */
+  mutable std::deque<Rung> m_rungs;
+  /** Number of rungs in use. */
+  mutable uint32_t m_nRungs;
+  /**
+   * Earliest events, sorted. A deque moves the shorter side on an
+   * insertion, so near-future events are cheap to insert after many
+   * simultaneous ones.
+   */
+  mutable std::deque<Scheduler::Event> m_bottom;
+  /** Number of events in queue. */
+  uint32_t m_qSize;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
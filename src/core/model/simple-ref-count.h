@@ -28,6 +28,9 @@
 #include "unused.h"
 #include <stdint.h>
 #include <limits>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 /**
  * \file
@@ -115,8 +118,7 @@ public:
    */
   inline void Unref (void) const
   {
-    m_count--;
-    if (m_count == 0)
+    if (--m_count == 0)
       {
         DELETER::Delete (static_cast<T*> (const_cast<SimpleRefCount *> (this)));
       }
@@ -139,9 +141,14 @@ private:
    *
    * \internal
    * Note we make this mutable so that the const methods can still
-   * change it.
+   * change it. The multithreaded simulator shares objects between
+   * threads, so its builds count atomically.
    */
+#ifdef NS3_MTP
+  mutable std::atomic<uint32_t> m_count;
+#else
   mutable uint32_t m_count;
+#endif
 };
 
 } // namespace ns3
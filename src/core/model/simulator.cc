@@ -30,14 +30,22 @@
 #include "object-factory.h"
 #include "global-value.h"
 #include "assert.h"
+#include "abort.h"
 #include "log.h"
 
+#include <cerrno>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <list>
+#include <map>
 #include <vector>
 #include <iostream>
 #include <iomanip>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 /**
  * \file
@@ -323,6 +331,132 @@ Simulator::GetSystemId (void)
     }
 }
 
+/**
+ * \ingroup simulator
+ * Branch of this process, -1 unless it is a child of ForkAt ().
+ */
+static int32_t g_forkBranch = -1;
+
+/**
+ * \ingroup simulator
+ * Number of child processes of ForkAt () which failed.
+ */
+static uint32_t g_forkFailures = 0;
+
+/**
+ * \ingroup simulator
+ * Wait until one of the child processes of Simulator::ForkAt () exits.
+ *
+ * Only the branches are waited for: the other children of the process,
+ * started by the scenario itself, are left to their owner.
+ *
+ * \param [in,out] running The branches of the running child processes, by pid.
+ */
+static void
+WaitForkChild (std::map<pid_t, uint32_t> &running)
+{
+  while (true)
+    {
+      for (std::map<pid_t, uint32_t>::iterator it = running.begin (); it != running.end (); it++)
+        {
+          int status = 0;
+          pid_t done = waitpid (it->first, &status, WNOHANG);
+          if (done < 0)
+            {
+              NS_ABORT_MSG_IF (errno != EINTR, "waitpid failed: " << std::strerror (errno));
+              continue;
+            }
+          if (done == 0)
+            {
+              // still running
+              continue;
+            }
+          if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+            {
+              NS_LOG_WARN ("branch " << it->second << " (pid " << done << ") failed with status " << status);
+              g_forkFailures++;
+            }
+          running.erase (it);
+          return;
+        }
+      usleep (1000);
+    }
+}
+
+/**
+ * \ingroup simulator
+ * Fork the child processes of Simulator::ForkAt ().
+ *
+ * \param [in] n The number of child processes.
+ * \param [in] branch The function called in each child process.
+ * \param [in] maxRunning The maximum number of child processes running at once.
+ */
+static void
+ForkNow (uint32_t n, Callback<void, uint32_t> branch, uint32_t maxRunning)
+{
+  NS_LOG_FUNCTION (n << maxRunning);
+  // or the children write the output buffered so far again
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+
+  std::map<pid_t, uint32_t> running;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      while (running.size () >= maxRunning)
+        {
+          WaitForkChild (running);
+        }
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid < 0, "fork failed: " << std::strerror (errno));
+      if (pid == 0)
+        {
+          g_forkBranch = i;
+          branch (i);
+          return;
+        }
+      running[pid] = i;
+    }
+  while (!running.empty ())
+    {
+      WaitForkChild (running);
+    }
+  Simulator::Stop ();
+}
+
+void
+Simulator::ForkAt (const Time &time, uint32_t n, const Callback<void, uint32_t> &branch, uint32_t maxRunning)
+{
+  NS_LOG_FUNCTION (time << n << maxRunning);
+  NS_ASSERT_MSG (time >= Now (), "checkpoint in the past");
+  // fork () copies only the calling thread: the children would wait
+  // forever for the worker threads at the end of the first window
+  if (GetImplementation ()->GetInstanceTypeId ().GetName () == "ns3::MultithreadedSimulatorImpl")
+    {
+      NS_FATAL_ERROR ("ForkAt is not supported by the multithreaded simulator");
+    }
+  if (maxRunning == 0)
+    {
+      long processors = sysconf (_SC_NPROCESSORS_ONLN);
+      maxRunning = processors > 0 ? processors : 1;
+    }
+  g_forkFailures = 0;
+  Schedule (time - Now (), &ForkNow, n, branch, maxRunning);
+}
+
+int32_t
+Simulator::GetForkBranch (void)
+{
+  return g_forkBranch;
+}
+
+uint32_t
+Simulator::GetForkFailures (void)
+{
+  return g_forkFailures;
+}
+
 void
 Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 {
@@ -21,6 +21,7 @@
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include "callback.h"
 #include "event-id.h"
 #include "event-impl.h"
 #include "make-event.h"
@@ -494,6 +495,53 @@ public:
    */
   static uint32_t GetSystemId (void);
 
+  /**
+   * Branch the simulation into several processes at a checkpoint.
+   *
+   * At @p time, the process is forked @p n times. Each child process
+   * calls @p branch with its index, from 0 to @p n - 1, and goes on
+   * with the simulation from the state reached at @p time, which it
+   * shares copy-on-write with the others. At most @p maxRunning
+   * children run at once: the next one is forked when one exits. The
+   * parent waits until all the children have exited, then its Run ()
+   * returns; use GetForkBranch () after Run () to tell it from the
+   * children.
+   *
+   * The branches only differ by what @p branch changes: the random
+   * variables carry on with the same streams, and the files opened
+   * before @p time are shared by all the processes. Open the output
+   * files of a branch after the checkpoint, e.g. after changing to a
+   * directory of its own in @p branch.
+   *
+   * The child processes inherit only the thread which forks them, so
+   * ForkAt aborts if the implementation is the
+   * MultithreadedSimulatorImpl.
+   *
+   * @param [in] time The absolute time of the checkpoint.
+   * @param [in] n The number of child processes.
+   * @param [in] branch The function called in each child process.
+   * @param [in] maxRunning The maximum number of child processes running
+   * at once, 0 for one per online processor.
+   */
+  static void ForkAt (const Time &time, uint32_t n, const Callback<void, uint32_t> &branch,
+                      uint32_t maxRunning = 0);
+
+  /**
+   * Get the branch of this process after ForkAt ().
+   *
+   * @return The index of the branch, -1 in the parent process and if
+   * the simulation was not forked.
+   */
+  static int32_t GetForkBranch (void);
+
+  /**
+   * Get the number of child processes which failed.
+   *
+   * @return In the parent process, after Run (), the number of child
+   * processes of ForkAt () which did not exit with a zero status.
+   */
+  static uint32_t GetForkFailures (void);
+
 private:
   /** Default constructor. */
   Simulator ();
@@ -24,6 +24,9 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -465,6 +468,96 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the order of the events of " +
+              schedulerFactory.GetTypeId ().GetName () +
+              " against the MapScheduler"),
+    m_schedulerFactory (schedulerFactory)
+{}
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<Scheduler::Event> pending;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  for (uint32_t step = 0; step < 40000; step++)
+    {
+      double action = random->GetValue ();
+      if (step < 5000 || action < 0.5 || reference->IsEmpty ())
+        {
+          // near-future timers, pacing, ties and far-future timeouts
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          double kind = random->GetValue ();
+          if (kind < 0.3)
+            {
+              ev.key.m_ts = now + 1;
+            }
+          else if (kind < 0.7)
+            {
+              ev.key.m_ts = now + random->GetInteger (0, 10000);
+            }
+          else if (kind < 0.8)
+            {
+              ev.key.m_ts = now + 5000;
+            }
+          else
+            {
+              ev.key.m_ts = now + random->GetInteger (1000000, 100000000);
+            }
+          scheduler->Insert (ev);
+          reference->Insert (ev);
+          pending.push_back (ev);
+        }
+      else if (action < 0.55)
+        {
+          uint32_t i = random->GetInteger (0, pending.size () - 1);
+          scheduler->Remove (pending[i]);
+          reference->Remove (pending[i]);
+          pending[i] = pending.back ();
+          pending.pop_back ();
+        }
+      else
+        {
+          Scheduler::Event peek = scheduler->PeekNext ();
+          Scheduler::Event next = scheduler->RemoveNext ();
+          Scheduler::Event expected = reference->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (peek.key.m_uid, next.key.m_uid, "PeekNext differs from RemoveNext");
+          NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, expected.key.m_uid, "Wrong event at step " << step);
+          now = next.key.m_ts;
+          for (uint32_t i = 0; i < pending.size (); i++)
+            {
+              if (pending[i].key.m_uid == next.key.m_uid)
+                {
+                  pending[i] = pending.back ();
+                  pending.pop_back ();
+                  break;
+                }
+            }
+        }
+    }
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "Events missing");
+      NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid, reference->RemoveNext ().key.m_uid, "Wrong event");
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "Events left");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -483,5 +576,10 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
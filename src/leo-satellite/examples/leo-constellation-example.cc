@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Constellation Example
+ * Builds a constellation of several shells of inclined Walker orbits with
+ * any number of ground stations, and sends traffic between two of them
+ *
+ * The default shells are the first phase of a large broadband
+ * constellation, 4409 satellites:
+ *
+ *   ./waf --run "leo-constellation-example --stations=20"
+ *
+ * A shell is given as altitude:inclination:PxS:F, where P is the number of
+ * planes, S the number of satellites per plane and F the Walker phasing
+ * factor.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/leo-constellation.h"
+#include "ns3/applications-module.h"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LeoConstellationExample");
+
+/**
+ * \param shells shells as altitude:inclination:PxS:F, separated by commas
+ * \param constellation receives the shells
+ */
+static void
+AddShells (std::string shells, Ptr<LeoConstellation> constellation)
+{
+  std::istringstream list (shells);
+  std::string text;
+  while (std::getline (list, text, ','))
+    {
+      double altitude;
+      double inclination;
+      uint32_t planes;
+      uint32_t satellites;
+      uint32_t phasing;
+      char c[4];
+      std::istringstream shell (text);
+      shell >> altitude >> c[0] >> inclination >> c[1] >> planes >> c[2] >> satellites >> c[3] >> phasing;
+      NS_ABORT_MSG_IF (shell.fail () || c[0] != ':' || c[1] != ':' || c[2] != 'x' || c[3] != ':',
+                       "Bad shell " << text << ", expected altitude:inclination:PxS:F");
+      constellation->AddWalkerDelta (altitude, inclination, planes, satellites, phasing);
+    }
+}
+
+/**
+ * Add ground stations: a few cities, then points spread evenly between
+ * the latitudes -60 and 60
+ * \param n the number of ground stations
+ * \param constellation receives the ground stations
+ */
+static void
+AddStations (uint32_t n, Ptr<LeoConstellation> constellation)
+{
+  const double cities[][2] = {
+    {40.71, -74.01}, {51.51, -0.13}, {35.68, 139.69}, {-33.87, 151.21}, {-23.55, -46.63},
+    {-26.20, 28.05}, {1.35, 103.82}, {34.05, -118.24}, {55.76, 37.62}, {19.08, 72.88}
+  };
+  uint32_t nCities = sizeof (cities)/sizeof (cities[0]);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (i < nCities)
+        {
+          constellation->AddGroundStation (cities[i][0], cities[i][1]);
+          continue;
+        }
+      // Fibonacci lattice over the band
+      uint32_t k = i - nCities;
+      double latitude = std::asin ((2.0*k + 1)/(n - nCities) - 1)*180/M_PI*60/90;
+      double longitude = std::fmod (k*137.50776405, 360) - 180;
+      constellation->AddGroundStation (latitude, longitude);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string shells = "550:53:72x22:17,1110:53.8:32x50:17,1130:74:8x50:5,1275:81:5x75:3,1325:70:6x75:3";
+  uint32_t stations = 10;
+  uint32_t updates = 3;
+  Time interval = Seconds (10);
+  Time delay_refresh = Seconds (0);
+
+  CommandLine cmd;
+  cmd.AddValue ("shells", "Shells as altitude:inclination:PxS:F, separated by commas", shells);
+  cmd.AddValue ("stations", "Number of ground stations, at least 2", stations);
+  cmd.AddValue ("updates", "Number of updates of the links", updates);
+  cmd.AddValue ("interval", "Time between the updates", interval);
+  cmd.AddValue ("delay_refresh", "Compute the delays of the links at most once per this period when packets are sent, instead of at each update (0 to disable)", delay_refresh);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (stations < 2, "At least 2 ground stations");
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ptr<LeoConstellation> constellation = CreateObject<LeoConstellation> ();
+  AddShells (shells, constellation);
+  AddStations (stations, constellation);
+  constellation->Build ();
+  if (delay_refresh.IsStrictlyPositive ())
+    {
+      constellation->EnableContinuousDelays (delay_refresh);
+    }
+  std::cout << "Built " << constellation->GetSatellites ().GetN () << " satellites in "
+            << constellation->GetNShells () << " shells and " << stations << " ground stations in "
+            << clock.End () / 1000.0 << " s" << std::endl;
+
+  // traffic from the first ground station to the second one
+  UdpServerHelper server (9);
+  ApplicationContainer serverApps = server.Install (constellation->GetGroundStations ().Get (1));
+  UdpClientHelper client (constellation->GetGroundStationAddress (1), 9);
+  client.SetAttribute ("MaxPackets", UintegerValue (interval.GetSeconds () * (updates + 1) * 10));
+  client.SetAttribute ("Interval", TimeValue (MilliSeconds (100)));
+  client.SetAttribute ("PacketSize", UintegerValue (1024));
+  ApplicationContainer clientApps = client.Install (constellation->GetGroundStations ().Get (0));
+  serverApps.Start (Seconds (0));
+  clientApps.Start (Seconds (0));
+
+  uint32_t handovers = 0;
+  for (uint32_t i = 0; i <= updates; i++)
+    {
+      if (i > 0)
+        {
+          std::vector<uint32_t> serving;
+          for (uint32_t g = 0; g < stations; g++)
+            {
+              for (uint32_t s = 0; s < constellation->GetNShells (); s++)
+                {
+                  serving.push_back (constellation->GetServingSatellite (g, s));
+                }
+            }
+          clock.Start ();
+          constellation->UpdateLinks ();
+          double update = clock.End () / 1000.0;
+          uint32_t changed = 0;
+          for (uint32_t k = 0; k < serving.size (); k++)
+            {
+              changed += serving[k] != constellation->GetServingSatellite (k / constellation->GetNShells (), k % constellation->GetNShells ());
+            }
+          handovers += changed;
+          std::cout << Simulator::Now ().GetSeconds () << " s: links updated in " << update << " s, "
+                    << changed << " handovers" << std::endl;
+        }
+      Simulator::Stop (interval);
+      Simulator::Run ();
+    }
+
+  Ptr<UdpServer> sink = DynamicCast<UdpServer> (serverApps.Get (0));
+  std::cout << "Received " << sink->GetReceived () << " packets, " << sink->GetLost ()
+            << " lost, " << handovers << " handovers" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Benchmark
+ * Measures how the setup, the link updates, the routing and the forwarding
+ * of LeoSatelliteConfig scale with the size of the constellation
+ *
+ * Each size runs in a child process, with fresh global state (the ground
+ * station placement and the node list are global) and its own peak memory.
+ * One CSV line is printed per size:
+ *
+ *   ./waf --run "leo-satellite-benchmark --sizes=6x8,12x16,72x22"
+ *
+ * The number of satellites per plane must be even, and at most 126 since
+ * the inter-plane links between two planes share a /24.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/leo-satellite-config.h"
+#include "ns3/applications-module.h"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteBenchmark");
+
+/**
+ * \param name a field of /proc/self/status, like VmRSS
+ * \return its value in MB, or -1 if it cannot be read
+ */
+static double
+GetMemory (std::string name)
+{
+  std::ifstream status ("/proc/self/status");
+  std::string line;
+  while (std::getline (status, line))
+    {
+      if (line.compare (0, name.size () + 1, name + ":") == 0)
+        {
+          std::istringstream value (line.substr (name.size () + 1));
+          double kb;
+          value >> kb;
+          return kb / 1024;
+        }
+    }
+  return -1;
+}
+
+/**
+ * \param sizes sizes as PxN, separated by commas
+ * \return the number of planes and of satellites per plane of each size
+ */
+static std::vector<std::pair<uint32_t, uint32_t> >
+ParseSizes (std::string sizes)
+{
+  std::vector<std::pair<uint32_t, uint32_t> > result;
+  std::istringstream list (sizes);
+  std::string size;
+  while (std::getline (list, size, ','))
+    {
+      std::string::size_type x = size.find ('x');
+      NS_ABORT_MSG_IF (x == std::string::npos, "Bad size " << size << ", expected PxN");
+      uint32_t planes = std::atoi (size.substr (0, x).c_str ());
+      uint32_t satellites = std::atoi (size.substr (x + 1).c_str ());
+      NS_ABORT_MSG_IF (planes < 2 || satellites < 4 || satellites % 2 || satellites > 126,
+                       "Bad size " << size << ", the satellites per plane must be even, between 4 and 126");
+      result.push_back (std::make_pair (planes, satellites));
+    }
+  return result;
+}
+
+/**
+ * Build a constellation, run its updates and print its CSV line
+ * \param planes the number of planes
+ * \param satellites the number of satellites per plane
+ * \param altitude the altitude [km]
+ * \param updates the number of UpdateLinks
+ * \param interval the time between the updates
+ * \param packetInterval the time between the packets of the traffic
+ * \param snapshot whether the routing is precomputed
+ * \param out where to print the line
+ */
+static void
+RunSize (uint32_t planes, uint32_t satellites, double altitude, uint32_t updates,
+         Time interval, Time packetInterval, bool snapshot, std::ostream &out)
+{
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  LeoSatelliteConfig network (planes, satellites, altitude);
+  double construct = clock.End () / 1000.0;
+  double rss = GetMemory ("VmRSS");
+
+  clock.Start ();
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  double routing = clock.End () / 1000.0;
+
+  double precompute = 0;
+  if (snapshot)
+    {
+      clock.Start ();
+      network.EnableSnapshotRouting (interval, Seconds (interval.GetSeconds () * (updates + 1)));
+      precompute = clock.End () / 1000.0;
+    }
+
+  // traffic between the two ground stations, through the constellation
+  UdpServerHelper server (9);
+  ApplicationContainer serverApps = server.Install (network.ground_stations.Get (1));
+  UdpClientHelper client (network.ground_station_interfaces[1].GetAddress (0), 9);
+  client.SetAttribute ("MaxPackets", UintegerValue (interval.GetSeconds () * (updates + 1) / packetInterval.GetSeconds ()));
+  client.SetAttribute ("Interval", TimeValue (packetInterval));
+  client.SetAttribute ("PacketSize", UintegerValue (1024));
+  ApplicationContainer clientApps = client.Install (network.ground_stations.Get (0));
+  serverApps.Start (Seconds (0));
+  clientApps.Start (Seconds (0));
+
+  double update = 0;
+  double run = 0;
+  for (uint32_t i = 0; i <= updates; i++)
+    {
+      if (i > 0)
+        {
+          clock.Start ();
+          network.UpdateLinks ();
+          update += clock.End () / 1000.0;
+        }
+      Simulator::Stop (interval);
+      clock.Start ();
+      Simulator::Run ();
+      run += clock.End () / 1000.0;
+    }
+  uint64_t received = DynamicCast<UdpServer> (serverApps.Get (0))->GetReceived ();
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+
+  out << planes << "," << satellites << "," << planes * satellites << ","
+      << (snapshot ? "snapshot" : "global") << ","
+      << construct << "," << rss << "," << GetMemory ("VmHWM") << ","
+      << routing << "," << precompute << ","
+      << (updates ? update / updates : 0) << ","
+      << run << "," << received << "," << received / run << "," << events / run
+      << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string sizes = "6x8,12x16,24x16,36x20,72x22";
+  double altitude = 550;
+  uint32_t updates = 3;
+  Time interval = Seconds (100);
+  Time packetInterval = MilliSeconds (10);
+  bool snapshot = true;
+  bool header = true;
+
+  CommandLine cmd;
+  cmd.AddValue ("sizes", "Constellations to build, as planes x satellites per plane, separated by commas", sizes);
+  cmd.AddValue ("altitude", "Altitude of the satellites in kilometers", altitude);
+  cmd.AddValue ("updates", "Number of UpdateLinks of each constellation", updates);
+  cmd.AddValue ("interval", "Time between the updates", interval);
+  cmd.AddValue ("packetInterval", "Time between the packets sent from a ground station to the other", packetInterval);
+  cmd.AddValue ("snapshot_routing", "Precompute the routing tables instead of recomputing them at the updates", snapshot);
+  cmd.AddValue ("header", "Print the names of the columns", header);
+  cmd.Parse (argc, argv);
+
+  std::vector<std::pair<uint32_t, uint32_t> > list = ParseSizes (sizes);
+  std::cout << std::setprecision (6);
+  if (header)
+    {
+      std::cout << "planes,sats_per_plane,satellites,routing,construct_s,rss_mb,peak_rss_mb,"
+                << "global_routing_s,snapshot_routing_s,update_links_s,run_s,rx_packets,rx_packets_per_s,events_per_s"
+                << std::endl;
+    }
+  for (uint32_t i = 0; i < list.size (); i++)
+    {
+      std::cout.flush ();
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid < 0, "Cannot fork");
+      if (pid == 0)
+        {
+          // the configuration is verbose on std::cout, keep it for the results
+          std::ostream out (std::cout.rdbuf ());
+          out << std::setprecision (6);
+          std::ofstream null;
+          std::cout.rdbuf (null.rdbuf ());
+          RunSize (list[i].first, list[i].second, altitude, updates, interval, packetInterval, snapshot, out);
+          out.flush ();
+          _exit (0);
+        }
+      int status;
+      waitpid (pid, &status, 0);
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          std::cerr << "Constellation " << list[i].first << "x" << list[i].second << " failed" << std::endl;
+          return 1;
+        }
+    }
+  return 0;
+}
@@ -19,17 +19,34 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("LeoSatelliteExample");
 
+static void
+PrintHandover (const LeoHandover &handover)
+{
+  std::cout << Simulator::Now ().GetSeconds () << "s: ground station " << handover.groundStation
+            << " moves from satellite " << handover.oldSatellite << " to " << handover.newSatellite
+            << " at " << handover.time.GetSeconds () << "s, delay " << handover.oldDelay.GetSeconds ()
+            << "s -> " << handover.newDelay.GetSeconds () << "s" << std::endl;
+}
+
 int 
 main (int argc, char *argv[])
 {
   uint32_t n_planes = 3;
   uint32_t n_sats_per_plane = 4;
   double altitude = 2000;
+  bool snapshot_routing = false;
+  bool handover_events = false;
+  Time delay_refresh = Seconds (0);
+  bool trace_handovers = false;
 
   CommandLine cmd;
   cmd.AddValue ("n_planes", "Number of planes in satellite constellation", n_planes);
   cmd.AddValue ("n_sats_per_plane", "Number of satellites per plane in the satellite constellation", n_sats_per_plane);
   cmd.AddValue ("altitude", "Altitude of satellites in constellation in kilometers ... must be between 500 and 2000", altitude);
+  cmd.AddValue ("snapshot_routing", "Precompute the routing tables of the whole simulation instead of recomputing them at each update", snapshot_routing);
+  cmd.AddValue ("handover_events", "Hand the ground stations over at the predicted times instead of at each update", handover_events);
+  cmd.AddValue ("delay_refresh", "Compute the delays of the links at most once per this period when packets are sent, instead of at each update (0 to disable)", delay_refresh);
+  cmd.AddValue ("trace_handovers", "Print the handovers of the ground stations", trace_handovers);
 
   cmd.Parse (argc,argv);
 
@@ -37,6 +54,22 @@ main (int argc, char *argv[])
   LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
 
   LeoSatelliteConfig sat_network(n_planes, n_sats_per_plane, altitude);
+  if (trace_handovers)
+  {
+    sat_network.TraceConnectWithoutContext("Handover", MakeCallback(&PrintHandover));
+  }
+  if (delay_refresh.IsStrictlyPositive ())
+  {
+    sat_network.EnableContinuousDelays(delay_refresh);
+  }
+  if (handover_events)
+  {
+    sat_network.EnableHandoverEvents(Seconds(2000));
+  }
+  if (snapshot_routing)
+  {
+    sat_network.EnableSnapshotRouting(Seconds(100), Seconds(2000));
+  }
   
   UdpEchoServerHelper echoServer (9);
 
@@ -0,0 +1,554 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Constellation builder
+ * Builds constellations of several shells of inclined Walker orbits, with
+ * any number of ground stations
+ */
+
+#include "leo-constellation.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-list-routing-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/leo-satellite-mobility.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoConstellation");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoConstellation);
+
+extern double speed_of_light;
+
+/**
+ * \param a a position, as (latitude, longitude, altitude [km])
+ * \param b another position
+ * \return the propagation delay of the straight line between the positions
+ */
+static Time
+GetPropagationDelay (const Vector &a, const Vector &b)
+{
+  Vector d = LeoConstellationPropagator::GetCartesian (a) - LeoConstellationPropagator::GetCartesian (b);
+  return Seconds (d.GetLength ()*1000/speed_of_light);
+}
+
+TypeId
+LeoConstellation::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoConstellation")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoConstellation> ()
+    .AddAttribute ("IslDataRate",
+                   "Data rate of the inter-satellite links.",
+                   DataRateValue (DataRate ("5.36Gbps")),
+                   MakeDataRateAccessor (&LeoConstellation::m_islRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("GroundDataRate",
+                   "Data rate of the links between the ground stations and the satellites.",
+                   DataRateValue (DataRate ("5.36Gbps")),
+                   MakeDataRateAccessor (&LeoConstellation::m_groundRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("RouteToSatellites",
+                   "Route towards the addresses of the satellites, and not only "
+                   "towards the ground stations, with tables growing as the "
+                   "square of the number of satellites.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LeoConstellation::m_routeToSatellites),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Handover",
+                     "A ground station moved to another satellite of a shell.",
+                     MakeTraceSourceAccessor (&LeoConstellation::m_handoverTrace),
+                     "ns3::LeoConstellation::HandoverTracedCallback")
+  ;
+  return tid;
+}
+
+LeoConstellation::LeoConstellation ()
+  : m_routeToSatellites (false),
+    m_continuousDelays (false),
+    m_built (false)
+{
+  m_propagator = CreateObject<LeoConstellationPropagator> ();
+  m_visibility = CreateObject<LeoVisibilityService> ();
+  m_visibility->SetPropagator (m_propagator);
+}
+
+LeoConstellation::~LeoConstellation ()
+{
+}
+
+void
+LeoConstellation::DoDispose (void)
+{
+  m_isls.clear ();
+  m_groundChannels.clear ();
+  m_protocols.clear ();
+  m_routing = 0;
+  m_visibility = 0;
+  m_propagator = 0;
+  Object::DoDispose ();
+}
+
+uint32_t
+LeoConstellation::AddShell (const LeoShell &shell)
+{
+  NS_ABORT_MSG_IF (m_built, "Shells must be added before Build");
+  NS_ABORT_MSG_IF (shell.planes == 0 || shell.satellitesPerPlane == 0, "Empty shell");
+  NS_ABORT_MSG_IF (shell.phasing >= shell.planes, "The phasing factor must be less than the number of planes");
+  NS_ABORT_MSG_IF (shell.spread <= 0 || shell.spread > 360, "Bad spread of the ascending nodes " << shell.spread);
+  m_shells.push_back (shell);
+  return m_shells.size () - 1;
+}
+
+uint32_t
+LeoConstellation::AddWalkerDelta (double altitude, double inclination, uint32_t planes, uint32_t satellitesPerPlane, uint32_t phasing)
+{
+  LeoShell shell;
+  shell.altitude = altitude;
+  shell.inclination = inclination;
+  shell.planes = planes;
+  shell.satellitesPerPlane = satellitesPerPlane;
+  shell.phasing = phasing;
+  shell.spread = 360;
+  return AddShell (shell);
+}
+
+uint32_t
+LeoConstellation::AddGroundStation (double latitude, double longitude)
+{
+  NS_ABORT_MSG_IF (m_built, "Ground stations must be added before Build");
+  NS_ABORT_MSG_IF (latitude < -90 || latitude > 90, "Bad latitude " << latitude);
+  m_stations.push_back (Vector (latitude, longitude, 0));
+  return m_stations.size () - 1;
+}
+
+void
+LeoConstellation::CreateOrbits (const LeoShell &shell)
+{
+  uint32_t total = shell.planes*shell.satellitesPerPlane;
+  double epoch = Simulator::Now ().GetSeconds ();
+  for (uint32_t p = 0; p < shell.planes; p++)
+    {
+      double node = shell.spread*p/shell.planes;
+      for (uint32_t j = 0; j < shell.satellitesPerPlane; j++)
+        {
+          double phase = 360.0*j/shell.satellitesPerPlane + 360.0*shell.phasing*p/total;
+          m_propagator->AddOrbit (shell.inclination, node, phase, shell.altitude, epoch);
+        }
+    }
+}
+
+void
+LeoConstellation::Build (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_built, "Constellation already built");
+  NS_ABORT_MSG_IF (m_shells.empty (), "No shell in the constellation");
+  m_built = true;
+
+  // the satellites, with the indexes of the propagator
+  for (uint32_t s = 0; s < m_shells.size (); s++)
+    {
+      m_firstSatellite.push_back (m_propagator->GetN ());
+      CreateOrbits (m_shells[s]);
+    }
+  uint32_t nSatellites = m_propagator->GetN ();
+  m_satellites.Create (nSatellites);
+  for (uint32_t k = 0; k < nSatellites; k++)
+    {
+      Ptr<LeoSatelliteMobilityModel> mobility = CreateObject<LeoSatelliteMobilityModel> ();
+      mobility->SetOrbit (m_propagator, k);
+      m_satellites.Get (k)->AggregateObject (mobility);
+    }
+  m_groundStations.Create (m_stations.size ());
+  for (uint32_t g = 0; g < m_stations.size (); g++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (m_stations[g]);
+      m_groundStations.Get (g)->AggregateObject (mobility);
+      m_visibility->AddGroundStation (m_stations[g]);
+    }
+  NS_LOG_INFO ("Created " << nSatellites << " satellites and " << m_stations.size () << " ground stations");
+
+  // one stack helper for all the nodes, with neither IPv6 nor global
+  // routing, whose routes are given by the snapshot routing
+  InternetStackHelper stack;
+  stack.SetIpv6StackInstall (false);
+  Ipv4ListRoutingHelper list;
+  list.Add (Ipv4StaticRoutingHelper (), 0);
+  stack.SetRoutingHelper (list);
+  stack.Install (m_satellites);
+  stack.SetTcp ("ns3::QuicL4Protocol");
+  stack.Install (m_groundStations);
+
+  // +Grid of each shell
+  PointToPointHelper isl;
+  isl.SetDeviceAttribute ("DataRate", DataRateValue (m_islRate));
+  for (uint32_t s = 0; s < m_shells.size (); s++)
+    {
+      const LeoShell &shell = m_shells[s];
+      uint32_t first = m_firstSatellite[s];
+      uint32_t n = shell.satellitesPerPlane;
+      bool delta = shell.spread == 360;
+      for (uint32_t p = 0; p < shell.planes; p++)
+        {
+          for (uint32_t j = 0; j < n; j++)
+            {
+              uint32_t satellite = first + p*n + j;
+              if (n > 2 || j + 1 < n)
+                {
+                  AddIsl (isl, satellite, first + p*n + (j + 1)%n);
+                }
+              if (p + 1 < shell.planes)
+                {
+                  AddIsl (isl, satellite, first + (p + 1)*n + j);
+                }
+              else if (delta && shell.planes > 2)
+                {
+                  AddIsl (isl, satellite, first + (j + shell.phasing)%n);
+                }
+            }
+        }
+      NS_LOG_INFO ("Shell " << s << ": " << shell.planes << " planes of " << n << " satellites at "
+                            << shell.altitude << " km, inclination " << shell.inclination);
+    }
+
+  // one ground device per satellite and one per ground station and shell
+  PointToPointHelper ground;
+  ground.SetDeviceAttribute ("DataRate", DataRateValue (m_groundRate));
+  m_satelliteGroundDevices = ground.InstallDevices (m_satellites);
+  for (uint32_t g = 0; g < m_groundStations.GetN (); g++)
+    {
+      for (uint32_t s = 0; s < m_shells.size (); s++)
+        {
+          m_groundDevices.Add (ground.InstallDevices (NodeContainer (m_groundStations.Get (g))));
+        }
+    }
+  AssignGroundStations (m_serving);
+  for (uint32_t i = 0; i < m_serving.size (); i++)
+    {
+      Ptr<ReconfigurablePointToPointChannel> channel = CreateObject<ReconfigurablePointToPointChannel> ();
+      channel->SetDelay (GetDelay (nSatellites + i/m_shells.size (), m_serving[i], Simulator::Now ()));
+      m_groundDevices.Get (i)->GetObject<PointToPointNetDevice> ()->Attach (channel);
+      m_satelliteGroundDevices.Get (m_serving[i])->GetObject<PointToPointNetDevice> ()->Attach (channel);
+      m_groundChannels.push_back (channel);
+    }
+
+  // one /16 for the links of each shell, one for the ground devices of the
+  // satellites and one for the ground stations
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.0.0");
+  for (uint32_t s = 0; s < m_shells.size (); s++)
+    {
+      NetDeviceContainer devices;
+      for (uint32_t l = 0; l < m_isls.size (); l++)
+        {
+          if (m_isls[l].a >= m_firstSatellite[s] && m_isls[l].a < m_firstSatellite[s] + m_shells[s].planes*m_shells[s].satellitesPerPlane)
+            {
+              devices.Add (m_isls[l].channel->GetDevice (0));
+              devices.Add (m_isls[l].channel->GetDevice (1));
+            }
+        }
+      NS_ABORT_MSG_IF (devices.GetN () > 65534, "Shell " << s << " has too many links for its /16");
+      address.Assign (devices);
+      address.NewNetwork ();
+    }
+  NS_ABORT_MSG_IF (m_satelliteGroundDevices.GetN () > 65534 || m_groundDevices.GetN () > 65534,
+                   "Too many ground devices for a /16");
+  address.Assign (m_satelliteGroundDevices);
+  address.NewNetwork ();
+  address.Assign (m_groundDevices);
+
+  // the snapshot routing comes before the static routing of each node
+  NodeContainer nodes (m_satellites, m_groundStations);
+  for (uint32_t k = 0; k < nodes.GetN (); k++)
+    {
+      Ptr<Ipv4ListRouting> routing = DynamicCast<Ipv4ListRouting> (nodes.Get (k)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+      NS_ASSERT (routing != 0);
+      Ptr<LeoSnapshotRouting> protocol = CreateObject<LeoSnapshotRouting> ();
+      routing->AddRoutingProtocol (protocol, 10);
+      m_protocols.push_back (protocol);
+    }
+  ComputeRouting ();
+}
+
+void
+LeoConstellation::AddIsl (PointToPointHelper &helper, uint32_t a, uint32_t b)
+{
+  NetDeviceContainer devices = helper.InstallReconfigurable (m_satellites.Get (a), m_satellites.Get (b));
+  Link link;
+  link.a = a;
+  link.b = b;
+  link.channel = devices.Get (0)->GetChannel ()->GetObject<ReconfigurablePointToPointChannel> ();
+  link.channel->SetDelay (GetDelay (a, b, Simulator::Now ()));
+  m_isls.push_back (link);
+}
+
+void
+LeoConstellation::AssignGroundStations (std::vector<uint32_t> &serving)
+{
+  Time now = Simulator::Now ();
+  uint32_t nSatellites = m_propagator->GetN ();
+  serving.resize (m_stations.size ()*m_shells.size ());
+  std::vector<bool> busy (nSatellites, false);
+  for (uint32_t g = 0; g < m_stations.size (); g++)
+    {
+      for (uint32_t s = 0; s < m_shells.size (); s++)
+        {
+          // the satellites of the other shells are busy for this link
+          std::vector<bool> mask (busy);
+          uint32_t first = m_firstSatellite[s];
+          uint32_t last = first + m_shells[s].planes*m_shells[s].satellitesPerPlane;
+          std::fill (mask.begin (), mask.begin () + first, true);
+          std::fill (mask.begin () + last, mask.end (), true);
+          LeoVisibility closest;
+          if (!m_visibility->FindClosest (g, now, mask, closest))
+            {
+              NS_LOG_LOGIC ("No satellite of shell " << s << " above the elevation mask of ground station " << g);
+            }
+          serving[g*m_shells.size () + s] = closest.satellite;
+          busy[closest.satellite] = true;
+        }
+    }
+}
+
+Time
+LeoConstellation::GetDelay (uint32_t a, uint32_t b, Time t) const
+{
+  uint32_t nSatellites = m_propagator->GetN ();
+  Vector ends[2];
+  uint32_t nodes[2] = {a, b};
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      ends[k] = (nodes[k] < nSatellites) ? m_propagator->GetPosition (nodes[k], t) : m_stations[nodes[k] - nSatellites];
+    }
+  return GetPropagationDelay (ends[0], ends[1]);
+}
+
+Time
+LeoConstellation::GetLinkDelay (Ptr<PointToPointNetDevice> a, Ptr<PointToPointNetDevice> b, Time t) const
+{
+  Ptr<Node> nodes[2] = {a->GetNode (), b->GetNode ()};
+  Vector ends[2];
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      Ptr<LeoSatelliteMobilityModel> satellite = nodes[k]->GetObject<LeoSatelliteMobilityModel> ();
+      if (satellite != 0)
+        {
+          ends[k] = m_propagator->ComputePosition (satellite->GetPropagatorIndex (), t);
+        }
+      else
+        {
+          ends[k] = nodes[k]->GetObject<MobilityModel> ()->GetPosition ();
+        }
+    }
+  return GetPropagationDelay (ends[0], ends[1]);
+}
+
+Ipv4Address
+LeoConstellation::GetAddress (Ptr<NetDevice> device) const
+{
+  Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+  return ipv4->GetAddress (ipv4->GetInterfaceForDevice (device), 0).GetLocal ();
+}
+
+void
+LeoConstellation::ComputeRouting (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t nSatellites = m_satellites.GetN ();
+  NodeContainer nodes (m_satellites, m_groundStations);
+  m_routing = CreateObject<LeoSnapshotRoutingTable> ();
+  for (uint32_t k = 0; k < nodes.GetN (); k++)
+    {
+      Ptr<Ipv4> ipv4 = nodes.Get (k)->GetObject<Ipv4> ();
+      for (uint32_t i = 1; i < ipv4->GetNInterfaces (); i++)
+        {
+          for (uint32_t a = 0; a < ipv4->GetNAddresses (i); a++)
+            {
+              m_routing->AddAddress (ipv4->GetAddress (i, a).GetLocal (), k);
+            }
+        }
+    }
+
+  // each link in both directions
+  LeoRoutingGraph graph (nodes.GetN ());
+  std::vector<Ptr<NetDevice> > devices;
+  std::vector<uint32_t> ends;
+  for (uint32_t l = 0; l < m_isls.size (); l++)
+    {
+      devices.push_back (m_isls[l].channel->GetDevice (0));
+      devices.push_back (m_isls[l].channel->GetDevice (1));
+      ends.push_back (m_isls[l].a);
+      ends.push_back (m_isls[l].b);
+    }
+  for (uint32_t i = 0; i < m_serving.size (); i++)
+    {
+      devices.push_back (m_groundDevices.Get (i));
+      devices.push_back (m_satelliteGroundDevices.Get (m_serving[i]));
+      ends.push_back (nSatellites + i/m_shells.size ());
+      ends.push_back (m_serving[i]);
+    }
+  for (uint32_t d = 0; d < devices.size (); d += 2)
+    {
+      for (uint32_t k = 0; k < 2; k++)
+        {
+          Ptr<NetDevice> device = devices[d + k];
+          LeoRoutingLink link;
+          link.neighbor = ends[d + 1 - k];
+          link.interface = device->GetNode ()->GetObject<Ipv4> ()->GetInterfaceForDevice (device);
+          link.gateway = GetAddress (devices[d + 1 - k]);
+          graph[ends[d + k]].push_back (link);
+        }
+    }
+  if (!m_routeToSatellites)
+    {
+      for (uint32_t g = 0; g < m_groundStations.GetN (); g++)
+        {
+          m_routing->AddDestination (nSatellites + g);
+        }
+    }
+  m_routing->AddSnapshot (Simulator::Now (), graph);
+  m_routing->Compute (Time::Max ());
+  for (uint32_t k = 0; k < m_protocols.size (); k++)
+    {
+      m_protocols[k]->SetTable (m_routing, k);
+    }
+}
+
+void
+LeoConstellation::UpdateLinks (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (!m_built, "Constellation not built");
+  Time now = Simulator::Now ();
+  uint32_t nSatellites = m_satellites.GetN ();
+  if (!m_continuousDelays)
+    {
+      for (uint32_t l = 0; l < m_isls.size (); l++)
+        {
+          m_isls[l].channel->SetDelay (GetDelay (m_isls[l].a, m_isls[l].b, now));
+        }
+    }
+
+  std::vector<uint32_t> serving;
+  AssignGroundStations (serving);
+  bool changed = false;
+  for (uint32_t i = 0; i < serving.size (); i++)
+    {
+      uint32_t station = i/m_shells.size ();
+      Time delay = GetDelay (nSatellites + station, serving[i], now);
+      if (serving[i] != m_serving[i])
+        {
+          NS_LOG_LOGIC ("Ground station " << station << " hands over from satellite " << m_serving[i]
+                                          << " to " << serving[i]);
+          m_groundChannels[i]->Rebind (m_satelliteGroundDevices.Get (serving[i])->GetObject<PointToPointNetDevice> ());
+          m_handoverTrace (station, i%m_shells.size (), m_serving[i], serving[i]);
+          changed = true;
+        }
+      if (!m_continuousDelays)
+        {
+          m_groundChannels[i]->SetDelay (delay);
+        }
+    }
+  m_serving.swap (serving);
+  if (changed)
+    {
+      ComputeRouting ();
+    }
+}
+
+void
+LeoConstellation::EnableContinuousDelays (Time refresh)
+{
+  NS_ABORT_MSG_IF (!m_built, "Constellation not built");
+  NS_ABORT_MSG_IF (refresh.IsNegative (), "Bad refresh period of the delays");
+  m_continuousDelays = true;
+  std::vector<Ptr<ReconfigurablePointToPointChannel> > channels (m_groundChannels);
+  for (uint32_t l = 0; l < m_isls.size (); l++)
+    {
+      channels.push_back (m_isls[l].channel);
+    }
+  for (uint32_t i = 0; i < channels.size (); i++)
+    {
+      channels[i]->SetAttribute ("DelayRefresh", TimeValue (refresh));
+      channels[i]->SetDelayCallback (MakeCallback (&LeoConstellation::GetLinkDelay, this));
+    }
+}
+
+uint32_t
+LeoConstellation::GetNShells (void) const
+{
+  return m_shells.size ();
+}
+
+const LeoShell &
+LeoConstellation::GetShell (uint32_t shell) const
+{
+  NS_ASSERT (shell < m_shells.size ());
+  return m_shells[shell];
+}
+
+NodeContainer
+LeoConstellation::GetSatellites (void) const
+{
+  return m_satellites;
+}
+
+Ptr<Node>
+LeoConstellation::GetSatellite (uint32_t shell, uint32_t plane, uint32_t index) const
+{
+  NS_ASSERT (shell < m_shells.size () && plane < m_shells[shell].planes && index < m_shells[shell].satellitesPerPlane);
+  return m_satellites.Get (m_firstSatellite[shell] + plane*m_shells[shell].satellitesPerPlane + index);
+}
+
+NodeContainer
+LeoConstellation::GetGroundStations (void) const
+{
+  return m_groundStations;
+}
+
+Ipv4Address
+LeoConstellation::GetGroundStationAddress (uint32_t station) const
+{
+  NS_ASSERT (station < m_groundStations.GetN ());
+  return GetAddress (m_groundDevices.Get (station*m_shells.size ()));
+}
+
+uint32_t
+LeoConstellation::GetServingSatellite (uint32_t station, uint32_t shell) const
+{
+  NS_ASSERT (station < m_groundStations.GetN () && shell < m_shells.size ());
+  return m_serving[station*m_shells.size () + shell];
+}
+
+Ptr<LeoConstellationPropagator>
+LeoConstellation::GetPropagator (void) const
+{
+  return m_propagator;
+}
+
+Ptr<LeoVisibilityService>
+LeoConstellation::GetVisibilityService (void) const
+{
+  return m_visibility;
+}
+
+Ptr<LeoSnapshotRoutingTable>
+LeoConstellation::GetRoutingTable (void) const
+{
+  return m_routing;
+}
+
+} // namespace ns3
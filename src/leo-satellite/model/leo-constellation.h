@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Constellation builder
+ * Builds constellations of several shells of inclined Walker orbits, with
+ * any number of ground stations
+ */
+#ifndef LEO_CONSTELLATION_H
+#define LEO_CONSTELLATION_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/traced-callback.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/reconfigurable-point-to-point-channel.h"
+#include "ns3/leo-constellation-propagator.h"
+#include "ns3/leo-visibility-service.h"
+#include "ns3/leo-snapshot-routing.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief A shell of a constellation: a Walker pattern of circular orbits
+ * at one altitude and inclination
+ */
+struct LeoShell
+{
+  double altitude;              //!< altitude of the orbits [km]
+  double inclination;           //!< inclination of the orbits [degrees]
+  uint32_t planes;              //!< number of orbital planes
+  uint32_t satellitesPerPlane;  //!< number of satellites per plane
+  uint32_t phasing;             //!< Walker phasing factor, in [0, planes)
+  double spread;                //!< span of the ascending nodes: 360 for a delta, 180 for a star [degrees]
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief Builder of constellations of several shells of inclined orbits.
+ *
+ * Each shell is a Walker pattern i:T/P/F: the P planes have their
+ * ascending nodes evenly spread over 360 degrees (delta) or 180 degrees
+ * (star), and satellite j of plane p has the argument of latitude
+ * 360 j/S + 360 F p/T at time zero. The satellites of a shell are linked
+ * in a +Grid: to their two neighbors in the plane, and to the satellite of
+ * the same index in the two adjacent planes, which keep the same phase
+ * offset. The planes of a delta shell close the grid, the last plane
+ * linking to the satellite F indexes further in the first one, the seam of
+ * a star is not crossed.
+ *
+ * Each ground station has one link per shell, to the closest satellite of
+ * the shell above the elevation mask of the visibility service, or to the
+ * closest satellite of the shell if none is above the mask. A satellite
+ * serves one ground station at a time, the ground stations choosing in
+ * turn. UpdateLinks follows the movement of the satellites: it hands the
+ * ground stations over and updates the delays of all the links, unless
+ * EnableContinuousDelays is called.
+ *
+ * The nodes are routed with one LeoSnapshotRoutingTable over the whole
+ * constellation, recomputed when a ground station is handed over, instead
+ * of the global routing. Its tables only hold the routes towards the
+ * ground stations, unless RouteToSatellites is set. Build installs the stack on all the nodes at
+ * once, without IPv6 nor global routing, and numbers the links of each
+ * shell from one /16, so that constellations of thousands of satellites
+ * are set up in seconds.
+ */
+class LeoConstellation : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LeoConstellation ();
+  virtual ~LeoConstellation ();
+
+  /**
+   * Add a shell, before Build
+   * \param shell the shell
+   * \return the index of the shell
+   */
+  uint32_t AddShell (const LeoShell &shell);
+  /**
+   * Add a Walker delta shell i:T/P/F, before Build
+   * \param altitude altitude of the orbits [km]
+   * \param inclination inclination of the orbits [degrees]
+   * \param planes number of orbital planes
+   * \param satellitesPerPlane number of satellites per plane
+   * \param phasing Walker phasing factor, in [0, planes)
+   * \return the index of the shell
+   */
+  uint32_t AddWalkerDelta (double altitude, double inclination, uint32_t planes, uint32_t satellitesPerPlane, uint32_t phasing);
+  /**
+   * Add a ground station, before Build
+   * \param latitude latitude [degrees]
+   * \param longitude longitude [degrees]
+   * \return the index of the ground station
+   */
+  uint32_t AddGroundStation (double latitude, double longitude);
+
+  /**
+   * Create the nodes, the links and the routing of the shells and ground
+   * stations added
+   */
+  void Build (void);
+  /**
+   * Move the links to the current positions of the satellites
+   */
+  void UpdateLinks (void);
+  /**
+   * Compute the delays of the links from the positions of their ends when
+   * a transmission starts, instead of at each UpdateLinks
+   * \param refresh period of the computations of the delay of a link, zero
+   * for each transmission
+   */
+  void EnableContinuousDelays (Time refresh);
+
+  /**
+   * \return the number of shells
+   */
+  uint32_t GetNShells (void) const;
+  /**
+   * \param shell a shell
+   * \return its parameters
+   */
+  const LeoShell & GetShell (uint32_t shell) const;
+  /**
+   * \return the satellites of all the shells, shell by shell, plane by plane
+   */
+  NodeContainer GetSatellites (void) const;
+  /**
+   * \param shell a shell
+   * \param plane a plane of the shell
+   * \param index a satellite of the plane
+   * \return the satellite
+   */
+  Ptr<Node> GetSatellite (uint32_t shell, uint32_t plane, uint32_t index) const;
+  /**
+   * \return the ground stations
+   */
+  NodeContainer GetGroundStations (void) const;
+  /**
+   * \param station a ground station
+   * \return the address of its link to the first shell
+   */
+  Ipv4Address GetGroundStationAddress (uint32_t station) const;
+  /**
+   * \param station a ground station
+   * \param shell a shell
+   * \return the satellite serving the ground station in the shell, as an
+   * index in GetSatellites
+   */
+  uint32_t GetServingSatellite (uint32_t station, uint32_t shell) const;
+
+  /**
+   * \return the positions of the satellites
+   */
+  Ptr<LeoConstellationPropagator> GetPropagator (void) const;
+  /**
+   * \return the satellites seen by the ground stations, whose attributes
+   * can be set before Build
+   */
+  Ptr<LeoVisibilityService> GetVisibilityService (void) const;
+  /**
+   * \return the routing tables, 0 before Build
+   */
+  Ptr<LeoSnapshotRoutingTable> GetRoutingTable (void) const;
+
+  /**
+   * TracedCallback signature for the handovers
+   * \param [in] station the ground station
+   * \param [in] shell the shell of its link
+   * \param [in] oldSatellite the satellite serving it before
+   * \param [in] newSatellite the satellite serving it now
+   */
+  typedef void (* HandoverTracedCallback)(uint32_t station, uint32_t shell, uint32_t oldSatellite, uint32_t newSatellite);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief A link between two nodes
+   */
+  struct Link
+  {
+    uint32_t a;                                   //!< node at the first end
+    uint32_t b;                                   //!< node at the second end
+    Ptr<ReconfigurablePointToPointChannel> channel; //!< the channel
+  };
+
+  /**
+   * Create the satellites of a shell in the propagator
+   * \param shell the shell
+   */
+  void CreateOrbits (const LeoShell &shell);
+  /**
+   * Link two satellites
+   * \param helper the helper of the links
+   * \param a a satellite
+   * \param b another satellite
+   */
+  void AddIsl (PointToPointHelper &helper, uint32_t a, uint32_t b);
+  /**
+   * The ground stations take in turn the closest free satellite of each
+   * shell
+   * \param serving receives the satellite serving each ground station in
+   * each shell, at station * number of shells + shell
+   */
+  void AssignGroundStations (std::vector<uint32_t> &serving);
+  /**
+   * \param a a node
+   * \param b another node
+   * \param t the time
+   * \return the propagation delay between the nodes
+   */
+  Time GetDelay (uint32_t a, uint32_t b, Time t) const;
+  /**
+   * \param a the device at one end of a link
+   * \param b the device at the other end
+   * \param t the time
+   * \return the propagation delay of the link
+   */
+  Time GetLinkDelay (Ptr<PointToPointNetDevice> a, Ptr<PointToPointNetDevice> b, Time t) const;
+  /**
+   * Compute the routing tables of the current links
+   */
+  void ComputeRouting (void);
+  /**
+   * \param device a device
+   * \return its address
+   */
+  Ipv4Address GetAddress (Ptr<NetDevice> device) const;
+
+  std::vector<LeoShell> m_shells;               //!< the shells
+  std::vector<uint32_t> m_firstSatellite;       //!< first satellite of each shell
+  std::vector<Vector> m_stations;               //!< position of each ground station
+  DataRate m_islRate;                           //!< data rate of the inter-satellite links
+  DataRate m_groundRate;                        //!< data rate of the ground links
+  bool m_routeToSatellites;                     //!< whether the satellites are destinations of the routing
+  bool m_continuousDelays;                      //!< whether the channels compute their delays
+  bool m_built;                                 //!< whether Build was called
+
+  Ptr<LeoConstellationPropagator> m_propagator; //!< positions of the satellites
+  Ptr<LeoVisibilityService> m_visibility;       //!< satellites seen by the ground stations
+  Ptr<LeoSnapshotRoutingTable> m_routing;       //!< routing tables of the current links
+  std::vector<Ptr<LeoSnapshotRouting> > m_protocols; //!< routing protocol of each node
+
+  NodeContainer m_satellites;                   //!< the satellites, in the order of the propagator
+  NodeContainer m_groundStations;               //!< the ground stations
+  std::vector<Link> m_isls;                     //!< the inter-satellite links
+  NetDeviceContainer m_satelliteGroundDevices;  //!< ground device of each satellite
+  NetDeviceContainer m_groundDevices;           //!< device of each ground station towards each shell
+  std::vector<Ptr<ReconfigurablePointToPointChannel> > m_groundChannels; //!< channel of each ground device
+  std::vector<uint32_t> m_serving;              //!< satellite serving each ground device
+  TracedCallback<uint32_t, uint32_t, uint32_t, uint32_t> m_handoverTrace; //!< handovers
+};
+
+} // namespace ns3
+
+#endif /* LEO_CONSTELLATION_H */
@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Inter-plane link topology
+ * Keeps track of which satellites of adjacent planes are linked, and of the delay of the links
+ */
+
+#include "leo-isl-topology.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/nstime.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoIslTopology");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoIslTopology);
+
+extern double speed_of_light;
+
+/**
+ * \param angle an angle [degrees]
+ * \return the angle in [-180, 180)
+ */
+static double
+WrapAngle (double angle)
+{
+  return angle - 360*std::floor ((angle + 180)/360);
+}
+
+TypeId
+LeoIslTopology::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoIslTopology")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoIslTopology> ()
+    .AddAttribute ("DelayTolerance",
+                   "Smallest change of the delay of a link reported by an update.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LeoIslTopology::m_tolerance),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+LeoIslTopology::LeoIslTopology ()
+{
+}
+
+LeoIslTopology::~LeoIslTopology ()
+{
+}
+
+void
+LeoIslTopology::SetPropagator (Ptr<LeoConstellationPropagator> propagator)
+{
+  m_propagator = propagator;
+}
+
+void
+LeoIslTopology::AddPlane (const std::vector<uint32_t> &satellites)
+{
+  NS_ASSERT (m_propagator != 0);
+  NS_ABORT_MSG_IF (satellites.size () < 2, "A plane needs two satellites");
+  NS_ABORT_MSG_IF (!m_planes.empty () && satellites.size () != m_planes[0].size (),
+                   "All the planes must have the same number of satellites");
+  uint32_t n = satellites.size ();
+  // the satellites are found from their phase if they are evenly spaced on
+  // the same orbit, else by searching the plane
+  double spacing = WrapAngle (m_propagator->GetPhase (satellites[1], Seconds (0))
+                              - m_propagator->GetPhase (satellites[0], Seconds (0)));
+  bool uniform = std::abs (std::abs (spacing)*n - 360) < 1e-6;
+  for (uint32_t j = 0; j < n && uniform; j++)
+    {
+      double offset = WrapAngle (m_propagator->GetPhase (satellites[j], Seconds (0))
+                                 - m_propagator->GetPhase (satellites[0], Seconds (0)) - j*spacing);
+      uniform = std::abs (offset) < 1e-6
+        && m_propagator->GetAngularRate (satellites[j]) == m_propagator->GetAngularRate (satellites[0])
+        && m_propagator->GetAscendingLongitude (satellites[j]) == m_propagator->GetAscendingLongitude (satellites[0]);
+    }
+  NS_LOG_LOGIC ("plane " << m_planes.size () << (uniform ? " evenly spaced" : " searched"));
+  m_planes.push_back (satellites);
+  m_spacing.push_back (uniform ? spacing : 0);
+  m_links.push_back (std::vector<LeoIslLink> (n));
+}
+
+uint32_t
+LeoIslTopology::GetNPlanes (void) const
+{
+  return m_planes.size ();
+}
+
+const LeoIslLink &
+LeoIslTopology::GetLink (uint32_t plane, uint32_t satellite) const
+{
+  NS_ASSERT (plane < m_links.size () && satellite < m_links[plane].size ());
+  return m_links[plane][satellite];
+}
+
+uint32_t
+LeoIslTopology::GetNext (uint32_t plane, uint32_t k) const
+{
+  // the last plane is linked to the first one in reverse order
+  if (plane == m_planes.size () - 1)
+    {
+      return m_planes[0][m_planes[0].size () - k - 1];
+    }
+  return m_planes[plane + 1][k];
+}
+
+uint32_t
+LeoIslTopology::FindSlot (uint32_t plane, double phase, Time t) const
+{
+  int32_t n = m_planes[plane].size ();
+  double first = m_propagator->GetPhase (m_planes[plane][0], t);
+  int32_t k = std::lround (WrapAngle (phase - first)/m_spacing[plane]);
+  return ((k % n) + n) % n;
+}
+
+void
+LeoIslTopology::Measure (LeoIslLink &link) const
+{
+  uint32_t next = (link.plane + 1) % m_planes.size ();
+  link.distance = CalculateDistance (m_positions[m_planes[link.plane][link.satellite]],
+                                     m_positions[m_planes[next][link.peer]]);
+  link.delay = Seconds ((link.distance*1000)/speed_of_light);
+}
+
+void
+LeoIslTopology::Start (Time t)
+{
+  NS_LOG_FUNCTION (this << t);
+  m_propagator->GetPositions (t, m_positions);
+  uint32_t nPlanes = m_planes.size ();
+  for (uint32_t i = 0; i < nPlanes; i++)
+    {
+      uint32_t n = m_planes[i].size ();
+      for (uint32_t j = 0; j < n; j++)
+        {
+          LeoIslLink &link = m_links[i][j];
+          link.plane = i;
+          link.satellite = j;
+          link.peer = (i == nPlanes - 1) ? n - j - 1 : j;
+          link.oldPeer = link.peer;
+          Measure (link);
+        }
+    }
+  m_delta.time = t;
+  m_delta.changed.clear ();
+  m_delta.updated.clear ();
+}
+
+const LeoIslDelta &
+LeoIslTopology::Update (Time t)
+{
+  NS_LOG_FUNCTION (this << t);
+  m_propagator->GetPositions (t, m_positions);
+  m_delta.time = t;
+  m_delta.changed.clear ();
+  m_delta.updated.clear ();
+
+  uint32_t nPlanes = m_planes.size ();
+  for (uint32_t i = 0; i < nPlanes; i++)
+    {
+      const std::vector<uint32_t> &plane = m_planes[i];
+      uint32_t n = plane.size ();
+      uint32_t nextPlane = (i + 1) % nPlanes;
+      bool reversed = (i == nPlanes - 1);
+
+      // reference satellite (closest to the equator): one of the satellites
+      // closest to the phases of the equator crossings
+      std::vector<uint32_t> candidates;
+      if (m_spacing[i] != 0)
+        {
+          uint32_t north = FindSlot (i, 0, t);
+          uint32_t south = FindSlot (i, 180, t);
+          for (uint32_t d = n - 1; d <= n + 1; d++)
+            {
+              candidates.push_back ((north + d) % n);
+              candidates.push_back ((south + d) % n);
+            }
+        }
+      else
+        {
+          for (uint32_t j = 0; j < n; j++)
+            {
+              candidates.push_back (j);
+            }
+        }
+      std::sort (candidates.begin (), candidates.end ());
+      uint32_t refSat = candidates[0];
+      for (uint32_t c = 1; c < candidates.size (); c++)
+        {
+          if (std::abs (m_positions[plane[candidates[c]]].x) < std::abs (m_positions[plane[refSat]].x))
+            {
+              refSat = candidates[c];
+            }
+        }
+      Vector refSatPos = m_positions[plane[refSat]];
+
+      // closest adjacent satellite: one of the satellites closest to the
+      // latitude of the reference satellite, on its side of the next plane
+      candidates.clear ();
+      if (m_spacing[nextPlane] != 0)
+        {
+          double ascending = m_propagator->GetAscendingLongitude (m_planes[nextPlane][0]);
+          double phase = (std::abs (WrapAngle (refSatPos.y - ascending)) < 90) ? refSatPos.x : 180 - refSatPos.x;
+          uint32_t slot = FindSlot (nextPlane, phase, t);
+          uint32_t k = reversed ? n - slot - 1 : slot;
+          for (uint32_t d = n - 1; d <= n + 1; d++)
+            {
+              candidates.push_back ((k + d) % n);
+            }
+        }
+      else
+        {
+          for (uint32_t k = 0; k < n; k++)
+            {
+              candidates.push_back (k);
+            }
+        }
+      std::sort (candidates.begin (), candidates.end ());
+      uint32_t closestAdjSat = candidates[0];
+      double closestAdjSatDist = CalculateDistance (refSatPos, m_positions[GetNext (i, closestAdjSat)]);
+      for (uint32_t c = 1; c < candidates.size (); c++)
+        {
+          double dist = CalculateDistance (refSatPos, m_positions[GetNext (i, candidates[c])]);
+          if (dist < closestAdjSatDist)
+            {
+              closestAdjSatDist = dist;
+              closestAdjSat = candidates[c];
+            }
+        }
+      NS_LOG_LOGIC ("plane " << i << ": satellite " << refSat << " closest to the equator, closest to satellite "
+                             << closestAdjSat << " of plane " << nextPlane);
+
+      // the other satellites of the plane are shifted by the same number of satellites
+      uint32_t ref_incr = (closestAdjSat + n - refSat) % n;
+      for (uint32_t j = 0; j < n; j++)
+        {
+          LeoIslLink &link = m_links[i][j];
+          Time oldDelay = link.delay;
+          uint32_t next = (j + ref_incr) % n;
+          link.oldPeer = link.peer;
+          link.peer = reversed ? n - next - 1 : next;
+          Measure (link);
+          if (link.peer != link.oldPeer)
+            {
+              m_delta.changed.push_back (link);
+            }
+          else if (Abs (link.delay - oldDelay) > m_tolerance)
+            {
+              m_delta.updated.push_back (link);
+            }
+        }
+    }
+  NS_LOG_INFO (t.GetSeconds () << ": " << m_delta.changed.size () << " inter-plane links changed, "
+                               << m_delta.updated.size () << " delays changed");
+  return m_delta;
+}
+
+} // namespace ns3
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Inter-plane link topology
+ * Keeps track of which satellites of adjacent planes are linked, and of the delay of the links
+ */
+#ifndef LEO_ISL_TOPOLOGY_H
+#define LEO_ISL_TOPOLOGY_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/leo-constellation-propagator.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief An inter-plane link, from a satellite to a satellite of the next plane
+ */
+struct LeoIslLink
+{
+  uint32_t plane;      //!< plane of the satellite
+  uint32_t satellite;  //!< index of the satellite in its plane
+  uint32_t oldPeer;    //!< index of the peer in the next plane before the update
+  uint32_t peer;       //!< index of the peer in the next plane
+  double distance;     //!< length of the link [km]
+  Time delay;          //!< propagation delay of the link
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief The changes of the inter-plane links at an update
+ */
+struct LeoIslDelta
+{
+  Time time;                          //!< time of the update
+  std::vector<LeoIslLink> changed;    //!< links with a new peer
+  std::vector<LeoIslLink> updated;    //!< links with the same peer and a new delay
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief Inter-plane links of a constellation of polar planes.
+ *
+ * Each satellite of a plane is linked to a satellite of the next plane,
+ * the last plane being linked to the first one in reverse order. At each
+ * update, the satellite of a plane closest to the equator is linked to the
+ * closest satellite of the next plane, and the other satellites of the
+ * plane to the satellites of the next plane with the same shift of index.
+ *
+ * When the satellites of a plane are evenly spaced on their orbit, the
+ * satellite closest to the equator and its closest neighbor are found
+ * from the orbital phases of the first satellites of the planes, checking
+ * the distance of a few candidates only, instead of searching the planes.
+ * The other planes (the halves of a plane of LeoSatelliteConfig move in
+ * the same direction when the number of planes is even) are searched.
+ * The positions of all the satellites are computed in one pass by the
+ * LeoConstellationPropagator. An update returns the links which changed of
+ * peer and the links whose delay changed by more than DelayTolerance.
+ */
+class LeoIslTopology : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LeoIslTopology ();
+  virtual ~LeoIslTopology ();
+
+  /**
+   * \param propagator the propagator of the satellites
+   */
+  void SetPropagator (Ptr<LeoConstellationPropagator> propagator);
+  /**
+   * Add a plane, linked to the previous plane added
+   * \param satellites the indexes in the propagator of the satellites of
+   * the plane, in the order of the plane
+   */
+  void AddPlane (const std::vector<uint32_t> &satellites);
+  /**
+   * Link each satellite to the satellite of the next plane with the same
+   * index, and compute the delays of the links
+   * \param t the time
+   */
+  void Start (Time t);
+  /**
+   * Find the peers of the satellites and the delays of the links
+   * \param t the time
+   * \return the changes since the last update
+   */
+  const LeoIslDelta & Update (Time t);
+
+  /**
+   * \return the number of planes
+   */
+  uint32_t GetNPlanes (void) const;
+  /**
+   * \param plane a plane
+   * \param satellite the index of a satellite in the plane
+   * \return the link of the satellite to the next plane
+   */
+  const LeoIslLink & GetLink (uint32_t plane, uint32_t satellite) const;
+
+private:
+  /**
+   * \param plane a plane
+   * \param k index of a satellite in the next plane, in the order of the plane
+   * \return the index of the satellite in the propagator
+   */
+  uint32_t GetNext (uint32_t plane, uint32_t k) const;
+  /**
+   * \param plane a plane
+   * \param phase an orbital phase [degrees]
+   * \param t the time
+   * \return the index of the satellite of the plane closest to the phase
+   */
+  uint32_t FindSlot (uint32_t plane, double phase, Time t) const;
+  /**
+   * Compute the length and the delay of a link
+   * \param link the link
+   */
+  void Measure (LeoIslLink &link) const;
+
+  Ptr<LeoConstellationPropagator> m_propagator;   //!< the positions
+  std::vector<std::vector<uint32_t> > m_planes;   //!< the satellites of the planes
+  std::vector<double> m_spacing;                  //!< phase from a satellite to the next one in each plane, 0 if searched
+  std::vector<std::vector<LeoIslLink> > m_links;  //!< the link of each satellite
+  std::vector<Vector> m_positions;                //!< positions of the satellites at the update
+  LeoIslDelta m_delta;                            //!< changes of the last update
+  Time m_tolerance;                               //!< smallest delay change reported
+};
+
+} // namespace ns3
+
+#endif /* LEO_ISL_TOPOLOGY_H */
@@ -9,15 +9,12 @@
  */
 
 #include "leo-satellite-config.h"
-#include "ns3/quic-l4-protocol.h"
 
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteConfig);
 NS_LOG_COMPONENT_DEFINE ("LeoSatelliteConfig");
 
-extern double CalculateDistanceGroundToSat (const Vector &a, const Vector &b);
-
 double speed_of_light = 299792458; //in m/s
 
 //typeid
@@ -26,6 +23,18 @@ TypeId LeoSatelliteConfig::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::LeoSatelliteConfig")
   .SetParent<Object> ()
   .SetGroupName("LeoSatellite")
+  .AddTraceSource ("IslDelta",
+                   "The inter-plane links which changed of peer or of delay at UpdateLinks.",
+                   MakeTraceSourceAccessor (&LeoSatelliteConfig::m_islTrace),
+                   "ns3::LeoSatelliteConfig::IslDeltaTracedCallback")
+  .AddTraceSource ("Handover",
+                   "A ground station moves to another satellite, traced when predicted with the handover events.",
+                   MakeTraceSourceAccessor (&LeoSatelliteConfig::m_handoverTrace),
+                   "ns3::LeoSatelliteConfig::HandoverTracedCallback")
+  .AddTraceSource ("GroundDelay",
+                   "The delay of the link of a ground station was set.",
+                   MakeTraceSourceAccessor (&LeoSatelliteConfig::m_groundDelayTrace),
+                   "ns3::LeoSatelliteConfig::GroundDelayTracedCallback")
   ;
   return tid;
 }
@@ -40,24 +49,42 @@ TypeId LeoSatelliteConfig::GetInstanceTypeId (void) const
   return tid;
 }
 
+Ptr<LeoIslTopology> LeoSatelliteConfig::GetIslTopology () const
+{
+  return this->m_isl;
+}
+
+Ptr<LeoSnapshotRoutingTable> LeoSatelliteConfig::GetSnapshotRouting () const
+{
+  return this->m_routing;
+}
+
+Ptr<LeoVisibilityService> LeoSatelliteConfig::GetVisibilityService () const
+{
+  return this->m_visibility;
+}
+
 //constructor
 LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satellites_per_plane, double altitude)
 {
   this->num_planes = num_planes;
   this->num_satellites_per_plane = num_satellites_per_plane;
   this->m_altitude = altitude;
+  this->m_continuousDelays = false;
 
   uint32_t total_num_satellites = num_planes*num_satellites_per_plane;
   NodeContainer temp;
   temp.Create(total_num_satellites);
 
-  //assign mobility model to all satellites
+  //assign mobility model to all satellites, all computed by the same propagator
+  this->m_propagator = CreateObject<LeoConstellationPropagator> ();
   MobilityHelper mobility;
   mobility.SetMobilityModel ("ns3::LeoSatelliteMobilityModel",
                              "NPerPlane", IntegerValue (num_satellites_per_plane),
                              "NumberofPlanes", IntegerValue (num_planes),
                              "Altitude", DoubleValue(altitude),
-                             "Time", DoubleValue(Simulator::Now().GetSeconds()));
+                             "Time", DoubleValue(Simulator::Now().GetSeconds()),
+                             "Propagator", PointerValue(this->m_propagator));
   mobility.Install(temp);
   
   for (NodeContainer::Iterator j = temp.Begin ();
@@ -91,6 +118,26 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
      this->plane.push_back(temp_plane);
   }
 
+  //the inter-plane links follow the orbital phases of the satellites
+  this->m_isl = CreateObject<LeoIslTopology> ();
+  this->m_isl->SetPropagator(this->m_propagator);
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    std::vector<uint32_t> satellites;
+    for (uint32_t j=0; j<num_satellites_per_plane; j++)
+    {
+      satellites.push_back(this->plane[i].Get(j)->GetObject<LeoSatelliteMobilityModel>()->GetPropagatorIndex());
+    }
+    this->m_isl->AddPlane(satellites);
+    this->satellite_propagator_index.insert(this->satellite_propagator_index.end(), satellites.begin(), satellites.end());
+  }
+  this->m_isl->Start(Simulator::Now());
+  this->propagator_satellite_index.resize(this->m_propagator->GetN());
+  for (uint32_t k=0; k<total_num_satellites; k++)
+  {
+    this->propagator_satellite_index[this->satellite_propagator_index[k]] = k;
+  }
+
   //setting up all intraplane links
   Vector nodeAPosition = this->plane[0].Get(0)->GetObject<MobilityModel>()->GetPosition();
   Vector nodeBPosition = this->plane[0].Get(1)->GetObject<MobilityModel>()->GetPosition();
@@ -111,47 +158,39 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
     }
   }
 
-  //setting up interplane links
+  //setting up interplane links, each satellite has one device towards each
+  //adjacent plane and its channel to the next plane is rebound when the peer changes
   std::cout<<"Setting up inter-plane links"<<std::endl;
+  PointToPointHelper interplane_link_helper;
+  interplane_link_helper.SetDeviceAttribute ("DataRate", StringValue ("5.36Gbps"));
+  std::vector<Ptr<NetDevice>> peer_devices (total_num_satellites);
   for (uint32_t i=0; i<num_planes; i++)
   {
     for (uint32_t j=0; j<num_satellites_per_plane; j++)
     {
-      uint32_t nodeBIndex;
-      (i == num_planes - 1) ? nodeBIndex = num_satellites_per_plane - j - 1: nodeBIndex = j;
-      Vector nodeAPos = this->plane[i].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      Vector nodeBPos = this->plane[(i+1)%num_planes].Get(nodeBIndex)->GetObject<MobilityModel>()->GetPosition();
-      double distance = CalculateDistance(nodeAPos, nodeBPos);
-      double delay = (distance*1000)/speed_of_light;
-      CsmaHelper interplane_link_helper;
-      interplane_link_helper.SetChannelAttribute("DataRate", StringValue ("5.36Gbps"));
+      const LeoIslLink &link = this->m_isl->GetLink(i, j);
+      uint32_t nodeBIndex = link.peer;
+      double distance = link.distance;
+      double delay = link.delay.GetSeconds();
       interplane_link_helper.SetChannelAttribute("Delay", TimeValue(Seconds(delay)));
 
       std::cout<<"Channel open between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nodeBIndex<< " with distance "<<distance<< "km and delay of "<<delay<<" seconds"<<std::endl;
 
-      NodeContainer temp_node_container;
-      temp_node_container.Add(this->plane[i].Get(j));
-      temp_node_container.Add(this->plane[(i+1)%num_planes]);
       NetDeviceContainer temp_netdevice_container;
-      temp_netdevice_container = interplane_link_helper.Install(temp_node_container);
-      Ptr<CsmaChannel> csma_channel;
-      Ptr<Channel> channel;
-      channel = temp_netdevice_container.Get(0)->GetChannel();
-      csma_channel = channel->GetObject<CsmaChannel> ();
-      
-      for (uint32_t k=0; k<num_satellites_per_plane; k++)
-      {
-        if (j != k)
-        {
-          csma_channel->Detach(temp_netdevice_container.Get(k+1)->GetObject<CsmaNetDevice> ());
-        }
-      }
-        
-      this->inter_plane_devices.push_back(temp_netdevice_container);
-      this->inter_plane_channels.push_back(csma_channel);
+      temp_netdevice_container = interplane_link_helper.InstallReconfigurable(this->plane[i].Get(j), this->plane[(i+1)%num_planes].Get(nodeBIndex));
+      Ptr<ReconfigurablePointToPointChannel> channel;
+      channel = temp_netdevice_container.Get(0)->GetChannel()->GetObject<ReconfigurablePointToPointChannel> ();
+
+      this->inter_plane_devices.Add(temp_netdevice_container.Get(0));
+      peer_devices[((i+1)%num_planes)*num_satellites_per_plane + nodeBIndex] = temp_netdevice_container.Get(1);
+      this->inter_plane_channels.push_back(channel);
       this->inter_plane_channel_tracker.push_back(nodeBIndex);
     }
   }
+  for (uint32_t k=0; k<total_num_satellites; k++)
+  {
+    this->inter_plane_peer_devices.Add(peer_devices[k]);
+  }
 
   //setting up two ground stations for now
   std::cout << "Setting up two ground stations" << std::endl;
@@ -171,57 +210,39 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
     Vector temp = ground_stations.Get(j)->GetObject<MobilityModel> ()->GetPosition();
     std::cout << Simulator::Now().GetSeconds() << ": ground station # " << j << ": x = " << temp.x << ", y = " << temp.y << std::endl;
   }
-  //setting up links between ground stations and their closest satellites
-  std::cout<<"Setting links between ground stations and satellites"<<std::endl;
-  for (uint32_t i=0; i<2; i++)
-  {
-    Vector gndPos = ground_stations.Get(i)->GetObject<MobilityModel> ()->GetPosition();
-    uint32_t closestAdjSat = 0;
-    uint32_t closestAdjSatDist = 0;
-    uint32_t planeIndex;
-    if (i == 0)
-      planeIndex = 0;
-    else
-      planeIndex = floor(3*num_planes/7);
-    //find closest adjacent satellite for ground station
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
-    {
-      Vector pos = this->plane[planeIndex].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      double temp_dist = CalculateDistanceGroundToSat(gndPos,pos);
-      if((temp_dist < closestAdjSatDist) || (j==0))
-      {
-        closestAdjSatDist = temp_dist;
-        closestAdjSat = j;
-      }
-    }
-    double delay = (closestAdjSatDist*1000)/speed_of_light;
-    CsmaHelper ground_station_link_helper;
-    ground_station_link_helper.SetChannelAttribute("DataRate", StringValue ("5.36Gbps"));
-    ground_station_link_helper.SetChannelAttribute("Delay", TimeValue(Seconds(delay)));
-
-    std::cout<<"Channel open between ground station " << i << " and plane " << planeIndex << " satellite "<<closestAdjSat<<" with distance "<<closestAdjSatDist<< "km and delay of "<<delay<<" seconds"<<std::endl;
-
-    NodeContainer temp_node_container;
-    temp_node_container.Add(ground_stations.Get(i));
-    temp_node_container.Add(this->plane[planeIndex]);
-    NetDeviceContainer temp_netdevice_container;
-    temp_netdevice_container = ground_station_link_helper.Install(temp_node_container);
-    Ptr<CsmaChannel> csma_channel;
-    Ptr<Channel> channel;
-    channel = temp_netdevice_container.Get(0)->GetChannel();
-    csma_channel = channel->GetObject<CsmaChannel> ();
+  //the ground stations are served by the closest satellite above their elevation mask
+  this->m_visibility = CreateObject<LeoVisibilityService> ();
+  this->m_visibility->SetPropagator(this->m_propagator);
+  for (uint32_t i=0; i<ground_stations.GetN(); i++)
+  {
+    this->m_visibility->AddGroundStation(ground_stations.Get(i)->GetObject<MobilityModel> ()->GetPosition());
+  }
 
-    for (uint32_t k=0; k<num_satellites_per_plane; k++)
-    {
-      if (closestAdjSat != k)
-      {
-        csma_channel->Detach(temp_netdevice_container.Get(k+1)->GetObject<CsmaNetDevice> ());
-      }
-    }
-        
-    this->ground_station_devices.push_back(temp_netdevice_container);
-    this->ground_station_channels.push_back(csma_channel);
-    this->ground_station_channel_tracker.push_back(closestAdjSat);
+  //setting up links between ground stations and their closest satellites, each
+  //satellite has one ground device and the channel of a ground station is
+  //rebound to the device of its new satellite at a handover
+  std::cout<<"Setting links between ground stations and satellites"<<std::endl;
+  PointToPointHelper ground_station_link_helper;
+  ground_station_link_helper.SetDeviceAttribute("DataRate", StringValue ("5.36Gbps"));
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    this->satellite_ground_devices.Add(ground_station_link_helper.InstallDevices(this->plane[i]));
+  }
+  this->ground_station_devices = ground_station_link_helper.InstallDevices(ground_stations);
+  this->ground_station_channel_tracker.resize(ground_stations.GetN());
+  std::vector<double> distances;
+  AssignGroundStations(Simulator::Now(), std::vector<bool> (ground_stations.GetN(), true), this->ground_station_channel_tracker, distances);
+  for (uint32_t i=0; i<ground_stations.GetN(); i++)
+  {
+    uint32_t sat = this->ground_station_channel_tracker[i];
+    double delay = (distances[i]*1000)/speed_of_light;
+    Ptr<ReconfigurablePointToPointChannel> channel = CreateObject<ReconfigurablePointToPointChannel> ();
+    channel->SetDelay(Seconds(delay));
+    this->ground_station_devices.Get(i)->GetObject<PointToPointNetDevice> ()->Attach(channel);
+    this->satellite_ground_devices.Get(sat)->GetObject<PointToPointNetDevice> ()->Attach(channel);
+    this->ground_station_channels.push_back(channel);
+
+    std::cout<<"Channel open between ground station " << i << " and plane " << sat/num_satellites_per_plane << " satellite "<<sat%num_satellites_per_plane<<" with distance "<<distances[i]<< "km and delay of "<<delay<<" seconds"<<std::endl;
   }
 
   //Configure IP Addresses for all NetDevices
@@ -235,35 +256,54 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
     this->intra_plane_interfaces.push_back(address.Assign(this->intra_plane_devices[i]));
   }
   
-  //configuring IP Addresses for InterPlane devices
-  for(uint32_t i=0; i< this->inter_plane_devices.size(); i++)
+  //configuring IP Addresses for InterPlane devices, one network between each
+  //plane and the next one, which keeps holding the links when the peers change
+  for(uint32_t i=0; i< this->num_planes; i++)
   {
-    address.NewNetwork();
-    this->inter_plane_interfaces.push_back(address.Assign(this->inter_plane_devices[i]));
-    for(uint32_t j=1; j<= this->num_satellites_per_plane; j++)
+    NetDeviceContainer temp_netdevice_container;
+    uint32_t next = (i+1)%num_planes;
+    for(uint32_t j=0; j< this->num_satellites_per_plane; j++)
     {
-      if(j != this->inter_plane_channel_tracker[i] + 1)
-      {
-        std::pair< Ptr< Ipv4 >, uint32_t > interface = this->inter_plane_interfaces[i].Get(j);
-        interface.first->SetDown(interface.second);
-      }
+      temp_netdevice_container.Add(this->inter_plane_devices.Get(i*num_satellites_per_plane + j));
     }
+    for(uint32_t j=0; j< this->num_satellites_per_plane; j++)
+    {
+      temp_netdevice_container.Add(this->inter_plane_peer_devices.Get(next*num_satellites_per_plane + j));
+    }
+    address.NewNetwork();
+    this->inter_plane_interfaces.push_back(address.Assign(temp_netdevice_container));
   }
 
-  //configuring IP Addresses for Ground devices
-  for(uint32_t i=0; i< this->ground_station_devices.size(); i++)
+  //configuring IP Addresses for Ground devices, the ground interfaces of the
+  //satellites are down while they serve no ground station
+  std::vector<bool> serving (total_num_satellites, false);
+  for(uint32_t i=0; i< this->ground_station_channel_tracker.size(); i++)
   {
+    serving[this->ground_station_channel_tracker[i]] = true;
+  }
+  for(uint32_t i=0; i< this->num_planes; i++)
+  {
+    NetDeviceContainer temp_netdevice_container;
+    for(uint32_t j=0; j< this->num_satellites_per_plane; j++)
+    {
+      temp_netdevice_container.Add(this->satellite_ground_devices.Get(i*num_satellites_per_plane + j));
+    }
     address.NewNetwork();
-    this->ground_station_interfaces.push_back(address.Assign(this->ground_station_devices[i]));
-    for(uint32_t j=1; j<= this->num_satellites_per_plane; j++)
+    this->satellite_ground_interfaces.push_back(address.Assign(temp_netdevice_container));
+    for(uint32_t j=0; j< this->num_satellites_per_plane; j++)
     {
-      if(j != this->ground_station_channel_tracker[i] + 1)
+      if(!serving[i*num_satellites_per_plane + j])
       {
-        std::pair< Ptr< Ipv4 >, uint32_t > interface = this->ground_station_interfaces[i].Get(j);
+        std::pair< Ptr< Ipv4 >, uint32_t > interface = this->satellite_ground_interfaces[i].Get(j);
         interface.first->SetDown(interface.second);
       }
     }
   }
+  for(uint32_t i=0; i< this->ground_station_devices.GetN(); i++)
+  {
+    address.NewNetwork();
+    this->ground_station_interfaces.push_back(address.Assign(this->ground_station_devices.Get(i)));
+  }
 
   //Populate Routing Tables
   std::cout<<"Populating Routing Tables"<<std::endl;
@@ -271,156 +311,401 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
   std::cout<<"Finished Populating Routing Tables"<<std::endl;
 
   // Set up packet sniffing for entire network
-  /*CsmaHelper csma;
-  for (uint32_t i=0; i< this->inter_plane_devices.size(); i++)
+  /*PointToPointHelper p2p;
+  for (uint32_t i=0; i< this->inter_plane_devices.GetN(); i++)
   {
-    csma.EnablePcap("inter-sniff", this->inter_plane_devices[i].Get(1), true);
+    p2p.EnablePcap("inter-sniff", this->inter_plane_devices.Get(i), true);
   }
-  PointToPointHelper p2p;
   for(uint32_t i=0; i< this->intra_plane_devices.size(); i++)
   {
     p2p.EnablePcap("intra-sniff", this->intra_plane_devices[i].Get(1), true);
   }
-  for(uint32_t i=0; i< this->ground_station_devices.size(); i++)
+  for(uint32_t i=0; i< this->ground_station_devices.GetN(); i++)
   {
-    p2p.EnablePcap("ground-sniff", this->ground_station_devices[i].Get(1), true);
+    p2p.EnablePcap("ground-sniff", this->ground_station_devices.Get(i), true);
   }*/
 }
 
-void LeoSatelliteConfig::UpdateLinks()
+void LeoSatelliteConfig::AddRoutingLink (LeoRoutingGraph &graph, uint32_t a, uint32_t b, Ptr<NetDevice> device, Ipv4Address gateway) const
 {
-  std::cout<<std::endl<<std::endl<<std::endl<<"Updating Links"<<std::endl;
+  LeoRoutingLink link;
+  link.neighbor = b;
+  link.interface = device->GetNode()->GetObject<Ipv4>()->GetInterfaceForDevice(device);
+  link.gateway = gateway;
+  graph[a].push_back(link);
+}
+
+LeoRoutingGraph LeoSatelliteConfig::GetRoutingGraph (Ptr<LeoIslTopology> isl, const std::vector<uint32_t> &ground_sats) const
+{
+  //satellite j of plane i is node i*num_satellites_per_plane + j, the ground stations follow
+  uint32_t n = this->num_satellites_per_plane;
+  LeoRoutingGraph graph (num_planes*n + ground_stations.GetN());
 
-  std::vector<NodeContainer> update_links_plane = this->plane;
-  NodeContainer final_plane;
-  for(uint32_t j=0; j<num_satellites_per_plane; j++)
+  //intra-plane links
+  for (uint32_t i=0; i<num_planes; i++)
   {
-    final_plane.Add(this->plane[0].Get(num_satellites_per_plane - j - 1));
+    for (uint32_t j=0; j<n; j++)
+    {
+      uint32_t idx = i*n + j;
+      uint32_t next = i*n + (j+1)%n;
+      AddRoutingLink(graph, idx, next, this->intra_plane_devices[idx].Get(0), this->intra_plane_interfaces[idx].GetAddress(1));
+      AddRoutingLink(graph, next, idx, this->intra_plane_devices[idx].Get(1), this->intra_plane_interfaces[idx].GetAddress(0));
+    }
   }
-  update_links_plane.push_back(final_plane);
- 
-  for (uint32_t i=0; i<this->num_planes; i++)
+
+  //inter-plane links
+  for (uint32_t i=0; i<num_planes; i++)
   {
-    Vector refSatPos;
-    uint32_t refSat = 0;
-    //find reference satellite (closest to equator)
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+    for (uint32_t j=0; j<n; j++)
     {
-      Vector pos = update_links_plane[i].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      if ((std::abs(pos.x) < std::abs(refSatPos.x)) || j == 0)
-      {
-        refSatPos = pos;
-        refSat = j;
-      }
+      uint32_t peer = isl->GetLink(i, j).peer;
+      uint32_t idx = i*n + j;
+      uint32_t peer_idx = ((i+1)%num_planes)*n + peer;
+      AddRoutingLink(graph, idx, peer_idx, this->inter_plane_devices.Get(idx), this->inter_plane_interfaces[i].GetAddress(n + peer));
+      AddRoutingLink(graph, peer_idx, idx, this->inter_plane_peer_devices.Get(peer_idx), this->inter_plane_interfaces[i].GetAddress(j));
     }
+  }
+
+  //ground links
+  for (uint32_t i=0; i<ground_stations.GetN(); i++)
+  {
+    uint32_t idx = num_planes*n + i;
+    uint32_t sat_idx = ground_sats[i];
+    AddRoutingLink(graph, idx, sat_idx, this->ground_station_devices.Get(i), this->satellite_ground_interfaces[sat_idx/n].GetAddress(sat_idx%n));
+    AddRoutingLink(graph, sat_idx, idx, this->satellite_ground_devices.Get(sat_idx), this->ground_station_interfaces[i].GetAddress(0));
+  }
+  return graph;
+}
+
+void LeoSatelliteConfig::EnableSnapshotRouting (Time interval, Time horizon)
+{
+  NS_ABORT_MSG_IF (this->m_routing != 0, "Snapshot routing already enabled");
+  NS_ABORT_MSG_IF (interval <= Seconds(0) || horizon < interval, "Bad interval or horizon of the snapshots");
+  this->m_routing = CreateObject<LeoSnapshotRoutingTable> ();
 
-    //find the closest adjacent satellite to the reference satellite
-    uint32_t closestAdjSat = 0;
-    double closestAdjSatDist = 0;
-    Vector adjPos; //debug
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+  NodeContainer nodes;
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    nodes.Add(this->plane[i]);
+  }
+  nodes.Add(ground_stations);
+  for (uint32_t k=0; k<nodes.GetN(); k++)
+  {
+    Ptr<Ipv4> ipv4 = nodes.Get(k)->GetObject<Ipv4>();
+    for (uint32_t i=1; i<ipv4->GetNInterfaces(); i++)
     {
-      Vector pos = update_links_plane[i+1].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      double temp_dist = CalculateDistance(refSatPos,pos);
-      if((temp_dist < closestAdjSatDist) || (j==0))
+      for (uint32_t a=0; a<ipv4->GetNAddresses(i); a++)
       {
-        closestAdjSatDist = temp_dist;
-        closestAdjSat = j;
-        adjPos = pos; //debug
+        this->m_routing->AddAddress(ipv4->GetAddress(i, a).GetLocal(), k);
       }
     }
+  }
 
-    //calculate the reference increment factor for adjacent satellites in a plane
-    uint32_t ref_incr;
-    (refSat <= closestAdjSat) ? (ref_incr = closestAdjSat - refSat) : (ref_incr = this->num_satellites_per_plane - refSat + closestAdjSat);
-
-    //update all adjacent satellites for this plane
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+  //the first snapshot is the current topology, the next ones are predicted
+  //by a second inter-plane topology and the visibility service, at each
+  //interval and at each predicted handover
+  Time start = Simulator::Now();
+  this->m_routing->AddSnapshot(start, GetRoutingGraph(this->m_isl, this->ground_station_channel_tracker));
+  Ptr<LeoIslTopology> isl = CreateObject<LeoIslTopology> ();
+  isl->SetPropagator(this->m_propagator);
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    std::vector<uint32_t> satellites;
+    for (uint32_t j=0; j<num_satellites_per_plane; j++)
+    {
+      satellites.push_back(this->plane[i].Get(j)->GetObject<LeoSatelliteMobilityModel>()->GetPropagatorIndex());
+    }
+    isl->AddPlane(satellites);
+  }
+  isl->Start(start);
+  bool events = !this->m_handoverWindow.IsZero();
+  std::vector<uint32_t> ground_sats = this->ground_station_channel_tracker;
+  std::vector<Time> next_handover = this->m_nextHandover;
+  Time next_update = start + interval;
+  while (true)
+  {
+    Time t = next_update;
+    for (uint32_t i=0; i<next_handover.size(); i++)
     {
-      uint32_t access_idx = i*(this->num_satellites_per_plane) + j;
-      uint32_t currAdjNodeID = this->inter_plane_channel_tracker[access_idx];
-      uint32_t nextAdjNodeID = (j + ref_incr)%(this->num_satellites_per_plane);
-      double nextAdjNodeDist;
+      t = std::min(t, next_handover[i]);
+    }
+    if (t >= start + horizon)
+      break;
+    if (t == next_update)
+    {
+      isl->Update(t);
+      next_update += interval;
+    }
+    std::vector<bool> due (ground_stations.GetN(), !events);
+    for (uint32_t i=0; i<next_handover.size(); i++)
+    {
+      due[i] = next_handover[i] == t;
+    }
+    std::vector<double> distances;
+    AssignGroundStations(t, due, ground_sats, distances);
+    for (uint32_t i=0; i<next_handover.size(); i++)
+    {
+      if (due[i])
+        next_handover[i] = this->m_visibility->PredictHandover(i, t, this->m_handoverWindow);
+    }
+    this->m_routing->AddSnapshot(t, GetRoutingGraph(isl, ground_sats));
+  }
+  NS_LOG_INFO("Computing " << this->m_routing->GetNSnapshots() << " routing snapshots");
+  this->m_routing->Compute(start + horizon);
 
-      Vector constNodePos = update_links_plane[i].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      Vector nextAdjNodePos = update_links_plane[(i+1)/*%(this->num_planes)*/].Get(nextAdjNodeID)->GetObject<MobilityModel>()->GetPosition();
+  //the snapshot routing comes before the global routing of each node
+  for (uint32_t k=0; k<nodes.GetN(); k++)
+  {
+    Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (nodes.Get(k)->GetObject<Ipv4>()->GetRoutingProtocol());
+    NS_ABORT_MSG_IF (list == 0, "Snapshot routing needs an Ipv4ListRouting");
+    Ptr<LeoSnapshotRouting> routing = CreateObject<LeoSnapshotRouting> ();
+    routing->SetTable(this->m_routing, k);
+    list->AddRoutingProtocol(routing, 10);
+  }
+}
 
-      nextAdjNodeDist = CalculateDistance(constNodePos, nextAdjNodePos);
+void LeoSatelliteConfig::EnableHandoverEvents (Time window)
+{
+  NS_ABORT_MSG_IF (!this->m_handoverWindow.IsZero(), "Handover events already enabled");
+  NS_ABORT_MSG_IF (this->m_routing != 0, "Handover events must be enabled before the snapshot routing");
+  NS_ABORT_MSG_IF (window <= Seconds(0), "Bad prediction window of the handovers");
+  this->m_handoverWindow = window;
+  this->m_nextHandover.clear();
+  for (uint32_t i=0; i<ground_stations.GetN(); i++)
+  {
+    this->m_nextHandover.push_back(this->m_visibility->PredictHandover(i, Simulator::Now(), window));
+    TracePredictedHandover(i);
+  }
+  ScheduleHandover();
+}
 
-      if (i == this->num_planes - 1)
-        nextAdjNodeID = num_satellites_per_plane - nextAdjNodeID - 1;
+void LeoSatelliteConfig::ScheduleHandover ()
+{
+  Time next = this->m_nextHandover[0];
+  for (uint32_t i=1; i<this->m_nextHandover.size(); i++)
+  {
+    next = std::min(next, this->m_nextHandover[i]);
+  }
+  this->m_handoverEvent = Simulator::Schedule(next - Simulator::Now(), &LeoSatelliteConfig::HandOver, this);
+}
 
-      if(currAdjNodeID == nextAdjNodeID)
-      {
-        double new_delay = (nextAdjNodeDist*1000)/speed_of_light;
-        this->inter_plane_channels[access_idx]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-        std::cout<<"Channel updated between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nextAdjNodeID<< " with distance "<<nextAdjNodeDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
-      }
-      else
-      {
-        this->inter_plane_channels[access_idx]->Detach(this->inter_plane_devices[access_idx].Get(currAdjNodeID+1)->GetObject<CsmaNetDevice> ());
-        std::pair< Ptr< Ipv4 >, uint32_t> interface = this->inter_plane_interfaces[access_idx].Get(currAdjNodeID+1);
-        interface.first->SetDown(interface.second);
-        this->inter_plane_channels[access_idx]->Reattach(this->inter_plane_devices[access_idx].Get(nextAdjNodeID+1)->GetObject<CsmaNetDevice> ());
-        interface = this->inter_plane_interfaces[access_idx].Get(nextAdjNodeID+1);
-        interface.first->SetUp(interface.second);
-        this->inter_plane_channel_tracker[access_idx] = nextAdjNodeID;
-        double new_delay = (nextAdjNodeDist*1000)/speed_of_light;
-        this->inter_plane_channels[access_idx]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-        std::cout<<"New channel between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nextAdjNodeID<< " with distance "<<nextAdjNodeDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
-      }
+void LeoSatelliteConfig::HandOver ()
+{
+  NS_LOG_FUNCTION(this);
+  Time now = Simulator::Now();
+  std::vector<bool> due (ground_stations.GetN());
+  for (uint32_t i=0; i<due.size(); i++)
+  {
+    due[i] = this->m_nextHandover[i] <= now;
+  }
+  std::vector<uint32_t> ground_sats = this->ground_station_channel_tracker;
+  std::vector<double> distances;
+  AssignGroundStations(now, due, ground_sats, distances);
+  bool topologyChanged = SetGroundLinks(ground_sats, distances);
+  for (uint32_t i=0; i<due.size(); i++)
+  {
+    if (due[i])
+    {
+      this->m_nextHandover[i] = this->m_visibility->PredictHandover(i, now, this->m_handoverWindow);
+      TracePredictedHandover(i);
     }
   }
+  UpdateRouting(topologyChanged);
+  ScheduleHandover();
+}
 
-  //updating links between ground stations and their closest satellites
-  for (uint32_t i=0; i<2; i++)
+void LeoSatelliteConfig::TracePredictedHandover (uint32_t station)
+{
+  //the end of the window is not a handover
+  Time t = this->m_nextHandover[station];
+  if (t >= Simulator::Now() + this->m_handoverWindow)
+    return;
+  //the closest satellite then, unless another ground station takes it first
+  LeoVisibility closest;
+  this->m_visibility->FindClosest(station, t, std::vector<bool> (), closest);
+  uint32_t old_sat = this->ground_station_channel_tracker[station];
+  LeoVisibility old_look = this->m_visibility->Observe(station, this->satellite_propagator_index[old_sat], t);
+  LeoHandover handover;
+  handover.groundStation = station;
+  handover.time = t;
+  handover.oldSatellite = old_sat;
+  handover.newSatellite = this->propagator_satellite_index[closest.satellite];
+  handover.oldDelay = Seconds((old_look.distance*1000)/speed_of_light);
+  handover.newDelay = Seconds((closest.distance*1000)/speed_of_light);
+  m_handoverTrace(handover);
+}
+
+void LeoSatelliteConfig::AssignGroundStations (Time t, const std::vector<bool> &due, std::vector<uint32_t> &ground_sats, std::vector<double> &distances) const
+{
+  //the satellites of the ground stations not due stay busy
+  std::vector<bool> busy (this->m_propagator->GetN(), false);
+  for (uint32_t i=0; i<ground_sats.size(); i++)
+  {
+    if (!due[i])
+      busy[this->satellite_propagator_index[ground_sats[i]]] = true;
+  }
+  distances.resize(ground_sats.size());
+  for (uint32_t i=0; i<ground_sats.size(); i++)
   {
-    Vector gndPos = ground_stations.Get(i)->GetObject<MobilityModel> ()->GetPosition();
-    uint32_t closestAdjSat = 0;
-    uint32_t closestAdjSatDist = 0;
-    uint32_t planeIndex;
-    if (i == 0)
-      planeIndex = 0;
+    LeoVisibility closest;
+    if (due[i])
+    {
+      if (!this->m_visibility->FindClosest(i, t, busy, closest))
+        NS_LOG_LOGIC("No satellite above the elevation mask of ground station "<<i);
+      ground_sats[i] = this->propagator_satellite_index[closest.satellite];
+      busy[closest.satellite] = true;
+    }
     else
-      planeIndex = floor(3*num_planes/7);
-    //find closest adjacent satellite for ground station
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
     {
-      Vector pos = this->plane[planeIndex].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      double temp_dist = CalculateDistanceGroundToSat(gndPos,pos);
-      if((temp_dist < closestAdjSatDist) || (j==0))
-      {
-        closestAdjSatDist = temp_dist;
-        closestAdjSat = j;
-      }
+      closest = this->m_visibility->Observe(i, this->satellite_propagator_index[ground_sats[i]], t);
     }
+    distances[i] = closest.distance;
+  }
+}
 
-    uint32_t currAdjNodeID = this->ground_station_channel_tracker[i];
-    if(currAdjNodeID == closestAdjSat)
+bool LeoSatelliteConfig::SetGroundLinks (const std::vector<uint32_t> &ground_sats, const std::vector<double> &distances)
+{
+  uint32_t n = this->num_satellites_per_plane;
+  //the old satellites go down first, one of them may be the new satellite of another ground station
+  for (uint32_t i=0; i<ground_sats.size(); i++)
+  {
+    uint32_t old_sat = this->ground_station_channel_tracker[i];
+    if (ground_sats[i] != old_sat)
     {
-      double new_delay = (closestAdjSatDist*1000)/speed_of_light;
-      this->ground_station_channels[i]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-      std::cout<<"Channel updated between ground station "<<i<<" and plane "<<planeIndex<<" satellite "<<closestAdjSat<< " with distance "<<closestAdjSatDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
+      std::pair< Ptr< Ipv4 >, uint32_t> interface = this->satellite_ground_interfaces[old_sat/n].Get(old_sat%n);
+      interface.first->SetDown(interface.second);
+    }
+  }
+  bool changed = false;
+  for (uint32_t i=0; i<ground_sats.size(); i++)
+  {
+    uint32_t sat = ground_sats[i];
+    double new_delay = (distances[i]*1000)/speed_of_light;
+    if (sat == this->ground_station_channel_tracker[i])
+    {
+      if (!this->m_continuousDelays)
+      {
+        this->ground_station_channels[i]->SetDelay(Seconds(new_delay));
+        m_groundDelayTrace(i, Seconds(new_delay));
       }
-      else
+      NS_LOG_LOGIC("Channel updated between ground station "<<i<<" and plane "<<sat/n<<" satellite "<<sat%n<< " with distance "<<distances[i]<< "km and delay of "<<new_delay<<" seconds");
+    }
+    else
+    {
+      if (this->m_handoverWindow.IsZero())
       {
-        this->ground_station_channels[i]->Detach(this->ground_station_devices[i].Get(currAdjNodeID+1)->GetObject<CsmaNetDevice> ());
-        std::pair< Ptr< Ipv4 >, uint32_t> interface = this->ground_station_interfaces[i].Get(currAdjNodeID+1);
-        interface.first->SetDown(interface.second);
-        this->ground_station_channels[i]->Reattach(this->ground_station_devices[i].Get(closestAdjSat+1)->GetObject<CsmaNetDevice> ());
-        interface = this->ground_station_interfaces[i].Get(closestAdjSat+1);
-        interface.first->SetUp(interface.second);
-        this->ground_station_channel_tracker[i] = closestAdjSat;
-        double new_delay = (closestAdjSatDist*1000)/speed_of_light;
-        this->ground_station_channels[i]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-        std::cout<<"New channel between ground station "<<i<<" and plane "<<planeIndex<<" satellite "<<closestAdjSat<< " with distance "<<closestAdjSatDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
+        LeoHandover handover;
+        handover.groundStation = i;
+        handover.time = Simulator::Now();
+        handover.oldSatellite = this->ground_station_channel_tracker[i];
+        handover.newSatellite = sat;
+        LeoVisibility old_look = this->m_visibility->Observe(i, this->satellite_propagator_index[handover.oldSatellite], handover.time);
+        handover.oldDelay = Seconds((old_look.distance*1000)/speed_of_light);
+        handover.newDelay = Seconds(new_delay);
+        m_handoverTrace(handover);
       }
+      m_groundDelayTrace(i, Seconds(new_delay));
+      this->ground_station_channels[i]->Rebind(this->satellite_ground_devices.Get(sat)->GetObject<PointToPointNetDevice> (), Seconds(new_delay));
+      std::pair< Ptr< Ipv4 >, uint32_t> interface = this->satellite_ground_interfaces[sat/n].Get(sat%n);
+      interface.first->SetUp(interface.second);
+      this->ground_station_channel_tracker[i] = sat;
+      changed = true;
+      NS_LOG_LOGIC("New channel between ground station "<<i<<" and plane "<<sat/n<<" satellite "<<sat%n<< " with distance "<<distances[i]<< "km and delay of "<<new_delay<<" seconds");
+    }
   }
-  
-  //Recompute Routing Tables
-  std::cout<<"Recomputing Routing Tables"<<std::endl;
-  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
-  std::cout<<"Finished Recomputing Routing Tables"<<std::endl;
+  return changed;
+}
+
+void LeoSatelliteConfig::UpdateRouting (bool topologyChanged)
+{
+  //Move the precomputed tables to the current snapshot, until their horizon
+  bool snapshot = false;
+  if (this->m_routing != 0)
+  {
+    snapshot = this->m_routing->Apply(Simulator::Now());
+    if (!snapshot)
+    {
+      NS_LOG_INFO("Past the routing snapshots, back to global routing");
+      this->m_routing = 0;
+      topologyChanged = true;
+    }
+  }
+
+  //Recompute Routing Tables, global routing does not depend on the delays
+  if (!snapshot && topologyChanged)
+  {
+    NS_LOG_INFO("Recomputing Routing Tables");
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  }
+}
+
+void LeoSatelliteConfig::EnableContinuousDelays (Time refresh)
+{
+  NS_ABORT_MSG_IF (refresh.IsNegative(), "Bad refresh period of the delays");
+  this->m_continuousDelays = true;
+  std::vector<Ptr<ReconfigurablePointToPointChannel>> channels = this->inter_plane_channels;
+  channels.insert(channels.end(), this->ground_station_channels.begin(), this->ground_station_channels.end());
+  for (uint32_t i=0; i<channels.size(); i++)
+  {
+    channels[i]->SetAttribute("DelayRefresh", TimeValue(refresh));
+    channels[i]->SetDelayCallback(MakeCallback(&LeoSatelliteConfig::GetLinkDelay, this));
+  }
+}
+
+Time LeoSatelliteConfig::GetLinkDelay (Ptr<PointToPointNetDevice> a, Ptr<PointToPointNetDevice> b, Time t) const
+{
+  //straight line between the ends, a satellite or a ground station
+  Ptr<Node> nodes[2] = {a->GetNode(), b->GetNode()};
+  Vector ends[2];
+  for (uint32_t k=0; k<2; k++)
+  {
+    Ptr<LeoSatelliteMobilityModel> satellite = nodes[k]->GetObject<LeoSatelliteMobilityModel>();
+    Vector position;
+    if (satellite != 0)
+      position = this->m_propagator->ComputePosition(satellite->GetPropagatorIndex(), t);
+    else
+      position = nodes[k]->GetObject<MobilityModel>()->GetPosition();
+    ends[k] = LeoConstellationPropagator::GetCartesian(position);
+  }
+  double distance = (ends[1] - ends[0]).GetLength();
+  return Seconds((distance*1000)/speed_of_light);
+}
+
+void LeoSatelliteConfig::UpdateLinks()
+{
+  NS_LOG_INFO("Updating Links");
+
+  //only the inter-plane links which changed are touched
+  const LeoIslDelta &delta = this->m_isl->Update(Simulator::Now());
+  for (uint32_t l=0; l<delta.changed.size(); l++)
+  {
+    const LeoIslLink &link = delta.changed[l];
+    uint32_t access_idx = link.plane*(this->num_satellites_per_plane) + link.satellite;
+    uint32_t peer_idx = ((link.plane+1)%num_planes)*(this->num_satellites_per_plane) + link.peer;
+    this->inter_plane_channels[access_idx]->Rebind(this->inter_plane_peer_devices.Get(peer_idx)->GetObject<PointToPointNetDevice> (), link.delay);
+    this->inter_plane_channel_tracker[access_idx] = link.peer;
+    NS_LOG_LOGIC("New channel between plane "<<link.plane<<" satellite "<<link.satellite<<" and plane "<<(link.plane+1)%num_planes<<" satellite "<<link.peer<< " with distance "<<link.distance<< "km and delay of "<<link.delay.GetSeconds()<<" seconds");
+  }
+  for (uint32_t l=0; l<delta.updated.size(); l++)
+  {
+    const LeoIslLink &link = delta.updated[l];
+    uint32_t access_idx = link.plane*(this->num_satellites_per_plane) + link.satellite;
+    if (!this->m_continuousDelays)
+      this->inter_plane_channels[access_idx]->SetDelay(link.delay);
+    NS_LOG_LOGIC("Channel updated between plane "<<link.plane<<" satellite "<<link.satellite<<" and plane "<<(link.plane+1)%num_planes<<" satellite "<<link.peer<< " with distance "<<link.distance<< "km and delay of "<<link.delay.GetSeconds()<<" seconds");
+  }
+  m_islTrace(delta);
+  bool topologyChanged = !delta.changed.empty();
+
+  //updating links between ground stations and their closest satellites, only
+  //their delays when the handovers are events of their own
+  std::vector<uint32_t> ground_sats = this->ground_station_channel_tracker;
+  std::vector<double> distances;
+  AssignGroundStations(Simulator::Now(), std::vector<bool> (ground_sats.size(), this->m_handoverWindow.IsZero()), ground_sats, distances);
+  if (SetGroundLinks(ground_sats, distances))
+    topologyChanged = true;
+
+  UpdateRouting(topologyChanged);
 }
 
 }
@@ -17,9 +17,12 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/leo-satellite-mobility.h"
 #include "ns3/ground-station-mobility.h"
+#include "ns3/leo-isl-topology.h"
+#include "ns3/leo-snapshot-routing.h"
+#include "ns3/leo-visibility-service.h"
+#include "ns3/traced-callback.h"
 #include <vector>
 #include "ns3/mobility-module.h"
-#include "ns3/csma-module.h"
 #include <cmath>
 #include "ns3/internet-module.h"
 #include "ns3/ipv4-global-routing-helper.h"
@@ -27,6 +30,20 @@
 
 namespace ns3 {
 
+/**
+ * \ingroup leo-satellite
+ * \brief A ground station moving to another satellite
+ */
+struct LeoHandover
+{
+  uint32_t groundStation; //!< the ground station
+  Time time;              //!< time of the handover
+  uint32_t oldSatellite;  //!< satellite serving the ground station before, i*num_satellites_per_plane + j
+  uint32_t newSatellite;  //!< satellite serving it after
+  Time oldDelay;          //!< delay of the ground link to the old satellite at the handover
+  Time newDelay;          //!< delay of the ground link to the new satellite at the handover
+};
+
 class LeoSatelliteConfig : public Object
 {
 public:
@@ -43,24 +60,105 @@ public:
   
   void UpdateLinks (); //update the intersatellite links
 
+  Ptr<LeoIslTopology> GetIslTopology () const; //the inter-plane links
+
+  /**
+   * Route with forwarding tables computed now for the snapshots of the
+   * topology at now + k*interval until now + horizon, instead of
+   * recomputing the global routing at each UpdateLinks. UpdateLinks moves
+   * the tables to the snapshot of its time, so it should be called every
+   * interval, and falls back to the global routing after the horizon.
+   * \param interval time between the snapshots
+   * \param horizon duration of the snapshots
+   */
+  void EnableSnapshotRouting (Time interval, Time horizon);
+  Ptr<LeoSnapshotRoutingTable> GetSnapshotRouting () const; //the tables, 0 if not enabled
+
+  /**
+   * Hand the ground stations over to a new satellite at the times predicted
+   * by the visibility service, instead of at each UpdateLinks, which then
+   * only updates the delays of the ground links. Must be called before
+   * EnableSnapshotRouting, whose snapshots then include the handovers.
+   * \param window longest time between two predictions of a ground station
+   */
+  void EnableHandoverEvents (Time window);
+  Ptr<LeoVisibilityService> GetVisibilityService () const; //the satellites seen by the ground stations
+
+  /**
+   * Compute the delays of the inter-plane and ground links from the
+   * positions of their ends when a transmission starts, instead of at each
+   * UpdateLinks, so that they change smoothly within a Simulator::Run.
+   * \param refresh period of the computations of the delay of a link, zero
+   * for each transmission
+   */
+  void EnableContinuousDelays (Time refresh);
+
+  /**
+   * TracedCallback signature for the inter-plane links changed by UpdateLinks
+   * \param [in] delta the links which changed of peer or of delay
+   */
+  typedef void (* IslDeltaTracedCallback)(const LeoIslDelta &delta);
+  /**
+   * TracedCallback signature for the handovers, traced when they are
+   * predicted with the handover events, else when UpdateLinks does them.
+   * A scenario announces them to the MpQuicPathManager of a path through
+   * the ground station with NotifyHandover, the RTT moving by twice the
+   * change of the delay.
+   * \param [in] handover the handover
+   */
+  typedef void (* HandoverTracedCallback)(const LeoHandover &handover);
+  /**
+   * TracedCallback signature for the delays of the ground links set by
+   * UpdateLinks and the handovers
+   * \param [in] station the ground station
+   * \param [in] delay the new delay of its link
+   */
+  typedef void (* GroundDelayTracedCallback)(uint32_t station, Time delay);
+
   NodeContainer ground_stations; //node container to hold ground stations
   std::vector<Ipv4InterfaceContainer> ground_station_interfaces;
 
 private:
+  void AssignGroundStations (Time t, const std::vector<bool> &due, std::vector<uint32_t> &ground_sats, std::vector<double> &distances) const; //the due ground stations take in turn the closest free satellite at time t
+  bool SetGroundLinks (const std::vector<uint32_t> &ground_sats, const std::vector<double> &distances); //bind the ground links to these satellites, true if one changed
+  void UpdateRouting (bool topologyChanged); //follow a change of the links in the routing
+  void ScheduleHandover (); //schedule the next predicted handover
+  void HandOver (); //handover of the ground stations due now
+  void TracePredictedHandover (uint32_t station); //trace the next handover of a ground station, if predicted
+  Time GetLinkDelay (Ptr<PointToPointNetDevice> a, Ptr<PointToPointNetDevice> b, Time t) const; //propagation delay between the nodes of two devices at time t
+  LeoRoutingGraph GetRoutingGraph (Ptr<LeoIslTopology> isl, const std::vector<uint32_t> &ground_sats) const; //links of each node for the inter-plane and ground links given
+  void AddRoutingLink (LeoRoutingGraph &graph, uint32_t a, uint32_t b, Ptr<NetDevice> device, Ipv4Address gateway) const; //link from node a to node b
+
   uint32_t num_planes;
   uint32_t num_satellites_per_plane;
   double m_altitude;
+  Ptr<LeoConstellationPropagator> m_propagator; //positions of all the satellites
+  Ptr<LeoIslTopology> m_isl; //which satellites of adjacent planes are linked
+  TracedCallback<const LeoIslDelta &> m_islTrace; //the inter-plane links changed by UpdateLinks
+  TracedCallback<const LeoHandover &> m_handoverTrace; //the handovers of the ground stations
+  TracedCallback<uint32_t, Time> m_groundDelayTrace; //the delays set on the ground links
+  Ptr<LeoSnapshotRoutingTable> m_routing; //precomputed routing tables, if enabled
+  Ptr<LeoVisibilityService> m_visibility; //which satellites the ground stations see
+  Time m_handoverWindow; //longest prediction of the handovers, zero if not events
+  std::vector<Time> m_nextHandover; //predicted handover of each ground station
+  EventId m_handoverEvent; //the next handover
+  bool m_continuousDelays; //whether the channels compute their delays
 
   std::vector<NodeContainer> plane; //node container for each plane
   std::vector<NetDeviceContainer> intra_plane_devices; //contains net devices for all P2P links for all planes
-  std::vector<NetDeviceContainer> inter_plane_devices;
-  std::vector<Ptr<CsmaChannel>> inter_plane_channels;
+  NetDeviceContainer inter_plane_devices; //device of each satellite towards the next plane, near end of its channel
+  NetDeviceContainer inter_plane_peer_devices; //device of each satellite towards the previous plane, far end of a channel
+  std::vector<Ptr<ReconfigurablePointToPointChannel>> inter_plane_channels; //channel of each satellite towards the next plane
   std::vector<uint32_t> inter_plane_channel_tracker; //this will have the node from the adjacent plane that is currently connected
-  std::vector<NetDeviceContainer> ground_station_devices; 
-  std::vector<Ptr<CsmaChannel>> ground_station_channels;
-  std::vector<uint32_t> ground_station_channel_tracker;
+  std::vector<uint32_t> satellite_propagator_index; //propagator index of satellite j of plane i, at i*num_satellites_per_plane + j
+  std::vector<uint32_t> propagator_satellite_index; //the other way round
+  NetDeviceContainer satellite_ground_devices; //device of each satellite towards the ground stations, bound when it serves one
+  NetDeviceContainer ground_station_devices; //device of each ground station
+  std::vector<Ptr<ReconfigurablePointToPointChannel>> ground_station_channels;
+  std::vector<uint32_t> ground_station_channel_tracker; //satellite serving each ground station, i*num_satellites_per_plane + j
   std::vector<Ipv4InterfaceContainer> intra_plane_interfaces;
-  std::vector<Ipv4InterfaceContainer> inter_plane_interfaces;
+  std::vector<Ipv4InterfaceContainer> inter_plane_interfaces; //interfaces between each plane and the next one
+  std::vector<Ipv4InterfaceContainer> satellite_ground_interfaces; //ground interfaces of the satellites of each plane
   
 };
   
@@ -0,0 +1,429 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Snapshot routing
+ * Forwarding tables of a predictable topology, computed in advance for each snapshot
+ */
+
+#include "leo-snapshot-routing.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/uinteger.h"
+#include "ns3/system-thread.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSnapshotRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSnapshotRoutingTable);
+NS_OBJECT_ENSURE_REGISTERED (LeoSnapshotRouting);
+
+TypeId
+LeoSnapshotRoutingTable::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSnapshotRoutingTable")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSnapshotRoutingTable> ()
+    .AddAttribute ("Threads",
+                   "Number of snapshots computed in parallel.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&LeoSnapshotRoutingTable::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LeoSnapshotRoutingTable::LeoSnapshotRoutingTable ()
+  : m_threads (1),
+    m_nNodes (0),
+    m_nColumns (0),
+    m_current (0),
+    m_valid (false)
+{
+}
+
+LeoSnapshotRoutingTable::~LeoSnapshotRoutingTable ()
+{
+}
+
+void
+LeoSnapshotRoutingTable::AddAddress (Ipv4Address address, uint32_t node)
+{
+  m_addresses[address.Get ()] = node;
+}
+
+void
+LeoSnapshotRoutingTable::AddDestination (uint32_t node)
+{
+  NS_ABORT_MSG_IF (m_valid, "The destinations must be added before Compute");
+  m_destinations.push_back (node);
+}
+
+void
+LeoSnapshotRoutingTable::AddSnapshot (Time start, const LeoRoutingGraph &graph)
+{
+  NS_LOG_FUNCTION (this << start << graph.size ());
+  NS_ABORT_MSG_IF (!m_starts.empty () && start <= m_starts.back (), "The snapshots must be added in order");
+  NS_ABORT_MSG_IF (!m_graphs.empty () && graph.size () != m_graphs[0].size (), "All the snapshots must have the same nodes");
+  m_starts.push_back (start);
+  m_graphs.push_back (graph);
+}
+
+void
+LeoSnapshotRoutingTable::ComputeSnapshot (uint32_t snapshot, std::vector<LeoRoute> &routes) const
+{
+  const LeoRoutingGraph &graph = m_graphs[snapshot];
+  uint32_t n = graph.size ();
+  LeoRoute none;
+  none.interface = LeoRoute::NO_INTERFACE;
+  routes.assign (n*m_nColumns, none);
+
+  // the links are symmetric: a search from the destination gives the
+  // distance of every node to it, and a node forwards to its first
+  // neighbor one hop closer
+  std::vector<uint32_t> distance (n);
+  std::vector<uint32_t> queue (n);
+  for (uint32_t c = 0; c < m_nColumns; c++)
+    {
+      uint32_t d = m_destinations.empty () ? c : m_destinations[c];
+      std::fill (distance.begin (), distance.end (), 0xffffffff);
+      distance[d] = 0;
+      uint32_t head = 0;
+      uint32_t tail = 0;
+      queue[tail++] = d;
+      while (head < tail)
+        {
+          uint32_t v = queue[head++];
+          for (std::vector<LeoRoutingLink>::const_iterator l = graph[v].begin (); l != graph[v].end (); ++l)
+            {
+              if (distance[l->neighbor] == 0xffffffff)
+                {
+                  distance[l->neighbor] = distance[v] + 1;
+                  queue[tail++] = l->neighbor;
+                }
+            }
+        }
+      for (uint32_t u = 0; u < n; u++)
+        {
+          if (u == d || distance[u] == 0xffffffff)
+            {
+              continue;
+            }
+          for (std::vector<LeoRoutingLink>::const_iterator l = graph[u].begin (); l != graph[u].end (); ++l)
+            {
+              if (distance[l->neighbor] + 1 == distance[u])
+                {
+                  routes[u*m_nColumns + c].interface = l->interface;
+                  routes[u*m_nColumns + c].gateway = l->gateway;
+                  break;
+                }
+            }
+        }
+    }
+}
+
+void
+LeoSnapshotRoutingTable::RunJob (Job *job)
+{
+  uint32_t last = std::min<uint32_t> (job->first + job->routes->size (), job->table->m_graphs.size ());
+  for (uint32_t k = job->first + job->thread; k < last; k += job->step)
+    {
+      job->table->ComputeSnapshot (k, (*job->routes)[k - job->first]);
+    }
+}
+
+void
+LeoSnapshotRoutingTable::Compute (Time end)
+{
+  NS_LOG_FUNCTION (this << end);
+  NS_ABORT_MSG_IF (m_graphs.empty (), "No snapshot to compute");
+  NS_ABORT_MSG_IF (end <= m_starts.back (), "The end must be after the last snapshot");
+  m_end = end;
+  m_nNodes = m_graphs[0].size ();
+  m_nColumns = m_destinations.empty () ? m_nNodes : m_destinations.size ();
+  uint32_t missing = LeoRoute::NO_INTERFACE;
+  m_column.assign (m_nNodes, missing);
+  for (uint32_t c = 0; c < m_nColumns; c++)
+    {
+      uint32_t d = m_destinations.empty () ? c : m_destinations[c];
+      NS_ABORT_MSG_IF (d >= m_nNodes, "No node " << d);
+      m_column[d] = c;
+    }
+  m_changes.assign (m_graphs.size (), std::vector<Change> ());
+
+  // the snapshots are computed by batches of one snapshot per thread, each
+  // batch is compared to the previous snapshot then dropped
+  uint32_t nSnapshots = m_graphs.size ();
+  std::vector<std::vector<LeoRoute> > batch (m_threads);
+  std::vector<LeoRoute> previous;
+  for (uint32_t first = 0; first < nSnapshots; first += m_threads)
+    {
+      std::vector<Job> jobs (m_threads);
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t t = 0; t < m_threads; t++)
+        {
+          jobs[t].table = this;
+          jobs[t].first = first;
+          jobs[t].thread = t;
+          jobs[t].step = m_threads;
+          jobs[t].routes = &batch;
+          if (t > 0 && first + t < nSnapshots)
+            {
+              threads.push_back (Create<SystemThread> (MakeBoundCallback (&LeoSnapshotRoutingTable::RunJob, &jobs[t])));
+              threads.back ()->Start ();
+            }
+        }
+      RunJob (&jobs[0]);
+      for (uint32_t t = 0; t < threads.size (); t++)
+        {
+          threads[t]->Join ();
+        }
+
+      for (uint32_t k = first; k < std::min (first + m_threads, nSnapshots); k++)
+        {
+          std::vector<LeoRoute> &routes = batch[k - first];
+          if (k == 0)
+            {
+              m_routes = routes;
+            }
+          else
+            {
+              for (uint32_t i = 0; i < routes.size (); i++)
+                {
+                  if (routes[i] != previous[i])
+                    {
+                      Change change;
+                      change.index = i;
+                      change.route = routes[i];
+                      m_changes[k].push_back (change);
+                    }
+                }
+            }
+          NS_LOG_INFO ("snapshot " << k << " at " << m_starts[k].GetSeconds () << "s: "
+                                   << m_changes[k].size () << " routes changed");
+          previous.swap (routes);
+        }
+    }
+  m_graphs.clear ();
+  m_current = 0;
+  m_valid = true;
+}
+
+bool
+LeoSnapshotRoutingTable::Apply (Time t)
+{
+  NS_LOG_FUNCTION (this << t);
+  NS_ASSERT_MSG (!m_starts.empty () && m_graphs.empty (), "The snapshots are not computed");
+  if (t >= m_end)
+    {
+      NS_LOG_LOGIC ("past the last snapshot");
+      m_valid = false;
+      return false;
+    }
+  uint32_t snapshot = std::upper_bound (m_starts.begin (), m_starts.end (), t) - m_starts.begin ();
+  NS_ABORT_MSG_IF (snapshot == 0, "Time before the first snapshot");
+  snapshot--;
+  NS_ABORT_MSG_IF (snapshot < m_current, "The snapshots can only move forward");
+  while (m_current < snapshot)
+    {
+      m_current++;
+      const std::vector<Change> &changes = m_changes[m_current];
+      for (std::vector<Change>::const_iterator c = changes.begin (); c != changes.end (); ++c)
+        {
+          m_routes[c->index] = c->route;
+        }
+      NS_LOG_LOGIC ("snapshot " << m_current << ": " << changes.size () << " routes changed");
+    }
+  return true;
+}
+
+const LeoRoute *
+LeoSnapshotRoutingTable::Lookup (uint32_t node, Ipv4Address destination) const
+{
+  if (!m_valid)
+    {
+      return 0;
+    }
+  std::map<uint32_t, uint32_t>::const_iterator it = m_addresses.find (destination.Get ());
+  if (it == m_addresses.end ())
+    {
+      return 0;
+    }
+  uint32_t column = m_column[it->second];
+  if (column == LeoRoute::NO_INTERFACE)
+    {
+      return 0;
+    }
+  const LeoRoute *route = &m_routes[node*m_nColumns + column];
+  return (route->interface == LeoRoute::NO_INTERFACE) ? 0 : route;
+}
+
+uint32_t
+LeoSnapshotRoutingTable::GetNNodes (void) const
+{
+  return m_nNodes;
+}
+
+uint32_t
+LeoSnapshotRoutingTable::GetNSnapshots (void) const
+{
+  return m_starts.size ();
+}
+
+uint32_t
+LeoSnapshotRoutingTable::GetCurrentSnapshot (void) const
+{
+  return m_current;
+}
+
+uint32_t
+LeoSnapshotRoutingTable::GetNChanges (uint32_t snapshot) const
+{
+  NS_ASSERT (snapshot < m_changes.size ());
+  return m_changes[snapshot].size ();
+}
+
+TypeId
+LeoSnapshotRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSnapshotRouting")
+    .SetParent<Ipv4RoutingProtocol> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSnapshotRouting> ()
+  ;
+  return tid;
+}
+
+LeoSnapshotRouting::LeoSnapshotRouting ()
+  : m_node (0)
+{
+}
+
+LeoSnapshotRouting::~LeoSnapshotRouting ()
+{
+}
+
+void
+LeoSnapshotRouting::DoDispose (void)
+{
+  m_ipv4 = 0;
+  m_table = 0;
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+void
+LeoSnapshotRouting::SetTable (Ptr<LeoSnapshotRoutingTable> table, uint32_t node)
+{
+  m_table = table;
+  m_node = node;
+}
+
+Ptr<Ipv4Route>
+LeoSnapshotRouting::Lookup (Ipv4Address destination) const
+{
+  if (m_table == 0)
+    {
+      return 0;
+    }
+  const LeoRoute *entry = m_table->Lookup (m_node, destination);
+  if (entry == 0)
+    {
+      return 0;
+    }
+  Ptr<Ipv4Route> route = Create<Ipv4Route> ();
+  route->SetDestination (destination);
+  route->SetGateway (entry->gateway);
+  route->SetSource (m_ipv4->GetAddress (entry->interface, 0).GetLocal ());
+  route->SetOutputDevice (m_ipv4->GetNetDevice (entry->interface));
+  return route;
+}
+
+Ptr<Ipv4Route>
+LeoSnapshotRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << p << &header << oif << &sockerr);
+  Ptr<Ipv4Route> route;
+  if (!header.GetDestination ().IsMulticast () && !header.GetDestination ().IsBroadcast ())
+    {
+      route = Lookup (header.GetDestination ());
+    }
+  if (route != 0 && oif != 0 && route->GetOutputDevice () != oif)
+    {
+      NS_LOG_LOGIC ("route not through the requested device");
+      route = 0;
+    }
+  sockerr = (route != 0) ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+  return route;
+}
+
+bool
+LeoSnapshotRouting::RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                                 UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                                 LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << idev);
+  // local delivery is done by the Ipv4ListRouting
+  if (header.GetDestination ().IsMulticast () || header.GetDestination ().IsBroadcast ())
+    {
+      return false;
+    }
+  Ptr<Ipv4Route> route = Lookup (header.GetDestination ());
+  if (route == 0)
+    {
+      NS_LOG_LOGIC ("no snapshot route to " << header.GetDestination ());
+      return false;
+    }
+  ucb (route, p, header);
+  return true;
+}
+
+void
+LeoSnapshotRouting::NotifyInterfaceUp (uint32_t interface)
+{
+}
+
+void
+LeoSnapshotRouting::NotifyInterfaceDown (uint32_t interface)
+{
+}
+
+void
+LeoSnapshotRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+LeoSnapshotRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+LeoSnapshotRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
+  m_ipv4 = ipv4;
+}
+
+void
+LeoSnapshotRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  std::ostream *os = stream->GetStream ();
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", Local time: " << m_ipv4->GetObject<Node> ()->GetLocalTime ().As (unit)
+      << ", LeoSnapshotRouting table";
+  if (m_table == 0)
+    {
+      *os << " not set" << std::endl;
+      return;
+    }
+  *os << ", snapshot " << m_table->GetCurrentSnapshot () << " of " << m_table->GetNSnapshots () << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,246 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Snapshot routing
+ * Forwarding tables of a predictable topology, computed in advance for each snapshot
+ */
+#ifndef LEO_SNAPSHOT_ROUTING_H
+#define LEO_SNAPSHOT_ROUTING_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief A link of a node in a snapshot of the topology
+ */
+struct LeoRoutingLink
+{
+  uint32_t neighbor;     //!< index of the node at the other end
+  uint32_t interface;    //!< interface of the node on the link
+  Ipv4Address gateway;   //!< address of the neighbor on the link
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief A snapshot of the topology: the links of each node
+ */
+typedef std::vector<std::vector<LeoRoutingLink> > LeoRoutingGraph;
+
+/**
+ * \ingroup leo-satellite
+ * \brief The route of a node to a destination node
+ */
+struct LeoRoute
+{
+  uint32_t interface;    //!< output interface, NO_INTERFACE if there is no route
+  Ipv4Address gateway;   //!< next hop
+
+  static const uint32_t NO_INTERFACE = 0xffffffff; //!< interface of a missing route
+
+  /**
+   * \param other another route
+   * \return true if the routes differ
+   */
+  bool operator != (const LeoRoute &other) const
+  {
+    return interface != other.interface || gateway != other.gateway;
+  }
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief Forwarding tables of all the nodes, for a sequence of snapshots.
+ *
+ * The snapshots of the topology are added for the whole horizon of the
+ * simulation, then Compute finds the shortest paths (in hops, as the
+ * global routing) of each snapshot, several snapshots in parallel when
+ * Threads is more than 1. Only the tables of the first snapshot are kept
+ * whole, the other snapshots are stored as the routes which changed since
+ * the previous one, and Apply moves the tables to a snapshot by rewriting
+ * these routes only.
+ *
+ * The table is shared by the LeoSnapshotRouting protocols of the nodes,
+ * which look up the route of their node to the node owning the
+ * destination address. The tables hold the routes of every node to every
+ * node, or only to the destinations added, like the ground stations of a
+ * large constellation.
+ */
+class LeoSnapshotRoutingTable : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LeoSnapshotRoutingTable ();
+  virtual ~LeoSnapshotRoutingTable ();
+
+  /**
+   * \param address an address of a node
+   * \param node the index of the node
+   */
+  void AddAddress (Ipv4Address address, uint32_t node);
+  /**
+   * Compute the routes towards a node, instead of towards all the nodes
+   * when no destination is added
+   * \param node the index of the node
+   */
+  void AddDestination (uint32_t node);
+  /**
+   * Add the snapshot starting at a time, after the snapshots already added
+   * \param start the time from which the snapshot is valid
+   * \param graph the links of the nodes, one vector per node
+   */
+  void AddSnapshot (Time start, const LeoRoutingGraph &graph);
+  /**
+   * Compute the tables of all the snapshots, and move to the first one
+   * \param end the time until which the last snapshot is valid
+   */
+  void Compute (Time end);
+  /**
+   * Move the tables to the snapshot valid at a time
+   * \param t the time, not earlier than the time of the current snapshot
+   * \return false if the time is after the end of the last snapshot
+   */
+  bool Apply (Time t);
+
+  /**
+   * \param node the index of a node
+   * \param destination a destination address
+   * \return the route of the node to the destination, or 0 if there is
+   * none or the tables are past their end
+   */
+  const LeoRoute * Lookup (uint32_t node, Ipv4Address destination) const;
+
+  /**
+   * \return the number of nodes
+   */
+  uint32_t GetNNodes (void) const;
+  /**
+   * \return the number of snapshots
+   */
+  uint32_t GetNSnapshots (void) const;
+  /**
+   * \return the index of the current snapshot
+   */
+  uint32_t GetCurrentSnapshot (void) const;
+  /**
+   * \param snapshot a snapshot
+   * \return the number of routes changed by moving to the snapshot
+   */
+  uint32_t GetNChanges (uint32_t snapshot) const;
+
+private:
+  /**
+   * \brief A route which changes at a snapshot
+   */
+  struct Change
+  {
+    uint32_t index;    //!< node * number of destinations + destination column
+    LeoRoute route;    //!< the new route
+  };
+
+  /**
+   * \brief Snapshots computed by one thread
+   */
+  struct Job
+  {
+    const LeoSnapshotRoutingTable *table;        //!< the table
+    uint32_t first;                              //!< first snapshot of the batch
+    uint32_t thread;                             //!< index of the thread in the batch
+    uint32_t step;                               //!< number of threads
+    std::vector<std::vector<LeoRoute> > *routes; //!< the tables of the batch
+  };
+
+  /**
+   * Compute the snapshots of a job
+   * \param job the job
+   */
+  static void RunJob (Job *job);
+  /**
+   * Compute the tables of a snapshot, by a breadth-first search from each
+   * destination
+   * \param snapshot the snapshot
+   * \param routes receives the route of each node to each destination
+   */
+  void ComputeSnapshot (uint32_t snapshot, std::vector<LeoRoute> &routes) const;
+
+  uint32_t m_threads;                          //!< number of threads computing the snapshots
+  std::map<uint32_t, uint32_t> m_addresses;    //!< node of each address
+  std::vector<Time> m_starts;                  //!< start of each snapshot
+  std::vector<LeoRoutingGraph> m_graphs;       //!< the snapshots, until computed
+  uint32_t m_nNodes;                           //!< number of nodes
+  std::vector<uint32_t> m_destinations;        //!< the destinations added, all the nodes if empty
+  std::vector<uint32_t> m_column;              //!< column of each node in the tables, NO_INTERFACE if not a destination
+  uint32_t m_nColumns;                         //!< number of destinations
+  Time m_end;                                  //!< end of the last snapshot
+  std::vector<LeoRoute> m_routes;              //!< the current tables
+  std::vector<std::vector<Change> > m_changes; //!< routes changed at each snapshot
+  uint32_t m_current;                          //!< current snapshot
+  bool m_valid;                                //!< whether the tables hold a snapshot
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief Routing protocol of a node, reading the routes of the node in a
+ * LeoSnapshotRoutingTable.
+ *
+ * It is added to the Ipv4ListRouting of the node with a higher priority
+ * than the global routing, which routes the packets when the snapshot
+ * routing has no route.
+ */
+class LeoSnapshotRouting : public Ipv4RoutingProtocol
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LeoSnapshotRouting ();
+  virtual ~LeoSnapshotRouting ();
+
+  /**
+   * \param table the tables of all the nodes
+   * \param node the index of the node of this protocol in the table
+   */
+  void SetTable (Ptr<LeoSnapshotRoutingTable> table, uint32_t node);
+
+  // Inherited from Ipv4RoutingProtocol
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                            UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                            LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param destination a destination address
+   * \return the route to the destination, or 0
+   */
+  Ptr<Ipv4Route> Lookup (Ipv4Address destination) const;
+
+  Ptr<Ipv4> m_ipv4;                       //!< the IPv4 of the node
+  Ptr<LeoSnapshotRoutingTable> m_table;   //!< the tables
+  uint32_t m_node;                        //!< index of the node in the table
+};
+
+} // namespace ns3
+
+#endif /* LEO_SNAPSHOT_ROUTING_H */
@@ -0,0 +1,329 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Visibility service
+ * Finds the satellites seen by ground stations, and predicts the handovers
+ */
+
+#include "leo-visibility-service.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include <algorithm>
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoVisibilityService");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoVisibilityService);
+
+extern double earthRadius;
+
+/**
+ * \param a a satellite
+ * \param b another satellite
+ * \return whether a is closer than b
+ */
+static bool
+IsCloser (const LeoVisibility &a, const LeoVisibility &b)
+{
+  return a.distance < b.distance;
+}
+
+TypeId
+LeoVisibilityService::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoVisibilityService")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoVisibilityService> ()
+    .AddAttribute ("ElevationMask",
+                   "Smallest elevation of a visible satellite [degrees].",
+                   DoubleValue (10),
+                   MakeDoubleAccessor (&LeoVisibilityService::m_mask),
+                   MakeDoubleChecker<double> (-90, 90))
+    .AddAttribute ("CellSize",
+                   "Size of the cells of the grid, in latitude and longitude [degrees].",
+                   DoubleValue (10),
+                   MakeDoubleAccessor (&LeoVisibilityService::m_cellSize),
+                   MakeDoubleChecker<double> (0.1, 180))
+    .AddAttribute ("Step",
+                   "Time step of the handover predictions.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&LeoVisibilityService::m_step),
+                   MakeTimeChecker ())
+    .AddAttribute ("Resolution",
+                   "Precision of the predicted handover times.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&LeoVisibilityService::m_resolution),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+LeoVisibilityService::LeoVisibilityService ()
+  : m_nBands (0),
+    m_nColumns (0),
+    m_coverage (0),
+    m_gridValid (false)
+{
+}
+
+LeoVisibilityService::~LeoVisibilityService ()
+{
+}
+
+void
+LeoVisibilityService::SetPropagator (Ptr<LeoConstellationPropagator> propagator)
+{
+  m_propagator = propagator;
+  m_gridValid = false;
+}
+
+uint32_t
+LeoVisibilityService::AddGroundStation (const Vector &position)
+{
+  m_stations.push_back (position);
+  m_stationCartesian.push_back (LeoConstellationPropagator::GetCartesian (position));
+  return m_stations.size () - 1;
+}
+
+uint32_t
+LeoVisibilityService::GetNGroundStations (void) const
+{
+  return m_stations.size ();
+}
+
+void
+LeoVisibilityService::BuildGrid (Time t)
+{
+  if (m_gridValid && m_gridTime == t)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << t);
+  NS_ASSERT (m_propagator != 0);
+  m_propagator->GetPositions (t, m_positions);
+  uint32_t n = m_positions.size ();
+  m_cartesian.resize (n);
+
+  // the coverage angle of a satellite grows with its altitude
+  double highest = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_cartesian[i] = LeoConstellationPropagator::GetCartesian (m_positions[i]);
+      highest = std::max (highest, m_positions[i].z);
+    }
+  double mask = m_mask*M_PI/180;
+  m_coverage = (std::acos (earthRadius*std::cos (mask)/(earthRadius + highest)) - mask)*180/M_PI;
+
+  // counting sort of the satellites by cell
+  m_nBands = std::ceil (180/m_cellSize);
+  m_nColumns = std::ceil (360/m_cellSize);
+  std::vector<uint32_t> cells (n);
+  m_cellStart.assign (m_nBands*m_nColumns + 1, 0);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t band = std::min<uint32_t> (m_nBands - 1, std::floor ((m_positions[i].x + 90)/m_cellSize));
+      double longitude = m_positions[i].y + 180 - 360*std::floor ((m_positions[i].y + 180)/360);
+      uint32_t column = std::min<uint32_t> (m_nColumns - 1, std::floor (longitude/m_cellSize));
+      cells[i] = band*m_nColumns + column;
+      m_cellStart[cells[i] + 1]++;
+    }
+  for (uint32_t c = 0; c < m_nBands*m_nColumns; c++)
+    {
+      m_cellStart[c + 1] += m_cellStart[c];
+    }
+  m_cellSatellites.resize (n);
+  std::vector<uint32_t> fill (m_cellStart.begin (), m_cellStart.end () - 1);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_cellSatellites[fill[cells[i]]++] = i;
+    }
+  m_gridTime = t;
+  m_gridValid = true;
+}
+
+void
+LeoVisibilityService::Search (uint32_t station, double angle, std::vector<uint32_t> &satellites) const
+{
+  satellites.clear ();
+  double latitude = m_stations[station].x;
+  double longitude = m_stations[station].y;
+  double south = std::max (-90.0, latitude - angle);
+  double north = std::min (90.0, latitude + angle);
+  uint32_t firstBand = std::min<uint32_t> (m_nBands - 1, std::floor ((south + 90)/m_cellSize));
+  uint32_t lastBand = std::min<uint32_t> (m_nBands - 1, std::floor ((north + 90)/m_cellSize));
+
+  // longitudes of the cap, all of them if it covers a pole
+  int32_t firstColumn = 0;
+  int32_t lastColumn = m_nColumns - 1;
+  if (north < 90 && south > -90)
+    {
+      double sine = std::sin (angle*M_PI/180)/std::cos (latitude*M_PI/180);
+      double width = (sine >= 1) ? 180 : std::asin (sine)*180/M_PI;
+      int32_t first = std::floor ((longitude - width + 180)/m_cellSize);
+      int32_t last = std::floor ((longitude + width + 180)/m_cellSize);
+      if (last - first + 1 < static_cast<int32_t> (m_nColumns))
+        {
+          firstColumn = first;
+          lastColumn = last;
+        }
+    }
+
+  int32_t nColumns = m_nColumns;
+  for (uint32_t band = firstBand; band <= lastBand; band++)
+    {
+      for (int32_t k = firstColumn; k <= lastColumn; k++)
+        {
+          uint32_t cell = band*m_nColumns + ((k % nColumns) + nColumns) % nColumns;
+          satellites.insert (satellites.end (),
+                             m_cellSatellites.begin () + m_cellStart[cell],
+                             m_cellSatellites.begin () + m_cellStart[cell + 1]);
+        }
+    }
+}
+
+LeoVisibility
+LeoVisibilityService::Look (uint32_t station, uint32_t satellite) const
+{
+  const Vector &ground = m_stationCartesian[station];
+  Vector d = m_cartesian[satellite] - ground;
+  LeoVisibility look;
+  look.satellite = satellite;
+  look.distance = d.GetLength ();
+  double up = (d.x*ground.x + d.y*ground.y + d.z*ground.z)/(look.distance*ground.GetLength ());
+  look.elevation = std::asin (std::max (-1.0, std::min (1.0, up)))*180/M_PI;
+  return look;
+}
+
+void
+LeoVisibilityService::GetVisible (uint32_t station, Time t, std::vector<LeoVisibility> &visible)
+{
+  NS_ASSERT (station < m_stations.size ());
+  BuildGrid (t);
+  visible.clear ();
+  std::vector<uint32_t> satellites;
+  Search (station, m_coverage, satellites);
+  for (uint32_t i = 0; i < satellites.size (); i++)
+    {
+      LeoVisibility look = Look (station, satellites[i]);
+      if (look.elevation >= m_mask)
+        {
+          visible.push_back (look);
+        }
+    }
+  std::sort (visible.begin (), visible.end (), IsCloser);
+}
+
+void
+LeoVisibilityService::GetVisible (Time t, std::vector<std::vector<LeoVisibility> > &visible)
+{
+  visible.resize (m_stations.size ());
+  for (uint32_t s = 0; s < m_stations.size (); s++)
+    {
+      GetVisible (s, t, visible[s]);
+    }
+}
+
+bool
+LeoVisibilityService::FindClosest (uint32_t station, Time t, const std::vector<bool> &busy, LeoVisibility &closest)
+{
+  NS_ASSERT (station < m_stations.size ());
+  BuildGrid (t);
+  std::vector<uint32_t> satellites;
+  Search (station, m_coverage, satellites);
+  bool found = false;
+  for (uint32_t i = 0; i < satellites.size (); i++)
+    {
+      if (!busy.empty () && busy[satellites[i]])
+        {
+          continue;
+        }
+      LeoVisibility look = Look (station, satellites[i]);
+      if (look.elevation >= m_mask && (!found || look.distance < closest.distance))
+        {
+          closest = look;
+          found = true;
+        }
+    }
+  if (found)
+    {
+      return true;
+    }
+
+  // no satellite above the mask: the closest one
+  for (uint32_t i = 0; i < m_positions.size (); i++)
+    {
+      if (!busy.empty () && busy[i])
+        {
+          continue;
+        }
+      LeoVisibility look = Look (station, i);
+      if (!found || look.distance < closest.distance)
+        {
+          closest = look;
+          found = true;
+        }
+    }
+  NS_ABORT_MSG_IF (!found, "No satellite available for ground station " << station);
+  NS_LOG_LOGIC ("ground station " << station << ": no satellite above the mask, closest " << closest.satellite
+                                  << " at " << closest.elevation << " degrees");
+  return false;
+}
+
+LeoVisibility
+LeoVisibilityService::Observe (uint32_t station, uint32_t satellite, Time t)
+{
+  NS_ASSERT (station < m_stations.size ());
+  BuildGrid (t);
+  NS_ASSERT (satellite < m_positions.size ());
+  return Look (station, satellite);
+}
+
+uint32_t
+LeoVisibilityService::GetServing (uint32_t station, Time t)
+{
+  LeoVisibility closest;
+  FindClosest (station, t, std::vector<bool> (), closest);
+  return closest.satellite;
+}
+
+Time
+LeoVisibilityService::PredictHandover (uint32_t station, Time t, Time horizon)
+{
+  NS_LOG_FUNCTION (this << station << t << horizon);
+  NS_ABORT_MSG_IF (m_step <= Seconds (0) || m_resolution <= Seconds (0), "Bad step or resolution");
+  uint32_t serving = GetServing (station, t);
+  Time end = t + horizon;
+  Time before = t;
+  while (before < end)
+    {
+      Time after = std::min (before + m_step, end);
+      if (GetServing (station, after) != serving)
+        {
+          // the serving satellite changes between before and after
+          while (after - before > m_resolution)
+            {
+              Time middle = before + TimeStep ((after - before).GetTimeStep () / 2);
+              if (GetServing (station, middle) != serving)
+                {
+                  after = middle;
+                }
+              else
+                {
+                  before = middle;
+                }
+            }
+          NS_LOG_LOGIC ("ground station " << station << ": handover from satellite " << serving
+                                          << " at " << after.GetSeconds ());
+          return after;
+        }
+      before = after;
+    }
+  return end;
+}
+
+} // namespace ns3
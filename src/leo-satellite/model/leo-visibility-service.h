@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Visibility service
+ * Finds the satellites seen by ground stations, and predicts the handovers
+ */
+#ifndef LEO_VISIBILITY_SERVICE_H
+#define LEO_VISIBILITY_SERVICE_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/leo-constellation-propagator.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief A satellite as seen from a ground station
+ */
+struct LeoVisibility
+{
+  uint32_t satellite;  //!< index of the satellite in the propagator
+  double elevation;    //!< elevation above the horizon [degrees]
+  double distance;     //!< distance to the satellite [km]
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief Visibility of the satellites of a constellation from ground stations.
+ *
+ * The sub-satellite points of all the satellites are sorted in a grid of
+ * CellSize by CellSize degrees of latitude and longitude, once per time
+ * asked. A satellite above the ElevationMask of a ground station is within
+ * the coverage angle of its altitude from the station, so only the cells
+ * of that spherical cap are searched, for any number of ground stations.
+ * The distances are computed from cartesian coordinates, over the poles
+ * as well.
+ *
+ * The serving satellite of a ground station is the closest satellite above
+ * the mask, or the closest satellite if none is above the mask.
+ * PredictHandover steps forward in time until the serving satellite
+ * changes, and finds the time of the change by bisection.
+ */
+class LeoVisibilityService : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LeoVisibilityService ();
+  virtual ~LeoVisibilityService ();
+
+  /**
+   * \param propagator the propagator of the satellites
+   */
+  void SetPropagator (Ptr<LeoConstellationPropagator> propagator);
+  /**
+   * \param position position of the ground station, as (latitude,
+   * longitude, altitude [km])
+   * \return the index of the ground station
+   */
+  uint32_t AddGroundStation (const Vector &position);
+  /**
+   * \return the number of ground stations
+   */
+  uint32_t GetNGroundStations (void) const;
+
+  /**
+   * \param t the time
+   * \param visible receives, for each ground station, the satellites above
+   * the mask by increasing distance
+   */
+  void GetVisible (Time t, std::vector<std::vector<LeoVisibility> > &visible);
+  /**
+   * \param station a ground station
+   * \param t the time
+   * \param visible receives the satellites above the mask by increasing distance
+   */
+  void GetVisible (uint32_t station, Time t, std::vector<LeoVisibility> &visible);
+  /**
+   * Find the serving satellite of a ground station among the satellites
+   * which are not busy
+   * \param station a ground station
+   * \param t the time
+   * \param busy the satellites which cannot serve, indexed as in the
+   * propagator, or empty
+   * \param closest receives the closest satellite above the mask, or the
+   * closest satellite if none is above the mask
+   * \return whether the satellite is above the mask
+   */
+  bool FindClosest (uint32_t station, Time t, const std::vector<bool> &busy, LeoVisibility &closest);
+  /**
+   * \param station a ground station
+   * \param t the time
+   * \param horizon the longest prediction
+   * \return the first time after t at which the serving satellite of the
+   * ground station changes, or t + horizon
+   */
+  Time PredictHandover (uint32_t station, Time t, Time horizon);
+  /**
+   * \param station a ground station
+   * \param satellite a satellite
+   * \param t the time
+   * \return the satellite as seen from the ground station
+   */
+  LeoVisibility Observe (uint32_t station, uint32_t satellite, Time t);
+
+private:
+  /**
+   * Sort the satellites in the cells of the grid at a time
+   * \param t the time
+   */
+  void BuildGrid (Time t);
+  /**
+   * \param station a ground station
+   * \param angle the radius of the cap [degrees]
+   * \param satellites receives the satellites of the cells of the cap
+   */
+  void Search (uint32_t station, double angle, std::vector<uint32_t> &satellites) const;
+  /**
+   * \param station a ground station
+   * \param satellite a satellite
+   * \return the satellite as seen from the ground station at the time of the grid
+   */
+  LeoVisibility Look (uint32_t station, uint32_t satellite) const;
+  /**
+   * \param station a ground station
+   * \param t the time
+   * \return the serving satellite of the ground station
+   */
+  uint32_t GetServing (uint32_t station, Time t);
+
+  Ptr<LeoConstellationPropagator> m_propagator;   //!< the positions
+  double m_mask;                                  //!< elevation mask [degrees]
+  double m_cellSize;                              //!< size of the cells [degrees]
+  Time m_step;                                    //!< step of the predictions
+  Time m_resolution;                              //!< precision of the predicted times
+
+  std::vector<Vector> m_stations;                 //!< position of each ground station
+  std::vector<Vector> m_stationCartesian;         //!< cartesian position of each ground station [km]
+
+  // Grid at m_gridTime
+  std::vector<Vector> m_positions;                //!< positions of the satellites
+  std::vector<Vector> m_cartesian;                //!< cartesian positions of the satellites [km]
+  std::vector<uint32_t> m_cellStart;              //!< first satellite of each cell in m_cellSatellites
+  std::vector<uint32_t> m_cellSatellites;         //!< the satellites, cell by cell
+  uint32_t m_nBands;                              //!< number of cells in latitude
+  uint32_t m_nColumns;                            //!< number of cells in longitude
+  double m_coverage;                              //!< coverage angle of the highest satellite [degrees]
+  Time m_gridTime;                                //!< time of the grid
+  bool m_gridValid;                               //!< whether the grid holds positions
+};
+
+} // namespace ns3
+
+#endif /* LEO_VISIBILITY_SERVICE_H */
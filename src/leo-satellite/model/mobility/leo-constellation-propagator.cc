@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Constellation propagator
+ * Computes the positions of all the satellites of a constellation at once
+ */
+
+#include "leo-constellation-propagator.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoConstellationPropagator");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoConstellationPropagator);
+
+extern double earthRadius;
+
+TypeId
+LeoConstellationPropagator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoConstellationPropagator")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<LeoConstellationPropagator> ()
+  ;
+  return tid;
+}
+
+LeoConstellationPropagator::LeoConstellationPropagator ()
+  : m_cacheValid (false)
+{
+}
+
+LeoConstellationPropagator::~LeoConstellationPropagator ()
+{
+}
+
+uint32_t
+LeoConstellationPropagator::AddSatellite (double latitude, double longitude, bool direction, double altitude, double epoch)
+{
+  uint32_t index;
+  {
+    CriticalSection cs (m_mutex);
+    index = m_phase.size ();
+    m_phase.push_back (0);
+    m_rate.push_back (0);
+    m_epoch.push_back (0);
+    m_ascLongitude.push_back (0);
+    m_descLongitude.push_back (0);
+    m_altitude.push_back (0);
+    m_sinInclination.push_back (1);
+    m_cosInclination.push_back (0);
+    m_isInclined.push_back (false);
+    m_latitude.push_back (0);
+    m_longitude.push_back (0);
+  }
+  SetSatellite (index, latitude, longitude, direction, altitude, epoch);
+  return index;
+}
+
+void
+LeoConstellationPropagator::SetSatellite (uint32_t index, double latitude, double longitude, bool direction, double altitude, double epoch)
+{
+  NS_ASSERT (index < m_phase.size ());
+  NS_ASSERT_MSG (!m_isInclined[index], "Satellite " << index << " is in an inclined orbit");
+  CriticalSection cs (m_mutex);
+  // The longitude of the other half of the orbit is on the other side of the pole
+  double opposite = (longitude < 0) ? longitude + 180 : longitude - 180;
+  m_phase[index] = direction ? latitude : 180 - latitude;
+  m_rate[index] = GetRate (altitude);
+  m_epoch[index] = epoch;
+  m_ascLongitude[index] = direction ? longitude : opposite;
+  m_descLongitude[index] = direction ? opposite : longitude;
+  m_altitude[index] = altitude;
+  m_cacheValid = false;
+  NS_LOG_LOGIC ("satellite " << index << " phase " << m_phase[index] << " rate " << m_rate[index]);
+}
+
+uint32_t
+LeoConstellationPropagator::AddOrbit (double inclination, double ascendingNode, double phase, double altitude, double epoch)
+{
+  CriticalSection cs (m_mutex);
+  uint32_t index = m_phase.size ();
+  m_phase.push_back (phase);
+  m_rate.push_back (GetRate (altitude));
+  m_epoch.push_back (epoch);
+  m_ascLongitude.push_back (ascendingNode);
+  m_descLongitude.push_back (ascendingNode);
+  m_altitude.push_back (altitude);
+  m_sinInclination.push_back (std::sin (inclination*M_PI/180));
+  m_cosInclination.push_back (std::cos (inclination*M_PI/180));
+  m_isInclined.push_back (true);
+  m_inclined.push_back (index);
+  m_latitude.push_back (0);
+  m_longitude.push_back (0);
+  m_cacheValid = false;
+  NS_LOG_LOGIC ("satellite " << index << " inclination " << inclination << " node " << ascendingNode << " phase " << phase);
+  return index;
+}
+
+double
+LeoConstellationPropagator::GetRate (double altitude)
+{
+  // Speed of the circular orbit, then degrees travelled per second
+  double G = 6.673e-11; // gravitational constant [Nm^2/kg^2]
+  double earthMass = 5.972e24; // mass of Earth [kg]
+  double radius = earthRadius + altitude; // [km]
+  double speed = std::sqrt (G*earthMass/(radius*1000)); // [m/s]
+  double orbitalPeriod = 2*M_PI*radius/(speed/1000); // [seconds]
+  return 360/orbitalPeriod;
+}
+
+void
+LeoConstellationPropagator::GetInclinedPosition (uint32_t index, double u, double &latitude, double &longitude) const
+{
+  double sine = std::sin (u*M_PI/180);
+  double cosine = std::cos (u*M_PI/180);
+  latitude = std::asin (m_sinInclination[index]*sine)*180/M_PI;
+  longitude = m_ascLongitude[index] + std::atan2 (m_cosInclination[index]*sine, cosine)*180/M_PI;
+  longitude -= 360*std::floor ((longitude + 180)/360);
+}
+
+uint32_t
+LeoConstellationPropagator::GetN (void) const
+{
+  return m_phase.size ();
+}
+
+double
+LeoConstellationPropagator::GetAngularRate (uint32_t index) const
+{
+  NS_ASSERT (index < m_rate.size ());
+  return m_rate[index];
+}
+
+double
+LeoConstellationPropagator::GetPhase (uint32_t index, Time t) const
+{
+  NS_ASSERT (index < m_phase.size ());
+  CriticalSection cs (m_mutex);
+  double u = m_phase[index] + m_rate[index]*(t.GetSeconds () - m_epoch[index]);
+  return u - 360*std::floor ((u + 90)/360);
+}
+
+double
+LeoConstellationPropagator::GetAscendingLongitude (uint32_t index) const
+{
+  NS_ASSERT (index < m_ascLongitude.size ());
+  return m_ascLongitude[index];
+}
+
+Vector
+LeoConstellationPropagator::GetCartesian (const Vector &position)
+{
+  double latitude = position.x*M_PI/180;
+  double longitude = position.y*M_PI/180;
+  double radius = earthRadius + position.z;
+  return Vector (radius*std::cos (latitude)*std::cos (longitude),
+                 radius*std::cos (latitude)*std::sin (longitude),
+                 radius*std::sin (latitude));
+}
+
+void
+LeoConstellationPropagator::Propagate (Time t) const
+{
+  NS_LOG_FUNCTION (this << t);
+  double now = t.GetSeconds ();
+  uint32_t n = m_phase.size ();
+  const double *phase = m_phase.data ();
+  const double *rate = m_rate.data ();
+  const double *epoch = m_epoch.data ();
+  const double *ascLongitude = m_ascLongitude.data ();
+  const double *descLongitude = m_descLongitude.data ();
+  double *latitude = m_latitude.data ();
+  double *longitude = m_longitude.data ();
+  // No branch in the loop, so that the compiler can vectorize it
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double u = phase[i] + rate[i]*(now - epoch[i]);
+      u -= 360*std::floor ((u + 90)/360);
+      bool ascending = u < 90;
+      latitude[i] = ascending ? u : 180 - u;
+      longitude[i] = ascending ? ascLongitude[i] : descLongitude[i];
+    }
+  // then the inclined orbits, over the polar positions of their satellites
+  for (uint32_t k = 0; k < m_inclined.size (); k++)
+    {
+      uint32_t i = m_inclined[k];
+      GetInclinedPosition (i, phase[i] + rate[i]*(now - epoch[i]), latitude[i], longitude[i]);
+    }
+  m_cacheTime = t;
+  m_cacheValid = true;
+}
+
+Vector
+LeoConstellationPropagator::GetPosition (uint32_t index, Time t) const
+{
+  NS_ASSERT (index < m_phase.size ());
+  CriticalSection cs (m_mutex);
+  if (!m_cacheValid || m_cacheTime != t)
+    {
+      Propagate (t);
+    }
+  return Vector (m_latitude[index], m_longitude[index], m_altitude[index]);
+}
+
+Vector
+LeoConstellationPropagator::ComputePosition (uint32_t index, Time t) const
+{
+  double u = GetPhase (index, t);
+  if (m_isInclined[index])
+    {
+      double latitude;
+      double longitude;
+      GetInclinedPosition (index, u, latitude, longitude);
+      return Vector (latitude, longitude, m_altitude[index]);
+    }
+  bool ascending = u < 90;
+  return Vector (ascending ? u : 180 - u,
+                 ascending ? m_ascLongitude[index] : m_descLongitude[index],
+                 m_altitude[index]);
+}
+
+void
+LeoConstellationPropagator::GetPositions (Time t, std::vector<Vector> &positions) const
+{
+  CriticalSection cs (m_mutex);
+  if (!m_cacheValid || m_cacheTime != t)
+    {
+      Propagate (t);
+    }
+  positions.resize (m_phase.size ());
+  for (uint32_t i = 0; i < positions.size (); i++)
+    {
+      positions[i] = Vector (m_latitude[i], m_longitude[i], m_altitude[i]);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Constellation propagator
+ * Computes the positions of all the satellites of a constellation at once
+ */
+#ifndef LEO_CONSTELLATION_PROPAGATOR_H
+#define LEO_CONSTELLATION_PROPAGATOR_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/system-mutex.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief Positions of the satellites of a constellation in closed form.
+ *
+ * A satellite in a polar orbit is described by its orbital phase u, in
+ * degrees, -90 at the south pole, 0 at the equator going north and 180 at
+ * the equator going south, and by the longitudes of the ascending (S to N)
+ * and of the descending half of its orbit. Its position at time t only
+ * depends on t:
+ *   u = u0 + rate * (t - epoch) wrapped to [-90, 270)
+ *   latitude = u on the ascending half, 180 - u on the descending one
+ *
+ * A satellite in an inclined circular orbit is described by the
+ * inclination i of the orbit, the longitude of its ascending node and its
+ * argument of latitude u, counted from the ascending node:
+ *   latitude = asin (sin i sin u)
+ *   longitude = ascending node + atan2 (cos i sin u, cos u)
+ * The Earth does not rotate under the orbits, as for the polar ones.
+ *
+ * The satellites are stored as arrays, one per parameter, and the
+ * positions of all of them are computed in one branch-free pass the first
+ * time a position is asked at a new time, then read from the cache until
+ * the time changes. The result does not depend on the order of the calls,
+ * and the cache is protected by a mutex so the satellites can be read from
+ * several threads.
+ */
+class LeoConstellationPropagator : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LeoConstellationPropagator ();
+  virtual ~LeoConstellationPropagator ();
+
+  /**
+   * Add a satellite
+   * \param latitude latitude at the epoch [degrees]
+   * \param longitude longitude at the epoch [degrees]
+   * \param direction 1 if the satellite moves from south to north at the epoch
+   * \param altitude altitude [km], which gives the speed of the satellite
+   * \param epoch time of the latitude and longitude [s]
+   * \return the index of the satellite
+   */
+  uint32_t AddSatellite (double latitude, double longitude, bool direction, double altitude, double epoch);
+  /**
+   * Move a satellite
+   * \param index index of the satellite
+   * \param latitude latitude at the epoch [degrees]
+   * \param longitude longitude at the epoch [degrees]
+   * \param direction 1 if the satellite moves from south to north at the epoch
+   * \param altitude altitude [km], which gives the speed of the satellite
+   * \param epoch time of the latitude and longitude [s]
+   */
+  void SetSatellite (uint32_t index, double latitude, double longitude, bool direction, double altitude, double epoch);
+  /**
+   * Add a satellite in an inclined circular orbit
+   * \param inclination inclination of the orbit [degrees]
+   * \param ascendingNode longitude of the ascending node [degrees]
+   * \param phase argument of latitude at the epoch [degrees]
+   * \param altitude altitude [km], which gives the speed of the satellite
+   * \param epoch time of the phase [s]
+   * \return the index of the satellite
+   */
+  uint32_t AddOrbit (double inclination, double ascendingNode, double phase, double altitude, double epoch);
+  /**
+   * \return the number of satellites
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param index index of a satellite
+   * \param t the time
+   * \return the position of the satellite at the time, as (latitude,
+   * longitude, altitude)
+   */
+  Vector GetPosition (uint32_t index, Time t) const;
+  /**
+   * \param t the time
+   * \param positions receives the positions of all the satellites at the time
+   */
+  void GetPositions (Time t, std::vector<Vector> &positions) const;
+  /**
+   * \param index index of a satellite
+   * \param t the time
+   * \return the position of the satellite at the time, computed without
+   * the cache, for the lookups of a few satellites at many times
+   */
+  Vector ComputePosition (uint32_t index, Time t) const;
+  /**
+   * \param index index of a satellite
+   * \param t the time
+   * \return the orbital phase of the satellite at the time, in [-90, 270)
+   * degrees, computed without the cache; the argument of latitude for an
+   * inclined orbit
+   */
+  double GetPhase (uint32_t index, Time t) const;
+  /**
+   * \param index index of a satellite
+   * \return the longitude of the ascending (S to N) half of the orbit of the
+   * satellite, its ascending node for an inclined orbit
+   */
+  double GetAscendingLongitude (uint32_t index) const;
+  /**
+   * \param index index of a satellite
+   * \return the angular speed of the satellite [degrees/s]
+   */
+  double GetAngularRate (uint32_t index) const;
+  /**
+   * \param position a position, as (latitude, longitude, altitude [km])
+   * \return its cartesian coordinates, centered on the Earth [km]
+   */
+  static Vector GetCartesian (const Vector &position);
+
+private:
+  /**
+   * Compute the positions of all the satellites in the cache, the mutex
+   * being held
+   * \param t the time
+   */
+  void Propagate (Time t) const;
+  /**
+   * \param altitude altitude of a circular orbit [km]
+   * \return the angular speed of a satellite on the orbit [degrees/s]
+   */
+  static double GetRate (double altitude);
+  /**
+   * \param index index of a satellite in an inclined orbit
+   * \param u its argument of latitude [degrees]
+   * \param latitude receives its latitude [degrees]
+   * \param longitude receives its longitude, in [-180, 180) [degrees]
+   */
+  void GetInclinedPosition (uint32_t index, double u, double &latitude, double &longitude) const;
+
+  // The satellites, one element per satellite in each array
+  std::vector<double> m_phase;           //!< orbital phase at the epoch [degrees]
+  std::vector<double> m_rate;            //!< angular speed [degrees/s]
+  std::vector<double> m_epoch;           //!< time of the phase [s]
+  std::vector<double> m_ascLongitude;    //!< longitude of the ascending half of the orbit
+  std::vector<double> m_descLongitude;   //!< longitude of the descending half of the orbit
+  std::vector<double> m_altitude;        //!< altitude [km]
+  std::vector<double> m_sinInclination;  //!< sine of the inclination of the inclined orbits
+  std::vector<double> m_cosInclination;  //!< cosine of the inclination of the inclined orbits
+  std::vector<bool> m_isInclined;        //!< whether the satellite is in an inclined orbit
+  std::vector<uint32_t> m_inclined;      //!< the satellites in inclined orbits
+
+  // Positions at m_cacheTime
+  mutable std::vector<double> m_latitude;   //!< latitudes of the satellites
+  mutable std::vector<double> m_longitude;  //!< longitudes of the satellites
+  mutable Time m_cacheTime;                 //!< time of the cached positions
+  mutable bool m_cacheValid;                //!< whether the cache holds positions
+  mutable SystemMutex m_mutex;              //!< protects the cache
+};
+
+} // namespace ns3
+
+#endif /* LEO_CONSTELLATION_PROPAGATOR_H */
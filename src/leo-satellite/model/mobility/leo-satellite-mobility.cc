@@ -15,9 +15,11 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/integer.h"
+#include "ns3/pointer.h"
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 namespace ns3 {
 
@@ -68,17 +70,47 @@ LeoSatelliteMobilityModel::GetTypeId (void)
                    BooleanValue(1),
                    MakeBooleanAccessor (&LeoSatelliteMobilityModel::m_direction),
                    MakeBooleanChecker ())
+    .AddAttribute ("Propagator",
+                   "Propagator of the constellation, computing the positions of its satellites at once.",
+                   PointerValue (),
+                   MakePointerAccessor (&LeoSatelliteMobilityModel::m_propagator),
+                   MakePointerChecker<LeoConstellationPropagator> ())
   ;
 
   return tid;
 }
 
 LeoSatelliteMobilityModel::LeoSatelliteMobilityModel()
+  : m_index (std::numeric_limits<uint32_t>::max ()),
+    m_fixedOrbit (false)
 {
   currentNode++;
   m_current = currentNode;
 }
 
+Ptr<LeoConstellationPropagator>
+LeoSatelliteMobilityModel::GetPropagator (void) const
+{
+  return m_propagator;
+}
+
+uint32_t
+LeoSatelliteMobilityModel::GetPropagatorIndex (void) const
+{
+  return m_index;
+}
+
+void
+LeoSatelliteMobilityModel::SetOrbit (Ptr<LeoConstellationPropagator> propagator, uint32_t index)
+{
+  NS_ASSERT (index < propagator->GetN ());
+  m_propagator = propagator;
+  m_index = index;
+  m_altitude = propagator->GetPosition (index, Simulator::Now ()).z;
+  m_fixedOrbit = true;
+  NotifyCourseChange ();
+}
+
 /* To be called after MobilityModel object is created to set position.
    Input should be a NULL vector as position is determined by number of orbital planes and number of satellites per   
    orbital plane
@@ -96,13 +128,10 @@ LeoSatelliteMobilityModel::LeoSatelliteMobilityModel()
 void 
 LeoSatelliteMobilityModel::DoSetPosition (const Vector &position)
 {
-  // Determine speed of satellite from altitude
-  double G = 6.673e-11; // gravitational constant [Nm^2/kg^2]
-  double earthMass = 5.972e24; // mass of Earth [kg]
-  double altitude = m_altitude;
-
-  m_speed = std::sqrt(G*earthMass/(earthRadius*1000 + altitude*1000));
-
+  if (m_fixedOrbit)
+  {
+    return;
+  }
   // Set latitude and longitude of satellite from number of orbital planes and number of satellites per orbital plane
   // First satellite in plane will have a longitude that is a half-step down from 90 degrees 
   if (m_current == 1)
@@ -122,86 +151,27 @@ LeoSatelliteMobilityModel::DoSetPosition (const Vector &position)
   // Set direction based on which orbital plane satellite belongs to
   uint32_t plane = floor((m_current - 1)/(m_nPerPlane/2));
   (plane % 2 == 1) ? m_direction = 0: m_direction = 1;
+
+  // The propagator derives the speed of the satellite from its altitude
+  if (m_propagator == 0)
+  {
+    m_propagator = CreateObject<LeoConstellationPropagator> ();
+  }
+  if (m_index == std::numeric_limits<uint32_t>::max ())
+  {
+    m_index = m_propagator->AddSatellite (m_latitude, m_longitude, m_direction, m_altitude, m_time);
+  }
+  else
+  {
+    m_propagator->SetSatellite (m_index, m_latitude, m_longitude, m_direction, m_altitude, m_time);
+  }
 }
 
 Vector
 LeoSatelliteMobilityModel::DoGetPosition (void) const
 {
-   double altitude = m_altitude;
-   double latitude = m_latitude;
-   double longitude = m_longitude;
-   bool direction = m_direction; 
-   double currentTime = Simulator::Now().GetSeconds();
-   double radius = earthRadius + altitude; 
-   double newLatitude;
-
-   // How many orbital periods have been completed, then converted to degree displacement
-   double orbitalPeriod = 2*M_PI*radius/(m_speed/1000); // [seconds]
-   double orbitalPeriodTravelled = (currentTime - m_time)/orbitalPeriod;
-   double degreeDisplacement = fmod(orbitalPeriodTravelled*360, 360); 
-
-   if (direction == 1)
-   {
-      if ((latitude + degreeDisplacement) > 90)
-      {
-         degreeDisplacement = degreeDisplacement - (90 - latitude); // We've accounted for the degrees taken to get to north pole
-         latitude = 90;
-         if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-         direction = 0;
-
-        if ((latitude - degreeDisplacement) < -90)
-        {
-          degreeDisplacement = degreeDisplacement - 180; // We've accounted for the degrees taken to get to south pole
-          latitude = -90;
-          if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-          direction = 1;
-        }
-      }
-      (direction == 1) ? newLatitude = latitude + degreeDisplacement : newLatitude = latitude - degreeDisplacement;
-   }
-
-  //  else if (direction == 0)
-   else
-   {
-      if ((latitude - degreeDisplacement) < -90)
-      {
-         degreeDisplacement = degreeDisplacement - (latitude - (-90)); // We've accounted for the degrees taken to get to south pole
-         latitude = -90;
-         if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-         direction = 1;
-
-        if ((latitude + degreeDisplacement) > 90)
-        {
-          degreeDisplacement = degreeDisplacement - 180; // We've accounted for the degrees taken to get to north pole
-          latitude = 90;
-          if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-          direction = 0;
-        }
-      }
-      (direction == 1) ? newLatitude = latitude + degreeDisplacement : newLatitude = latitude - degreeDisplacement;
-   }
-   
-   // Update latitude, longitude, direction, and time values for this object
-   m_latitude = newLatitude;
-   m_longitude = longitude;
-   m_time = currentTime;
-   m_direction = direction;
-
-   // Create vector to return
-   Vector currentPosition = Vector(m_latitude, m_longitude, altitude);
-   return currentPosition;
+  NS_ASSERT_MSG (m_propagator != 0, "SetPosition must be called to initialize the satellite");
+  return m_propagator->GetPosition (m_index, Simulator::Now ());
 }
 
 /* Args "a" and "b" to be obtained from LeoSatelliteMobilityModel::DoGetPosition for each argument 
@@ -14,6 +14,7 @@
 #include "ns3/ptr.h"
 #include "ns3/mobility-model.h"
 #include "ns3/vector.h"
+#include "leo-constellation-propagator.h"
 
 namespace ns3 {
 
@@ -24,6 +25,11 @@ namespace ns3 {
  * Each satellite moves in a polar orbit within its plane
  * Satellites move with a fixed velocity determined by their altitude
  * Satellites in adjacent planes move in opposing directions
+ *
+ * The position is read from a LeoConstellationPropagator, shared by the
+ * satellites of a constellation through the Propagator attribute, which
+ * computes it from the current time only. Without a propagator, the
+ * satellite gets its own one at SetPosition.
  */
 class LeoSatelliteMobilityModel : public MobilityModel
 {
@@ -35,6 +41,23 @@ public:
   static TypeId GetTypeId (void);
   LeoSatelliteMobilityModel();
 
+  /**
+   * \return the propagator of the satellite, null before SetPosition
+   */
+  Ptr<LeoConstellationPropagator> GetPropagator (void) const;
+  /**
+   * \return the index of the satellite in its propagator
+   */
+  uint32_t GetPropagatorIndex (void) const;
+  /**
+   * Follow a satellite already added to a propagator, like an inclined
+   * orbit, instead of the polar orbit set at SetPosition, which then keeps
+   * the orbit
+   * \param propagator the propagator
+   * \param index the index of the satellite in the propagator
+   */
+  void SetOrbit (Ptr<LeoConstellationPropagator> propagator, uint32_t index);
+
 private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
@@ -43,16 +66,18 @@ private:
   uint32_t m_current; // current node
   double m_nPerPlane; // number of satellites per plane -> m_nPerPlane/2 must be even number
   double m_numPlanes; // number of planes -> must be an odd number
-  mutable double m_time; // time when current m_latitude, m_longitude, and m_direction were set
+  double m_time; // time when the initial m_latitude, m_longitude, and m_direction were set
   double m_altitude; // [km]
   // The following variables are calculated automatically given the above parameteres
-  mutable double m_latitude; // latitude of satellite at m_time
+  double m_latitude; // initial latitude of satellite
                      // negative value indicates southern latitude, positive value indicates northern latitude
-  mutable double m_longitude; // initial longitude of satellite
+  double m_longitude; // initial longitude of satellite
                       // negative value indicates western longitude, positive value indicates eastern longitude
-  mutable bool m_direction; // each adjacent plane will be orbiting in an opposite direction 
+  bool m_direction; // each adjacent plane will be orbiting in an opposite direction
                     // 1 = S to N, 0 = N to S
-  double m_speed; // [m/s]
+  Ptr<LeoConstellationPropagator> m_propagator; // computes the position
+  uint32_t m_index; // index of the satellite in m_propagator
+  bool m_fixedOrbit; // whether the orbit was set with SetOrbit
 };
 
 } // namespace ns3
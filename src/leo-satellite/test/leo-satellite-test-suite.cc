@@ -4,6 +4,14 @@
 
 // An essential include is test.h
 #include "ns3/test.h"
+#include "ns3/leo-constellation-propagator.h"
+#include "ns3/leo-snapshot-routing.h"
+#include "ns3/leo-visibility-service.h"
+#include "ns3/leo-constellation.h"
+#include "ns3/leo-isl-topology.h"
+#include "ns3/simulator.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
@@ -45,6 +53,416 @@ LeoSatelliteTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * The propagator moves the satellites along their polar orbit, over the
+ * poles, the same whatever the order of the calls
+ */
+class LeoConstellationPropagatorTestCase : public TestCase
+{
+public:
+  LeoConstellationPropagatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoConstellationPropagatorTestCase::LeoConstellationPropagatorTestCase ()
+  : TestCase ("Positions computed by the constellation propagator")
+{
+}
+
+void
+LeoConstellationPropagatorTestCase::DoRun (void)
+{
+  Ptr<LeoConstellationPropagator> propagator = CreateObject<LeoConstellationPropagator> ();
+  uint32_t north = propagator->AddSatellite (0, -90, 1, 2000, 0);
+  uint32_t south = propagator->AddSatellite (45, 30, 0, 2000, 10);
+  double period = 360 / propagator->GetAngularRate (north);
+  NS_TEST_ASSERT_MSG_EQ_TOL (period, 7633, 1, "orbital period at 2000 km");
+
+  // a quarter of period: the first satellite goes from the equator to the
+  // north pole, then over it to the other side of the Earth
+  Vector pos = propagator->GetPosition (north, Seconds (period / 4));
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, 90, 1e-6, "at the pole");
+  pos = propagator->GetPosition (north, Seconds (period / 2));
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, 0, 1e-6, "back at the equator");
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.y, 90, 1e-6, "other side of the pole");
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.z, 2000, 1e-6, "altitude");
+  pos = propagator->GetPosition (north, Seconds (period * 7 / 8));
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, -45, 1e-6, "going north again");
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.y, -90, 1e-6, "first side of the pole");
+
+  // the second satellite goes south, from its epoch
+  pos = propagator->GetPosition (south, Seconds (10 + period / 4));
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, -45, 1e-6, "going south");
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.y, 30, 1e-6, "before the south pole");
+  pos = propagator->GetPosition (south, Seconds (10 + period / 2));
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, -45, 1e-6, "over the south pole");
+  NS_TEST_ASSERT_MSG_EQ_TOL (pos.y, -150, 1e-6, "after the south pole");
+
+  // the positions only depend on the time
+  std::vector<Vector> positions;
+  propagator->GetPositions (Seconds (1234), positions);
+  NS_TEST_ASSERT_MSG_EQ (positions.size (), 2, "all the satellites");
+  propagator->GetPosition (north, Seconds (5678));
+  pos = propagator->GetPosition (south, Seconds (1234));
+  NS_TEST_ASSERT_MSG_EQ (pos.x, positions[south].x, "same latitude");
+  NS_TEST_ASSERT_MSG_EQ (pos.y, positions[south].y, "same longitude");
+}
+
+/**
+ * The visibility service finds the satellites above the elevation mask,
+ * over the pole as well, and the time at which the closest one changes
+ */
+class LeoVisibilityServiceTestCase : public TestCase
+{
+public:
+  LeoVisibilityServiceTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoVisibilityServiceTestCase::LeoVisibilityServiceTestCase ()
+  : TestCase ("Satellites seen by ground stations and handovers")
+{
+}
+
+void
+LeoVisibilityServiceTestCase::DoRun (void)
+{
+  Ptr<LeoConstellationPropagator> propagator = CreateObject<LeoConstellationPropagator> ();
+  uint32_t zenith = propagator->AddSatellite (80, 0, 1, 2000, 0);
+  uint32_t pole = propagator->AddSatellite (85, 180, 1, 2000, 0);
+  uint32_t south = propagator->AddSatellite (60, 0, 1, 2000, 0);
+  uint32_t far = propagator->AddSatellite (0, 90, 1, 2000, 0);
+  Ptr<LeoVisibilityService> visibility = CreateObject<LeoVisibilityService> ();
+  visibility->SetPropagator (propagator);
+  uint32_t station = visibility->AddGroundStation (Vector (80, 0, 0));
+
+  // the satellite across the pole is closer than the one 20 degrees south
+  std::vector<LeoVisibility> visible;
+  visibility->GetVisible (station, Seconds (0), visible);
+  NS_TEST_ASSERT_MSG_EQ (visible.size (), 3, "satellites above the mask");
+  NS_TEST_ASSERT_MSG_EQ (visible[0].satellite, zenith, "closest satellite");
+  NS_TEST_ASSERT_MSG_EQ_TOL (visible[0].distance, 2000, 1e-6, "distance to the zenith");
+  NS_TEST_ASSERT_MSG_EQ_TOL (visible[0].elevation, 90, 1e-6, "elevation of the zenith");
+  NS_TEST_ASSERT_MSG_EQ (visible[1].satellite, pole, "satellite across the pole");
+  NS_TEST_ASSERT_MSG_EQ (visible[2].satellite, south, "satellite south");
+
+  // busy satellites are skipped, down to the closest one below the mask
+  std::vector<bool> busy (propagator->GetN (), false);
+  LeoVisibility closest;
+  busy[zenith] = true;
+  NS_TEST_ASSERT_MSG_EQ (visibility->FindClosest (station, Seconds (0), busy, closest), true, "above the mask");
+  NS_TEST_ASSERT_MSG_EQ (closest.satellite, pole, "next closest satellite");
+  busy[pole] = true;
+  busy[south] = true;
+  NS_TEST_ASSERT_MSG_EQ (visibility->FindClosest (station, Seconds (0), busy, closest), false, "below the mask");
+  NS_TEST_ASSERT_MSG_EQ (closest.satellite, far, "closest free satellite");
+
+  // a satellite 20 degrees behind on the same orbit serves the station on
+  // the equator once the first one is 10 degrees past it
+  propagator = CreateObject<LeoConstellationPropagator> ();
+  propagator->AddSatellite (0, 0, 1, 2000, 0);
+  uint32_t next = propagator->AddSatellite (-20, 0, 1, 2000, 0);
+  visibility = CreateObject<LeoVisibilityService> ();
+  visibility->SetPropagator (propagator);
+  station = visibility->AddGroundStation (Vector (0, 0, 0));
+  double handover = 10 / propagator->GetAngularRate (next);
+  Time t = visibility->PredictHandover (station, Seconds (0), Seconds (1000));
+  NS_TEST_ASSERT_MSG_EQ_TOL (t.GetSeconds (), handover, 0.002, "handover time");
+  NS_TEST_ASSERT_MSG_EQ (visibility->PredictHandover (station, Seconds (0), Seconds (100)), Seconds (100), "no handover within the horizon");
+  visibility->GetVisible (station, t, visible);
+  NS_TEST_ASSERT_MSG_EQ (visible[0].satellite, next, "served by the next satellite");
+}
+
+/**
+ * Inclined orbits, and a constellation of two Walker shells with three
+ * ground stations
+ */
+class LeoConstellationTestCase : public TestCase
+{
+public:
+  LeoConstellationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoConstellationTestCase::LeoConstellationTestCase ()
+  : TestCase ("Inclined Walker shells and ground stations")
+{
+}
+
+void
+LeoConstellationTestCase::DoRun (void)
+{
+  // the highest latitude of an inclined orbit is its inclination, a
+  // quarter of an orbit after the ascending node
+  Ptr<LeoConstellationPropagator> propagator = CreateObject<LeoConstellationPropagator> ();
+  uint32_t node = propagator->AddOrbit (53, 30, 0, 550, 0);
+  uint32_t top = propagator->AddOrbit (53, 30, 90, 550, 0);
+  Vector position = propagator->GetPosition (node, Seconds (0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (position.x, 0, 1e-9, "latitude of the ascending node");
+  NS_TEST_ASSERT_MSG_EQ_TOL (position.y, 30, 1e-9, "longitude of the ascending node");
+  position = propagator->GetPosition (top, Seconds (0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (position.x, 53, 1e-9, "highest latitude");
+  NS_TEST_ASSERT_MSG_EQ_TOL (position.y, 120, 1e-9, "longitude of the highest latitude");
+  Vector computed = propagator->ComputePosition (top, Seconds (1234));
+  position = propagator->GetPosition (top, Seconds (1234));
+  NS_TEST_ASSERT_MSG_EQ_TOL (computed.x, position.x, 1e-9, "same latitude with and without the cache");
+  NS_TEST_ASSERT_MSG_EQ_TOL (computed.y, position.y, 1e-9, "same longitude with and without the cache");
+
+  Ptr<LeoConstellation> constellation = CreateObject<LeoConstellation> ();
+  constellation->AddWalkerDelta (550, 53, 6, 8, 1);
+  constellation->AddWalkerDelta (1100, 70, 4, 6, 1);
+  constellation->AddGroundStation (0, 0);
+  constellation->AddGroundStation (40, -74);
+  constellation->AddGroundStation (-33, 151);
+  constellation->Build ();
+  NS_TEST_ASSERT_MSG_EQ (constellation->GetSatellites ().GetN (), 72, "satellites of the shells");
+
+  // each ground station is served by a satellite of each shell, which
+  // serves no other ground station
+  std::vector<bool> serving (72, false);
+  for (uint32_t g = 0; g < 3; g++)
+    {
+      for (uint32_t s = 0; s < 2; s++)
+        {
+          uint32_t satellite = constellation->GetServingSatellite (g, s);
+          bool inShell = (s == 0) ? satellite < 48 : satellite >= 48;
+          NS_TEST_ASSERT_MSG_EQ (inShell, true, "satellite of the shell");
+          NS_TEST_ASSERT_MSG_EQ (serving[satellite], false, "satellite serving one ground station");
+          serving[satellite] = true;
+        }
+    }
+
+  // the routes lead to the ground stations only
+  Ptr<LeoSnapshotRoutingTable> routing = constellation->GetRoutingTable ();
+  NS_TEST_ASSERT_MSG_EQ ((routing->Lookup (72, constellation->GetGroundStationAddress (2)) != 0), true, "route between ground stations");
+  NS_TEST_ASSERT_MSG_EQ ((routing->Lookup (10, constellation->GetGroundStationAddress (1)) != 0), true, "route from a satellite");
+  Ipv4Address satellite = constellation->GetSatellite (1, 0, 0)->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+  NS_TEST_ASSERT_MSG_EQ ((routing->Lookup (72, satellite) == 0), true, "no route to a satellite");
+
+  constellation->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * The inter-plane links found from the phases of evenly spaced planes, and
+ * by searching the others, are the links of a search of all the
+ * satellites, and an update reports the links which changed of peer
+ */
+class LeoIslTopologyTestCase : public TestCase
+{
+public:
+  LeoIslTopologyTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Link the satellites of a plane by searching all the satellites
+   * \param planes the satellites of the planes
+   * \param positions the positions of the satellites
+   * \param i a plane
+   * \return the peer of each satellite of the plane in the next plane
+   */
+  std::vector<uint32_t> Search (const std::vector<std::vector<uint32_t> > &planes,
+                                const std::vector<Vector> &positions, uint32_t i);
+};
+
+LeoIslTopologyTestCase::LeoIslTopologyTestCase ()
+  : TestCase ("Inter-plane links updated incrementally and searched")
+{
+}
+
+std::vector<uint32_t>
+LeoIslTopologyTestCase::Search (const std::vector<std::vector<uint32_t> > &planes,
+                                const std::vector<Vector> &positions, uint32_t i)
+{
+  uint32_t n = planes[i].size ();
+  bool reversed = (i == planes.size () - 1);
+  uint32_t refSat = 0;
+  for (uint32_t j = 1; j < n; j++)
+    {
+      if (std::abs (positions[planes[i][j]].x) < std::abs (positions[planes[i][refSat]].x))
+        {
+          refSat = j;
+        }
+    }
+  uint32_t closest = 0;
+  double closestDist = 0;
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t next = reversed ? planes[0][n - k - 1] : planes[i + 1][k];
+      double dist = CalculateDistance (positions[planes[i][refSat]], positions[next]);
+      if (k == 0 || dist < closestDist)
+        {
+          closest = k;
+          closestDist = dist;
+        }
+    }
+  std::vector<uint32_t> peers (n);
+  for (uint32_t j = 0; j < n; j++)
+    {
+      uint32_t next = (j + closest + n - refSat) % n;
+      peers[j] = reversed ? n - next - 1 : next;
+    }
+  return peers;
+}
+
+void
+LeoIslTopologyTestCase::DoRun (void)
+{
+  // five polar planes of twelve satellites, the third one with a satellite
+  // out of its slot, so that it is searched
+  const uint32_t nPlanes = 5;
+  const uint32_t n = 12;
+  Ptr<LeoConstellationPropagator> propagator = CreateObject<LeoConstellationPropagator> ();
+  std::vector<std::vector<uint32_t> > planes (nPlanes);
+  for (uint32_t i = 0; i < nPlanes; i++)
+    {
+      for (uint32_t j = 0; j < n; j++)
+        {
+          double phase = j * 360.0 / n + i * 7.0 + ((i == 2 && j == 5) ? 4 : 0);
+          planes[i].push_back (propagator->AddOrbit (90, i * 180.0 / nPlanes, phase, 780, 0));
+        }
+    }
+  Ptr<LeoIslTopology> topology = CreateObject<LeoIslTopology> ();
+  topology->SetPropagator (propagator);
+  for (uint32_t i = 0; i < nPlanes; i++)
+    {
+      topology->AddPlane (planes[i]);
+    }
+  topology->Start (Seconds (0));
+
+  // one orbital period, in steps of a minute
+  std::vector<std::vector<uint32_t> > peers (nPlanes);
+  for (uint32_t i = 0; i < nPlanes; i++)
+    {
+      for (uint32_t j = 0; j < n; j++)
+        {
+          peers[i].push_back (topology->GetLink (i, j).peer);
+        }
+    }
+  double period = 360 / propagator->GetAngularRate (planes[0][0]);
+  uint32_t changes = 0;
+  std::vector<Vector> positions;
+  for (uint32_t step = 1; step * 60 < period; step++)
+    {
+      Time t = Seconds (step * 60);
+      const LeoIslDelta &delta = topology->Update (t);
+      propagator->GetPositions (t, positions);
+      uint32_t expected = 0;
+      for (uint32_t i = 0; i < nPlanes; i++)
+        {
+          std::vector<uint32_t> searched = Search (planes, positions, i);
+          for (uint32_t j = 0; j < n; j++)
+            {
+              const LeoIslLink &link = topology->GetLink (i, j);
+              NS_TEST_ASSERT_MSG_EQ (link.peer, searched[j], "peer of satellite " << j << " of plane " << i
+                                     << " at " << t.GetSeconds () << " s");
+              NS_TEST_ASSERT_MSG_EQ (link.oldPeer, peers[i][j], "previous peer");
+              expected += (searched[j] != peers[i][j]);
+              peers[i][j] = searched[j];
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (delta.changed.size (), expected, "links reported changed at " << t.GetSeconds () << " s");
+      for (uint32_t c = 0; c < delta.changed.size (); c++)
+        {
+          NS_TEST_ASSERT_MSG_NE (delta.changed[c].peer, delta.changed[c].oldPeer, "link reported without a new peer");
+        }
+      changes += expected;
+    }
+  NS_TEST_ASSERT_MSG_GT (changes, 0, "no link changed over a period");
+}
+
+/**
+ * The snapshot routing follows the shortest paths of each snapshot, and
+ * stores the routes which change only
+ */
+class LeoSnapshotRoutingTestCase : public TestCase
+{
+public:
+  LeoSnapshotRoutingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Add a link in both directions, on interface 1 + the index of the neighbor
+   * \param graph the graph
+   * \param a a node
+   * \param b another node
+   */
+  void Link (LeoRoutingGraph &graph, uint32_t a, uint32_t b);
+};
+
+LeoSnapshotRoutingTestCase::LeoSnapshotRoutingTestCase ()
+  : TestCase ("Routing tables computed for each snapshot")
+{
+}
+
+void
+LeoSnapshotRoutingTestCase::Link (LeoRoutingGraph &graph, uint32_t a, uint32_t b)
+{
+  LeoRoutingLink link;
+  link.neighbor = b;
+  link.interface = 1 + b;
+  link.gateway = Ipv4Address (0x0a000001 + b);
+  graph[a].push_back (link);
+  link.neighbor = a;
+  link.interface = 1 + a;
+  link.gateway = Ipv4Address (0x0a000001 + a);
+  graph[b].push_back (link);
+}
+
+void
+LeoSnapshotRoutingTestCase::DoRun (void)
+{
+  // a line 0-1-2-3, then a ring with 3 linked to 0
+  Ptr<LeoSnapshotRoutingTable> table = CreateObjectWithAttributes<LeoSnapshotRoutingTable> ("Threads", UintegerValue (2));
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      table->AddAddress (Ipv4Address (0x0a000001 + i), i);
+    }
+  LeoRoutingGraph line (4);
+  Link (line, 0, 1);
+  Link (line, 1, 2);
+  Link (line, 2, 3);
+  LeoRoutingGraph ring = line;
+  Link (ring, 3, 0);
+  table->AddSnapshot (Seconds (0), line);
+  table->AddSnapshot (Seconds (10), ring);
+  table->AddSnapshot (Seconds (20), line);
+  table->Compute (Seconds (30));
+
+  const LeoRoute *route = table->Lookup (0, Ipv4Address ("10.0.0.4"));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "route along the line");
+  NS_TEST_ASSERT_MSG_EQ (route->interface, 2, "through node 1");
+  NS_TEST_ASSERT_MSG_EQ (route->gateway, Ipv4Address ("10.0.0.2"), "gateway node 1");
+  NS_TEST_ASSERT_MSG_EQ (table->Lookup (0, Ipv4Address ("10.0.0.9")), 0, "unknown address");
+
+  // the routes of 0 to 3 and of 3 to 0 change, and the route of 1 to 3
+  // which has two paths of two hops and takes the one of its first link
+  NS_TEST_ASSERT_MSG_EQ (table->GetNChanges (1), 3, "routes changed by the ring");
+  NS_TEST_ASSERT_MSG_EQ (table->GetNChanges (2), 3, "routes changed back");
+  NS_TEST_ASSERT_MSG_EQ (table->Apply (Seconds (15)), true, "second snapshot");
+  NS_TEST_ASSERT_MSG_EQ (table->GetCurrentSnapshot (), 1, "second snapshot");
+  route = table->Lookup (0, Ipv4Address ("10.0.0.4"));
+  NS_TEST_ASSERT_MSG_EQ (route->interface, 4, "direct link of the ring");
+  route = table->Lookup (1, Ipv4Address ("10.0.0.4"));
+  NS_TEST_ASSERT_MSG_EQ (route->interface, 1, "first of two shortest paths");
+  route = table->Lookup (2, Ipv4Address ("10.0.0.1"));
+  NS_TEST_ASSERT_MSG_EQ (route->interface, 2, "unchanged route");
+
+  NS_TEST_ASSERT_MSG_EQ (table->Apply (Seconds (25)), true, "third snapshot");
+  route = table->Lookup (0, Ipv4Address ("10.0.0.4"));
+  NS_TEST_ASSERT_MSG_EQ (route->interface, 2, "back along the line");
+  NS_TEST_ASSERT_MSG_EQ (table->Apply (Seconds (30)), false, "past the end");
+  NS_TEST_ASSERT_MSG_EQ (table->Lookup (0, Ipv4Address ("10.0.0.4")), 0, "no route past the end");
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -60,6 +478,11 @@ LeoSatelliteTestSuite::LeoSatelliteTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new LeoSatelliteTestCase1, TestCase::QUICK);
+  AddTestCase (new LeoConstellationPropagatorTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSnapshotRoutingTestCase, TestCase::QUICK);
+  AddTestCase (new LeoVisibilityServiceTestCase, TestCase::QUICK);
+  AddTestCase (new LeoConstellationTestCase, TestCase::QUICK);
+  AddTestCase (new LeoIslTopologyTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Pairs of MP-QUIC nodes, each client sending a file to its server over
+// the two point-to-point links of the MAMS scenarios, run by the
+// multithreaded simulator or by the default one. The bytes received by the
+// servers and the number of events do not depend on the simulator nor on
+// the number of threads; the wall clock time does.
+// Sample usage:
+//   ./waf --run 'mtp-quic-pairs --pairs=32 --threads=8'
+//   ./waf --run 'mtp-quic-pairs --pairs=32 --mtp=0'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/quic-module.h"
+#include "ns3/mtp-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/// Stream buffer discarding everything
+class NullBuffer : public std::streambuf
+{
+protected:
+  virtual int overflow (int c)
+  {
+    return c;
+  }
+};
+
+/// Bytes received by each server, written by the thread of the server only
+static std::vector<uint64_t> g_rxBytes;
+
+/**
+ * Count the bytes received by a server
+ * \param server index of the server
+ * \param p the data received
+ */
+static void
+ServerRx (uint32_t server, Ptr<const Packet> p)
+{
+  g_rxBytes[server] += p->GetSize ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nPairs = 16;
+  bool mtp = true;
+  uint32_t threads = 0;
+  uint32_t fileSize = 2000000;
+  std::string rate = "20Mbps";
+  std::string delay = "10ms";
+  double stop = 5;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("pairs", "number of client-server pairs", nPairs);
+  cmd.AddValue ("mtp", "run with the multithreaded simulator", mtp);
+  cmd.AddValue ("threads", "threads of the multithreaded simulator, 0 for one per core", threads);
+  cmd.AddValue ("fileSize", "bytes sent by each client", fileSize);
+  cmd.AddValue ("rate", "data rate of the links", rate);
+  cmd.AddValue ("delay", "delay of the links", delay);
+  cmd.AddValue ("stop", "simulation time in seconds", stop);
+  cmd.Parse (argc, argv);
+
+  if (mtp)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+      Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (threads));
+    }
+
+  // the file is written to the socket at once
+  Config::SetDefault ("ns3::QuicStreamBase::StreamSndBufSize", UintegerValue (10485760));
+  Config::SetDefault ("ns3::QuicStreamBase::StreamRcvBufSize", UintegerValue (10485760));
+  Config::SetDefault ("ns3::QuicSocketBase::SocketSndBufSize", UintegerValue (10485760));
+  Config::SetDefault ("ns3::QuicSocketBase::SocketRcvBufSize", UintegerValue (10485760));
+
+  NodeContainer clients;
+  NodeContainer servers;
+  clients.Create (nPairs);
+  servers.Create (nPairs);
+  QuicHelper stack;
+  stack.InstallQuic (clients);
+  stack.InstallQuic (servers);
+
+  Time pathDelay = Time (delay);
+  g_rxBytes.assign (nPairs, 0);
+  // MP-QUIC opens its second path to 10.1.2.2: every pair uses the addresses
+  // of the MAMS scenarios, the pairs being separate networks
+  Ipv4AddressGenerator::TestMode ();
+  uint16_t port = 9;
+  ApplicationContainer clientApps;
+  ApplicationContainer serverApps;
+  for (uint32_t i = 0; i < nPairs; i++)
+    {
+      Ipv4InterfaceContainer path0;
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          PointToPointHelper link;
+          link.SetDeviceAttribute ("DataRate", StringValue (rate));
+          link.SetChannelAttribute ("Delay", StringValue (delay));
+          std::ostringstream network;
+          network << "10.1." << j + 1 << ".0";
+          Ipv4AddressHelper address;
+          address.SetBase (network.str ().c_str (), "255.255.255.0");
+          Ipv4InterfaceContainer interfaces = address.Assign (link.Install (clients.Get (i), servers.Get (i)));
+          if (j == 0)
+            {
+              path0 = interfaces;
+            }
+        }
+
+      QuicEchoServerHelper echoServer (port);
+      ApplicationContainer server = echoServer.Install (servers.Get (i));
+      server.Get (0)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&ServerRx, i));
+      serverApps.Add (server);
+
+      QuicEchoClientHelper echoClient (path0.GetAddress (1), port);
+      echoClient.SetAttribute ("MaxPackets", UintegerValue (1));
+      echoClient.SetAttribute ("Interval", TimeValue (Seconds (0.01)));
+      echoClient.SetAttribute ("PacketSize", UintegerValue (1460));
+      echoClient.SetIniRTT0 (pathDelay);
+      echoClient.SetIniRTT1 (pathDelay);
+      echoClient.SetBW0 (DataRate (rate));
+      echoClient.SetBW1 (DataRate (rate));
+      echoClient.SetScheAlgo (2);
+      ApplicationContainer client = echoClient.Install (clients.Get (i));
+      echoClient.SetFill (client.Get (0), 100, fileSize);
+      clientApps.Add (client);
+    }
+  serverApps.Start (Seconds (0));
+  clientApps.Start (Seconds (1));
+
+  // the sockets print on std::cout, from all the threads
+  std::streambuf *out = std::cout.rdbuf ();
+  std::ios::fmtflags flags = std::cout.flags ();
+  NullBuffer null;
+  std::cout.rdbuf (&null);
+
+  SystemWallClockMs wall;
+  wall.Start ();
+  Simulator::Stop (Seconds (stop));
+  Simulator::Run ();
+  int64_t wallMs = wall.End ();
+  std::cout.rdbuf (out);
+  std::cout.flags (flags);
+
+  uint32_t partitions = 1;
+  Time lookahead = Seconds (0);
+  uint64_t rounds = 0;
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      partitions = impl->GetPartitionCount ();
+      lookahead = impl->GetLookahead ();
+      rounds = impl->GetRoundCount ();
+    }
+  uint64_t rxBytes = 0;
+  uint32_t complete = 0;
+  for (uint32_t i = 0; i < nPairs; i++)
+    {
+      rxBytes += g_rxBytes[i];
+      complete += g_rxBytes[i] >= fileSize;
+    }
+  std::cout << "mtp,pairs,partitions,lookahead_ms,rounds,events,rx_bytes,complete,sim_s,wall_s" << std::endl;
+  std::cout << mtp << "," << nPairs << "," << partitions << "," << lookahead.GetSeconds () * 1000 << ","
+            << rounds << "," << Simulator::GetEventCount () << "," << rxBytes << "," << complete << ","
+            << Simulator::Now ().GetSeconds () << "," << wallMs / 1000.0 << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,868 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <thread>
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::LogicalProcess *MultithreadedSimulatorImpl::g_current = 0;
+
+/// Timestamp of the empty queues
+static const uint64_t NEVER = std::numeric_limits<uint64_t>::max ();
+
+/**
+ * \return the key following all the events
+ */
+static Scheduler::EventKey
+NeverKey (void)
+{
+  Scheduler::EventKey key;
+  key.m_ts = NEVER;
+  key.m_uid = std::numeric_limits<uint32_t>::max ();
+  key.m_context = Simulator::NO_CONTEXT;
+  return key;
+}
+
+/**
+ * Find the group of a node, halving the paths on the way
+ * \param parent the parent of each node in its group
+ * \param node the node
+ * \return the root of the group
+ */
+static uint32_t
+FindGroup (std::vector<uint32_t> &parent, uint32_t node)
+{
+  while (parent[node] != node)
+    {
+      parent[node] = parent[parent[node]];
+      node = parent[node];
+    }
+  return node;
+}
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mtp")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "Maximum number of threads, 0 for one per core",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MinLookahead",
+                   "The nodes joined by a point-to-point link of a shorter delay are kept in the same partition",
+                   TimeValue (MicroSeconds (10)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::m_minLookahead),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  m_threadCount = 0;
+  m_lookahead = NEVER;
+  m_running = false;
+  m_stop = false;
+  m_stopKey = NeverKey ();
+  m_globalNext = NeverKey ();
+  m_globalSent = 0;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_eventCount = 0;
+  m_rounds = 0;
+  m_barrierCount = 0;
+  m_barrierGeneration = 0;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Gather ();
+  for (std::vector<LogicalProcess *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      delete *i;
+    }
+  m_partitions.clear ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ABORT_MSG_IF (m_running, "MultithreadedSimulatorImpl::SetScheduler(): called in Run ()");
+  m_schedulerFactory = schedulerFactory;
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop || !m_events->IsEmpty ())
+    {
+      return m_stop;
+    }
+  for (std::vector<LogicalProcess *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->m_events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Partition (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<LogicalProcess *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      delete *i;
+    }
+  m_partitions.clear ();
+
+  // group the nodes which cannot run apart: the nodes of the channels
+  // which are not a long enough point-to-point link
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<uint32_t> parent (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      parent[i] = i;
+    }
+  std::vector<Ptr<Channel> > links;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      Ptr<Channel> channel = *i;
+      std::size_t nDevices = channel->GetNDevices ();
+      if (nDevices < 2)
+        {
+          continue;
+        }
+      // the delay of a link between two partitions must stay above the
+      // lookahead: a variable delay (SetDelay, rate traces, rebound
+      // channels) gives no such bound
+      TimeValue delay;
+      BooleanValue variable;
+      if (nDevices == 2
+          && channel->GetDevice (0)->IsPointToPoint ()
+          && channel->GetDevice (1)->IsPointToPoint ()
+          && channel->GetAttributeFailSafe ("Delay", delay)
+          && delay.Get ().IsStrictlyPositive ()
+          && delay.Get () >= m_minLookahead
+          && channel->GetAttributeFailSafe ("VariableDelay", variable)
+          && !variable.Get ())
+        {
+          links.push_back (channel);
+          continue;
+        }
+      uint32_t first = FindGroup (parent, channel->GetDevice (0)->GetNode ()->GetId ());
+      for (std::size_t j = 1; j < nDevices; j++)
+        {
+          parent[FindGroup (parent, channel->GetDevice (j)->GetNode ()->GetId ())] = first;
+        }
+    }
+
+  std::map<uint32_t, std::vector<uint32_t> > groupNodes;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      groupNodes[FindGroup (parent, i)].push_back (i);
+    }
+  std::vector<std::vector<uint32_t> > groups;
+  for (std::map<uint32_t, std::vector<uint32_t> >::iterator i = groupNodes.begin (); i != groupNodes.end (); ++i)
+    {
+      groups.push_back (i->second);
+    }
+  // the largest groups first, then the groups of the lowest node ids
+  std::stable_sort (groups.begin (), groups.end (),
+                    [] (const std::vector<uint32_t> &a, const std::vector<uint32_t> &b)
+                    {
+                      return a.size () > b.size ();
+                    });
+
+  uint32_t nThreads = m_threadCount;
+  if (nThreads == 0)
+    {
+      nThreads = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+  nThreads = std::max<uint32_t> (std::min<std::size_t> (nThreads, groups.size ()), 1);
+
+  for (uint32_t i = 0; i < nThreads; i++)
+    {
+      LogicalProcess *lp = new LogicalProcess ();
+      lp->m_id = i;
+      lp->m_impl = this;
+      lp->m_events = m_schedulerFactory.Create<Scheduler> ();
+      lp->m_currentTs = m_currentTs;
+      lp->m_currentContext = Simulator::NO_CONTEXT;
+      lp->m_currentUid = 0;
+      lp->m_eventCount = 0;
+      lp->m_sent = 0;
+      lp->m_windowEnd = m_currentTs;
+      lp->m_next = NeverKey ();
+      lp->m_stopped = false;
+      lp->m_mailbox = 0;
+      m_partitions.push_back (lp);
+    }
+
+  // each group goes to the partition with the fewest nodes
+  std::vector<std::size_t> load (nThreads, 0);
+  m_nodePartition.assign (nNodes, 0);
+  for (std::vector<std::vector<uint32_t> >::iterator i = groups.begin (); i != groups.end (); ++i)
+    {
+      uint32_t target = std::min_element (load.begin (), load.end ()) - load.begin ();
+      load[target] += i->size ();
+      for (std::vector<uint32_t>::iterator j = i->begin (); j != i->end (); ++j)
+        {
+          m_nodePartition[*j] = target;
+        }
+    }
+
+  m_lookahead = NEVER;
+  for (std::vector<Ptr<Channel> >::iterator i = links.begin (); i != links.end (); ++i)
+    {
+      uint32_t a = (*i)->GetDevice (0)->GetNode ()->GetId ();
+      uint32_t b = (*i)->GetDevice (1)->GetNode ()->GetId ();
+      if (m_nodePartition[a] != m_nodePartition[b])
+        {
+          TimeValue delay;
+          (*i)->GetAttribute ("Delay", delay);
+          m_lookahead = std::min (m_lookahead, (uint64_t) delay.Get ().GetTimeStep ());
+        }
+    }
+  NS_LOG_INFO (nNodes << " nodes in " << groups.size () << " groups, " << nThreads
+                      << " partitions, lookahead " << GetLookahead ().As (Time::MS));
+}
+
+void
+MultithreadedSimulatorImpl::Distribute (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Scheduler::Event> global;
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event ev = m_events->RemoveNext ();
+      LogicalProcess *lp = GetPartitionOf (ev.key.m_context);
+      if (lp != 0)
+        {
+          lp->m_events->Insert (ev);
+        }
+      else
+        {
+          global.push_back (ev);
+        }
+    }
+  for (std::vector<Scheduler::Event>::iterator i = global.begin (); i != global.end (); ++i)
+    {
+      m_events->Insert (*i);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Gather (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<LogicalProcess *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      Receive (lp);
+      while (!lp->m_events->IsEmpty ())
+        {
+          m_events->Insert (lp->m_events->RemoveNext ());
+        }
+      if (lp->m_currentTs > m_currentTs)
+        {
+          m_currentTs = lp->m_currentTs;
+          m_currentUid = lp->m_currentUid;
+        }
+    }
+}
+
+MultithreadedSimulatorImpl::LogicalProcess *
+MultithreadedSimulatorImpl::GetPartitionOf (uint32_t context) const
+{
+  if (context < m_nodePartition.size () && !m_partitions.empty ())
+    {
+      return m_partitions[m_nodePartition[context]];
+    }
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::LogicalProcess::Run (void)
+{
+  m_impl->RunPartition (this);
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  Partition ();
+  Distribute ();
+  m_globalNext = m_events->IsEmpty () ? NeverKey () : m_events->PeekNext ().key;
+  m_stop = false;
+  m_rounds = 0;
+  m_barrierCount = 0;
+  m_running = true;
+
+  for (std::size_t i = 1; i < m_partitions.size (); i++)
+    {
+      LogicalProcess *lp = m_partitions[i];
+      lp->m_thread = Create<SystemThread> (MakeCallback (&LogicalProcess::Run, lp));
+      lp->m_thread->Start ();
+    }
+  RunPartition (m_partitions[0]);
+  for (std::size_t i = 1; i < m_partitions.size (); i++)
+    {
+      m_partitions[i]->m_thread->Join ();
+      m_partitions[i]->m_thread = 0;
+    }
+
+  m_running = false;
+  Gather ();
+  bool stopped = m_stop;
+  for (std::vector<LogicalProcess *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      stopped = stopped || (*i)->m_stopped;
+    }
+  if (!stopped && m_stopKey.m_ts != NEVER
+      && (m_events->IsEmpty () || !(m_events->PeekNext ().key < m_stopKey)))
+    {
+      // stopped by Simulator::Stop (delay), which is an event of the
+      // DefaultSimulatorImpl
+      m_eventCount++;
+      m_currentTs = m_stopKey.m_ts;
+      m_currentUid = m_stopKey.m_uid;
+      m_stopKey = NeverKey ();
+    }
+  NS_LOG_INFO ("stopped at " << Now ().As (Time::S) << " after " << m_rounds << " rounds");
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (LogicalProcess *lp)
+{
+  g_current = lp;
+  while (true)
+    {
+      // the windows are over and the mailboxes hold all the events sent in them
+      Barrier ();
+      Receive (lp);
+      lp->m_next = lp->m_events->IsEmpty () ? NeverKey () : lp->m_events->PeekNext ().key;
+      // no event runs between the barriers: every thread takes the same decision
+      bool stop = m_stop;
+      for (std::vector<LogicalProcess *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          stop = stop || (*i)->m_stopped;
+        }
+      Scheduler::EventKey stopKey = m_stopKey;
+      // the main thread updates the next global event as soon as it runs
+      // the global events, maybe before the other threads looked at it
+      Scheduler::EventKey globalNext = m_globalNext;
+      Barrier ();
+
+      Scheduler::EventKey first = NeverKey ();
+      for (std::vector<LogicalProcess *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          if ((*i)->m_next < first)
+            {
+              first = (*i)->m_next;
+            }
+        }
+      if (stop || !(std::min (first, globalNext) < stopKey))
+        {
+          break;
+        }
+      if (lp->m_id == 0)
+        {
+          m_rounds++;
+        }
+      if (globalNext < first)
+        {
+          // the global events run alone, on the main thread
+          if (lp->m_id == 0)
+            {
+              g_current = 0;
+              ProcessGlobalEvents (std::min (first, stopKey));
+              g_current = lp;
+            }
+          continue;
+        }
+
+      // run the events before the window end, before the next global
+      // event and before the stop time
+      lp->m_windowEnd = m_lookahead > NEVER - first.m_ts ? NEVER : first.m_ts + m_lookahead;
+      Scheduler::EventKey bound = std::min (globalNext, stopKey);
+      while (!lp->m_stopped && !lp->m_events->IsEmpty ())
+        {
+          Scheduler::EventKey key = lp->m_events->PeekNext ().key;
+          if (key.m_ts >= lp->m_windowEnd || !(key < bound))
+            {
+              break;
+            }
+          Scheduler::Event next = lp->m_events->RemoveNext ();
+          NS_ASSERT (next.key.m_ts >= lp->m_currentTs);
+          lp->m_eventCount++;
+          lp->m_currentTs = next.key.m_ts;
+          lp->m_currentContext = next.key.m_context;
+          lp->m_currentUid = next.key.m_uid;
+          next.impl->Invoke ();
+          next.impl->Unref ();
+        }
+    }
+  g_current = 0;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessGlobalEvents (const Scheduler::EventKey &bound)
+{
+  while (!m_stop && !m_events->IsEmpty () && m_events->PeekNext ().key < bound)
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      NS_ASSERT (next.key.m_ts >= m_currentTs);
+      m_eventCount++;
+      m_currentTs = next.key.m_ts;
+      m_currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  // published to the partitions by the next barrier
+  m_globalNext = m_events->IsEmpty () ? NeverKey () : m_events->PeekNext ().key;
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (void)
+{
+  uint32_t n = m_partitions.size ();
+  uint32_t generation = m_barrierGeneration.load (std::memory_order_acquire);
+  if (m_barrierCount.fetch_add (1, std::memory_order_acq_rel) + 1 == n)
+    {
+      m_barrierCount.store (0, std::memory_order_relaxed);
+      m_barrierGeneration.fetch_add (1, std::memory_order_release);
+      return;
+    }
+  uint32_t spins = 0;
+  while (m_barrierGeneration.load (std::memory_order_acquire) == generation)
+    {
+      if (++spins > 1000)
+        {
+          std::this_thread::yield ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Send (LogicalProcess *lp, const Scheduler::Event &ev)
+{
+  Message *message = new Message;
+  message->ev = ev;
+  if (g_current != 0)
+    {
+      message->source = g_current->m_id;
+      message->seq = g_current->m_sent++;
+    }
+  else
+    {
+      message->source = m_partitions.size ();
+      message->seq = m_globalSent++;
+    }
+  message->next = lp->m_mailbox.load (std::memory_order_relaxed);
+  while (!lp->m_mailbox.compare_exchange_weak (message->next, message,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed))
+    {
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Receive (LogicalProcess *lp)
+{
+  Message *message = lp->m_mailbox.exchange (0, std::memory_order_acquire);
+  if (message == 0)
+    {
+      return;
+    }
+  std::vector<Message *> messages;
+  for (; message != 0; message = message->next)
+    {
+      messages.push_back (message);
+    }
+  // the order the threads posted the messages in depends on the run: use
+  // the order of their senders
+  std::sort (messages.begin (), messages.end (),
+             [] (const Message *a, const Message *b)
+             {
+               if (a->ev.key.m_ts != b->ev.key.m_ts)
+                 {
+                   return a->ev.key.m_ts < b->ev.key.m_ts;
+                 }
+               if (a->source != b->source)
+                 {
+                   return a->source < b->source;
+                 }
+               return a->seq < b->seq;
+             });
+  for (std::vector<Message *>::iterator i = messages.begin (); i != messages.end (); ++i)
+    {
+      Scheduler::Event ev = (*i)->ev;
+      ev.key.m_uid = m_uid++;
+      lp->m_events->Insert (ev);
+      delete *i;
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::Insert (Scheduler::Event ev)
+{
+  ev.key.m_uid = m_uid++;
+  if (g_current != 0)
+    {
+      g_current->m_events->Insert (ev);
+    }
+  else
+    {
+      m_events->Insert (ev);
+    }
+  return EventId (ev.impl, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (g_current != 0)
+    {
+      g_current->m_stopped = true;
+    }
+  else
+    {
+      m_stop = true;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  if (g_current != 0)
+    {
+      Simulator::Schedule (delay, &Simulator::Stop);
+      return;
+    }
+  Scheduler::EventKey key;
+  key.m_ts = m_currentTs + delay.GetTimeStep ();
+  key.m_uid = m_uid++;
+  key.m_context = Simulator::NO_CONTEXT;
+  m_stopKey = std::min (m_stopKey, key);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = Now ().GetTimeStep () + delay.GetTimeStep ();
+  ev.key.m_context = GetContext ();
+  return Insert (ev);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = Now ().GetTimeStep () + delay.GetTimeStep ();
+  ev.key.m_context = context;
+  LogicalProcess *target = m_running ? GetPartitionOf (context) : 0;
+  if (target == 0 || target == g_current)
+    {
+      Insert (ev);
+      return;
+    }
+  // the target partition may already run events up to the end of the window
+  NS_ABORT_MSG_IF (g_current != 0 && ev.key.m_ts < g_current->m_windowEnd,
+                   "MultithreadedSimulatorImpl: event for node " << context << " in partition "
+                   << target->m_id << " scheduled at " << TimeStep (ev.key.m_ts).As (Time::S)
+                   << " by partition " << g_current->m_id << ", before the end of the window at "
+                   << TimeStep (g_current->m_windowEnd).As (Time::S)
+                   << "; the delay between two partitions must be at least the lookahead");
+  Send (target, ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = Now ().GetTimeStep ();
+  ev.key.m_context = GetContext ();
+  return Insert (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  CriticalSection cs (m_destroyMutex);
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  if (g_current != 0)
+    {
+      return TimeStep (g_current->m_currentTs);
+    }
+  return TimeStep (m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - Now ().GetTimeStep ());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  LogicalProcess *lp = m_running ? GetPartitionOf (id.GetContext ()) : 0;
+  if (lp == 0)
+    {
+      lp = g_current;
+    }
+  NS_ABORT_MSG_IF (g_current != 0 && lp != g_current,
+                   "MultithreadedSimulatorImpl::Remove(): event of node " << id.GetContext ()
+                   << " removed by partition " << g_current->m_id);
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  (lp != 0 ? lp->m_events : m_events)->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (const_cast<SystemMutex &> (m_destroyMutex));
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  // compare with the clock of the queue holding the event
+  const LogicalProcess *lp = m_running ? GetPartitionOf (id.GetContext ()) : 0;
+  if (lp == 0)
+    {
+      lp = g_current;
+    }
+  uint64_t currentTs = lp != 0 ? lp->m_currentTs : m_currentTs;
+  uint32_t currentUid = lp != 0 ? lp->m_currentUid : m_currentUid;
+  return id.GetTs () < currentTs
+         || (id.GetTs () == currentTs && id.GetUid () <= currentUid);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  if (g_current != 0)
+    {
+      return g_current->m_currentContext;
+    }
+  return Simulator::NO_CONTEXT;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = m_eventCount;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      count += (*i)->m_eventCount;
+    }
+  return count;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_partitions.size ();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t node) const
+{
+  NS_ASSERT (node < m_nodePartition.size ());
+  return m_nodePartition[node];
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return m_lookahead == NEVER ? GetMaximumSimulationTime () : TimeStep (m_lookahead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetRoundCount (void) const
+{
+  return m_rounds;
+}
+
+} // namespace ns3
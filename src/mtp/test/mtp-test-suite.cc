@@ -0,0 +1,554 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/multithreaded-simulator-impl.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests mtp module tests
+ */
+
+namespace {
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Select the simulator implementation of the next simulation
+ *
+ * \param threads the ThreadCount of the multithreaded simulator, 0 for
+ * the default simulator
+ */
+void
+SelectSimulator (uint32_t threads)
+{
+  Simulator::Destroy ();
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue (threads == 0 ? "ns3::DefaultSimulatorImpl" : "ns3::MultithreadedSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (threads));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \return the multithreaded simulator, null for another implementation
+ */
+Ptr<MultithreadedSimulatorImpl>
+GetMultithreadedSimulator (void)
+{
+  return DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Nodes in a line exchanging packets on point-to-point links
+ *
+ * Each node sends a packet of a random size on a random link every few
+ * milliseconds and forwards the large packets it receives, smaller, after
+ * a random processing time. Each node records what it does, with the
+ * time, in a trace written only by its own events.
+ */
+class MtpScenario
+{
+public:
+  /**
+   * \param ticks the packets sent by each node
+   */
+  MtpScenario (uint32_t ticks);
+
+  /**
+   * \brief Create the nodes and the links and schedule the first packets
+   * \param nodes the number of nodes
+   * \param delay the delay of the links
+   */
+  void Build (uint32_t nodes, Time delay);
+
+  /**
+   * \brief Schedule an event for a node, as a packet arriving with a delay
+   * \param node the node
+   * \param delay the delay of the event
+   */
+  void ScheduleFromNode (uint32_t node, Time delay);
+
+  NodeContainer m_nodes;                                //!< The nodes, in a line
+  std::vector<std::vector<std::string> > m_traces;      //!< What each node did
+
+private:
+  /**
+   * \brief Send a packet on a random link
+   * \param node the node
+   */
+  void Tick (uint32_t node);
+  /**
+   * \brief Receive a packet
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  /**
+   * \brief Send a packet on a random link of a node
+   * \param node the node
+   * \param what the name of the operation
+   * \param size the size of the packet
+   */
+  void Send (uint32_t node, std::string what, uint32_t size);
+  /**
+   * \brief Record what a node did
+   * \param node the node
+   * \param what the name of the operation
+   * \param size the size of the packet
+   */
+  void Record (uint32_t node, std::string what, uint32_t size);
+
+  uint32_t m_ticks;                                      //!< The packets sent by each node
+  std::vector<uint32_t> m_sent;                          //!< The packets sent by each node so far
+  std::vector<Ptr<UniformRandomVariable> > m_random;     //!< The random variable of each node
+};
+
+MtpScenario::MtpScenario (uint32_t ticks)
+  : m_ticks (ticks)
+{
+}
+
+void
+MtpScenario::Build (uint32_t nodes, Time delay)
+{
+  m_nodes.Create (nodes);
+  PointToPointHelper link;
+  link.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  link.SetChannelAttribute ("Delay", TimeValue (delay));
+  for (uint32_t i = 0; i + 1 < nodes; i++)
+    {
+      NetDeviceContainer devices = link.Install (m_nodes.Get (i), m_nodes.Get (i + 1));
+      for (uint32_t j = 0; j < devices.GetN (); j++)
+        {
+          devices.Get (j)->SetReceiveCallback (MakeCallback (&MtpScenario::Receive, this));
+        }
+    }
+  m_traces.assign (nodes, std::vector<std::string> ());
+  m_sent.assign (nodes, 0);
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+      random->SetStream (i + 1);
+      m_random.push_back (random);
+      Simulator::ScheduleWithContext (i, MicroSeconds (100 * i + 1), &MtpScenario::Tick, this, i);
+    }
+}
+
+void
+MtpScenario::ScheduleFromNode (uint32_t node, Time delay)
+{
+  Simulator::ScheduleWithContext (node, delay, &MtpScenario::Record, this, node, "late", 0);
+}
+
+void
+MtpScenario::Tick (uint32_t node)
+{
+  Send (node, "tx", 100 + m_random[node]->GetInteger (0, 1100));
+  if (++m_sent[node] < m_ticks)
+    {
+      Simulator::Schedule (NanoSeconds (m_random[node]->GetInteger (1000000, 3000000)),
+                           &MtpScenario::Tick, this, node);
+    }
+}
+
+bool
+MtpScenario::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  uint32_t node = device->GetNode ()->GetId ();
+  Record (node, "rx", packet->GetSize ());
+  if (packet->GetSize () > 600)
+    {
+      Simulator::Schedule (NanoSeconds (m_random[node]->GetInteger (1000, 500000)),
+                           &MtpScenario::Send, this, node, "fw", packet->GetSize () - 500);
+    }
+  return true;
+}
+
+void
+MtpScenario::Send (uint32_t node, std::string what, uint32_t size)
+{
+  Ptr<Node> n = m_nodes.Get (node);
+  Ptr<NetDevice> device = n->GetDevice (m_random[node]->GetInteger (0, n->GetNDevices () - 1));
+  Record (node, what, size);
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+void
+MtpScenario::Record (uint32_t node, std::string what, uint32_t size)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << what << " " << size;
+  m_traces[node].push_back (oss.str ());
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief A run of the multithreaded simulator repeats the default simulator
+ *
+ * The scenario runs to its end with the default simulator and with the
+ * multithreaded one: the traces of the nodes, the number of events and the
+ * end time are the same.
+ */
+class MtpRunTestCase : public TestCase
+{
+public:
+  /**
+   * \param threads the ThreadCount of the multithreaded simulator
+   */
+  MtpRunTestCase (uint32_t threads);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_threads;  //!< The ThreadCount of the multithreaded simulator
+};
+
+MtpRunTestCase::MtpRunTestCase (uint32_t threads)
+  : TestCase ("Run on " + std::to_string (threads) + " threads"),
+    m_threads (threads)
+{
+}
+
+void
+MtpRunTestCase::DoRun (void)
+{
+  uint32_t nodes = 4;
+  std::vector<std::vector<std::string> > traces[2];
+  uint64_t events[2];
+  Time end[2];
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      SelectSimulator (k == 0 ? 0 : m_threads);
+      MtpScenario scenario (50);
+      scenario.Build (nodes, MilliSeconds (5));
+      Simulator::Run ();
+      traces[k] = scenario.m_traces;
+      events[k] = Simulator::GetEventCount ();
+      end[k] = Simulator::Now ();
+      if (k == 1)
+        {
+          Ptr<MultithreadedSimulatorImpl> impl = GetMultithreadedSimulator ();
+          NS_TEST_ASSERT_MSG_EQ ((impl != 0), true, "not run by the multithreaded simulator");
+          NS_TEST_EXPECT_MSG_EQ (impl->GetPartitionCount (), std::min (m_threads, nodes), "wrong number of partitions");
+          NS_TEST_EXPECT_MSG_EQ (impl->GetLookahead (), MilliSeconds (5), "wrong lookahead");
+          NS_TEST_EXPECT_MSG_GT (impl->GetRoundCount (), 1, "the run was not split in rounds");
+        }
+    }
+  SelectSimulator (0);
+
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      NS_TEST_EXPECT_MSG_GT (traces[0][i].size (), 50, "node " << i << " received nothing");
+      NS_TEST_ASSERT_MSG_EQ (traces[1][i].size (), traces[0][i].size (), "wrong trace size of node " << i);
+      for (uint32_t j = 0; j < traces[0][i].size (); j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (traces[1][i][j], traces[0][i][j], "different event " << j << " of node " << i);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (events[1], events[0], "different number of events");
+  NS_TEST_EXPECT_MSG_EQ (end[1], end[0], "different end time");
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Simulator::Stop with the multithreaded simulator
+ *
+ * Stop (delay) called by the script and Stop () called by an event
+ * without context stop every partition where the default simulator
+ * stops. Stop () called by the event of a node stops its partition there
+ * and the other partitions within the lookahead, after the events the
+ * default simulator ran.
+ */
+class MtpStopTestCase : public TestCase
+{
+public:
+  /** How the simulation is stopped */
+  enum Mode
+  {
+    STOP_DELAY,   //!< Simulator::Stop (delay) called by the script
+    GLOBAL,       //!< Simulator::Stop () called by an event without context
+    NODE          //!< Simulator::Stop () called by an event of node 1
+  };
+
+  /**
+   * \param mode how the simulation is stopped
+   */
+  MtpStopTestCase (Mode mode);
+
+private:
+  virtual void DoRun (void);
+
+  /// \return a description of the test case
+  static std::string Name (Mode mode);
+
+  Mode m_mode;  //!< How the simulation is stopped
+};
+
+MtpStopTestCase::MtpStopTestCase (Mode mode)
+  : TestCase (Name (mode)),
+    m_mode (mode)
+{
+}
+
+std::string
+MtpStopTestCase::Name (Mode mode)
+{
+  switch (mode)
+    {
+    case STOP_DELAY:
+      return "Simulator::Stop (delay) called by the script";
+    case GLOBAL:
+      return "Simulator::Stop () called by an event without context";
+    default:
+      return "Simulator::Stop () called by an event of a node";
+    }
+}
+
+void
+MtpStopTestCase::DoRun (void)
+{
+  uint32_t nodes = 4;
+  Time stop = MicroSeconds (40123);
+  Time lookahead = MilliSeconds (5);
+  std::vector<std::vector<std::string> > traces[2];
+  Time end[2];
+  uint64_t events[2];
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      SelectSimulator (k == 0 ? 0 : nodes);
+      MtpScenario scenario (50);
+      scenario.Build (nodes, lookahead);
+      switch (m_mode)
+        {
+        case STOP_DELAY:
+          Simulator::Stop (stop);
+          break;
+        case GLOBAL:
+          Simulator::Schedule (stop, static_cast<void (*) (void)> (&Simulator::Stop));
+          break;
+        case NODE:
+          Simulator::ScheduleWithContext (1, stop, static_cast<void (*) (void)> (&Simulator::Stop));
+          break;
+        }
+      Simulator::Run ();
+      traces[k] = scenario.m_traces;
+      end[k] = Simulator::Now ();
+      events[k] = Simulator::GetEventCount ();
+    }
+  SelectSimulator (0);
+
+  NS_TEST_EXPECT_MSG_EQ (end[0], stop, "the default simulator did not stop in time");
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      NS_TEST_EXPECT_MSG_GT (traces[0][i].size (), 0, "node " << i << " did nothing");
+      if (m_mode != NODE || i == 1)
+        {
+          NS_TEST_EXPECT_MSG_EQ (traces[1][i].size (), traces[0][i].size (), "node " << i << " did not stop");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_GT_OR_EQ (traces[1][i].size (), traces[0][i].size (), "node " << i << " stopped early");
+          std::istringstream last (traces[1][i].back ());
+          int64_t ts;
+          last >> ts;
+          NS_TEST_EXPECT_MSG_LT (TimeStep (ts), stop + lookahead, "node " << i << " did not stop");
+        }
+      for (uint32_t j = 0; j < std::min (traces[0][i].size (), traces[1][i].size ()); j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (traces[1][i][j], traces[0][i][j], "different event " << j << " of node " << i);
+        }
+    }
+  if (m_mode != NODE)
+    {
+      NS_TEST_EXPECT_MSG_EQ (end[1], stop, "the multithreaded simulator did not stop in time");
+      NS_TEST_EXPECT_MSG_EQ (events[1], events[0], "different event count");
+    }
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief The links which cannot split the partitions
+ *
+ * In a line of four nodes, the link 1-2 has a variable delay and the
+ * link 2-3 is shorter than MinLookahead: only the link 0-1 joins two
+ * partitions.
+ */
+class MtpPartitionTestCase : public TestCase
+{
+public:
+  MtpPartitionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MtpPartitionTestCase::MtpPartitionTestCase ()
+  : TestCase ("Links with a variable or a short delay are not cut")
+{
+}
+
+void
+MtpPartitionTestCase::DoRun (void)
+{
+  SelectSimulator (4);
+  MtpScenario scenario (10);
+  scenario.Build (4, MilliSeconds (5));
+  Ptr<PointToPointChannel> variable = DynamicCast<PointToPointChannel> (scenario.m_nodes.Get (1)->GetDevice (1)->GetChannel ());
+  variable->SetDelay (MilliSeconds (2));
+  scenario.m_nodes.Get (2)->GetDevice (1)->GetChannel ()->SetAttribute ("Delay", TimeValue (MicroSeconds (2)));
+  Simulator::Run ();
+
+  Ptr<MultithreadedSimulatorImpl> impl = GetMultithreadedSimulator ();
+  NS_TEST_ASSERT_MSG_EQ ((impl != 0), true, "not run by the multithreaded simulator");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetPartitionCount (), 2, "wrong number of partitions");
+  NS_TEST_EXPECT_MSG_NE (impl->GetPartition (0), impl->GetPartition (1), "the link 0-1 was not cut");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetPartition (1), impl->GetPartition (2), "the link with a variable delay was cut");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetPartition (2), impl->GetPartition (3), "the short link was cut");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetLookahead (), MilliSeconds (5), "wrong lookahead");
+  SelectSimulator (0);
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief The misuses of the multithreaded simulator which abort
+ *
+ * An event sent to another partition sooner than the lookahead, and a
+ * Simulator::ForkAt, abort the simulation: it runs in a child process,
+ * which must be killed by SIGABRT.
+ */
+class MtpAbortTestCase : public TestCase
+{
+public:
+  /**
+   * \param fork true for a Simulator::ForkAt, false for an event within
+   * the lookahead
+   */
+  MtpAbortTestCase (bool fork);
+
+private:
+  virtual void DoRun (void);
+
+  bool m_fork;  //!< True for a Simulator::ForkAt
+};
+
+MtpAbortTestCase::MtpAbortTestCase (bool fork)
+  : TestCase (fork ? "Simulator::ForkAt aborts"
+                   : "An event for another partition within the lookahead aborts"),
+    m_fork (fork)
+{
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * The branch of Simulator::ForkAt, never called
+ *
+ * \param branch the index of the branch
+ */
+static void
+ForkBranch (uint32_t branch)
+{
+}
+
+void
+MtpAbortTestCase::DoRun (void)
+{
+  pid_t pid = fork ();
+  NS_TEST_ASSERT_MSG_NE (pid, -1, "fork failed");
+  if (pid == 0)
+    {
+      // the child process must not report, nor run the other tests
+      int null = open ("/dev/null", O_WRONLY);
+      dup2 (null, STDERR_FILENO);
+      SelectSimulator (2);
+      MtpScenario scenario (10);
+      scenario.Build (2, MilliSeconds (5));
+      if (m_fork)
+        {
+          Simulator::ForkAt (MilliSeconds (3), 2, MakeCallback (&ForkBranch));
+        }
+      else
+        {
+          Simulator::ScheduleWithContext (0, MilliSeconds (3), &MtpScenario::ScheduleFromNode,
+                                          &scenario, 1, MicroSeconds (10));
+        }
+      Simulator::Run ();
+      _exit (0);
+    }
+  int status;
+  NS_TEST_ASSERT_MSG_EQ (waitpid (pid, &status, 0), pid, "waitpid failed");
+  NS_TEST_EXPECT_MSG_EQ (WIFSIGNALED (status) && WTERMSIG (status) == SIGABRT, true,
+                         "the simulation did not abort");
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief mtp TestSuite
+ */
+class MtpTestSuite : public TestSuite
+{
+public:
+  MtpTestSuite ()
+    : TestSuite ("mtp", UNIT)
+  {
+    AddTestCase (new MtpRunTestCase (2), TestCase::QUICK);
+    AddTestCase (new MtpRunTestCase (4), TestCase::QUICK);
+    AddTestCase (new MtpStopTestCase (MtpStopTestCase::STOP_DELAY), TestCase::QUICK);
+    AddTestCase (new MtpStopTestCase (MtpStopTestCase::GLOBAL), TestCase::QUICK);
+    AddTestCase (new MtpStopTestCase (MtpStopTestCase::NODE), TestCase::QUICK);
+    AddTestCase (new MtpPartitionTestCase, TestCase::QUICK);
+    AddTestCase (new MtpAbortTestCase (false), TestCase::QUICK);
+    AddTestCase (new MtpAbortTestCase (true), TestCase::QUICK);
+  }
+};
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
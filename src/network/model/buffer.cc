@@ -20,6 +20,7 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -50,7 +51,11 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -206,6 +211,12 @@ Buffer::Buffer (uint32_t dataSize, bool initialize)
     }
 }
 
+Buffer::Buffer (uint32_t dataSize, uint8_t fill)
+{
+  NS_LOG_FUNCTION (this << dataSize << (uint32_t) fill);
+  Initialize (dataSize, fill);
+}
+
 bool
 Buffer::CheckInternalState (void) const
 {
@@ -241,14 +252,15 @@ Buffer::CheckInternalState (void) const
 }
 
 void
-Buffer::Initialize (uint32_t zeroSize)
+Buffer::Initialize (uint32_t zeroSize, uint8_t fill)
 {
-  NS_LOG_FUNCTION (this << zeroSize);
+  NS_LOG_FUNCTION (this << zeroSize << (uint32_t) fill);
   m_data = Buffer::Create (0);
   m_start = std::min (m_data->m_size, g_recommendedStart);
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
   m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
+  m_zeroAreaFill = fill;
   m_end = m_zeroAreaEnd;
   m_data->m_dirtyStart = m_start;
   m_data->m_dirtyEnd = m_end;
@@ -262,8 +274,7 @@ Buffer::operator = (Buffer const&o)
   if (m_data != o.m_data) 
     {
       // not assignment to self.
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Recycle (m_data);
         }
@@ -274,6 +285,7 @@ Buffer::operator = (Buffer const&o)
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
   m_zeroAreaStart = o.m_zeroAreaStart;
   m_zeroAreaEnd = o.m_zeroAreaEnd;
+  m_zeroAreaFill = o.m_zeroAreaFill;
   m_start = o.m_start;
   m_end = o.m_end;
   NS_ASSERT (CheckInternalState ());
@@ -285,8 +297,7 @@ Buffer::~Buffer ()
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       Recycle (m_data);
     }
@@ -310,7 +321,13 @@ Buffer::AddAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  // the buffers sharing the data may live in other threads: only grow
+  // data we own in place
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#endif
   if (m_start >= start && !isDirty)
     {
       /* enough space in the buffer and not dirty. 
@@ -328,8 +345,7 @@ Buffer::AddAtStart (uint32_t start)
       uint32_t newSize = GetInternalSize () + start;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0)
+      if (--m_data->m_count == 0)
         {
           Buffer::Recycle (m_data);
         }
@@ -355,7 +371,13 @@ Buffer::AddAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  // the buffers sharing the data may live in other threads: only grow
+  // data we own in place
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#endif
   if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
     {
       /* enough space in buffer and not dirty
@@ -373,8 +395,7 @@ Buffer::AddAtEnd (uint32_t end)
       uint32_t newSize = GetInternalSize () + end;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Buffer::Recycle (m_data);
         }
@@ -404,14 +425,16 @@ Buffer::AddAtEnd (const Buffer &o)
       m_end == m_zeroAreaEnd &&
       m_end == m_data->m_dirtyEnd &&
       o.m_start == o.m_zeroAreaStart &&
-      o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+      o.m_zeroAreaEnd - o.m_zeroAreaStart > 0 &&
+      (m_zeroAreaFill == o.m_zeroAreaFill || m_zeroAreaEnd == m_zeroAreaStart))
     {
       /**
        * This is an optimization which kicks in when
        * we attempt to aggregate two buffers which contain
-       * adjacent zero areas.
+       * adjacent zero areas with the same fill byte.
        */
       uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
+      m_zeroAreaFill = o.m_zeroAreaFill;
       m_zeroAreaEnd += zeroSize;
       m_end = m_zeroAreaEnd;
       m_data->m_dirtyEnd = m_zeroAreaEnd;
@@ -536,7 +559,7 @@ Buffer::CreateFullCopy (void) const
     {
       Buffer tmp;
       tmp.AddAtStart (m_zeroAreaEnd - m_zeroAreaStart);
-      tmp.Begin ().WriteU8 (0, m_zeroAreaEnd - m_zeroAreaStart);
+      tmp.Begin ().WriteU8 (m_zeroAreaFill, m_zeroAreaEnd - m_zeroAreaStart);
       uint32_t dataStart = m_zeroAreaStart - m_start;
       tmp.AddAtStart (dataStart);
       tmp.Begin ().Write (m_data->m_data+m_start, dataStart);
@@ -559,11 +582,14 @@ Buffer::GetSerializedSize (void) const
   uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
   uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
-  // total size 4-bytes for dataStart length 
+  // total size 4-bytes for zero data length
+  // + 4-bytes for zero data fill byte, if not zero
+  // + 4-bytes for dataStart length 
   // + X number of bytes for dataStart 
   // + 4-bytes for dataEnd length 
   // + X number of bytes for dataEnd
   uint32_t sz = sizeof (uint32_t)
+    + (m_zeroAreaFill != 0 ? sizeof (uint32_t) : 0)
     + sizeof (uint32_t)
     + dataStart
     + sizeof (uint32_t)
@@ -579,17 +605,33 @@ Buffer::Serialize (uint8_t* buffer, uint32_t maxSize) const
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
-  // Add the zero data length
+  // Add the zero data length, flagged if a fill byte follows
+  uint32_t zeroDataLength = m_zeroAreaEnd - m_zeroAreaStart;
+  NS_ASSERT ((zeroDataLength & ZERO_FILL_FLAG) == 0);
   if (size + 4 <= maxSize)
     {
       size += 4;
-      *p++ = m_zeroAreaEnd - m_zeroAreaStart;
+      *p++ = zeroDataLength | (m_zeroAreaFill != 0 ? ZERO_FILL_FLAG : 0);
     }
   else
     {
       return 0;
     }
 
+  // Add the zero data fill byte
+  if (m_zeroAreaFill != 0)
+    {
+      if (size + 4 <= maxSize)
+        {
+          size += 4;
+          *p++ = m_zeroAreaFill;
+        }
+      else
+        {
+          return 0;
+        }
+    }
+
   // Add the length of actual start data
   uint32_t dataStartLength = m_zeroAreaStart - m_start;
   if (size + 4 <= maxSize)
@@ -655,8 +697,17 @@ Buffer::Deserialize (const uint8_t *buffer, uint32_t size)
   uint32_t zeroDataLength = *p++;
   sizeCheck -= 4;
 
+  uint8_t zeroDataFill = 0;
+  if (zeroDataLength & ZERO_FILL_FLAG)
+    {
+      zeroDataLength &= ~ZERO_FILL_FLAG;
+      NS_ASSERT (sizeCheck >= 4);
+      zeroDataFill = static_cast<uint8_t> (*p++);
+      sizeCheck -= 4;
+    }
+
   // Create zero bytes
-  Initialize (zeroDataLength);
+  Initialize (zeroDataLength, zeroDataFill);
 
   // Add start data
   NS_ASSERT (sizeCheck >= 4);
@@ -724,10 +775,17 @@ Buffer::CopyData (std::ostream *os, uint32_t size) const
           size -= m_zeroAreaStart-m_start;
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
           uint32_t left = tmpsize;
+          const char *fill = g_zeroes.buffer;
+          char pattern[1000];
+          if (m_zeroAreaFill != 0)
+            {
+              memset (pattern, m_zeroAreaFill, sizeof (pattern));
+              fill = pattern;
+            }
           while (left > 0)
             {
               uint32_t toWrite = std::min (left, g_zeroes.size);
-              os->write (g_zeroes.buffer, toWrite);
+              os->write (fill, toWrite);
               left -= toWrite;
             }
           if (size > tmpsize)
@@ -754,14 +812,8 @@ Buffer::CopyData (uint8_t *buffer, uint32_t size) const
       if (size > 0) 
         { 
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
-          uint32_t left = tmpsize;
-          while (left > 0)
-            {
-              uint32_t toWrite = std::min (left, g_zeroes.size);
-              memcpy (buffer, g_zeroes.buffer, toWrite);
-              left -= toWrite;
-              buffer += toWrite;
-            }
+          memset (buffer, m_zeroAreaFill, tmpsize);
+          buffer += tmpsize;
           size -= tmpsize;
           if (size > 0)
             {
@@ -774,6 +826,20 @@ Buffer::CopyData (uint8_t *buffer, uint32_t size) const
   return originalSize - size;
 }
 
+uint32_t
+Buffer::CountByte (uint8_t byte) const
+{
+  NS_LOG_FUNCTION (this << (uint32_t) byte);
+  const uint8_t *data = m_data->m_data;
+  uint32_t count = std::count (data + m_start, data + m_zeroAreaStart, byte);
+  if (m_zeroAreaFill == byte)
+    {
+      count += m_zeroAreaEnd - m_zeroAreaStart;
+    }
+  count += std::count (data + m_zeroAreaStart, data + GetInternalEnd (), byte);
+  return count;
+}
+
 /******************************************************
  *            The buffer iterator below.
  ******************************************************/
@@ -854,7 +920,7 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (&m_data[m_current], start.m_zeroFill, toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
       size -= toCopy;
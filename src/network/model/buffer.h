@@ -24,8 +24,15 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
+#ifndef NS3_MTP
+// the multithreaded simulator frees data in another thread than the one
+// which allocated it
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3 {
 
@@ -70,6 +77,11 @@ namespace ns3 {
  * a pair of integers which describe where in the buffer content
  * the "virtual zero area" starts and ends.
  *
+ * The bytes of the virtual zero area all have the same value, zero
+ * unless the buffer was created with another fill byte: a payload
+ * filled with a pattern byte costs no memory either, and CountByte
+ * checks it without reading it byte by byte.
+ *
  * \verbatim
  * ***: unused bytes
  * xxx: bytes "added" at the front of the zero area
@@ -462,6 +474,10 @@ private:
      * end of the "virtual zero area".
      */
     uint32_t m_zeroEnd;
+    /**
+     * value of the bytes of the "virtual zero area".
+     */
+    uint8_t m_zeroFill;
     /**
      * offset in virtual bytes from the start of the data buffer to the
      * start of the data which can be read by this iterator
@@ -580,7 +596,8 @@ private:
    * This buffer's contents are serialized into the raw 
    * character buffer parameter. Note: The zero length 
    * data is not copied entirely. Only the length of 
-   * zero byte data is serialized.
+   * zero byte data is serialized, and its fill byte
+   * if it is not zero.
    */
   uint32_t Serialize (uint8_t* buffer, uint32_t maxSize) const;
 
@@ -611,6 +628,17 @@ private:
    */
   uint32_t CopyData (uint8_t *buffer, uint32_t size) const;
 
+  /**
+   * \brief Count the bytes of the buffer equal to a value
+   *
+   * The virtual zero area is accounted for as a whole, so this is
+   * cheap on buffers whose payload was never materialized.
+   *
+   * \param byte the value to look for
+   * \returns the number of bytes equal to byte
+   */
+  uint32_t CountByte (uint8_t byte) const;
+
   /**
    * \brief Copy constructor
    * \param o the buffer to copy
@@ -641,6 +669,17 @@ private:
    * \param initialize initialize the buffer with zeroes.
    */
   Buffer (uint32_t dataSize, bool initialize);
+  /**
+   * \brief Constructor
+   *
+   * The buffer will be initialized with fill bytes up to its size.
+   * As for zeroes, no memory is allocated for them until the buffer
+   * is fragmented or its content is accessed.
+   *
+   * \param dataSize the buffer size
+   * \param fill the value of every byte of the buffer
+   */
+  Buffer (uint32_t dataSize, uint8_t fill);
   ~Buffer ();
 private:
   /**
@@ -663,7 +702,11 @@ private:
      * The reference count of an instance of this data structure.
      * Each buffer which references an instance holds a count.
      */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /**
      * the size of the m_data field below.
      */
@@ -710,8 +753,9 @@ private:
    * \brief Initializes the buffer with a number of zeroes.
    *
    * \param zeroSize the zeroes size
+   * \param fill the value of the "zeroes"
    */
-  void Initialize (uint32_t zeroSize);
+  void Initialize (uint32_t zeroSize, uint8_t fill = 0);
 
   /**
    * \brief Get the buffer real size.
@@ -762,12 +806,21 @@ private:
    * m_zeroAreaStart.
    */
   uint32_t m_maxZeroAreaStart;
+  /**
+   * flag of the serialized zero area length: a word with the fill
+   * byte follows it. Zero-filled buffers keep the format without it.
+   */
+  static const uint32_t ZERO_FILL_FLAG = 0x80000000;
   /**
    * location in a newly-allocated buffer where you should start
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
+#ifdef NS3_MTP
+  static thread_local uint32_t g_recommendedStart;
+#else
   static uint32_t g_recommendedStart;
+#endif
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -779,6 +832,10 @@ private:
    * of m_data->m_data
    */
   uint32_t m_zeroAreaEnd;
+  /**
+   * value of the bytes of the virtual zero area
+   */
+  uint8_t m_zeroAreaFill;
   /**
    * offset to the start of the data referenced by this Buffer
    * instance from the start of m_data->m_data
@@ -814,6 +871,7 @@ namespace ns3 {
 Buffer::Iterator::Iterator ()
   : m_zeroStart (0),
     m_zeroEnd (0),
+    m_zeroFill (0),
     m_dataStart (0),
     m_dataEnd (0),
     m_current (0),
@@ -836,6 +894,7 @@ Buffer::Iterator::Construct (const Buffer *buffer)
 {
   m_zeroStart = buffer->m_zeroAreaStart;
   m_zeroEnd = buffer->m_zeroAreaEnd;
+  m_zeroFill = buffer->m_zeroAreaFill;
   m_dataStart = buffer->m_start;
   m_dataEnd = buffer->m_end;
   m_data = buffer->m_data->m_data;
@@ -1008,7 +1067,7 @@ Buffer::Iterator::PeekU8 (void)
     }
   else if (m_current < m_zeroEnd)
     {
-      return 0;
+      return m_zeroFill;
     }
   else
     {
@@ -1052,6 +1111,7 @@ Buffer::Buffer (Buffer const&o)
     m_maxZeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaEnd (o.m_zeroAreaEnd),
+    m_zeroAreaFill (o.m_zeroAreaFill),
     m_start (o.m_start),
     m_end (o.m_end)
 {
@@ -260,6 +260,17 @@ public:
    * \param size the size of the zero-filled payload
    */
   Packet (uint32_t size);
+  /**
+   * \brief Create a packet with a payload filled with one byte value.
+   *
+   * As for the zero-filled payload, the memory is not allocated until
+   * the packet is fragmented or the bytes are accessed, and CountByte
+   * checks the payload without reading it.
+   *
+   * \param size the size of the payload
+   * \param fill the value of every byte of the payload
+   */
+  Packet (uint32_t size, uint8_t fill);
   /**
    * \brief Create a new packet from the serialized buffer.
    *
@@ -432,6 +443,16 @@ public:
    */
   uint32_t CopyData (uint8_t *buffer, uint32_t size) const;
 
+  /**
+   * \brief Count the bytes of the packet equal to a value.
+   *
+   * Not-allocated payload bytes are counted without being read.
+   *
+   * \param byte the value to look for
+   * \returns the number of bytes equal to byte
+   */
+  uint32_t CountByte (uint8_t byte) const;
+
   /**
    * \brief Copy the packet contents to an output stream.
    *
@@ -787,7 +808,11 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
   static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -387,6 +387,45 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // virtual area filled with a pattern byte
+  buffer = Buffer (4, (uint8_t) 0x5a);
+  NS_TEST_ASSERT_MSG_EQ (buffer.CountByte (0x5a), 4, "Bad pattern byte count");
+  buffer.AddAtStart (1);
+  buffer.Begin ().WriteU8 (0x11);
+  ENSURE_WRITTEN_BYTES (buffer, 5, 0x11, 0x5a, 0x5a, 0x5a, 0x5a);
+  Buffer pattern = Buffer (2, (uint8_t) 0x5a);
+  buffer = Buffer (3, (uint8_t) 0x5a);
+  buffer.AddAtEnd (pattern);
+  NS_TEST_ASSERT_MSG_EQ (buffer.CountByte (0x5a), 5, "Bad merged pattern byte count");
+  pattern = Buffer (2, (uint8_t) 0x6b);
+  buffer.AddAtEnd (pattern);
+  ENSURE_WRITTEN_BYTES (buffer, 7, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x6b, 0x6b);
+  NS_TEST_ASSERT_MSG_EQ (buffer.CountByte (0x6b), 2, "Bad mixed pattern byte count");
+
+  // serialization: the fill byte only costs a word if it is not zero. The
+  // size given to Deserialize also counts the length word which
+  // Packet::Serialize writes before the buffer.
+  uint8_t serialized[64];
+  buffer = Buffer (1000);
+  buffer.AddAtStart (2);
+  buffer.Begin ().WriteU16 (0x1122);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSerializedSize (), 16, "Bad zero-filled serialized size");
+  NS_TEST_ASSERT_MSG_EQ (buffer.Serialize (serialized, sizeof (serialized)), 1, "Zero-filled serialization failed");
+  Buffer copy;
+  NS_TEST_ASSERT_MSG_EQ (copy.Deserialize (serialized, buffer.GetSerializedSize () + 4), 1, "Zero-filled deserialization failed");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetSize (), 1002, "Bad zero-filled deserialized size");
+  NS_TEST_ASSERT_MSG_EQ (copy.CountByte (0), 1000, "Bad zero-filled deserialized area");
+  buffer = Buffer (1000, (uint8_t) 0x5a);
+  buffer.AddAtStart (2);
+  buffer.Begin ().WriteU16 (0x1122);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSerializedSize (), 20, "Bad pattern serialized size");
+  NS_TEST_ASSERT_MSG_EQ (buffer.Serialize (serialized, sizeof (serialized)), 1, "Pattern serialization failed");
+  Buffer patternCopy;
+  NS_TEST_ASSERT_MSG_EQ (patternCopy.Deserialize (serialized, buffer.GetSerializedSize () + 4), 1, "Pattern deserialization failed");
+  NS_TEST_ASSERT_MSG_EQ (patternCopy.GetSize (), 1002, "Bad pattern deserialized size");
+  NS_TEST_ASSERT_MSG_EQ (patternCopy.CountByte (0x5a), 1000, "Bad pattern deserialized area");
+  NS_TEST_ASSERT_MSG_EQ (patternCopy.Begin ().ReadU16 (), 0x1122, "Bad pattern deserialized data");
 }
 
 /**
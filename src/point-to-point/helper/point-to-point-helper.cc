@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/reconfigurable-point-to-point-channel.h"
 #include "ns3/queue.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/config.h"
@@ -230,23 +231,8 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
 {
   NetDeviceContainer container;
 
-  Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice> ();
-  devA->SetAddress (Mac48Address::Allocate ());
-  a->AddDevice (devA);
-  Ptr<Queue<Packet> > queueA = m_queueFactory.Create<Queue<Packet> > ();
-  devA->SetQueue (queueA);
-  Ptr<PointToPointNetDevice> devB = m_deviceFactory.Create<PointToPointNetDevice> ();
-  devB->SetAddress (Mac48Address::Allocate ());
-  b->AddDevice (devB);
-  Ptr<Queue<Packet> > queueB = m_queueFactory.Create<Queue<Packet> > ();
-  devB->SetQueue (queueB);
-  // Aggregate NetDeviceQueueInterface objects
-  Ptr<NetDeviceQueueInterface> ndqiA = CreateObject<NetDeviceQueueInterface> ();
-  ndqiA->GetTxQueue (0)->ConnectQueueTraces (queueA);
-  devA->AggregateObject (ndqiA);
-  Ptr<NetDeviceQueueInterface> ndqiB = CreateObject<NetDeviceQueueInterface> ();
-  ndqiB->GetTxQueue (0)->ConnectQueueTraces (queueB);
-  devB->AggregateObject (ndqiB);
+  Ptr<PointToPointNetDevice> devA = CreateDevice (a);
+  Ptr<PointToPointNetDevice> devB = CreateDevice (b);
 
   Ptr<PointToPointChannel> channel = 0;
 
@@ -293,6 +279,53 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
   return container;
 }
 
+Ptr<PointToPointNetDevice>
+PointToPointHelper::CreateDevice (Ptr<Node> node)
+{
+  Ptr<PointToPointNetDevice> dev = m_deviceFactory.Create<PointToPointNetDevice> ();
+  dev->SetAddress (Mac48Address::Allocate ());
+  node->AddDevice (dev);
+  Ptr<Queue<Packet> > queue = m_queueFactory.Create<Queue<Packet> > ();
+  dev->SetQueue (queue);
+  // Aggregate NetDeviceQueueInterface objects
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  ndqi->GetTxQueue (0)->ConnectQueueTraces (queue);
+  dev->AggregateObject (ndqi);
+  return dev;
+}
+
+NetDeviceContainer
+PointToPointHelper::InstallReconfigurable (Ptr<Node> a, Ptr<Node> b)
+{
+  NetDeviceContainer container;
+
+  Ptr<PointToPointNetDevice> devA = CreateDevice (a);
+  Ptr<PointToPointNetDevice> devB = CreateDevice (b);
+
+  // Same channel attributes as the other channels of the helper
+  ObjectFactory channelFactory = m_channelFactory;
+  channelFactory.SetTypeId ("ns3::ReconfigurablePointToPointChannel");
+  Ptr<ReconfigurablePointToPointChannel> channel = channelFactory.Create<ReconfigurablePointToPointChannel> ();
+
+  devA->Attach (channel);
+  devB->Attach (channel);
+  container.Add (devA);
+  container.Add (devB);
+
+  return container;
+}
+
+NetDeviceContainer
+PointToPointHelper::InstallDevices (NodeContainer c)
+{
+  NetDeviceContainer container;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      container.Add (CreateDevice (*i));
+    }
+  return container;
+}
+
 NetDeviceContainer 
 PointToPointHelper::Install (Ptr<Node> a, std::string bName)
 {
@@ -32,6 +32,7 @@ namespace ns3 {
 
 class NetDevice;
 class Node;
+class PointToPointNetDevice;
 
 /**
  * \brief Build a set of PointToPointNetDevice objects
@@ -150,7 +151,35 @@ public:
    */
   NetDeviceContainer Install (std::string aNode, std::string bNode);
 
+  /**
+   * \param a first node, the near end of the channel
+   * \param b second node, the far end of the channel
+   * \return a NetDeviceContainer for nodes
+   *
+   * Like Install (a, b), but the devices are connected by a
+   * ns3::ReconfigurablePointToPointChannel, whose far end can be rebound
+   * at run time to a device of another node.
+   */
+  NetDeviceContainer InstallReconfigurable (Ptr<Node> a, Ptr<Node> b);
+
+  /**
+   * \param c a set of nodes
+   * \return a NetDeviceContainer for nodes
+   *
+   * This method creates a ns3::PointToPointNetDevice with the requested
+   * attributes and its queue on each node, without a channel. A
+   * ns3::ReconfigurablePointToPointChannel can then be rebound to them.
+   */
+  NetDeviceContainer InstallDevices (NodeContainer c);
+
 private:
+  /**
+   * \brief Create a device with its queue and add it to a node
+   * \param node the node
+   * \return the device, attached to no channel
+   */
+  Ptr<PointToPointNetDevice> CreateDevice (Ptr<Node> node);
+
   /**
    * \brief Enable pcap output the indicated net device.
    *
@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/trace-source-accessor.h"
+#include "link-rate-trace-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LinkRateTraceModel");
+
+NS_OBJECT_ENSURE_REGISTERED (LinkRateTraceModel);
+
+TypeId
+LinkRateTraceModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LinkRateTraceModel")
+    .SetParent<Object> ()
+    .SetGroupName ("PointToPoint")
+    .AddConstructor<LinkRateTraceModel> ()
+    .AddAttribute ("TraceFile",
+                   "Binary (time, rate, delay, loss) trace to replay",
+                   StringValue (""),
+                   MakeStringAccessor (&LinkRateTraceModel::SetTraceFile,
+                                       &LinkRateTraceModel::GetTraceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("Loop",
+                   "Replay the trace from the start once it is over",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LinkRateTraceModel::m_loop),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Offset",
+                   "Simulation time corresponding to time zero of the trace",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LinkRateTraceModel::m_offset),
+                   MakeTimeChecker ())
+    .AddTraceSource ("RateChanged",
+                     "The trace moved the link to a new rate",
+                     MakeTraceSourceAccessor (&LinkRateTraceModel::m_rateTrace),
+                     "ns3::LinkRateTraceModel::RateTracedCallback")
+  ;
+  return tid;
+}
+
+LinkRateTraceModel::LinkRateTraceModel ()
+  : m_samples (0),
+    m_nSamples (0),
+    m_mapSize (0),
+    m_index (0),
+    m_started (false),
+    m_delay (Seconds (-1)),
+    m_loss (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_uniform = CreateObject<UniformRandomVariable> ();
+}
+
+LinkRateTraceModel::~LinkRateTraceModel ()
+{
+  NS_LOG_FUNCTION (this);
+  Unmap ();
+}
+
+void
+LinkRateTraceModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Unmap ();
+  m_uniform = 0;
+  Object::DoDispose ();
+}
+
+void
+LinkRateTraceModel::Unmap (void)
+{
+  if (m_samples != 0)
+    {
+      munmap (const_cast<Sample *> (m_samples), m_mapSize);
+    }
+  m_samples = 0;
+  m_nSamples = 0;
+  m_mapSize = 0;
+  m_index = 0;
+  m_started = false;
+}
+
+void
+LinkRateTraceModel::SetTraceFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Unmap ();
+  m_filename = filename;
+  if (filename.empty ())
+    {
+      return;
+    }
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Cannot open link rate trace " << filename);
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0, "Cannot stat link rate trace " << filename);
+  NS_ABORT_MSG_IF (st.st_size == 0 || st.st_size % sizeof (Sample) != 0,
+                   "Link rate trace " << filename << " is not a whole number of samples");
+
+  void *addr = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (addr == MAP_FAILED, "Cannot map link rate trace " << filename);
+  // the replay walks the trace forward
+  madvise (addr, st.st_size, MADV_SEQUENTIAL);
+
+  m_samples = static_cast<const Sample *> (addr);
+  m_mapSize = st.st_size;
+  m_nSamples = st.st_size / sizeof (Sample);
+  NS_LOG_INFO ("Mapped " << m_nSamples << " samples from " << filename
+                         << ", " << m_samples[0].m_time << " s to "
+                         << m_samples[m_nSamples - 1].m_time << " s");
+}
+
+std::string
+LinkRateTraceModel::GetTraceFile (void) const
+{
+  return m_filename;
+}
+
+uint64_t
+LinkRateTraceModel::GetNSamples (void) const
+{
+  return m_nSamples;
+}
+
+bool
+LinkRateTraceModel::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_nSamples == 0 || Simulator::Now () < m_offset)
+    {
+      return false;
+    }
+
+  double t = (Simulator::Now () - m_offset).GetSeconds ();
+  // the last sample lasts as long as the interval before it
+  double period = 0;
+  if (m_nSamples > 1)
+    {
+      double last = m_samples[m_nSamples - 1].m_time;
+      period = 2 * last - m_samples[m_nSamples - 2].m_time;
+    }
+  if (m_loop && period > 0)
+    {
+      t = std::fmod (t, period);
+      if (t < m_samples[m_index].m_time)
+        {
+          // wrapped around
+          m_index = 0;
+        }
+    }
+  if (t < m_samples[0].m_time)
+    {
+      return false;
+    }
+  while (m_index + 1 < m_nSamples && m_samples[m_index + 1].m_time <= t)
+    {
+      m_index++;
+    }
+
+  const Sample &s = m_samples[m_index];
+  DataRate rate (static_cast<uint64_t> (s.m_rate));
+  Time delay = Seconds (s.m_delay);
+  m_loss = s.m_loss;
+  if (m_started && rate == m_rate && delay == m_delay)
+    {
+      return false;
+    }
+
+  NS_LOG_INFO ("Sample " << m_index << ": " << rate << ", " << delay.As (Time::MS)
+                         << ", loss " << m_loss);
+  DataRate oldRate = m_rate;
+  m_started = true;
+  m_rate = rate;
+  m_delay = delay;
+  if (oldRate != rate)
+    {
+      m_rateTrace (oldRate, rate);
+    }
+  return true;
+}
+
+DataRate
+LinkRateTraceModel::GetRate (void) const
+{
+  return m_rate;
+}
+
+Time
+LinkRateTraceModel::GetDelay (void) const
+{
+  return m_delay;
+}
+
+bool
+LinkRateTraceModel::IsLost (void)
+{
+  if (!m_started)
+    {
+      return false;
+    }
+  if (m_rate.GetBitRate () == 0 || m_loss >= 1)
+    {
+      return true;
+    }
+  return m_loss > 0 && m_uniform->GetValue () < m_loss;
+}
+
+int64_t
+LinkRateTraceModel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_uniform->SetStream (stream);
+  return 1;
+}
+
+void
+LinkRateTraceModel::WriteTraceFile (std::string filename, const std::vector<Sample> &samples)
+{
+  std::ofstream out (filename.c_str (), std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_IF (!out, "Cannot write link rate trace " << filename);
+  out.write (reinterpret_cast<const char *> (samples.data ()), samples.size () * sizeof (Sample));
+}
+
+} // namespace ns3
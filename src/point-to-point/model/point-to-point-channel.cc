@@ -19,6 +19,8 @@
 #include "point-to-point-channel.h"
 #include "point-to-point-net-device.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
@@ -40,6 +42,14 @@ PointToPointChannel::GetTypeId (void)
                    TimeValue (Seconds (0)),
                    MakeTimeAccessor (&PointToPointChannel::m_delay),
                    MakeTimeChecker ())
+    .AddAttribute ("VariableDelay",
+                   "True if the Delay may change during the simulation. "
+                   "SetDelay sets it; a model which changes the Delay only "
+                   "once the simulation runs must set it beforehand.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointChannel::SetVariableDelay,
+                                        &PointToPointChannel::IsDelayVariable),
+                   MakeBooleanChecker ())
     .AddTraceSource ("TxRxPointToPoint",
                      "Trace source indicating transmission of packet "
                      "from the PointToPointChannel, used by the Animation "
@@ -57,6 +67,7 @@ PointToPointChannel::PointToPointChannel()
   :
     Channel (),
     m_delay (Seconds (0.)),
+    m_variableDelay (false),
     m_nDevices (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -135,6 +146,41 @@ PointToPointChannel::GetDelay (void) const
   return m_delay;
 }
 
+void
+PointToPointChannel::SetDelay (Time delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  m_delay = delay;
+  m_variableDelay = true;
+}
+
+void
+PointToPointChannel::SetVariableDelay (bool variable)
+{
+  NS_LOG_FUNCTION (this << variable);
+  m_variableDelay = variable;
+}
+
+bool
+PointToPointChannel::IsDelayVariable (void) const
+{
+  if (m_variableDelay)
+    {
+      return true;
+    }
+  // a replayed rate trace may change the delay at each transmission
+  for (std::size_t i = 0; i < m_nDevices; i++)
+    {
+      PointerValue trace;
+      m_link[i].m_src->GetAttribute ("RateTraceModel", trace);
+      if (trace.GetObject () != 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 Ptr<PointToPointNetDevice>
 PointToPointChannel::GetSource (uint32_t i) const
 {
@@ -147,6 +193,17 @@ PointToPointChannel::GetDestination (uint32_t i) const
   return m_link[i].m_dst;
 }
 
+void
+PointToPointChannel::ReplaceDevice (uint32_t i, Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << i << device);
+  NS_ASSERT (i < N_DEVICES);
+  NS_ASSERT (device != 0);
+  NS_ASSERT (IsInitialized ());
+  m_link[i].m_src = device;
+  m_link[1 - i].m_dst = device;
+}
+
 bool
 PointToPointChannel::IsInitialized (void) const
 {
@@ -100,6 +100,32 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \brief Set the propagation delay of the channel
+   *
+   * Packets already in flight keep the delay they were sent with. The
+   * delay of the channel becomes variable.
+   *
+   * \param delay the new delay
+   */
+  void SetDelay (Time delay);
+
+  /**
+   * \brief Declare whether the delay may change during the simulation
+   *
+   * A parallel simulator does not split the simulation across a channel
+   * whose delay is variable, since its current delay is no lower bound.
+   *
+   * \param variable true if the delay may change
+   */
+  void SetVariableDelay (bool variable);
+
+  /**
+   * \returns true if the delay may change during the simulation: it was
+   * declared variable, set by SetDelay, or a device replays a rate trace
+   */
+  virtual bool IsDelayVariable (void) const;
+
 protected:
   /**
    * \brief Get the delay associated with this channel
@@ -129,6 +155,17 @@ protected:
    */
   Ptr<PointToPointNetDevice> GetDestination (uint32_t i) const;
 
+  /**
+   * \brief Replace a net-device of an initialized channel
+   *
+   * The device becomes the source of link i and the destination of the
+   * other link, the state of the links is kept.
+   *
+   * \param i the link of the net-device to replace
+   * \param device the new net-device
+   */
+  void ReplaceDevice (uint32_t i, Ptr<PointToPointNetDevice> device);
+
   /**
    * TracedCallback signature for packet transmission animation events.
    *
@@ -150,6 +187,7 @@ private:
   static const std::size_t N_DEVICES = 2;
 
   Time          m_delay;    //!< Propagation delay
+  bool          m_variableDelay; //!< True if the delay may change
   std::size_t        m_nDevices; //!< Devices of this channel
 
   /**
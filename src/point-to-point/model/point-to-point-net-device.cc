@@ -28,6 +28,7 @@
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
+#include "link-rate-trace-model.h"
 
 namespace ns3 {
 
@@ -62,6 +63,11 @@ PointToPointNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&PointToPointNetDevice::m_receiveErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("RateTraceModel", 
+                   "Trace replayed to drive the rate, delay and loss of the link",
+                   PointerValue (),
+                   MakePointerAccessor (&PointToPointNetDevice::m_rateTraceModel),
+                   MakePointerChecker<LinkRateTraceModel> ())
     .AddAttribute ("InterframeGap", 
                    "The time to wait between packet (frame) transmissions",
                    TimeValue (Seconds (0.0)),
@@ -213,6 +219,7 @@ PointToPointNetDevice::DoDispose ()
   m_node = 0;
   m_channel = 0;
   m_receiveErrorModel = 0;
+  m_rateTraceModel = 0;
   m_currentPkt = 0;
   m_queue = 0;
   NetDevice::DoDispose ();
@@ -248,12 +255,40 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
+  //
+  // A replayed trace is only looked at when the link is used, rather than
+  // scheduling one event per sample.
+  //
+  bool lost = false;
+  if (m_rateTraceModel != 0)
+    {
+      if (m_rateTraceModel->Update ())
+        {
+          if (m_rateTraceModel->GetRate ().GetBitRate () > 0)
+            {
+              m_bps = m_rateTraceModel->GetRate ();
+            }
+          if (!m_rateTraceModel->GetDelay ().IsNegative ())
+            {
+              m_channel->SetDelay (m_rateTraceModel->GetDelay ());
+            }
+        }
+      lost = m_rateTraceModel->IsLost ();
+    }
+
   Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.As (Time::S));
   Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
 
+  if (lost)
+    {
+      NS_LOG_LOGIC ("Packet lost by the rate trace");
+      m_phyTxDropTrace (p);
+      return true;
+    }
+
   bool result = m_channel->TransmitStart (p, this, txTime);
   if (result == false)
     {
@@ -314,6 +349,28 @@ PointToPointNetDevice::Attach (Ptr<PointToPointChannel> ch)
   return true;
 }
 
+void
+PointToPointNetDevice::Reattach (Ptr<PointToPointChannel> ch)
+{
+  NS_LOG_FUNCTION (this << &ch);
+  NS_ASSERT (ch->GetDevice (0) == this || ch->GetDevice (1) == this);
+
+  m_channel = ch;
+  NotifyLinkUp ();
+}
+
+void
+PointToPointNetDevice::Detach (Ptr<PointToPointChannel> ch)
+{
+  NS_LOG_FUNCTION (this << &ch);
+
+  // the device may already have been moved to another channel
+  if (m_channel == ch)
+    {
+      NotifyLinkDown ();
+    }
+}
+
 void
 PointToPointNetDevice::SetQueue (Ptr<Queue<Packet> > q)
 {
@@ -393,6 +450,14 @@ PointToPointNetDevice::NotifyLinkUp (void)
   m_linkChangeCallbacks ();
 }
 
+void
+PointToPointNetDevice::NotifyLinkDown (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_linkUp = false;
+  m_linkChangeCallbacks ();
+}
+
 void
 PointToPointNetDevice::SetIfIndex (const uint32_t index)
 {
@@ -36,6 +36,7 @@ namespace ns3 {
 template <typename Item> class Queue;
 class PointToPointChannel;
 class ErrorModel;
+class LinkRateTraceModel;
 
 /**
  * \defgroup point-to-point Point-To-Point Network Device
@@ -110,6 +111,24 @@ public:
    */
   bool Attach (Ptr<PointToPointChannel> ch);
 
+  /**
+   * Move the device to a channel which already holds it, such as a
+   * ReconfigurablePointToPointChannel rebound to the device, without
+   * attaching it to the channel again.
+   *
+   * \param ch Ptr to the channel holding this device.
+   */
+  void Reattach (Ptr<PointToPointChannel> ch);
+
+  /**
+   * Take the link down when a ReconfigurablePointToPointChannel rebinds
+   * its far end to another device. The packets sent or still queued are
+   * dropped, until the device is reattached.
+   *
+   * \param ch Ptr to the channel which no longer holds this device.
+   */
+  void Detach (Ptr<PointToPointChannel> ch);
+
   /**
    * Attach a queue to the PointToPointNetDevice.
    *
@@ -282,6 +301,13 @@ private:
    */
   void NotifyLinkUp (void);
 
+  /**
+   * \brief Take the link down
+   *
+   * It calls also the linkChange callback.
+   */
+  void NotifyLinkDown (void);
+
   /**
    * Enumeration of the states of the transmit machine of the net device.
    */
@@ -326,6 +352,11 @@ private:
    */
   Ptr<ErrorModel> m_receiveErrorModel;
 
+  /**
+   * Trace driving the rate, delay and loss of the link, if any
+   */
+  Ptr<LinkRateTraceModel> m_rateTraceModel;
+
   /**
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "reconfigurable-point-to-point-channel.h"
+#include "point-to-point-net-device.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReconfigurablePointToPointChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (ReconfigurablePointToPointChannel);
+
+TypeId
+ReconfigurablePointToPointChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ReconfigurablePointToPointChannel")
+    .SetParent<PointToPointChannel> ()
+    .SetGroupName ("PointToPoint")
+    .AddConstructor<ReconfigurablePointToPointChannel> ()
+    .AddAttribute ("DelayRefresh",
+                   "Period of the computations of the delay by the delay callback, zero for each transmission.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&ReconfigurablePointToPointChannel::m_delayRefresh),
+                   MakeTimeChecker (Seconds (0)))
+  ;
+  return tid;
+}
+
+ReconfigurablePointToPointChannel::ReconfigurablePointToPointChannel ()
+  : PointToPointChannel (),
+    m_delayValid (false)
+{
+}
+
+ReconfigurablePointToPointChannel::~ReconfigurablePointToPointChannel ()
+{
+}
+
+void
+ReconfigurablePointToPointChannel::Rebind (Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  NS_ASSERT_MSG (device != GetSource (0), "The far end cannot be the near end");
+
+  if (device == GetSource (1))
+    {
+      return;
+    }
+  Ptr<PointToPointNetDevice> previous = GetSource (1);
+  ReplaceDevice (1, device);
+  device->Reattach (this);
+  previous->Detach (this);
+  m_delayValid = false;
+  m_lastArrival[0] = Seconds (0);
+  m_lastArrival[1] = Seconds (0);
+}
+
+void
+ReconfigurablePointToPointChannel::Rebind (Ptr<PointToPointNetDevice> device, Time delay)
+{
+  Rebind (device);
+  SetDelay (delay);
+}
+
+void
+ReconfigurablePointToPointChannel::SetDelayCallback (DelayCallback callback)
+{
+  m_delayCallback = callback;
+  m_delayValid = false;
+}
+
+bool
+ReconfigurablePointToPointChannel::IsDelayVariable (void) const
+{
+  return true;
+}
+
+bool
+ReconfigurablePointToPointChannel::TransmitStart (
+  Ptr<const Packet> p,
+  Ptr<PointToPointNetDevice> src,
+  Time txTime)
+{
+  if (src != GetSource (0) && src != GetSource (1))
+    {
+      NS_LOG_LOGIC ("Device " << src << " is no longer attached, dropping UID " << p->GetUid ());
+      return false;
+    }
+  if (m_delayCallback.IsNull ())
+    {
+      return PointToPointChannel::TransmitStart (p, src, txTime);
+    }
+
+  Time now = Simulator::Now ();
+  Time period = now;
+  if (m_delayRefresh.IsStrictlyPositive ())
+    {
+      period = TimeStep (now.GetTimeStep () - now.GetTimeStep () % m_delayRefresh.GetTimeStep ());
+    }
+  if (!m_delayValid || period != m_delayTime)
+    {
+      m_delayTime = period;
+      SetDelay (m_delayCallback (GetSource (0), GetSource (1), period));
+      m_delayValid = true;
+      NS_LOG_LOGIC ("Delay " << GetDelay () << " at " << period);
+    }
+
+  // a packet cannot overtake the previous one on the same wire
+  uint32_t wire = src == GetSource (0) ? 0 : 1;
+  Time computed = GetDelay ();
+  Time delay = computed;
+  if (now + txTime + delay < m_lastArrival[wire])
+    {
+      delay = m_lastArrival[wire] - now - txTime;
+    }
+  m_lastArrival[wire] = now + txTime + delay;
+  SetDelay (delay);
+  bool result = PointToPointChannel::TransmitStart (p, src, txTime);
+  SetDelay (computed);
+  return result;
+}
+
+} // namespace ns3
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This object connects two point-to-point net devices, the far end of the
+// channel being movable at run time to another device, e.g. to follow the
+// neighbor of a satellite.
+
+#ifndef RECONFIGURABLE_POINT_TO_POINT_CHANNEL_H
+#define RECONFIGURABLE_POINT_TO_POINT_CHANNEL_H
+
+#include "point-to-point-channel.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup point-to-point
+ *
+ * \brief A Point-To-Point Channel whose far end can be rebound
+ *
+ * The first device attached to the channel is its near end and stays
+ * attached. The second one is its far end, which Rebind replaces by
+ * another point-to-point device, usually of another node, without
+ * creating devices or interfaces: a node keeps one device per link and the
+ * channels move between the devices. The delay of the channel is changed in
+ * place with SetDelay.
+ *
+ * The delay can also follow the positions of the ends continuously: with a
+ * delay callback, the channel asks the delay between its two ends at the
+ * start of each transmission, for the start of the current DelayRefresh
+ * period, so the delay changes without stopping the simulation nor
+ * scheduling any event. As on a real link, the packets still arrive in the
+ * order they were sent when the delay decreases.
+ *
+ * The packets in flight when the channel is rebound are still received by
+ * the device they were sent to. A device which was the far end of the
+ * channel and was not rebound to another channel can no longer transmit on
+ * it: its packets are dropped.
+ */
+class ReconfigurablePointToPointChannel : public PointToPointChannel
+{
+public:
+  /**
+   * \brief Get the TypeId
+   *
+   * \return The TypeId for this class
+   */
+  static TypeId GetTypeId (void);
+
+  /** 
+   * \brief Constructor
+   */
+  ReconfigurablePointToPointChannel ();
+
+  /** 
+   * \brief Destructor
+   */
+  ~ReconfigurablePointToPointChannel ();
+
+  /**
+   * \brief Replace the far end of the channel
+   *
+   * The device is moved to this channel, the channel it was attached to
+   * before must itself be rebound to another device. The link of the
+   * previous far end goes down, unless it was already moved to another
+   * channel.
+   *
+   * \param device the new far end
+   */
+  void Rebind (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \brief Replace the far end of the channel and its delay
+   *
+   * \param device the new far end
+   * \param delay the propagation delay to the new far end
+   */
+  void Rebind (Ptr<PointToPointNetDevice> device, Time delay);
+
+  /**
+   * \brief Callback computing the delay between two devices at a time
+   *
+   * The arguments are the near end, the far end and the time.
+   */
+  typedef Callback<Time, Ptr<PointToPointNetDevice>, Ptr<PointToPointNetDevice>, Time> DelayCallback;
+
+  /**
+   * \brief Compute the delay at each transmission
+   *
+   * \param callback the delay between the two ends, or a null callback to
+   * keep the delay set by SetDelay
+   */
+  void SetDelayCallback (DelayCallback callback);
+
+  /**
+   * \brief Transmit the packet, if the source is an end of the channel
+   *
+   * \param p Packet to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTime Transmit time to apply
+   * \returns false if the source is no longer an end of the channel
+   */
+  virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src,
+                              Time txTime);
+
+  /**
+   * \returns true: the far end and the delay of the channel change
+   */
+  virtual bool IsDelayVariable (void) const;
+
+private:
+  DelayCallback m_delayCallback;  //!< delay between the ends, if set
+  Time m_delayRefresh;            //!< period of the delay computations
+  Time m_delayTime;               //!< time of the current delay
+  bool m_delayValid;              //!< whether the delay was computed for the current ends
+  Time m_lastArrival[2];          //!< end of the reception of the last packet on each wire
+};
+
+} // namespace ns3
+
+#endif /* RECONFIGURABLE_POINT_TO_POINT_CHANNEL_H */
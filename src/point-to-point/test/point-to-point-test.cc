@@ -23,9 +23,16 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/reconfigurable-point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/link-rate-trace-model.h"
+#include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
 
+#include <map>
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -126,10 +133,540 @@ PointToPointTest::DoRun (void)
   
   m_recvdPacket->CopyData (rxBuffer, txBufferSize);
   NS_TEST_EXPECT_MSG_EQ (memcmp (rxBuffer, txBuffer, txBufferSize), 0, "trivial");
+
+  BooleanValue variable;
+  channel->GetAttribute ("VariableDelay", variable);
+  NS_TEST_EXPECT_MSG_EQ (variable.Get (), false, "the Delay attribute made the delay variable");
+  channel->SetDelay (MilliSeconds (5));
+  channel->GetAttribute ("VariableDelay", variable);
+  NS_TEST_EXPECT_MSG_EQ (variable.Get (), true, "SetDelay did not make the delay variable");
   
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for the replay of a link rate trace
+ *
+ * Sends one packet in each of three trace samples: a slow link, a fast
+ * link with a shorter delay and an outage.
+ */
+class PointToPointRateTraceTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointRateTraceTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  std::vector<Time> m_rxTimes;  //!< reception times
+  uint32_t m_rateChanges;       //!< number of RateChanged events
+
+  /**
+   * \brief Send one packet to the device specified
+   *
+   * \param device NetDevice to send to.
+   * \param size Size of the payload.
+   */
+  void SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size);
+  /**
+   * \brief Callback function which records the reception time
+   *
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol mode used.
+   * \param sender The sender address.
+   *
+   * \return A boolean indicating packet handled properly.
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+  /**
+   * \brief Callback function which counts the rate changes
+   *
+   * \param oldRate The previous rate.
+   * \param newRate The new rate.
+   */
+  void RateChanged (DataRate oldRate, DataRate newRate);
+};
+
+PointToPointRateTraceTest::PointToPointRateTraceTest ()
+  : TestCase ("PointToPoint rate trace replay"),
+    m_rateChanges (0)
+{
+}
+
+void
+PointToPointRateTraceTest::SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointRateTraceTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointRateTraceTest::RateChanged (DataRate oldRate, DataRate newRate)
+{
+  m_rateChanges++;
+}
+
+void
+PointToPointRateTraceTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("p2p-rate-trace.lrt");
+  std::vector<LinkRateTraceModel::Sample> samples;
+  samples.push_back ({0.0, 1e6, 0.010, 0.0});
+  samples.push_back ({2.0, 8e6, 0.002, 0.0});
+  samples.push_back ({4.0, 0.0, -1.0, 0.0});
+  LinkRateTraceModel::WriteTraceFile (filename, samples);
+
+  Ptr<LinkRateTraceModel> trace = CreateObject<LinkRateTraceModel> ();
+  trace->SetTraceFile (filename);
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNSamples (), 3, "wrong number of samples mapped");
+  trace->TraceConnectWithoutContext ("RateChanged",
+                                     MakeCallback (&PointToPointRateTraceTest::RateChanged, this));
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devA->SetAttribute ("RateTraceModel", PointerValue (trace));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&PointToPointRateTraceTest::RxPacket, this));
+
+  // 998 bytes of payload and the 2 bytes PPP header
+  Simulator::Schedule (Seconds (1.0), &PointToPointRateTraceTest::SendOnePacket, this, devA, 998);
+  Simulator::Schedule (Seconds (3.0), &PointToPointRateTraceTest::SendOnePacket, this, devA, 998);
+  Simulator::Schedule (Seconds (5.0), &PointToPointRateTraceTest::SendOnePacket, this, devA, 998);
+  NS_TEST_EXPECT_MSG_EQ (channel->IsDelayVariable (), true, "the delay of a replayed trace is not variable");
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 2, "the packet sent during the outage was received");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[0], Seconds (1.0) + MilliSeconds (8) + MilliSeconds (10),
+                         "first sample not applied");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[1], Seconds (3.0) + MilliSeconds (1) + MilliSeconds (2),
+                         "second sample not applied");
+  NS_TEST_EXPECT_MSG_EQ (m_rateChanges, 3, "wrong number of rate changes");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for the looped replay of a link rate trace
+ *
+ * Two samples one second apart: the period of the replay is two seconds,
+ * the last sample is applied in each period and the replay wraps around
+ * to the first one.
+ */
+class PointToPointRateTraceLoopTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointRateTraceLoopTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  std::vector<Time> m_rxTimes;  //!< reception times
+
+  /**
+   * \brief Send one packet to the device specified
+   *
+   * \param device NetDevice to send to.
+   * \param size Size of the payload.
+   */
+  void SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size);
+  /**
+   * \brief Callback function which records the reception time
+   *
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol mode used.
+   * \param sender The sender address.
+   *
+   * \return A boolean indicating packet handled properly.
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+};
+
+PointToPointRateTraceLoopTest::PointToPointRateTraceLoopTest ()
+  : TestCase ("PointToPoint rate trace looped replay")
+{
+}
+
+void
+PointToPointRateTraceLoopTest::SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointRateTraceLoopTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointRateTraceLoopTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("p2p-rate-trace-loop.lrt");
+  std::vector<LinkRateTraceModel::Sample> samples;
+  samples.push_back ({0.0, 1e6, 0.010, 0.0});
+  samples.push_back ({1.0, 8e6, 0.002, 0.0});
+  LinkRateTraceModel::WriteTraceFile (filename, samples);
+
+  Ptr<LinkRateTraceModel> trace = CreateObject<LinkRateTraceModel> ();
+  trace->SetTraceFile (filename);
+  trace->SetAttribute ("Loop", BooleanValue (true));
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devA->SetAttribute ("RateTraceModel", PointerValue (trace));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&PointToPointRateTraceLoopTest::RxPacket, this));
+
+  // 998 bytes of payload and the 2 bytes PPP header
+  Simulator::Schedule (Seconds (1.5), &PointToPointRateTraceLoopTest::SendOnePacket, this, devA, 998);
+  Simulator::Schedule (Seconds (2.5), &PointToPointRateTraceLoopTest::SendOnePacket, this, devA, 998);
+  Simulator::Schedule (Seconds (3.5), &PointToPointRateTraceLoopTest::SendOnePacket, this, devA, 998);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 3, "a packet was lost");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[0], Seconds (1.5) + MilliSeconds (1) + MilliSeconds (2),
+                         "last sample not applied");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[1], Seconds (2.5) + MilliSeconds (8) + MilliSeconds (10),
+                         "replay did not wrap around to the first sample");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[2], Seconds (3.5) + MilliSeconds (1) + MilliSeconds (2),
+                         "last sample not applied after the wrap around");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for the delays computed at transmit time
+ *
+ * The delay drops from 10 ms to 2 ms at 1 s: the packet sent just after
+ * cannot overtake the packet sent just before, and the delay is computed
+ * once per refresh period.
+ */
+class PointToPointDelayCallbackTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointDelayCallbackTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  std::vector<Time> m_rxTimes;     //!< reception times
+  std::vector<Time> m_delayTimes;  //!< times of the delay computations
+
+  /**
+   * \brief Send one packet to the device specified
+   *
+   * \param device NetDevice to send to.
+   */
+  void SendOnePacket (Ptr<PointToPointNetDevice> device);
+  /**
+   * \brief Callback function which records the reception time
+   *
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol mode used.
+   * \param sender The sender address.
+   *
+   * \return A boolean indicating packet handled properly.
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+  /**
+   * \brief Delay of the channel
+   *
+   * \param a The near end.
+   * \param b The far end.
+   * \param t The time of the delay.
+   *
+   * \return The delay at the time.
+   */
+  Time GetDelay (Ptr<PointToPointNetDevice> a, Ptr<PointToPointNetDevice> b, Time t);
+};
+
+PointToPointDelayCallbackTest::PointToPointDelayCallbackTest ()
+  : TestCase ("PointToPoint delays computed at transmit time")
+{
+}
+
+void
+PointToPointDelayCallbackTest::SendOnePacket (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<Packet> p = Create<Packet> (998);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointDelayCallbackTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+Time
+PointToPointDelayCallbackTest::GetDelay (Ptr<PointToPointNetDevice> a, Ptr<PointToPointNetDevice> b, Time t)
+{
+  m_delayTimes.push_back (t);
+  return t < Seconds (1) ? MilliSeconds (10) : MilliSeconds (2);
+}
+
+void
+PointToPointDelayCallbackTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<ReconfigurablePointToPointChannel> channel = CreateObject<ReconfigurablePointToPointChannel> ();
+  channel->SetAttribute ("DelayRefresh", TimeValue (Seconds (1)));
+  channel->SetDelayCallback (MakeCallback (&PointToPointDelayCallbackTest::GetDelay, this));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&PointToPointDelayCallbackTest::RxPacket, this));
+
+  // 1 ms of transmission, the second packet starts at 1 s
+  Simulator::Schedule (MilliSeconds (999), &PointToPointDelayCallbackTest::SendOnePacket, this, devA);
+  Simulator::Schedule (MilliSeconds (999), &PointToPointDelayCallbackTest::SendOnePacket, this, devA);
+  Simulator::Schedule (MilliSeconds (2500), &PointToPointDelayCallbackTest::SendOnePacket, this, devA);
+  Simulator::Schedule (MilliSeconds (2600), &PointToPointDelayCallbackTest::SendOnePacket, this, devA);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 4, "wrong number of packets received");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[0], MilliSeconds (1010), "first packet");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[1], MilliSeconds (1010), "second packet overtook the first one");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[2], MilliSeconds (2503), "delay not updated");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[3], MilliSeconds (2603), "delay not updated");
+  NS_TEST_ASSERT_MSG_EQ (m_delayTimes.size (), 3, "delay not computed once per period");
+  NS_TEST_EXPECT_MSG_EQ (m_delayTimes[2], Seconds (2), "delay not computed for the start of the period");
+  NS_TEST_EXPECT_MSG_EQ (channel->IsDelayVariable (), true, "the delay of a reconfigurable channel is not variable");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for the rebinding of a reconfigurable channel
+ *
+ * The far end C of the channel has packets queued when the channel is
+ * rebound to B: the packets whose transmission started still reach A, the
+ * others are dropped and the link of C goes down. B and A then exchange
+ * packets over the channel.
+ */
+class PointToPointRebindTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointRebindTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  std::map<Ptr<NetDevice>, std::vector<Time> > m_rxTimes;  //!< reception times, by receiving device
+  uint32_t m_drops;         //!< packets dropped at transmit by C
+  uint32_t m_linkChanges;   //!< link changes of C
+  bool m_sentDown;          //!< true if C accepted a packet with its link down
+
+  /**
+   * \brief Send one packet to the device specified
+   *
+   * \param device NetDevice to send to.
+   */
+  void SendOnePacket (Ptr<PointToPointNetDevice> device);
+  /**
+   * \brief Send one packet to a device whose link is down
+   *
+   * \param device NetDevice to send to.
+   */
+  void SendDown (Ptr<PointToPointNetDevice> device);
+  /**
+   * \brief Callback function which records the reception time
+   *
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol mode used.
+   * \param sender The sender address.
+   *
+   * \return A boolean indicating packet handled properly.
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+  /**
+   * \brief Count the packets dropped at transmit
+   *
+   * \param pkt The packet dropped.
+   */
+  void PhyTxDrop (Ptr<const Packet> pkt);
+  /**
+   * \brief Count the link changes
+   */
+  void LinkChange (void);
+};
+
+PointToPointRebindTest::PointToPointRebindTest ()
+  : TestCase ("PointToPoint channel rebound to another device"),
+    m_drops (0),
+    m_linkChanges (0),
+    m_sentDown (false)
+{
+}
+
+void
+PointToPointRebindTest::SendOnePacket (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<Packet> p = Create<Packet> (998);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+void
+PointToPointRebindTest::SendDown (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<Packet> p = Create<Packet> (998);
+  m_sentDown = device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointRebindTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_rxTimes[dev].push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointRebindTest::PhyTxDrop (Ptr<const Packet> pkt)
+{
+  m_drops++;
+}
+
+void
+PointToPointRebindTest::LinkChange (void)
+{
+  m_linkChanges++;
+}
+
+void
+PointToPointRebindTest::DoRun (void)
+{
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devC = CreateObject<PointToPointNetDevice> ();
+  Ptr<ReconfigurablePointToPointChannel> channel = CreateObject<ReconfigurablePointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (10)));
+
+  Ptr<PointToPointNetDevice> devices[3] = { devA, devB, devC };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      devices[i]->SetAddress (Mac48Address::Allocate ());
+      devices[i]->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+      devices[i]->SetDataRate (DataRate ("8Mbps"));
+      node->AddDevice (devices[i]);
+      devices[i]->SetReceiveCallback (MakeCallback (&PointToPointRebindTest::RxPacket, this));
+    }
+  devA->Attach (channel);
+  devC->Attach (channel);
+  devC->AddLinkChangeCallback (MakeCallback (&PointToPointRebindTest::LinkChange, this));
+  devC->TraceConnectWithoutContext ("PhyTxDrop", MakeCallback (&PointToPointRebindTest::PhyTxDrop, this));
+
+  // 1 ms of transmission per packet: the first two have started when the
+  // channel is rebound at 1.5 ms, the last three are still queued
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::Schedule (Seconds (0), &PointToPointRebindTest::SendOnePacket, this, devC);
+    }
+  void (ReconfigurablePointToPointChannel::*rebind) (Ptr<PointToPointNetDevice>) = &ReconfigurablePointToPointChannel::Rebind;
+  Simulator::Schedule (MicroSeconds (1500), rebind, channel, devB);
+  Simulator::Schedule (MilliSeconds (20), &PointToPointRebindTest::SendDown, this, devC);
+  Simulator::Schedule (MilliSeconds (20), &PointToPointRebindTest::SendOnePacket, this, devA);
+  Simulator::Schedule (MilliSeconds (40), &PointToPointRebindTest::SendOnePacket, this, devB);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[devA].size (), 3, "wrong number of packets received by A");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[devA][0], MilliSeconds (11), "first packet of C");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[devA][1], MilliSeconds (12), "second packet of C");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[devA][2], MilliSeconds (51), "packet of B");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, 3, "packets queued in C not dropped");
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[devB].size (), 1, "B did not receive from A");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[devB][0], MilliSeconds (31), "packet of A");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[devC].size (), 0, "C received after the rebind");
+
+  NS_TEST_EXPECT_MSG_EQ (devC->IsLinkUp (), false, "link of C still up");
+  NS_TEST_EXPECT_MSG_EQ (m_linkChanges, 1, "link change of C not notified");
+  NS_TEST_EXPECT_MSG_EQ (m_sentDown, false, "C sent with its link down");
+  NS_TEST_EXPECT_MSG_EQ (devB->IsLinkUp (), true, "link of B not up");
+  NS_TEST_EXPECT_MSG_EQ (channel->GetDevice (1), devB, "far end not replaced");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -146,6 +683,10 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointRateTraceTest, TestCase::QUICK);
+  AddTestCase (new PointToPointRateTraceLoopTest, TestCase::QUICK);
+  AddTestCase (new PointToPointDelayCallbackTest, TestCase::QUICK);
+  AddTestCase (new PointToPointRebindTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -0,0 +1,417 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <algorithm>
+#include <cmath>
+#include "mp-quic-fluid-model.h"
+#include "quic-socket-base.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/data-rate.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpQuicFluidModel");
+
+NS_OBJECT_ENSURE_REGISTERED (MpQuicFluidModel);
+
+TypeId
+MpQuicFluidModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpQuicFluidModel")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpQuicFluidModel> ()
+    .AddAttribute ("SteadyStateSamples",
+                   "ACKs per steady-state detection epoch",
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&MpQuicFluidModel::m_steadyStateSamples),
+                   MakeUintegerChecker<uint32_t> (2))
+    .AddAttribute ("Tolerance",
+                   "Relative difference of mean cwnd and RTT allowed between two steady epochs",
+                   DoubleValue (0.2),
+                   MakeDoubleAccessor (&MpQuicFluidModel::m_tolerance),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("Rounds",
+                   "RTTs of the slowest path advanced by a fluid window before "
+                   "going back to packet level",
+                   UintegerValue (20),
+                   MakeUintegerAccessor (&MpQuicFluidModel::m_maxRounds),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("FastForward",
+                     "A fluid window ended and the transfer is back at packet level",
+                     MakeTraceSourceAccessor (&MpQuicFluidModel::m_fastForwardTrace),
+                     "ns3::MpQuicFluidModel::FastForwardTracedCallback")
+  ;
+  return tid;
+}
+
+MpQuicFluidModel::PathInfo::PathInfo ()
+  : m_samples (0),
+    m_sumCwnd (0),
+    m_sumRtt (0),
+    m_losses (0),
+    m_ackedBytes (0),
+    m_epochStart (Time (0)),
+    m_minCwnd (0),
+    m_maxCwnd (0),
+    m_prevValid (false),
+    m_prevCwnd (0),
+    m_prevRtt (0),
+    m_prevLosses (0),
+    m_prevGoodput (0),
+    m_goodput (0),
+    m_growing (false),
+    m_steady (false),
+    m_lossFree (false),
+    m_cwnd (0),
+    m_entryCwnd (0),
+    m_ssThresh (0),
+    m_rtt (Time (0)),
+    m_done (false)
+{
+}
+
+MpQuicFluidModel::MpQuicFluidModel ()
+  : Object (),
+    m_socket (0),
+    m_active (false),
+    m_windowBytes (0),
+    m_totalBytes (0),
+    m_totalTime (Time (0))
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpQuicFluidModel::~MpQuicFluidModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MpQuicFluidModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (auto it = m_paths.begin (); it != m_paths.end (); ++it)
+    {
+      it->m_roundEvent.Cancel ();
+    }
+  m_windowEvent.Cancel ();
+  m_socket = 0;
+  Object::DoDispose ();
+}
+
+void
+MpQuicFluidModel::SetSocket (Ptr<QuicSocketBase> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  m_socket = socket;
+  ResetDetector ();
+}
+
+void
+MpQuicFluidModel::AddPath (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  if (pathId >= m_paths.size ())
+    {
+      m_paths.resize (pathId + 1);
+    }
+}
+
+void
+MpQuicFluidModel::NotifyAck (uint8_t pathId, uint32_t cwnd, uint32_t ssThresh, Time rtt, uint32_t ackedBytes)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << cwnd << ssThresh << rtt << ackedBytes);
+  if (m_active || rtt.IsZero ())
+    {
+      // late ACKs of the packets sent before the fluid window
+      return;
+    }
+  if (pathId >= m_paths.size ())
+    {
+      AddPath (pathId);
+    }
+  if (LinkRatesChanged ())
+    {
+      NS_LOG_INFO ("Link rates changed, restart steady-state detection");
+      ResetDetector ();
+    }
+
+  PathInfo &path = m_paths[pathId];
+  if (path.m_samples == 0)
+    {
+      // the epoch measures the ACKs after its first one
+      path.m_epochStart = Simulator::Now ();
+      path.m_ackedBytes = 0;
+      path.m_minCwnd = cwnd;
+      path.m_maxCwnd = cwnd;
+    }
+  else
+    {
+      path.m_ackedBytes += ackedBytes;
+    }
+  path.m_ssThresh = ssThresh;
+  path.m_minCwnd = std::min (path.m_minCwnd, cwnd);
+  path.m_maxCwnd = std::max (path.m_maxCwnd, cwnd);
+  path.m_sumCwnd += cwnd;
+  path.m_sumRtt += rtt.GetSeconds ();
+  if (++path.m_samples < m_steadyStateSamples)
+    {
+      return;
+    }
+
+  // close the epoch and compare it with the previous one
+  double meanCwnd = path.m_sumCwnd / path.m_samples;
+  double meanRtt = path.m_sumRtt / path.m_samples;
+  Time epoch = Simulator::Now () - path.m_epochStart;
+  double goodput = epoch.IsStrictlyPositive () ? path.m_ackedBytes / epoch.GetSeconds () : 0;
+  if (path.m_prevValid)
+    {
+      path.m_steady = std::abs (meanCwnd - path.m_prevCwnd) <= m_tolerance * std::max (meanCwnd, path.m_prevCwnd)
+        && std::abs (meanRtt - path.m_prevRtt) <= m_tolerance * std::max (meanRtt, path.m_prevRtt)
+        && std::max (path.m_losses, path.m_prevLosses) - std::min (path.m_losses, path.m_prevLosses) <= 1;
+      path.m_lossFree = path.m_losses == 0 && path.m_prevLosses == 0;
+      // one epoch is a few RTTs: a single one overestimates the goodput as
+      // often as it underestimates it
+      path.m_goodput = (goodput + path.m_prevGoodput) / 2;
+    }
+  path.m_growing = path.m_maxCwnd > path.m_minCwnd;
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " epoch: cwnd " << meanCwnd << " rtt " << meanRtt
+                       << " goodput " << goodput << " losses " << path.m_losses << (path.m_steady ? " steady" : ""));
+  path.m_prevValid = true;
+  path.m_prevCwnd = meanCwnd;
+  path.m_prevRtt = meanRtt;
+  path.m_prevLosses = path.m_losses;
+  path.m_prevGoodput = goodput;
+  path.m_samples = 0;
+  path.m_sumCwnd = 0;
+  path.m_sumRtt = 0;
+  path.m_losses = 0;
+
+  if (path.m_steady)
+    {
+      MaybeStart ();
+    }
+}
+
+void
+MpQuicFluidModel::NotifyLoss (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  if (pathId >= m_paths.size ())
+    {
+      AddPath (pathId);
+    }
+  if (!m_active)
+    {
+      m_paths[pathId].m_losses++;
+    }
+  else if (m_paths[pathId].m_lossFree)
+    {
+      // losses are not part of the regime being fast-forwarded
+      Resync ("loss");
+    }
+}
+
+bool
+MpQuicFluidModel::IsActive (void) const
+{
+  return m_active;
+}
+
+uint32_t
+MpQuicFluidModel::GetCwnd (uint8_t pathId) const
+{
+  NS_ASSERT (pathId < m_paths.size ());
+  return (uint32_t) m_paths[pathId].m_cwnd;
+}
+
+uint64_t
+MpQuicFluidModel::GetFluidBytes (void) const
+{
+  return m_totalBytes;
+}
+
+Time
+MpQuicFluidModel::GetFluidTime (void) const
+{
+  return m_totalTime;
+}
+
+void
+MpQuicFluidModel::MaybeStart (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time maxRtt = Time (0);
+  for (uint8_t i = 0; i < m_paths.size (); i++)
+    {
+      if (!m_socket->IsPathUsable (i))
+        {
+          continue;
+        }
+      if (!m_paths[i].m_steady)
+        {
+          return;
+        }
+      maxRtt = std::max (maxRtt, Seconds (m_paths[i].m_prevRtt));
+    }
+  if (maxRtt.IsZero ())
+    {
+      return;
+    }
+
+  m_active = true;
+  m_start = Simulator::Now ();
+  m_end = m_start + maxRtt * m_maxRounds;
+  m_windowBytes = 0;
+  NS_LOG_INFO ("Steady state reached, fluid mode until " << m_end.GetSeconds () << " s");
+
+  for (uint8_t i = 0; i < m_paths.size (); i++)
+    {
+      PathInfo &path = m_paths[i];
+      path.m_done = !m_socket->IsPathUsable (i);
+      if (path.m_done)
+        {
+          continue;
+        }
+      path.m_cwnd = path.m_prevCwnd;
+      path.m_entryCwnd = path.m_cwnd;
+      path.m_rtt = Seconds (path.m_prevRtt);
+      path.m_roundEvent = Simulator::ScheduleNow (&MpQuicFluidModel::Round, this, i);
+    }
+  m_windowEvent = Simulator::Schedule (m_end - m_start, &MpQuicFluidModel::Resync,
+                                       this, "window complete");
+}
+
+void
+MpQuicFluidModel::Round (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  if (LinkRatesChanged ())
+    {
+      Resync ("link rate changed");
+      return;
+    }
+
+  PathInfo &path = m_paths[pathId];
+  double rate = GetLinkRate (pathId);
+  double bdp = rate * path.m_rtt.GetSeconds () / 8;
+  double budget = rate > 0 ? std::min (path.m_cwnd, bdp) : path.m_cwnd;
+  if (path.m_goodput > 0)
+    {
+      // the path holds its regime: the window also carries the
+      // retransmissions, the recovery stalls and the scheduler gaps, the
+      // measured goodput does not
+      budget = std::min (budget, path.m_goodput * path.m_rtt.GetSeconds ());
+    }
+
+  uint32_t sent = m_socket->FastForwardData (pathId, (uint32_t) budget, path.m_rtt / 2);
+  m_windowBytes += sent;
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " cwnd " << path.m_cwnd
+                       << " advanced by " << sent << " bytes");
+
+  if (sent == 0)
+    {
+      path.m_done = true;
+      for (auto it = m_paths.begin (); it != m_paths.end (); ++it)
+        {
+          if (!it->m_done)
+            {
+              return;
+            }
+        }
+      Resync ("no data left");
+      return;
+    }
+
+  if (path.m_lossFree && path.m_growing)
+    {
+      // no-loss branch of TotalData: exponential growth up to ssthresh, then
+      // one segment per round, never beyond what the link can carry
+      if (path.m_cwnd < path.m_ssThresh)
+        {
+          path.m_cwnd = std::min (2 * path.m_cwnd, (double) path.m_ssThresh);
+        }
+      else
+        {
+          path.m_cwnd += m_socket->GetSegSize ();
+        }
+      double cap = rate > 0 ? std::max (path.m_entryCwnd, bdp) : path.m_entryCwnd;
+      path.m_cwnd = std::min (path.m_cwnd, cap);
+    }
+
+  if (Simulator::Now () + path.m_rtt < m_end)
+    {
+      path.m_roundEvent = Simulator::Schedule (path.m_rtt, &MpQuicFluidModel::Round,
+                                               this, pathId);
+    }
+}
+
+void
+MpQuicFluidModel::Resync (const char *reason)
+{
+  NS_LOG_FUNCTION (this << reason);
+  if (!m_active)
+    {
+      return;
+    }
+  for (auto it = m_paths.begin (); it != m_paths.end (); ++it)
+    {
+      it->m_roundEvent.Cancel ();
+    }
+  m_windowEvent.Cancel ();
+  m_active = false;
+
+  Time duration = Simulator::Now () - m_start;
+  m_totalBytes += m_windowBytes;
+  m_totalTime += duration;
+  NS_LOG_INFO ("Back to packet level (" << reason << ") after " << duration.GetSeconds ()
+                                        << " s and " << m_windowBytes << " bytes");
+  m_fastForwardTrace (m_start, duration, m_windowBytes);
+
+  ResetDetector ();
+  m_socket->ResumePacketLevel ();
+}
+
+void
+MpQuicFluidModel::ResetDetector (void)
+{
+  for (auto it = m_paths.begin (); it != m_paths.end (); ++it)
+    {
+      it->m_samples = 0;
+      it->m_sumCwnd = 0;
+      it->m_sumRtt = 0;
+      it->m_losses = 0;
+      it->m_prevValid = false;
+      it->m_steady = false;
+      it->m_lossFree = false;
+    }
+  m_linkRates.clear ();
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      m_linkRates.push_back (GetLinkRate (i));
+    }
+}
+
+double
+MpQuicFluidModel::GetLinkRate (uint8_t pathId) const
+{
+  return m_socket->GetLinkRate (pathId).GetBitRate ();
+}
+
+bool
+MpQuicFluidModel::LinkRatesChanged (void) const
+{
+  for (uint8_t i = 0; i < m_linkRates.size (); i++)
+    {
+      if (m_linkRates[i] != GetLinkRate (i))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef MP_QUIC_FLUID_MODEL_H
+#define MP_QUIC_FLUID_MODEL_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class QuicSocketBase;
+
+/**
+ * \ingroup quic
+ * \brief Fluid fast-forward of the steady phases of an MP-QUIC bulk transfer
+ *
+ * The fluid model watches the ACKs received by the sender, in epochs of
+ * SteadyStateSamples ACKs per path. A path is steady when the mean congestion
+ * window and the mean RTT of its last two epochs are within Tolerance of each
+ * other and their loss counts differ by at most one. Once every usable path
+ * is steady, and as long as the link rates of the socket (its LinkRate0 and
+ * LinkRate1 attributes) are not changed, the transfer leaves packet level and
+ * is advanced one RTT round at a time:
+ *
+ *  - each round the socket pulls min(cwnd, bw * RTT, goodput * RTT) bytes of
+ *    stream data scheduled for the path out of its tx buffer, without sending
+ *    packets, and hands them to the peer socket after half an RTT, where
+ *    goodput is the rate of the bytes acknowledged in the last two epochs;
+ *  - on a loss-free path whose window moved in the last epoch, the window
+ *    evolves as in the no-loss branch of QuicSocketBase::TotalData: it
+ *    doubles below ssthresh, grows by one segment per round above it, and is
+ *    capped at the bandwidth-delay product (or at its entry value when the
+ *    link rate is unknown);
+ *  - a loss-free path whose window did not move is held back by the packet
+ *    scheduler or the application, not by its window: the window stays
+ *    where it is, as it would at packet level;
+ *  - on a lossy path the congestion controller is in its sawtooth regime and
+ *    the window stays at its mean over the last epoch.
+ *
+ * The transfer goes back to packet level, with the windows of the model, after
+ * Rounds RTTs of the slowest path, as soon as a link rate changes or a loss
+ * hits a loss-free path, or when no path has data left to send.
+ */
+class MpQuicFluidModel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief TracedCallback signature for fluid windows
+   *
+   * \param [in] start time at which the transfer left packet level
+   * \param [in] duration simulated time advanced by the fluid model
+   * \param [in] bytes stream bytes delivered by the fluid model
+   */
+  typedef void (* FastForwardTracedCallback)(Time start, Time duration, uint64_t bytes);
+
+  MpQuicFluidModel ();
+  virtual ~MpQuicFluidModel ();
+
+  /**
+   * \brief Set the sending socket
+   *
+   * \param socket the MP-QUIC socket
+   */
+  void SetSocket (Ptr<QuicSocketBase> socket);
+
+  /**
+   * \brief Register a path of the connection
+   *
+   * \param pathId the path identifier
+   */
+  void AddPath (uint8_t pathId);
+
+  /**
+   * \brief Feed the steady-state detector with a new ACK
+   *
+   * May switch the transfer to fluid mode.
+   *
+   * \param pathId the path the ACK refers to
+   * \param cwnd the congestion window of the path, in bytes
+   * \param ssThresh the slow start threshold of the path, in bytes
+   * \param rtt the last RTT sample of the path
+   * \param ackedBytes the bytes newly acknowledged by the ACK
+   */
+  void NotifyAck (uint8_t pathId, uint32_t cwnd, uint32_t ssThresh, Time rtt, uint32_t ackedBytes);
+
+  /**
+   * \brief Notify a loss on a path
+   *
+   * Resets the steady-state detector and, in fluid mode, resynchronizes to
+   * packet level.
+   *
+   * \param pathId the path identifier
+   */
+  void NotifyLoss (uint8_t pathId);
+
+  /**
+   * \return true while the transfer is advanced by the fluid model
+   */
+  bool IsActive (void) const;
+
+  /**
+   * \param pathId the path identifier
+   * \return the congestion window of the model for the path, in bytes
+   */
+  uint32_t GetCwnd (uint8_t pathId) const;
+
+  /**
+   * \return the total number of bytes delivered by the fluid model
+   */
+  uint64_t GetFluidBytes (void) const;
+
+  /**
+   * \return the total simulated time advanced by the fluid model
+   */
+  Time GetFluidTime (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Per-path detector and fluid state
+  struct PathInfo
+  {
+    PathInfo ();
+
+    uint32_t m_samples;       //!< ACKs in the current epoch
+    double m_sumCwnd;         //!< Sum of the windows of the current epoch
+    double m_sumRtt;          //!< Sum of the RTTs of the current epoch, in seconds
+    uint32_t m_losses;        //!< Losses in the current epoch
+    uint64_t m_ackedBytes;    //!< Bytes acknowledged in the current epoch
+    Time m_epochStart;        //!< Start of the current epoch
+    uint32_t m_minCwnd;       //!< Smallest window of the current epoch, in bytes
+    uint32_t m_maxCwnd;       //!< Largest window of the current epoch, in bytes
+
+    bool m_prevValid;         //!< True once an epoch has been completed
+    double m_prevCwnd;        //!< Mean window of the last epoch, in bytes
+    double m_prevRtt;         //!< Mean RTT of the last epoch, in seconds
+    uint32_t m_prevLosses;    //!< Losses in the last epoch
+    double m_prevGoodput;     //!< Bytes acknowledged per second in the last epoch
+    double m_goodput;         //!< Bytes acknowledged per second in the last two epochs
+    bool m_growing;           //!< True if the window moved in the last epoch
+    bool m_steady;            //!< True if the last two epochs matched
+    bool m_lossFree;          //!< True if the last two epochs had no loss
+
+    double m_cwnd;            //!< Window of the model, in bytes
+    double m_entryCwnd;       //!< Window when fluid mode started, in bytes
+    uint32_t m_ssThresh;      //!< Slow start threshold, in bytes
+    Time m_rtt;               //!< Round duration
+    bool m_done;              //!< True once the path ran out of data
+    EventId m_roundEvent;     //!< Next round
+  };
+
+  /**
+   * \brief Switch to fluid mode if every usable path is steady
+   */
+  void MaybeStart (void);
+
+  /**
+   * \brief Advance a path by one RTT round
+   *
+   * \param pathId the path identifier
+   */
+  void Round (uint8_t pathId);
+
+  /**
+   * \brief Leave fluid mode and hand the transfer back to the socket
+   *
+   * \param reason why, for logging
+   */
+  void Resync (const char *reason);
+
+  /**
+   * \brief Reset the steady-state detector of all paths
+   */
+  void ResetDetector (void);
+
+  /**
+   * \param pathId the path identifier
+   * \return the configured link rate of the path in bit/s, 0 if unknown
+   */
+  double GetLinkRate (uint8_t pathId) const;
+
+  /**
+   * \return true if the link rates changed since the last snapshot
+   */
+  bool LinkRatesChanged (void) const;
+
+  Ptr<QuicSocketBase> m_socket;       //!< The sending socket
+  std::vector<PathInfo> m_paths;      //!< Per-path state, indexed by path identifier
+  std::vector<double> m_linkRates;    //!< Link rates when the detector was last reset
+
+  bool m_active;                      //!< True in fluid mode
+  Time m_start;                       //!< Start of the current fluid window
+  Time m_end;                         //!< End of the current fluid window
+  EventId m_windowEvent;              //!< Resync at the end of the fluid window
+  uint64_t m_windowBytes;             //!< Bytes delivered in the current fluid window
+  uint64_t m_totalBytes;              //!< Bytes delivered in fluid mode
+  Time m_totalTime;                   //!< Time spent in fluid mode
+
+  uint32_t m_steadyStateSamples;      //!< Samples needed to declare a path steady
+  double m_tolerance;                 //!< Relative spread allowed among the samples
+  uint32_t m_maxRounds;               //!< Rounds per fluid window
+
+  TracedCallback<Time, Time, uint64_t> m_fastForwardTrace;  //!< Fluid windows
+};
+
+} // namespace ns3
+
+#endif /* MP_QUIC_FLUID_MODEL_H */
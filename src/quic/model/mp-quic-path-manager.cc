@@ -0,0 +1,326 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "mp-quic-path-manager.h"
+#include "quic-socket-base.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpQuicPathManager");
+
+NS_OBJECT_ENSURE_REGISTERED (MpQuicPathManager);
+
+const char* const
+MpQuicPathManager::PathStateName[MpQuicPathManager::PATH_FAILED + 1] = {
+  "PATH_ACTIVE", "PATH_PROBING", "PATH_FAILED"
+};
+
+TypeId
+MpQuicPathManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpQuicPathManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpQuicPathManager> ()
+    .AddAttribute ("ProbeInterval",
+                   "Idle time after which a keepalive PING is sent on a path",
+                   TimeValue (MilliSeconds (500)),
+                   MakeTimeAccessor (&MpQuicPathManager::m_probeInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxProbes",
+                   "Number of unanswered keepalive PINGs before a path is failed",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&MpQuicPathManager::m_maxProbes),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxPtoCount",
+                   "Number of consecutive probe timeouts (TLP or RTO) with data "
+                   "in flight before a path is failed",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&MpQuicPathManager::m_maxPtoCount),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("HandoverLead",
+                   "Time before an announced handover during which the "
+                   "schedulers prefer the other paths",
+                   TimeValue (MilliSeconds (25)),
+                   MakeTimeAccessor (&MpQuicPathManager::m_handoverLead),
+                   MakeTimeChecker ())
+    .AddTraceSource ("PathState",
+                     "Liveness state of a path changed",
+                     MakeTraceSourceAccessor (&MpQuicPathManager::m_pathStateTrace),
+                     "ns3::MpQuicPathManager::PathStateTracedCallback")
+    .AddTraceSource ("PathFailure",
+                     "A path was failed and its in-flight data reinjected",
+                     MakeTraceSourceAccessor (&MpQuicPathManager::m_pathFailureTrace),
+                     "ns3::MpQuicPathManager::PathFailureTracedCallback")
+    .AddTraceSource ("Handover",
+                     "An announced handover of a path took place",
+                     MakeTraceSourceAccessor (&MpQuicPathManager::m_handoverTrace),
+                     "ns3::MpQuicPathManager::HandoverTracedCallback")
+  ;
+  return tid;
+}
+
+MpQuicPathManager::PathInfo::PathInfo ()
+  : m_state (PATH_ACTIVE),
+    m_lastActivity (Simulator::Now ()),
+    m_ptoCount (0),
+    m_probesSent (0),
+    m_handover (Time::Max ())
+{
+}
+
+MpQuicPathManager::MpQuicPathManager ()
+  : Object (),
+    m_socket (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpQuicPathManager::~MpQuicPathManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MpQuicPathManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_keepaliveEvent.Cancel ();
+  for (auto it = m_paths.begin (); it != m_paths.end (); ++it)
+    {
+      it->m_handoverEvent.Cancel ();
+    }
+  m_socket = 0;
+  Object::DoDispose ();
+}
+
+void
+MpQuicPathManager::SetSocket (Ptr<QuicSocketBase> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  m_socket = socket;
+}
+
+void
+MpQuicPathManager::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_keepaliveEvent.Cancel ();
+  m_keepaliveEvent = Simulator::Schedule (m_probeInterval,
+                                          &MpQuicPathManager::KeepaliveTimeout, this);
+}
+
+void
+MpQuicPathManager::AddPath (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  if (pathId >= m_paths.size ())
+    {
+      m_paths.resize (pathId + 1);
+    }
+  m_paths[pathId] = PathInfo ();
+}
+
+void
+MpQuicPathManager::NotifyPathActivity (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  if (pathId >= m_paths.size ())
+    {
+      AddPath (pathId);
+    }
+
+  PathInfo &path = m_paths[pathId];
+  if (path.m_state == PATH_FAILED)
+    {
+      // late packets on a torn down path do not revive it
+      return;
+    }
+  path.m_lastActivity = Simulator::Now ();
+  path.m_ptoCount = 0;
+  path.m_probesSent = 0;
+  SetPathState (pathId, PATH_ACTIVE);
+}
+
+bool
+MpQuicPathManager::NotifyTimeout (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  if (pathId >= m_paths.size ())
+    {
+      AddPath (pathId);
+    }
+
+  PathInfo &path = m_paths[pathId];
+  if (path.m_state == PATH_FAILED)
+    {
+      return true;
+    }
+
+  path.m_ptoCount++;
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " probe timeout " << path.m_ptoCount
+                       << "/" << m_maxPtoCount);
+  if (path.m_ptoCount >= m_maxPtoCount && GetNUsablePaths () > 1)
+    {
+      FailPath (pathId);
+      return true;
+    }
+  return false;
+}
+
+bool
+MpQuicPathManager::IsPathUsable (uint8_t pathId) const
+{
+  return pathId >= m_paths.size () || m_paths[pathId].m_state != PATH_FAILED;
+}
+
+MpQuicPathManager::PathState_t
+MpQuicPathManager::GetPathState (uint8_t pathId) const
+{
+  if (pathId >= m_paths.size ())
+    {
+      return PATH_ACTIVE;
+    }
+  return m_paths[pathId].m_state;
+}
+
+uint32_t
+MpQuicPathManager::GetNUsablePaths (void) const
+{
+  uint32_t n = 0;
+  for (auto it = m_paths.begin (); it != m_paths.end (); ++it)
+    {
+      if (it->m_state != PATH_FAILED)
+        {
+          n++;
+        }
+    }
+  return n;
+}
+
+uint8_t
+MpQuicPathManager::GetAlternatePath (uint8_t pathId) const
+{
+  for (uint8_t i = 0; i < m_paths.size (); i++)
+    {
+      if (i != pathId && m_paths[i].m_state != PATH_FAILED)
+        {
+          return i;
+        }
+    }
+  return pathId;
+}
+
+void
+MpQuicPathManager::NotifyHandover (uint8_t pathId, Time time, Time rttChange)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << time << rttChange);
+  NS_ASSERT_MSG (time >= Simulator::Now (), "Handover announced in the past");
+  if (pathId >= m_paths.size ())
+    {
+      AddPath (pathId);
+    }
+
+  PathInfo &path = m_paths[pathId];
+  path.m_handoverEvent.Cancel ();
+  path.m_handover = time;
+  path.m_rttChange = rttChange;
+  path.m_handoverEvent = Simulator::Schedule (time - Simulator::Now (),
+                                              &MpQuicPathManager::Handover, this, pathId);
+}
+
+bool
+MpQuicPathManager::IsPathDraining (uint8_t pathId) const
+{
+  if (pathId >= m_paths.size ())
+    {
+      return false;
+    }
+  Time now = Simulator::Now ();
+  const PathInfo &path = m_paths[pathId];
+  return now < path.m_handover && now + m_handoverLead >= path.m_handover;
+}
+
+void
+MpQuicPathManager::Handover (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  PathInfo &path = m_paths[pathId];
+  path.m_handover = Time::Max ();
+  if (path.m_state == PATH_FAILED)
+    {
+      return;
+    }
+  Time rtt = m_socket->SeedPathRtt (pathId, path.m_rttChange);
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " handover, RTT seeded to " << rtt);
+  m_handoverTrace (pathId, rtt);
+}
+
+void
+MpQuicPathManager::KeepaliveTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  QuicSocket::QuicStates_t state = m_socket->GetSocketState ();
+  if (state == QuicSocket::CLOSING || state == QuicSocket::IDLE)
+    {
+      NS_LOG_INFO ("Socket closed, stop probing");
+      return;
+    }
+
+  if (state == QuicSocket::OPEN)
+    {
+      Time now = Simulator::Now ();
+      for (uint8_t i = 0; i < m_paths.size (); i++)
+        {
+          PathInfo &path = m_paths[i];
+          if (path.m_state == PATH_FAILED || now - path.m_lastActivity < m_probeInterval)
+            {
+              continue;
+            }
+          if (path.m_probesSent >= m_maxProbes && GetNUsablePaths () > 1)
+            {
+              NS_LOG_INFO ("Path " << (uint32_t) i << " did not answer "
+                                   << path.m_probesSent << " PINGs");
+              FailPath (i);
+              continue;
+            }
+          SetPathState (i, PATH_PROBING);
+          path.m_probesSent++;
+          m_socket->SendPing (i);
+        }
+    }
+
+  m_keepaliveEvent = Simulator::Schedule (m_probeInterval,
+                                          &MpQuicPathManager::KeepaliveTimeout, this);
+}
+
+void
+MpQuicPathManager::FailPath (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  SetPathState (pathId, PATH_FAILED);
+  uint32_t reinjected = m_socket->RemoveSubflow (pathId);
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " failed, last activity at "
+                       << m_paths[pathId].m_lastActivity.GetSeconds ()
+                       << " s, " << reinjected << " bytes reinjected");
+  m_pathFailureTrace (pathId, reinjected, m_paths[pathId].m_lastActivity);
+}
+
+void
+MpQuicPathManager::SetPathState (uint8_t pathId, PathState_t state)
+{
+  PathState_t oldState = m_paths[pathId].m_state;
+  if (oldState == state)
+    {
+      return;
+    }
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " " << PathStateName[oldState]
+                       << " -> " << PathStateName[state]);
+  m_paths[pathId].m_state = state;
+  m_pathStateTrace (pathId, oldState, state);
+}
+
+} // namespace ns3
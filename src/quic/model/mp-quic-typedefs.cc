@@ -84,6 +84,7 @@ MpQuicSubFlow::MpQuicSubFlow()
     m_numPacketsReceivedSinceLastAckSent = 0;
     m_queue_ack = false;
     m_receivedPacketNumbers = std::vector<SequenceNumber32> ();
+    m_largestRxPacket = SequenceNumber32 (0);
 
     m_tcb = CreateObject<QuicSocketState> ();
     m_tcb->m_cWnd = m_tcb->m_initialCWnd;
@@ -518,6 +519,21 @@ MpQuicSubFlow::SetInitialCwnd(uint32_t cwnd)
     }
 } 
 
+void
+MpQuicSubFlow::ResetCongestionState()
+{
+    SetInitialCwnd(m_cWnd);
+    m_ssThresh = 25000;
+    m_lossCwnd = 12500*0.5;
+    m_cwndState = "Slow_Start";
+    m_bwEst = 0;
+    m_tcb->m_cWnd = m_tcb->m_initialCWnd;
+    m_tcb->m_ssThresh = m_tcb->m_initialSsThresh;
+    m_rtt->Reset();
+    measuredRTT.clear();
+    largestRtt = Seconds(0);
+}
+
 
 
 MpQuicAddressInfo::MpQuicAddressInfo()
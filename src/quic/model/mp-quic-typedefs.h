@@ -99,6 +99,12 @@ public:
     static void UpdateSsh(uint32_t ssh, int id);
     void UpdateCwndOnPacketLost();
     void SetInitialCwnd(uint32_t cwnd);
+    /**
+     * \brief Go back to the initial congestion state, when the path moved to a different network
+     *
+     * The last RTT sample is kept: the schedulers use it until the first sample on the new path.
+     */
+    void ResetCongestionState();
     uint32_t GetMinPrevLossCwnd();
     double GetRate();
     //void InitialRateEvent (DataRate bw);
@@ -163,6 +169,7 @@ public:
     Timer m_pacingTimer       {Timer::REMOVE_ON_DESTROY}; //!< Pacing Event
 
     std::vector<SequenceNumber32> m_receivedPacketNumbers;  //!< Received packet number vector
+    SequenceNumber32 m_largestRxPacket;                     //!< Largest packet number received on the path
 
     multiset<double> measuredRTT;
     //list<double> measuredRTT;
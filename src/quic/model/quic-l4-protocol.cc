@@ -26,6 +26,7 @@
 #include "ns3/log.h"
 #include "ns3/nstime.h"
 #include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/object-vector.h"
 #include "ns3/pointer.h"
 
@@ -130,6 +131,23 @@ QuicL4Protocol::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&QuicL4Protocol::m_0RTTHandshakeStart),
                    MakeBooleanChecker ())
+    .AddAttribute ("SessionTicketLifetime",
+                   "Validity of the session ticket kept after a 1-RTT handshake, "
+                   "during which new connections with the same peer start with a 0-RTT handshake. "
+                   "Zero disables the resumption",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&QuicL4Protocol::m_ticketLifetime),
+                   MakeTimeChecker ())
+    .AddAttribute ("CoalescePackets",
+                   "Send the packets a socket sends at the same time on a path in one UDP datagram",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&QuicL4Protocol::m_coalescePackets),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxDatagramSize",
+                   "Largest UDP payload of a datagram holding coalesced packets, in bytes",
+                   UintegerValue (1472),
+                   MakeUintegerAccessor (&QuicL4Protocol::m_maxDatagramSize),
+                   MakeUintegerChecker<uint32_t> (64, 65507))
     .AddAttribute ("SocketType",
                    "Socket type of QUIC objects.",
                    TypeIdValue (QuicCongestionOps::GetTypeId ()),
@@ -150,6 +168,8 @@ QuicL4Protocol::GetTypeId (void)
 QuicL4Protocol::QuicL4Protocol ()
   : m_node (0),
   m_0RTTHandshakeStart (false),
+  m_coalescePackets (false),
+  m_maxDatagramSize (1472),
   m_isServer (false),
   m_endPoints (new Ipv4EndPointDemux ()),
   m_endPoints6 (new Ipv6EndPointDemux ())
@@ -163,6 +183,8 @@ QuicL4Protocol::QuicL4Protocol ()
 QuicL4Protocol::~QuicL4Protocol ()
 {
   NS_LOG_FUNCTION (this);
+  m_flushEvent.Cancel ();
+  m_pendingDatagrams.clear ();
   m_quicUdpBindingList.clear ();
 }
 
@@ -282,7 +304,7 @@ QuicL4Protocol::UdpConnect (const Address & address, Ptr<QuicSocketBase> socket)
           if (item->m_quicSocket == socket)
             {
               //return item->m_budpSocket->Connect (address);
-              m_authAddresses.push_back (InetSocketAddress::ConvertFrom (address).GetIpv4 ());
+              AddAuthAddress (address);
               return item->m_udpSocketList.back()->Connect (address);
               // std::cout<<"^^^^^^^^^^^^QuicL4Protocol::UdpConnect: m_udpsocketlist.back: "<< (item->m_udpSocketList.back() == 0 ? 0:1)<<std::endl;
             }
@@ -439,157 +461,185 @@ QuicL4Protocol::GetAuthAddresses () const
   return m_authAddresses;
 }
 
+void
+QuicL4Protocol::AddAuthAddress (const Address &address)
+{
+  Address ipv4 = InetSocketAddress::ConvertFrom (address).GetIpv4 ();
+  // every connection authenticates its peer again: keep the list short
+  if (std::find (m_authAddresses.begin (), m_authAddresses.end (), ipv4) == m_authAddresses.end ())
+    {
+      m_authAddresses.push_back (ipv4);
+    }
+}
+
 void
 QuicL4Protocol::ForwardUp (Ptr<Socket> sock)
 {
   NS_LOG_FUNCTION (this);
   Address from;
-  Ptr<Packet> packet;
+  Ptr<Packet> datagram;
 
-  while ((packet = sock->RecvFrom (from)))
+  while ((datagram = sock->RecvFrom (from)))
     {
       NS_LOG_INFO ("Receiving packet on UDP socket");
       //packet->Print (std::clog);
       // NS_LOG_INFO ("");
 
-      QuicHeader header;
-      packet->RemoveHeader (header);
-
-      //  std::cout<<this<< " Recv pkt " << header.GetPacketNumber () 
-      //           <<"pathId: "<<header.GetPathId()
-      //           << " recv seq " << header.GetSeq () 
-      //           << " data size " << packet->GetSize () 
-      //           <<"\n";
-
-      uint64_t connectionId;
-      if (header.HasConnectionId ())
-        {
-          connectionId = header.GetConnectionId ();
-        }
-      /*else if (m_sockets.size () <= 2) // Rivedere
+      // a datagram may hold several coalesced packets
+      std::vector<Ptr<Packet> > packets = SplitDatagram (datagram);
+      for (std::vector<Ptr<Packet> >::iterator p = packets.begin (); p != packets.end (); ++p)
         {
-          if (m_sockets[0]->GetSocketState () != QuicSocket::LISTENING)
+          Ptr<Packet> packet = *p;
+          QuicHeader header;
+          packet->RemoveHeader (header);
+
+          //  std::cout<<this<< " Recv pkt " << header.GetPacketNumber () 
+          //           <<"pathId: "<<header.GetPathId()
+          //           << " recv seq " << header.GetSeq () 
+          //           << " data size " << packet->GetSize () 
+          //           <<"\n";
+
+          uint64_t connectionId;
+          if (header.HasConnectionId ())
             {
-              connectionId = m_sockets[0]->GetConnectionId ();
+              connectionId = header.GetConnectionId ();
             }
-          else if (m_sockets.size () == 2 && m_sockets[1]->GetSocketState () != QuicSocket::LISTENING)
+          /*else if (m_sockets.size () <= 2) // Rivedere
             {
-              connectionId = m_sockets[1]->GetConnectionId ();
-            }
+              if (m_sockets[0]->GetSocketState () != QuicSocket::LISTENING)
+                {
+                  connectionId = m_sockets[0]->GetConnectionId ();
+                }
+              else if (m_sockets.size () == 2 && m_sockets[1]->GetSocketState () != QuicSocket::LISTENING)
+                {
+                  connectionId = m_sockets[1]->GetConnectionId ();
+                }
+              else
+                {
+                  NS_FATAL_ERROR ("The Connection ID can only be omitted by means of m_omit_connection_id transport parameter"
+                                  " if source and destination IP address and port are sufficient to identify a connection");
+                }
+
+            }*/
           else
             {
               NS_FATAL_ERROR ("The Connection ID can only be omitted by means of m_omit_connection_id transport parameter"
                               " if source and destination IP address and port are sufficient to identify a connection");
             }
 
-        }*/
-      else
-        {
-          NS_FATAL_ERROR ("The Connection ID can only be omitted by means of m_omit_connection_id transport parameter"
-                          " if source and destination IP address and port are sufficient to identify a connection");
-        }
-
-      QuicUdpBindingList::iterator it;
-      Ptr<QuicSocketBase> socket;
-      for (it = m_quicUdpBindingList.begin (); it != m_quicUdpBindingList.end (); ++it)
-        {
-          Ptr<QuicUdpBinding> item = *it;
-          if (item->m_quicSocket->GetConnectionId () == connectionId)
+          QuicUdpBindingList::iterator it;
+          Ptr<QuicSocketBase> socket;
+          for (it = m_quicUdpBindingList.begin (); it != m_quicUdpBindingList.end (); ++it)
             {
-              socket = item->m_quicSocket;
-              break;
+              Ptr<QuicUdpBinding> item = *it;
+              if (item->m_quicSocket->GetConnectionId () == connectionId)
+                {
+                  socket = item->m_quicSocket;
+                  break;
+                }
             }
-        }
 
-      NS_LOG_LOGIC ((socket == nullptr));
-      /*NS_LOG_INFO ("Initial " << header.IsInitial ());
-      NS_LOG_INFO ("Handshake " << header.IsHandshake ());
-      NS_LOG_INFO ("Short " << header.IsShort ());
-      NS_LOG_INFO ("Version Negotiation " << header.IsVersionNegotiation ());
-      NS_LOG_INFO ("Retry " << header.IsRetry ());
-      NS_LOG_INFO ("0Rtt " << header.IsORTT ());*/
+          NS_LOG_LOGIC ((socket == nullptr));
+          /*NS_LOG_INFO ("Initial " << header.IsInitial ());
+          NS_LOG_INFO ("Handshake " << header.IsHandshake ());
+          NS_LOG_INFO ("Short " << header.IsShort ());
+          NS_LOG_INFO ("Version Negotiation " << header.IsVersionNegotiation ());
+          NS_LOG_INFO ("Retry " << header.IsRetry ());
+          NS_LOG_INFO ("0Rtt " << header.IsORTT ());*/
 
-      if (header.IsInitial () and m_isServer and socket == nullptr)
-        {
-          NS_LOG_LOGIC (this << " Cloning listening socket " << m_quicUdpBindingList.front ()->m_quicSocket);
-          socket = CloneSocket (m_quicUdpBindingList.front ()->m_quicSocket);
-// std::cout<<"--*-*-*-fowardup(): socket->SetConnectionId 1"<<std::endl;
-          socket->SetConnectionId (connectionId);
-          socket->Connect (from);
-// std::cout<<"--*-*-*-fowardup(): socket->SetupCallback 1"<<std::endl;
-          socket->SetupCallback ();
+          if (header.IsInitial () and m_isServer and socket == nullptr)
+            {
+              NS_LOG_LOGIC (this << " Cloning listening socket " << m_quicUdpBindingList.front ()->m_quicSocket);
+              socket = CloneSocket (m_quicUdpBindingList.front ()->m_quicSocket);
+    // std::cout<<"--*-*-*-fowardup(): socket->SetConnectionId 1"<<std::endl;
+              socket->SetConnectionId (connectionId);
+              socket->Connect (from);
+    // std::cout<<"--*-*-*-fowardup(): socket->SetupCallback 1"<<std::endl;
+              socket->SetupCallback ();
 
-        }
-      else if (header.IsHandshake () and m_isServer and socket != nullptr)
-        {
-          NS_LOG_LOGIC ("CONNECTION AUTHENTICATED - Server authenticated Client " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
-                        InetSocketAddress::ConvertFrom (from).GetPort () << "");
-          m_authAddresses.push_back (InetSocketAddress::ConvertFrom (from).GetIpv4 ()); //add to the list of authenticated sockets
-        }
-      else if (header.IsHandshake () and !m_isServer and socket != nullptr)
-        {
-          NS_LOG_LOGIC ("CONNECTION AUTHENTICATED - Client authenticated Server " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
-                        InetSocketAddress::ConvertFrom (from).GetPort () << "");
-          m_authAddresses.push_back (InetSocketAddress::ConvertFrom (from).GetIpv4 ()); //add to the list of authenticated sockets
-        }
-      else if (header.IsAnnounce () and m_isServer and socket != nullptr) //for multipath
-        {
-          // ywj: if server receives announce from client, do nothing other than creating a new subflow.
-          m_authAddresses.push_back (InetSocketAddress::ConvertFrom (from).GetIpv4 ());
-        
-          socket->LookUpByAddr (from);     
-        }
-      else if (header.IsORTT () and m_isServer)
-        {
-          auto result = std::find (m_authAddresses.begin (), m_authAddresses.end (), InetSocketAddress::ConvertFrom (from).GetIpv4 ());
-          // check if a 0-RTT is allowed with this endpoint - or if the attribute m_0RTTHandshakeStart has been forced to be true
-          if (result == m_authAddresses.end () && m_0RTTHandshakeStart)
+            }
+          else if (header.IsHandshake () and m_isServer and socket != nullptr)
             {
-              m_authAddresses.push_back (InetSocketAddress::ConvertFrom (from).GetIpv4 ()); //add to the list of authenticated sockets
+              NS_LOG_LOGIC ("CONNECTION AUTHENTICATED - Server authenticated Client " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
+                            InetSocketAddress::ConvertFrom (from).GetPort () << "");
+              AddAuthAddress (from); //add to the list of authenticated sockets
             }
-          else if (result == m_authAddresses.end () && !m_0RTTHandshakeStart)
+          else if (header.IsHandshake () and !m_isServer and socket != nullptr)
             {
-              NS_LOG_WARN ( this << " CONNECTION ABORTED: 0RTT Packet from unauthenticated address " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
-                            InetSocketAddress::ConvertFrom (from).GetPort ());
-              continue;
+              NS_LOG_LOGIC ("CONNECTION AUTHENTICATED - Client authenticated Server " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
+                            InetSocketAddress::ConvertFrom (from).GetPort () << "");
+              AddAuthAddress (from); //add to the list of authenticated sockets
             }
+          else if (header.IsAnnounce () and m_isServer and socket != nullptr) //for multipath
+            {
+              // ywj: if server receives announce from client, do nothing other than creating a new subflow.
+              AddAuthAddress (from);
+        
+              socket->LookUpByAddr (from);     
+            }
+          else if (header.IsORTT () and m_isServer and socket != nullptr)
+            {
+              // retransmission of the 0-RTT packet of a connection already accepted
+              NS_LOG_LOGIC (this << " 0RTT Packet of connection " << connectionId);
+            }
+          else if (header.IsORTT () and m_isServer)
+            {
+              // a 0-RTT is allowed with a peer holding a valid session ticket - or if the attribute m_0RTTHandshakeStart has been forced to be true
+              uint32_t version;
+              if (GetSessionTicket (from, version) || m_0RTTHandshakeStart)
+                {
+                  AddAuthAddress (from); //add to the list of authenticated sockets
+                }
+              else
+                {
+                  NS_LOG_WARN ( this << " CONNECTION ABORTED: 0RTT Packet from address " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
+                                InetSocketAddress::ConvertFrom (from).GetPort () << " without a session ticket");
+                  continue;
+                }
+
+              NS_LOG_LOGIC ("CONNECTION AUTHENTICATED - Server authenticated Client " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
+                            InetSocketAddress::ConvertFrom (from).GetPort () << "");
+              NS_LOG_LOGIC ( this << " Cloning listening socket " << m_quicUdpBindingList.front ()->m_quicSocket);
+              socket = CloneSocket (m_quicUdpBindingList.front ()->m_quicSocket);
+              socket->SetConnectionId (connectionId);
+              socket->Connect (from);
+    // std::cout<<"--*-*-*-fowardup(): socket->SetupCallback 2"<<std::endl;
+              socket->SetupCallback ();
 
-          NS_LOG_LOGIC ("CONNECTION AUTHENTICATED - Server authenticated Client " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
-                        InetSocketAddress::ConvertFrom (from).GetPort () << "");
-          NS_LOG_LOGIC ( this << " Cloning listening socket " << m_quicUdpBindingList.front ()->m_quicSocket);
-          socket = CloneSocket (m_quicUdpBindingList.front ()->m_quicSocket);
-          socket->SetConnectionId (connectionId);
-          socket->Connect (from);
-// std::cout<<"--*-*-*-fowardup(): socket->SetupCallback 2"<<std::endl;
-          socket->SetupCallback ();
-
-        }
-      else if (header.IsShort ())
-        {
-          auto result = std::find (m_authAddresses.begin (), m_authAddresses.end (), InetSocketAddress::ConvertFrom (from).GetIpv4 ());
+            }
+          else if (header.IsShort ())
+            {
+              auto result = std::find (m_authAddresses.begin (), m_authAddresses.end (), InetSocketAddress::ConvertFrom (from).GetIpv4 ());
+
+              if (result == m_authAddresses.end () && m_0RTTHandshakeStart)
+                {
+                  AddAuthAddress (from); //add to the list of authenticated sockets
+                }
+              else if (result == m_authAddresses.end () && socket != nullptr && socket->GetConnectionMigration ())
+                {
+                  // the connection ID is known: the socket validates the new address with a PATH_CHALLENGE
+                  NS_LOG_LOGIC (this << " Short Packet of connection " << connectionId << " from new address " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
+                                InetSocketAddress::ConvertFrom (from).GetPort ());
+                }
+              else if (result == m_authAddresses.end () && !m_0RTTHandshakeStart)
+                {
+                  NS_LOG_WARN ( this << " CONNECTION ABORTED: Short Packet from unauthenticated address " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
+                                InetSocketAddress::ConvertFrom (from).GetPort ());
+                  continue;
+                }
+            }
 
-          if (result == m_authAddresses.end () && m_0RTTHandshakeStart)
+          // Handle callback for the correct socket
+          if (!m_socketHandlers[socket].IsNull ())
             {
-              m_authAddresses.push_back (InetSocketAddress::ConvertFrom (from).GetIpv4 ()); //add to the list of authenticated sockets
+              NS_LOG_LOGIC (this << " waking up handler of socket " << socket);
+              m_socketHandlers[socket] (packet, header, from);
             }
-          else if (result == m_authAddresses.end () && !m_0RTTHandshakeStart)
+          else
             {
-              NS_LOG_WARN ( this << " CONNECTION ABORTED: Short Packet from unauthenticated address " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
-                            InetSocketAddress::ConvertFrom (from).GetPort ());
-              continue;
+              NS_FATAL_ERROR ( this << " no handler for socket " << socket);
             }
         }
-
-      // Handle callback for the correct socket
-      if (!m_socketHandlers[socket].IsNull ())
-        {
-          NS_LOG_LOGIC (this << " waking up handler of socket " << socket);
-          m_socketHandlers[socket] (packet, header, from);
-        }
-      else
-        {
-          NS_FATAL_ERROR ( this << " no handler for socket " << socket);
-        }
     }
 }
 
@@ -652,6 +702,14 @@ void
 QuicL4Protocol::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  // the path managers and fluid models of the sockets hold them back
+  for (auto it = m_quicUdpBindingList.begin (); it != m_quicUdpBindingList.end (); ++it)
+    {
+      if ((*it)->m_quicSocket != nullptr)
+        {
+          (*it)->m_quicSocket->Dispose ();
+        }
+    }
   m_quicUdpBindingList.clear ();
 
   m_node = 0;
@@ -802,7 +860,7 @@ QuicL4Protocol::Receive (Ptr<Packet> packet,
 }
 
 void
-QuicL4Protocol::SendPacket (Ptr<QuicSocketBase> socket, Ptr<Packet> pkt, const QuicHeader &outgoing) const
+QuicL4Protocol::SendPacket (Ptr<QuicSocketBase> socket, Ptr<Packet> pkt, const QuicHeader &outgoing)
 {
   NS_LOG_FUNCTION (this << socket);
   uint16_t pathId = outgoing.GetPathId (); 
@@ -836,23 +894,241 @@ QuicL4Protocol::SendPacket (Ptr<QuicSocketBase> socket, Ptr<Packet> pkt, const Q
   //               <<"\n";
 
   // std::cout<<"^^^^------^^^^^^QuicL4Protocol::SendPacket: pathId: "<<pathId<<std::endl;
+  Ptr<Socket> udpSocket = GetPathUdpSocket (socket, pathId);
+  if (udpSocket == 0)
+    {
+      return;
+    }
+  if (!m_coalescePackets)
+    {
+      UdpSend (udpSocket, packetSent, 0);
+      return;
+    }
+
+  QueueDatagram (udpSocket, packetSent);
+}
+
+void
+QuicL4Protocol::QueueDatagram (Ptr<Socket> udpSocket, Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << udpSocket << packet);
+  // the packets sent by the socket in this event leave in as few datagrams as possible
+  uint32_t size = 1;
+  const std::vector<Ptr<Packet> > &pending = m_pendingDatagrams[udpSocket];
+  for (std::vector<Ptr<Packet> >::const_iterator it = pending.begin (); it != pending.end (); ++it)
+    {
+      size += 2 + (*it)->GetSize ();
+    }
+  if (!pending.empty () && size + 2 + packet->GetSize () > m_maxDatagramSize)
+    {
+      // the datagrams of the other sockets may still grow
+      FlushDatagram (udpSocket);
+    }
+  m_pendingDatagrams[udpSocket].push_back (packet);
+  if (!m_flushEvent.IsRunning ())
+    {
+      m_flushEvent = Simulator::ScheduleNow (&QuicL4Protocol::FlushDatagrams, this);
+    }
+}
+
+void
+QuicL4Protocol::FlushDatagram (Ptr<Socket> udpSocket)
+{
+  NS_LOG_FUNCTION (this << udpSocket);
+  std::map<Ptr<Socket>, std::vector<Ptr<Packet> > >::iterator it = m_pendingDatagrams.find (udpSocket);
+  if (it == m_pendingDatagrams.end ())
+    {
+      return;
+    }
+  std::vector<Ptr<Packet> > packets;
+  packets.swap (it->second);
+  m_pendingDatagrams.erase (it);
+  UdpSend (udpSocket, CoalesceDatagram (packets), 0);
+}
+
+void
+QuicL4Protocol::FlushDatagrams (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flushEvent.Cancel ();
+  std::map<Ptr<Socket>, std::vector<Ptr<Packet> > > pending;
+  pending.swap (m_pendingDatagrams);
+  for (std::map<Ptr<Socket>, std::vector<Ptr<Packet> > >::iterator it = pending.begin (); it != pending.end (); ++it)
+    {
+      UdpSend (it->first, CoalesceDatagram (it->second), 0);
+    }
+}
+
+Ptr<Packet>
+QuicL4Protocol::CoalesceDatagram (const std::vector<Ptr<Packet> > &packets) const
+{
+  NS_LOG_FUNCTION (this << packets.size ());
+  NS_ASSERT (!packets.empty ());
+  if (packets.size () == 1)
+    {
+      return packets.front ();
+    }
+  NS_LOG_LOGIC (this << " coalescing " << packets.size () << " packets in one datagram");
+  uint8_t marker = COALESCED_MARKER;
+  Ptr<Packet> datagram = Create<Packet> (&marker, 1);
+  for (std::vector<Ptr<Packet> >::const_iterator p = packets.begin (); p != packets.end (); ++p)
+    {
+      NS_ASSERT ((*p)->GetSize () <= 0xffff);
+      uint8_t length[2] = { (uint8_t) ((*p)->GetSize () >> 8), (uint8_t) ((*p)->GetSize () & 0xff) };
+      datagram->AddAtEnd (Create<Packet> (length, 2));
+      datagram->AddAtEnd (*p);
+    }
+  return datagram;
+}
+
+std::vector<Ptr<Packet> >
+QuicL4Protocol::SplitDatagram (Ptr<Packet> datagram) const
+{
+  NS_LOG_FUNCTION (this << datagram);
+  std::vector<Ptr<Packet> > packets;
+  uint8_t marker = 0;
+  datagram->CopyData (&marker, 1);
+  if (marker != COALESCED_MARKER)
+    {
+      packets.push_back (datagram);
+      return packets;
+    }
+
+  uint32_t offset = 1;
+  while (offset + 2 <= datagram->GetSize ())
+    {
+      uint8_t length[2];
+      datagram->CreateFragment (offset, 2)->CopyData (length, 2);
+      uint32_t size = (length[0] << 8) | length[1];
+      offset += 2;
+      if (size == 0 || offset + size > datagram->GetSize ())
+        {
+          NS_LOG_WARN (this << " truncated coalesced datagram, dropping its end");
+          break;
+        }
+      packets.push_back (datagram->CreateFragment (offset, size));
+      offset += size;
+    }
+  return packets;
+}
+
+void
+QuicL4Protocol::SendPacketTo (Ptr<QuicSocketBase> socket, Ptr<Packet> pkt, const QuicHeader &outgoing, const Address &to) const
+{
+  NS_LOG_FUNCTION (this << socket << to);
+
+  Ptr<Packet> packetSent = Create<Packet> ();
+  packetSent->AddHeader (outgoing);
+  packetSent->AddAtEnd (pkt);
+
+  Ptr<Socket> udpSocket = GetPathUdpSocket (socket, outgoing.GetPathId ());
+  if (udpSocket != 0)
+    {
+      udpSocket->SendTo (packetSent, 0, to);
+    }
+}
+
+Ptr<Socket>
+QuicL4Protocol::GetPathUdpSocket (Ptr<QuicSocketBase> socket, uint8_t pathId) const
+{
+  NS_LOG_FUNCTION (this << socket << (uint32_t) pathId);
+
   QuicUdpBindingList::const_iterator it;
   for (it = m_quicUdpBindingList.begin (); it != m_quicUdpBindingList.end (); ++it)
     {
       Ptr<QuicUdpBinding> item = *it;
       if (item->m_quicSocket == socket)
         {
-          // std::cout<<"----==------ QuicL4Protocol::SendPacket: m_udpSocketList. size: "<<item->m_udpSocketList.size()<<std::endl;
-          if (m_isServer && item->m_udpSocketList.size() == 3){
-            UdpSend (item->m_udpSocketList[pathId+1], packetSent, 0);
-          } else {
-            UdpSend (item->m_udpSocketList[pathId], packetSent, 0);
-          }
-          
+          // the first UDP socket of a multipath server is the one it accepted the connection on
+          uint32_t index = (m_isServer && item->m_udpSocketList.size () == 3) ? pathId + 1 : pathId;
+          if (index < item->m_udpSocketList.size ())
+            {
+              return item->m_udpSocketList[index];
+            }
+          return 0;
+        }
+    }
+  return 0;
+}
+
+int
+QuicL4Protocol::GetPathPeerName (Ptr<QuicSocketBase> socket, uint8_t pathId, Address &address) const
+{
+  NS_LOG_FUNCTION (this << socket << (uint32_t) pathId);
+
+  Ptr<Socket> udpSocket = GetPathUdpSocket (socket, pathId);
+  if (udpSocket == 0)
+    {
+      return -1;
+    }
+  return udpSocket->GetPeerName (address);
+}
+
+int
+QuicL4Protocol::GetPathSockName (Ptr<QuicSocketBase> socket, uint8_t pathId, Address &address) const
+{
+  NS_LOG_FUNCTION (this << socket << (uint32_t) pathId);
+
+  Ptr<Socket> udpSocket = GetPathUdpSocket (socket, pathId);
+  if (udpSocket == 0)
+    {
+      return -1;
+    }
+  return udpSocket->GetSockName (address);
+}
+
+int
+QuicL4Protocol::UdpReconnect (Ptr<QuicSocketBase> socket, uint8_t pathId, const Address &address)
+{
+  NS_LOG_FUNCTION (this << socket << (uint32_t) pathId << address);
+
+  Ptr<Socket> udpSocket = GetPathUdpSocket (socket, pathId);
+  if (udpSocket == 0 || !InetSocketAddress::IsMatchingType (address))
+    {
+      return -1;
+    }
+  AddAuthAddress (address);
+  return udpSocket->Connect (address);
+}
+
+int
+QuicL4Protocol::UdpRebind (Ptr<QuicSocketBase> socket, uint8_t pathId, const Address &address)
+{
+  NS_LOG_FUNCTION (this << socket << (uint32_t) pathId << address);
 
+  Ptr<Socket> oldSocket = GetPathUdpSocket (socket, pathId);
+  Address peer;
+  if (oldSocket == 0 || oldSocket->GetPeerName (peer) != 0)
+    {
+      return -1;
+    }
+
+  Ptr<Socket> udpSocket = CreateUdpSocket ();
+  int res = udpSocket->Bind (address);
+  if (res != 0)
+    {
+      return res;
+    }
+  udpSocket->Connect (peer);
+  udpSocket->SetRecvCallback (MakeCallback (&QuicL4Protocol::ForwardUp, this));
+
+  QuicUdpBindingList::iterator it;
+  for (it = m_quicUdpBindingList.begin (); it != m_quicUdpBindingList.end (); ++it)
+    {
+      Ptr<QuicUdpBinding> item = *it;
+      if (item->m_quicSocket == socket)
+        {
+          std::replace (item->m_udpSocketList.begin (), item->m_udpSocketList.end (), oldSocket, udpSocket);
+          if (item->m_budpSocket == oldSocket)
+            {
+              item->m_budpSocket = udpSocket;
+            }
           break;
         }
     }
+  oldSocket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+  oldSocket->Close ();
+  return 0;
 }
 
 
@@ -1021,5 +1297,37 @@ QuicL4Protocol::Is0RTTHandshakeAllowed () const
   return m_0RTTHandshakeStart;
 }
 
+void
+QuicL4Protocol::AddSessionTicket (const Address &address, uint32_t version)
+{
+  NS_LOG_FUNCTION (this << address << version);
+
+  if (m_ticketLifetime.IsZero () || !InetSocketAddress::IsMatchingType (address))
+    {
+      return;
+    }
+  m_sessionTickets[InetSocketAddress::ConvertFrom (address).GetIpv4 ()] =
+    std::make_pair (version, Simulator::Now () + m_ticketLifetime);
+}
+
+bool
+QuicL4Protocol::GetSessionTicket (const Address &address, uint32_t &version) const
+{
+  NS_LOG_FUNCTION (this << address);
+
+  if (m_sessionTickets.empty () || !InetSocketAddress::IsMatchingType (address))
+    {
+      return false;
+    }
+  std::map<Ipv4Address, std::pair<uint32_t, Time> >::const_iterator it =
+    m_sessionTickets.find (InetSocketAddress::ConvertFrom (address).GetIpv4 ());
+  if (it == m_sessionTickets.end () || it->second.second <= Simulator::Now ())
+    {
+      return false;
+    }
+  version = it->second.first;
+  return true;
+}
+
 } // namespace ns3
 
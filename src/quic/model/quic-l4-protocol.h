@@ -30,11 +30,15 @@
 #include "ns3/node.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ip-l4-protocol.h"
 #include "quic-header.h"
 #include "ns3/socket.h"
 
+class QuicCoalescingTestCase;
+
 namespace ns3 {
 
 class QuicSocketBase;
@@ -91,6 +95,8 @@ public:
 */
 class QuicL4Protocol : public IpL4Protocol
 {
+  /// allow QuicCoalescingTestCase access
+  friend class ::QuicCoalescingTestCase;
 public:
   /**
    * \brief Get the type ID.
@@ -268,7 +274,63 @@ public:
    * \param pck a smart pointer to a packet
    * \param outgoing the QuicHeader of the packet
    */
-  void SendPacket (Ptr<QuicSocketBase> socket, Ptr<Packet> pkt, const QuicHeader &outgoing) const;
+  void SendPacket (Ptr<QuicSocketBase> socket, Ptr<Packet> pkt, const QuicHeader &outgoing);
+
+  /**
+   * \brief Send a packet on a path to an address other than the peer of the path
+   *
+   * Used to probe a candidate peer address with a PATH_CHALLENGE before
+   * the path is moved to it.
+   *
+   * \param socket the QuicSocketBase that would send the packet
+   * \param pkt a smart pointer to a packet
+   * \param outgoing the QuicHeader of the packet
+   * \param to the destination
+   */
+  void SendPacketTo (Ptr<QuicSocketBase> socket, Ptr<Packet> pkt, const QuicHeader &outgoing, const Address &to) const;
+
+  /**
+   * \brief Get the address a path of a socket sends to
+   *
+   * \param socket the QuicSocketBase
+   * \param pathId the path
+   * \param address the peer address of the path
+   * \returns 0 if success, -1 otherwise
+   */
+  int GetPathPeerName (Ptr<QuicSocketBase> socket, uint8_t pathId, Address &address) const;
+
+  /**
+   * \brief Get the local address of a path of a socket
+   *
+   * \param socket the QuicSocketBase
+   * \param pathId the path
+   * \param address the local address of the path
+   * \returns 0 if success, -1 otherwise
+   */
+  int GetPathSockName (Ptr<QuicSocketBase> socket, uint8_t pathId, Address &address) const;
+
+  /**
+   * \brief Move a path to a new peer address, once the address is validated
+   *
+   * \param socket the QuicSocketBase
+   * \param pathId the path
+   * \param address the new peer address
+   * \return the result of the connect call on the UDP socket
+   */
+  int UdpReconnect (Ptr<QuicSocketBase> socket, uint8_t pathId, const Address &address);
+
+  /**
+   * \brief Move a path to a new local address
+   *
+   * The UDP socket of the path is replaced by one bound to the new
+   * address and connected to the same peer.
+   *
+   * \param socket the QuicSocketBase
+   * \param pathId the path
+   * \param address the new local address
+   * \return the result of the bind call on the new UDP socket
+   */
+  int UdpRebind (Ptr<QuicSocketBase> socket, uint8_t pathId, const Address &address);
 
   /**
    * \brief Remove a socket (and its clones if it is a listener)
@@ -301,6 +363,27 @@ public:
    */
   bool Is0RTTHandshakeAllowed () const;
 
+  /**
+   * \brief Store the session ticket of a peer once a 1-RTT handshake is complete
+   *
+   * The ticket lets the next connection with the peer start with a 0-RTT
+   * handshake until it expires, SessionTicketLifetime after the handshake.
+   * Nothing is stored if SessionTicketLifetime is zero.
+   *
+   * \param address the address of the peer
+   * \param version the QUIC version negotiated with the peer
+   */
+  void AddSessionTicket (const Address &address, uint32_t version);
+
+  /**
+   * \brief Look for a valid session ticket of a peer
+   *
+   * \param address the address of the peer
+   * \param version filled with the QUIC version of the ticket, if any
+   * \return true if a ticket of the peer has not expired yet
+   */
+  bool GetSessionTicket (const Address &address, uint32_t &version) const;
+
   /**
    * \brief Allocate an IPv4 Endpoint
    * \return the Endpoint
@@ -433,13 +516,82 @@ private:
    */
   Ptr<QuicSocketBase> CloneSocket (Ptr<QuicSocketBase> oldsock);
 
+  /**
+   * \brief Add the IP address of a peer to the authenticated addresses, once
+   *
+   * \param address the address of the peer
+   */
+  void AddAuthAddress (const Address &address);
+
+  /**
+   * \brief Get the UDP socket a path of a socket sends on
+   *
+   * \param socket the QuicSocketBase
+   * \param pathId the path
+   * \return the UDP socket, or 0 if the path has none
+   */
+  Ptr<Socket> GetPathUdpSocket (Ptr<QuicSocketBase> socket, uint8_t pathId) const;
+
+  /**
+   * \brief Queue a packet in the next datagram of a UDP socket
+   *
+   * The pending datagram of the socket is sent first if the packet would
+   * make it larger than MaxDatagramSize. The pending datagrams are sent at
+   * the end of the current event.
+   *
+   * \param udpSocket the UDP socket
+   * \param packet the QUIC packet
+   */
+  void QueueDatagram (Ptr<Socket> udpSocket, Ptr<Packet> packet);
+
+  /**
+   * \brief Send the packets queued for coalescing on one UDP socket
+   *
+   * \param udpSocket the UDP socket
+   */
+  void FlushDatagram (Ptr<Socket> udpSocket);
+
+  /**
+   * \brief Send the packets queued for coalescing, one datagram per UDP socket
+   */
+  void FlushDatagrams (void);
+
+  /**
+   * \brief Build the datagram carrying packets
+   *
+   * A datagram holding several QUIC packets starts with the
+   * COALESCED_MARKER byte; each packet follows, preceded by its length on
+   * two bytes. A single packet is sent unchanged.
+   *
+   * \param packets the QUIC packets, at least one
+   * \return the datagram
+   */
+  Ptr<Packet> CoalesceDatagram (const std::vector<Ptr<Packet> > &packets) const;
+
+  /**
+   * \brief Split a received datagram into the QUIC packets it holds
+   *
+   * \param datagram the datagram
+   * \return the QUIC packets, in order
+   */
+  std::vector<Ptr<Packet> > SplitDatagram (Ptr<Packet> datagram) const;
+
+  /// First byte of a coalesced datagram: a short header type no packet uses
+  static const uint8_t COALESCED_MARKER = 0x1f;
+
   Ptr<Node> m_node;           //!< The node this stack is associated with
   TypeId m_rttTypeId;         //!< The type of RttEstimator objects
   TypeId m_congestionTypeId;  //!< The socket type of QUIC objects
   bool m_0RTTHandshakeStart;  //!< A flag indicating if the L4 Protocol allows the 0-RTT Hansdhake start
+  Time m_ticketLifetime;      //!< Validity of the session tickets, zero for none
+  bool m_coalescePackets;     //!< Coalesce the packets sent at the same time into one datagram
+  uint32_t m_maxDatagramSize; //!< Largest UDP payload of a coalesced datagram
+  std::map<Ptr<Socket>, std::vector<Ptr<Packet> > > m_pendingDatagrams;  //!< Packets waiting to be coalesced, per UDP socket
+  EventId m_flushEvent;       //!< Sends the pending packets
   std::map <Ptr<Socket>, Callback<void, Ptr<Packet>, const QuicHeader&, Address& > > m_socketHandlers;  //!< Callback handlers for sockets
 
   std::vector<Address > m_authAddresses;    //!< Authenticated addresses for this L4 Protocol
+  std::map<Ipv4Address, std::pair<uint32_t, Time> > m_sessionTickets;  //!< Version and expiry of the session ticket of each peer
   QuicUdpBindingList m_quicUdpBindingList;  //!< List of QuicUdp bindings
   bool m_isServer;                          //!< A flag indicating if the L4 Protocol is server
 
@@ -73,7 +73,10 @@ QuicL5Protocol::GetTypeId (void)
 }
 
 QuicL5Protocol::QuicL5Protocol ()
-  : m_socket (0),
+  : vnReceived (false),
+  m_currentOffset (0),
+  m_largestInOrderOffset (0),
+  m_socket (0),
   m_node (0),
   m_connectionId ()
 {
@@ -47,6 +47,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
+#include "ns3/data-rate.h"
 #include "ns3/trace-source-accessor.h"
 #include "quic-socket-base.h"
 #include "quic-congestion-ops.h"
@@ -74,6 +75,7 @@
 #include "quic-socket-tx-scheduler.h"
 
 #include "quic-scheduler.h"
+#include "mp-quic-path-manager.h"
 
 namespace ns3 {
 
@@ -230,6 +232,55 @@ QuicSocketBase::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&QuicSocketBase::m_tcb),
                    MakePointerChecker<QuicSocketState> ())
+    .AddAttribute ("PathManager",
+                   "Enable path liveness probing and failover across subflows",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&QuicSocketBase::m_enablePathManager),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PathManagerObject",
+                   "The MpQuicPathManager of the connection, if enabled",
+                   PointerValue (),
+                   MakePointerAccessor (&QuicSocketBase::m_pathManager),
+                   MakePointerChecker<MpQuicPathManager> ())
+    .AddAttribute ("FluidModel",
+                   "Fast-forward the steady phases of bulk transfers with a fluid model",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&QuicSocketBase::m_enableFluidModel),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FluidModelObject",
+                   "The MpQuicFluidModel of the connection, if enabled",
+                   PointerValue (),
+                   MakePointerAccessor (&QuicSocketBase::m_fluidModel),
+                   MakePointerChecker<MpQuicFluidModel> ())
+    .AddAttribute ("ConnectionMigration",
+                   "Let the peer move the paths to new addresses, validated with PATH_CHALLENGE",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&QuicSocketBase::m_connectionMigration),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PathClassMask",
+                   "A path which moves to an address in the same subnet under this mask keeps its congestion state",
+                   Ipv4MaskValue ("255.255.255.0"),
+                   MakeIpv4MaskAccessor (&QuicSocketBase::m_pathClassMask),
+                   MakeIpv4MaskChecker ())
+    .AddAttribute ("PiggybackPendingAcks",
+                   "Attach the delayed ACKs waiting to be sent, of every path, to the next short packet "
+                   "instead of sending them in ACK-only packets",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&QuicSocketBase::m_piggybackAcks),
+                   MakeBooleanChecker ())
+    // not set at construction: the sockets start from QuicEchoClientHelper::SetBW0/SetBW1
+    .AddAttribute ("LinkRate0",
+                   "The rate of the link of path 0, as known to the MAMS schedulers",
+                   TypeId::ATTR_GET | TypeId::ATTR_SET,
+                   DataRateValue (DataRate (0)),
+                   MakeDataRateAccessor (&QuicSocketBase::m_bw0),
+                   MakeDataRateChecker ())
+    .AddAttribute ("LinkRate1",
+                   "The rate of the link of path 1, as known to the MAMS schedulers",
+                   TypeId::ATTR_GET | TypeId::ATTR_SET,
+                   DataRateValue (DataRate (0)),
+                   MakeDataRateAccessor (&QuicSocketBase::m_bw1),
+                   MakeDataRateChecker ())
                    
     // .AddTraceSource ("RTO", "Retransmission timeout",
     //                  MakeTraceSourceAccessor (&QuicSocketBase::m_rto),
@@ -264,6 +315,10 @@ QuicSocketBase::GetTypeId (void)
                      "TCP Congestion machine state",
                      MakeTraceSourceAccessor (&QuicSocketBase::m_congStateTrace),
                      "ns3::TcpSocketState::TcpCongStatesTracedValueCallback")
+    .AddTraceSource ("PathMigration",
+                     "A path moved to a new address",
+                     MakeTraceSourceAccessor (&QuicSocketBase::m_pathMigrationTrace),
+                     "ns3::QuicSocketBase::PathMigrationTracedCallback")
     // .AddTraceSource ("AdvWND",
     //                  "Advertised Window Size",
     //                  MakeTraceSourceAccessor (&QuicSocketBase::m_advWnd),
@@ -469,6 +524,30 @@ QuicSocketState::QuicSocketState (const QuicSocketState &other)
   m_lossDetectionAlarm.Cancel ();
 }
 
+//ywj: test how to use extern variable
+// The scenario set by the helpers before the sockets are created: each socket
+// keeps its own copy, read and updated in the context of its node only.
+extern Time owd_0; //owd_0 and owd_1 here are originally defined in the file 'quic-echo-helper.h'
+extern Time owd_1;
+
+extern double errorRate;
+extern DataRate bw_0;
+extern DataRate bw_1;
+
+extern uint8_t m_pktScheAlgo; //1. quic-rr (quic with round-robin), 2, mpquic-rr, 3. mpquic-ofo (our proposed scheduler for solving ofo issue)
+extern bool withMob;
+
+//external variables for video streaming test
+extern Time owd_0_vs; //owd_0 and owd_1 here are originally defined in the file 'quic-echo-helper.h'
+extern Time owd_1_vs;
+
+extern double errorRate_vs;
+extern DataRate bw_0_vs;
+extern DataRate bw_1_vs;
+
+extern uint8_t m_pktScheAlgo_vs; //1. quic-rr (quic with round-robin), 2, mpquic-rr, 3. mpquic-ofo (our proposed scheduler for solving ofo issue)
+extern bool withMob_vs;
+
 QuicSocketBase::QuicSocketBase (void)
   :  QuicSocket (),
     m_subflows (0),
@@ -485,6 +564,7 @@ QuicSocketBase::QuicSocketBase (void)
     m_errno (
       ERROR_NOTERROR),
     m_connected (false),
+    m_0RTTHandshake (false),
     m_connectionId (0),
     m_vers (
       QUIC_VERSION_NS3_IMPL),
@@ -513,7 +593,26 @@ QuicSocketBase::QuicSocketBase (void)
     m_lastRtt (Seconds (0.0)),
     m_queue_ack (false),
     m_numPacketsReceivedSinceLastAckSent (0),
-    m_pacingTimer (Timer::REMOVE_ON_DESTROY)
+    m_lastMaxData (0),
+    m_maxDataInterval (10),
+    m_pacingTimer (Timer::REMOVE_ON_DESTROY),
+    m_enablePathManager (false),
+    m_pathManager (0),
+    m_connectionMigration (true),
+    m_pathClassMask ("255.255.255.0"),
+    m_piggybackAcks (false),
+    m_pathChallengeData (0),
+    m_rxPathId (0),
+    m_enableFluidModel (false),
+    m_fluidModel (0),
+    m_fluidPeer (0),
+    m_owd0 (owd_0),
+    m_owd1 (owd_1),
+    m_bw0 (bw_0),
+    m_bw1 (bw_1),
+    m_errorRate (errorRate),
+    m_scheAlgo (m_pktScheAlgo),
+    m_withMob (withMob)
 {
   NS_LOG_FUNCTION (this);
 
@@ -574,16 +673,22 @@ QuicSocketBase::QuicSocketBase (void)
 
 QuicSocketBase::QuicSocketBase (const QuicSocketBase& sock)   // Copy constructor
   : QuicSocket (sock),
+    m_subSocket (sock.m_subSocket),
     m_endPoint (0),
     m_endPoint6 (0),
     m_node (sock.m_node),
     m_quicl4 (sock.m_quicl4),
     m_quicl5 (0),
+    m_socketTxBufferSize (sock.m_socketTxBufferSize),
+    m_socketRxBufferSize (sock.m_socketRxBufferSize),
+    m_schedulingTypeId (sock.m_schedulingTypeId),
+    m_defaultLatency (sock.m_defaultLatency),
     m_socketState (LISTENING),
     m_transportErrorCode (sock.m_transportErrorCode),
     m_serverBusy (sock.m_serverBusy),
     m_errno (sock.m_errno),
     m_connected (sock.m_connected),
+    m_0RTTHandshake (false),
     m_connectionId (0),
     m_vers (sock.m_vers),
     m_keyPhase (QuicHeader::PHASE_ZERO),
@@ -600,6 +705,7 @@ QuicSocketBase::QuicSocketBase (const QuicSocketBase& sock)   // Copy constructo
     m_couldContainTransportParameters (sock.m_couldContainTransportParameters),
     m_rto (sock.m_rto),
     m_drainingPeriodTimeout (sock.m_drainingPeriodTimeout),
+    m_flushOnClose (sock.m_flushOnClose),
     m_closeOnEmpty (sock.m_closeOnEmpty),
     m_lastRtt (sock.m_lastRtt),
     m_quicCongestionControlLegacy (sock.m_quicCongestionControlLegacy),
@@ -607,10 +713,28 @@ QuicSocketBase::QuicSocketBase (const QuicSocketBase& sock)   // Copy constructo
     m_numPacketsReceivedSinceLastAckSent (sock.m_numPacketsReceivedSinceLastAckSent),
     m_lastMaxData(0),
     m_maxDataInterval(10),
+    m_initialPacketSize (sock.m_initialPacketSize),
     m_pacingTimer (Timer::REMOVE_ON_DESTROY),
     m_txTrace (sock.m_txTrace),
     m_rxTrace (sock.m_rxTrace),
-    m_scheduler (0)
+    m_scheduler (0),
+    m_enablePathManager (sock.m_enablePathManager),
+    m_pathManager (0),
+    m_connectionMigration (sock.m_connectionMigration),
+    m_pathClassMask (sock.m_pathClassMask),
+    m_piggybackAcks (sock.m_piggybackAcks),
+    m_pathChallengeData (0),
+    m_rxPathId (0),
+    m_enableFluidModel (sock.m_enableFluidModel),
+    m_fluidModel (0),
+    m_fluidPeer (0),
+    m_owd0 (sock.m_owd0),
+    m_owd1 (sock.m_owd1),
+    m_bw0 (sock.m_bw0),
+    m_bw1 (sock.m_bw1),
+    m_errorRate (sock.m_errorRate),
+    m_scheAlgo (sock.m_scheAlgo),
+    m_withMob (sock.m_withMob)
 {
   NS_LOG_FUNCTION (this);
 
@@ -678,6 +802,29 @@ QuicSocketBase::~QuicSocketBase (void)
   m_quicl4 = 0;
   //CancelAllTimers ();
   m_pacingTimer.Cancel ();
+  if (m_fluidModel != 0)
+    {
+      UnregisterFluidEnd ();
+    }
+}
+
+void
+QuicSocketBase::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_pathManager != 0)
+    {
+      m_pathManager->Dispose ();
+      m_pathManager = 0;
+    }
+  if (m_fluidModel != 0)
+    {
+      m_fluidModel->Dispose ();
+      m_fluidModel = 0;
+      UnregisterFluidEnd ();
+    }
+  m_fluidPeer = 0;
+  QuicSocket::DoDispose ();
 }
 
 /* Inherit from Socket class: Bind socket to an end-point in QuicL4Protocol */
@@ -829,6 +976,8 @@ QuicSocketBase::NotifyConnectionEstablishedEnb (std::string context,
 
 // MAMS Extension
 //ywj added on Aug. 09: obtain sinr info dynamically.
+std::multimap<uint64_t, QuicSocketBase *> QuicSocketBase::g_fluidEnds;
+SystemMutex QuicSocketBase::g_fluidEndsMutex;
 std::vector<double> QuicSocketBase::ue_sinr = boost::assign::list_of(0)(0);
 std::vector<double> QuicSocketBase::ue_Bmin = boost::assign::list_of(0)(0)(0)(0)(0);
 
@@ -949,16 +1098,19 @@ QuicSocketBase::Connect (const Address & address)
       m_quicl5->CreateStream (QuicStream::BIDIRECTIONAL, 0);   // Create Stream 0 (necessary)
     }
 
-  // check if the address is in a list of known and authenticated addresses
-  auto result = std::find (
-    m_quicl4->GetAuthAddresses ().begin (), m_quicl4->GetAuthAddresses ().end (),
-    InetSocketAddress::ConvertFrom (address).GetIpv4 ());
+  // a client holding a session ticket of the server resumes with a 0-RTT handshake;
+  // the sockets cloned by a server always wait for the handshake of the client
+  uint32_t ticketVersion;
+  bool resume = m_socketState == IDLE && m_quicl4->GetSessionTicket (address, ticketVersion);
 
-  if (result != m_quicl4->GetAuthAddresses ().end ()
-      || m_quicl4->Is0RTTHandshakeAllowed ())
+  if (resume || (m_socketState == IDLE && m_quicl4->Is0RTTHandshakeAllowed ()))
     {
       NS_LOG_INFO (
-        "CONNECTION AUTHENTICATED Client found the Server " << InetSocketAddress::ConvertFrom (address).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (address).GetPort () << " in authenticated list");
+        "CONNECTION AUTHENTICATED Client found the Server " << InetSocketAddress::ConvertFrom (address).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (address).GetPort () << (resume ? " with a session ticket" : " in authenticated list"));
+      if (resume)
+        {
+          m_vers = ticketVersion;
+        }
       // connect the underlying UDP socket
       m_quicl4->UdpConnect (address, this);
 // std::cout<<"------------/////////////quicksocketbase.cc fast connect"<<std::endl;
@@ -1070,33 +1222,12 @@ int QuicSocketBase::AppendingTx (Ptr<Packet> frame)
   }
 }
 
-//ywj: test how to use extern variable
-extern Time owd_0; //owd_0 and owd_1 here are originally defined in the file 'quic-echo-helper.h'
-extern Time owd_1;
-
-extern double errorRate;
-extern DataRate bw_0;
-extern DataRate bw_1;
-
-extern uint8_t m_pktScheAlgo; //1. quic-rr (quic with round-robin), 2, mpquic-rr, 3. mpquic-ofo (our proposed scheduler for solving ofo issue)
-extern bool withMob;
-
-//external variables for video streaming test
-extern Time owd_0_vs; //owd_0 and owd_1 here are originally defined in the file 'quic-echo-helper.h'
-extern Time owd_1_vs;
-
-extern double errorRate_vs;
-extern DataRate bw_0_vs;
-extern DataRate bw_1_vs;
-
-extern uint8_t m_pktScheAlgo_vs; //1. quic-rr (quic with round-robin), 2, mpquic-rr, 3. mpquic-ofo (our proposed scheduler for solving ofo issue)
-extern bool withMob_vs;
 
 // MAMS Extension
 void QuicSocketBase::InitialBW ()
 {
-  bw_ini0 = bw_0;
-  bw_ini1 = bw_1;
+  bw_ini0 = m_bw0;
+  bw_ini1 = m_bw1;
   bwChangeCount++;
 }
 
@@ -1104,19 +1235,19 @@ void QuicSocketBase::InitialBW ()
 void QuicSocketBase::InitialExVar ()
 {
   if (m_pktScheAlgo_vs > 0) {
-    owd_0 = owd_0_vs;
-    owd_1 = owd_1_vs;
-    errorRate = errorRate_vs;
-    bw_0 = bw_0_vs;
-    bw_1 = bw_1_vs;
-    m_pktScheAlgo = m_pktScheAlgo_vs;
-    withMob = withMob_vs;
+    m_owd0 = owd_0_vs;
+    m_owd1 = owd_1_vs;
+    m_errorRate = errorRate_vs;
+    m_bw0 = bw_0_vs;
+    m_bw1 = bw_1_vs;
+    m_scheAlgo = m_pktScheAlgo_vs;
+    m_withMob = withMob_vs;
     m_subflows[0]->m_tcb->m_cWnd = m_subflows[0]->m_tcb->m_initialCWnd;
     m_subflows[0]->m_tcb->m_ssThresh = m_subflows[0]->m_tcb->m_initialSsThresh;
     m_subflows[0]->SetInitialCwnd(5840);
-    if (withMob) {
-      m_subflows[0]->RateChangeNotify(owd_0,owd_1,bw_0,bw_1);
-      m_subflows[1]->RateChangeNotify(owd_0,owd_1,bw_0,bw_1);
+    if (m_withMob) {
+      m_subflows[0]->RateChangeNotify(m_owd0,m_owd1,m_bw0,m_bw1);
+      m_subflows[1]->RateChangeNotify(m_owd0,m_owd1,m_bw0,m_bw1);
     }
     m_subflows[1]->SetInitialCwnd(m_subflows[0]->GetMinPrevLossCwnd());
   }
@@ -1128,14 +1259,14 @@ void QuicSocketBase::InitialRTT ()
 {
   if(m_subflows.size () == 1) {
     if (m_subflows[0]->lastMeasuredRtt.Get().GetMicroSeconds() == 0) {
-      m_subflows[0]->lastMeasuredRtt = 2*owd_0;
+      m_subflows[0]->lastMeasuredRtt = 2*m_owd0;
     }
   } else {
     if (m_subflows[0]->lastMeasuredRtt.Get().GetMicroSeconds() == 0) {
-      m_subflows[0]->lastMeasuredRtt = 2*owd_0;
+      m_subflows[0]->lastMeasuredRtt = 2*m_owd0;
     }
     if (m_subflows[1]->lastMeasuredRtt.Get().GetMicroSeconds() == 0) {
-      m_subflows[1]->lastMeasuredRtt = 2*owd_1;
+      m_subflows[1]->lastMeasuredRtt = 2*m_owd1;
     }
   }
 }
@@ -1146,24 +1277,46 @@ uint8_t QuicSocketBase::GetSubflowToUse ()
 	NS_LOG_FUNCTION (this);
 
   uint8_t nextSubFlow = 0;
-  switch (m_pktScheAlgo) {
+  switch (m_scheAlgo) {
+    case 0: // no MAMS scenario set the scheduler: single path QUIC
     case 1: //quic-rr (quic with round-robin)
+      if (!IsPathUsable (0)) {
+        nextSubFlow = m_pathManager->GetAlternatePath (0);
+      } else if (!IsPathPreferred (0) and IsPathPreferred (m_pathManager->GetAlternatePath (0))) {
+        nextSubFlow = m_pathManager->GetAlternatePath (0);
+      }
       break;
     case 2: // mpquic-rr
+      // the paths drained before a handover only when no other path is usable
       nextSubFlow = (m_lastUsedsFlowIdx + 1) % m_subflows.size();
+      while (!IsPathPreferred (nextSubFlow) and nextSubFlow != m_lastUsedsFlowIdx) {
+        nextSubFlow = (nextSubFlow + 1) % m_subflows.size();
+      }
+      if (!IsPathPreferred (nextSubFlow)) {
+        nextSubFlow = (m_lastUsedsFlowIdx + 1) % m_subflows.size();
+        while (!IsPathUsable (nextSubFlow) and nextSubFlow != m_lastUsedsFlowIdx) {
+          nextSubFlow = (nextSubFlow + 1) % m_subflows.size();
+        }
+      }
       std::cout<<"subflow.size == "<<(int)m_subflows.size()<<" returned path: "<<(int)nextSubFlow<<std::endl;
       break;
     case 3: // mpquic-ofo (our proposed scheduler for solving ofo issue)
     case 4: // ack returns on fastest path
     case 5: // ack returns on fastest path
-      if (m_subflows[0]->lastMeasuredRtt <= m_subflows[1]->lastMeasuredRtt and AvailableWindow(0) > GetSegSize()) {
+      if (m_subflows.size () < 2) {
+        nextSubFlow = 0;
+      } else if (!IsPathUsable (0) or !IsPathUsable (1)) {
+        nextSubFlow = IsPathUsable (0) ? 0 : 1;
+      } else if (IsPathPreferred (0) != IsPathPreferred (1)) {
+        nextSubFlow = IsPathPreferred (0) ? 0 : 1;
+      } else if (m_subflows[0]->lastMeasuredRtt <= m_subflows[1]->lastMeasuredRtt and AvailableWindow(0) > GetSegSize()) {
         nextSubFlow = 0;
       } else {
         nextSubFlow = 1;
       }
       break;
     default:
-      NS_ABORT_MSG ("The value of m_pktScheAlgo is invalid!!!");
+      NS_ABORT_MSG ("The value of m_scheAlgo is invalid!!!");
       break;
   }
   return nextSubFlow;
@@ -1197,13 +1350,10 @@ uint32_t QuicSocketBase::SendPendingData (bool withAck)
       NS_LOG_DEBUG ("Pacing Timer is not running");
     }
 
-    uint32_t win = AvailableWindow (0); //just use first subflow to deal with stream 0
-    uint32_t connWin = ConnectionWindow (0);
-    uint32_t bytesInFlight = BytesInFlight (0);
-
-    NS_LOG_DEBUG ( "BEFORE stream 0 Available Window " << win
-                                      << " Connection RWnd " << connWin
-                                      << " BytesInFlight " << bytesInFlight
+    // the windows are only computed for the log: stream 0 is not flow controlled
+    NS_LOG_DEBUG ( "BEFORE stream 0 Available Window " << AvailableWindow (0) //just use first subflow to deal with stream 0
+                                      << " Connection RWnd " << ConnectionWindow (0)
+                                      << " BytesInFlight " << BytesInFlight (0)
                                       << " BufferedSize " << m_txBuffer->AppSize ()
                                       << " MaxPacketSize " << GetSegSize ());
 
@@ -1214,18 +1364,20 @@ uint32_t QuicSocketBase::SendPendingData (bool withAck)
 
     SendDataPacket (next, 0, m_subflows[0]->m_queue_ack, 0);
 
-    win = AvailableWindow (0);
-    connWin = ConnectionWindow (0);
-    bytesInFlight = BytesInFlight (0);
-    NS_LOG_DEBUG ("AFTER stream 0 Available Window " << win
-                                          << " Connection RWnd " << connWin
-                                          << " BytesInFlight " << bytesInFlight
+    NS_LOG_DEBUG ("AFTER stream 0 Available Window " << AvailableWindow (0)
+                                          << " Connection RWnd " << ConnectionWindow (0)
+                                          << " BytesInFlight " << BytesInFlight (0)
                                           << " BufferedSize " << m_txBuffer->AppSize ()
                                           << " MaxPacketSize " << GetSegSize ());
 
     ++nPacketsSent;
   }
 
+  if (m_fluidModel != 0 && m_fluidModel->IsActive ()) {
+    NS_LOG_INFO ("Fluid mode: no data packets until the end of the fluid window");
+    return nPacketsSent;
+  }
+
   // MAMS Extension
   for (uint8_t i = 0; i < m_subflows.size(); i++) {        //ywj: must add this for loop to iterate all available paths
     uint32_t win = AvailableWindow (m_lastUsedsFlowIdx);
@@ -1463,8 +1615,11 @@ void QuicSocketBase::SendAck (uint8_t pathId)
     NS_LOG_INFO ("Send ACK packet with header " << head);
 
     //ywj: return ACK from the path with minRtt
-    if (m_pktScheAlgo == 4) {
+    if (m_scheAlgo == 4) {
       head.SetPathId (FindMinRttPath());
+    } else if (!IsPathUsable (pathId)) {
+      // the ACK frame still refers to pathId, only the carrying path changes
+      head.SetPathId (m_pathManager->GetAlternatePath (pathId));
     } else {
       head.SetPathId(pathId);
     }
@@ -1482,6 +1637,36 @@ void QuicSocketBase::SendAck (uint8_t pathId)
   }
 }
 
+void
+QuicSocketBase::PiggybackAcks (Ptr<Packet> p, const QuicHeader &head, bool withAck)
+{
+  NS_LOG_FUNCTION (this << head << withAck);
+
+  uint8_t pathId = head.GetPathId ();
+  for (uint8_t i = 0; i < m_subflows.size (); i++)
+    {
+      Ptr<MpQuicSubFlow> sFlow = m_subflows[i];
+      // the frames of the handshake packets are not all processed: keep the pending ACKs for a short packet
+      bool pending = m_piggybackAcks && head.IsShort () && (sFlow->m_sendAckEvent.IsRunning () || sFlow->m_delAckEvent.IsRunning ());
+      if ((!pending && !(withAck && i == pathId))
+          || sFlow->m_receivedSeqNumbers.empty () || sFlow->m_receivedPacketNumbers.empty ())
+        {
+          continue;
+        }
+      // the ACK frame carries its path, and the MAX_DATA frame when it is due
+      p->AddAtEnd (OnSendingAckFrame (i));
+      if (pending)
+        {
+          NS_LOG_INFO ("Piggyback the ACK of path " << (uint32_t) i << " instead of sending it alone");
+          sFlow->m_delAckEvent.Cancel ();
+          sFlow->m_sendAckEvent.Cancel ();
+          sFlow->m_queue_ack = false;
+          sFlow->m_numPacketsReceivedSinceLastAckSent = 0;
+          sFlow->m_receivedSeqNumbers.clear ();
+        }
+    }
+}
+
 // uint32_t
 // QuicSocketBase::SendDataPacket (SequenceNumber32 packetNumber,
 //                                 uint32_t maxSize, bool withAck)
@@ -1519,7 +1704,7 @@ uint32_t QuicSocketBase::SendDataPacket (SequenceNumber32 packetNumber, uint32_t
   Ptr<Packet> p;
 
   if(m_txBuffer->GetNumFrameStream0InBuffer () > 0) {
-    p = m_txBuffer->NextStream0Sequence (packetNumber);
+    p = m_txBuffer->NextStream0Sequence (packetNumber, GetSegSize ());
     NS_ABORT_MSG_IF (p == 0, "No packet for stream 0 in the buffer!");
   } else {
       NS_LOG_LOGIC(this << " SendDataPacket - sending packet " << packetNumber.GetValue () << " of size " << maxSize << " at time " << Simulator::Now ().GetSeconds ());
@@ -1528,64 +1713,12 @@ uint32_t QuicSocketBase::SendDataPacket (SequenceNumber32 packetNumber, uint32_t
         //std::cout<<"debug\n";
       }
 
-      switch (m_pktScheAlgo) {
-      case 3:
-      case 4:
-      case 5: { //represents MPTCP-LATE
-          InitialRTT ();
-          uint8_t nextId = (pathId + 1) % m_subflows.size();
-          // std::cout<<"QuicSocketBase::SendDataPacket \n current path "<<(int)pathId<<" rtt: "<<m_subflows[pathId]->lastMeasuredRtt
-          //     <<" next path "<<(int)nextId<<" rtt:  "<<m_subflows[nextId]->lastMeasuredRtt<<std::endl;
-
-          m_isFast = (m_subflows[pathId]->lastMeasuredRtt <= m_subflows[nextId]->lastMeasuredRtt) ? true : false;
-
-          int fastId;
-          if (!m_isFast) fastId = nextId;
-          else fastId = pathId;
-
-          if (m_QUpdate) {
-            TDiff = std::max (m_subflows[0]->lastMeasuredRtt,m_subflows[1]->lastMeasuredRtt).Get().GetMicroSeconds ()/2;
-            double fast_rtt = m_subflows[fastId]->lastMeasuredRtt.Get().GetMicroSeconds();
-            double fast_rto = m_subflows[fastId]->m_rto.Get().GetMicroSeconds();
-            if (TDiff / fast_rtt > 10) { //ywj: we don't hope the ratio is too large
-              TDiff = std::max(owd_0,owd_1).GetMicroSeconds ();
-              fast_rtt = std::min(owd_0,owd_1).GetMicroSeconds ()*2;
-            }
-            if (withMob && (m_pktScheAlgo == 3 || m_pktScheAlgo == 4)) {
-              Q = TotalData (TDiff, fastId, m_subflows[fastId]->m_cWnd / 1460, m_subflows[fastId]->m_ssThresh, errorRate, 1, fast_rtt, fast_rto);
-            } else if (withMob && m_pktScheAlgo == 5) {  // under mobility scenario, we map the error rate to the mobility speed, cuz LATE is unaware of mobility,
-                                                         // so set error rate to 0
-              Q = TotalData_noBWLimit (TDiff, fastId, m_subflows[fastId]->m_cWnd / 1460, m_subflows[fastId]->m_ssThresh, 0, 1, fast_rtt, fast_rto);
-            } else {
-              Q = TotalData_noBWLimit (TDiff, fastId, m_subflows[fastId]->m_cWnd / 1460, m_subflows[fastId]->m_ssThresh, errorRate, 1, fast_rtt, fast_rto);
-            }
-              // std::cout<<"----Q: "<<Q
-              //           <<" TDiff: "<<TDiff
-              //           <<" fast_rtt: "<<fast_rtt
-              //           <<" fast_rto: "<<fast_rto<<std::endl;
-              //std::cout<<"----Q: "<<Q<<std::endl;
-            IntQ = (Q / 1460)*1460;
-          }
-          if (!m_isFast) {
-            slowPathId = pathId;
-            std::cout << Simulator::Now().GetSeconds() <<" IntQ: "<<IntQ<<" leftSIze "
-                      <<m_txBuffer->FileSize()<<" sizeONslow: "<<m_txBuffer->SizeOnSlowPath() << std::endl;
-            if (IntQ >= m_txBuffer->FileSize() || IntQ >= m_txBuffer->SizeOnSlowPath()) {
-              blockSlowPath = true;
-              m_lastUsedsFlowIdx = (pathId + 1) % m_subflows.size();
-              return 0;
-            } else {
-              blockSlowPath = false;
-            }
-          }
-        }
-        break;
-      default:
-        break;
+      if (!UpdateScheduleState (pathId)) {
+        return 0;
       }
       //if (m_pktScheAlgo == 3 || m_pktScheAlgo == 4)
 
-      p = m_txBuffer->NextSequence (maxSize, packetNumber, pathId, IntQ, m_isFast, m_QUpdate, m_pktScheAlgo);
+      p = m_txBuffer->NextSequence (maxSize, packetNumber, pathId, IntQ, m_isFast, m_QUpdate, m_scheAlgo);
       m_QUpdate = false;
 
     }
@@ -1618,12 +1751,6 @@ uint32_t QuicSocketBase::SendDataPacket (SequenceNumber32 packetNumber, uint32_t
 
   bool isAckOnly = ((sz == 0) & (withAck));
 
-  if (withAck && !sFlow->m_receivedSeqNumbers.empty() && !m_subflows[pathId]->m_receivedPacketNumbers.empty ())
-    {
-      p->AddAtEnd (OnSendingAckFrame (pathId));
-    }
-
-
   QuicHeader head;
 
   if (m_socketState == CONNECTING_SVR)
@@ -1640,13 +1767,13 @@ uint32_t QuicSocketBase::SendDataPacket (SequenceNumber32 packetNumber, uint32_t
     {
 
 
-      if (!m_connected and !m_quicl4->Is0RTTHandshakeAllowed ())
+      if (!m_connected and !m_0RTTHandshake)
         {
           m_connected = true;
           head = QuicHeader::CreateHandshake (m_connectionId, m_vers,
                                               packetNumber);
         }
-      else if (!m_connected and m_quicl4->Is0RTTHandshakeAllowed ())
+      else if (!m_connected and m_0RTTHandshake)
         {
           head = QuicHeader::Create0RTT (m_connectionId, m_vers,
                                          packetNumber);
@@ -1689,6 +1816,13 @@ uint32_t QuicSocketBase::SendDataPacket (SequenceNumber32 packetNumber, uint32_t
   // packetSent->AddAtEnd (p);
   sFlow->Add(head.GetSeq());
 
+  if (m_piggybackAcks)
+    {
+      // p is the frame kept by the TX buffer for retransmission: the ACKs go on a copy
+      p = p->Copy ();
+    }
+  PiggybackAcks (p, head, withAck);
+
   m_quicl4->SendPacket (this, p, head);
   m_txTrace (p, head, this);
   NotifyDataSent (sz);
@@ -1708,6 +1842,75 @@ uint32_t QuicSocketBase::SendDataPacket (SequenceNumber32 packetNumber, uint32_t
   return sz;
 }
 
+bool
+QuicSocketBase::UpdateScheduleState (int pathId)
+{
+  NS_LOG_FUNCTION (this << pathId);
+  switch (m_scheAlgo) {
+  case 3:
+  case 4:
+  case 5: { //represents MPTCP-LATE
+      InitialRTT ();
+      uint8_t nextId = (pathId + 1) % m_subflows.size();
+      if (nextId == pathId || !IsPathUsable (nextId)) {
+        // single path, before the ANNOUNCE of a 0-RTT connection, or single
+        // surviving path: no out-of-order control needed
+        m_isFast = true;
+        blockSlowPath = false;
+        break;
+      }
+      // std::cout<<"QuicSocketBase::SendDataPacket \n current path "<<(int)pathId<<" rtt: "<<m_subflows[pathId]->lastMeasuredRtt
+      //     <<" next path "<<(int)nextId<<" rtt:  "<<m_subflows[nextId]->lastMeasuredRtt<<std::endl;
+
+      m_isFast = (m_subflows[pathId]->lastMeasuredRtt <= m_subflows[nextId]->lastMeasuredRtt) ? true : false;
+
+      int fastId;
+      if (!m_isFast) fastId = nextId;
+      else fastId = pathId;
+
+      if (m_QUpdate) {
+        TDiff = std::max (m_subflows[0]->lastMeasuredRtt,m_subflows[1]->lastMeasuredRtt).Get().GetMicroSeconds ()/2;
+        double fast_rtt = m_subflows[fastId]->lastMeasuredRtt.Get().GetMicroSeconds();
+        double fast_rto = m_subflows[fastId]->m_rto.Get().GetMicroSeconds();
+        if (TDiff / fast_rtt > 10) { //ywj: we don't hope the ratio is too large
+          TDiff = std::max(m_owd0,m_owd1).GetMicroSeconds ();
+          fast_rtt = std::min(m_owd0,m_owd1).GetMicroSeconds ()*2;
+        }
+        if (m_withMob && (m_scheAlgo == 3 || m_scheAlgo == 4)) {
+          Q = TotalData (TDiff, fastId, m_subflows[fastId]->m_cWnd / 1460, m_subflows[fastId]->m_ssThresh, m_errorRate, 1, fast_rtt, fast_rto);
+        } else if (m_withMob && m_scheAlgo == 5) {  // under mobility scenario, we map the error rate to the mobility speed, cuz LATE is unaware of mobility,
+                                                     // so set error rate to 0
+          Q = TotalData_noBWLimit (TDiff, fastId, m_subflows[fastId]->m_cWnd / 1460, m_subflows[fastId]->m_ssThresh, 0, 1, fast_rtt, fast_rto);
+        } else {
+          Q = TotalData_noBWLimit (TDiff, fastId, m_subflows[fastId]->m_cWnd / 1460, m_subflows[fastId]->m_ssThresh, m_errorRate, 1, fast_rtt, fast_rto);
+        }
+          // std::cout<<"----Q: "<<Q
+          //           <<" TDiff: "<<TDiff
+          //           <<" fast_rtt: "<<fast_rtt
+          //           <<" fast_rto: "<<fast_rto<<std::endl;
+          //std::cout<<"----Q: "<<Q<<std::endl;
+        IntQ = (Q / 1460)*1460;
+      }
+      if (!m_isFast) {
+        slowPathId = pathId;
+        std::cout << Simulator::Now().GetSeconds() <<" IntQ: "<<IntQ<<" leftSIze "
+                  <<m_txBuffer->FileSize()<<" sizeONslow: "<<m_txBuffer->SizeOnSlowPath() << std::endl;
+        if (IntQ >= m_txBuffer->FileSize() || IntQ >= m_txBuffer->SizeOnSlowPath()) {
+          blockSlowPath = true;
+          m_lastUsedsFlowIdx = (pathId + 1) % m_subflows.size();
+          return false;
+        } else {
+          blockSlowPath = false;
+        }
+      }
+    }
+    break;
+  default:
+    break;
+  }
+  return true;
+}
+
 //ywj: SetReTxTimeout () => SetReTxTimeout (uint8_t pathId)
 
 /* void
@@ -1795,6 +1998,12 @@ void QuicSocketBase::SetReTxTimeout (uint8_t pathId)
   //TODO check for special packets
   NS_LOG_FUNCTION (this);
 
+  if (!IsPathUsable (pathId))
+    {
+      m_subflows[pathId]->m_tcb->m_lossDetectionAlarm.Cancel ();
+      return;
+    }
+
   // Don't arm the alarm if there are no packets with retransmittable data in flight.
   //if (numRetransmittablePacketsOutstanding == 0)
   if (false)
@@ -1868,6 +2077,9 @@ void QuicSocketBase::SetReTxTimeout (uint8_t pathId)
 void QuicSocketBase::DoRetransmit (std::vector<Ptr<QuicSocketTxItem> > lostPackets, uint8_t pathId)
 {
   NS_LOG_FUNCTION (this);
+  if (m_fluidModel != 0) {
+    m_fluidModel->NotifyLoss (pathId);
+  }
   // Get packets to retransmit
   SequenceNumber32 next = ++m_subflows[pathId]->m_nextPktNum;
   uint32_t toRetx = m_txBuffer->Retransmission (next, pathId);
@@ -1891,7 +2103,7 @@ void QuicSocketBase::DoRetransmit (std::vector<Ptr<QuicSocketTxItem> > lostPacke
             <<" QuicSocketBase::DoRetransmit "
             <<"Retransmitted packet, next sequence number " << m_subflows[pathId]->m_nextPktNum<<std::endl;
 
-  if (m_pktScheAlgo == 3 || m_pktScheAlgo == 4)
+  if (m_scheAlgo == 3 || m_scheAlgo == 4)
     {
       SendDataPacket (next, toRetx, m_connected, pathId);
     }
@@ -1912,6 +2124,21 @@ void QuicSocketBase::ReTxTimeout (uint8_t pathId)
     }
   NS_LOG_FUNCTION (this);
   NS_LOG_INFO ("ReTxTimeout Expired at time " << Simulator::Now ().GetSeconds ());
+  if (!IsPathUsable (pathId))
+    {
+      NS_LOG_INFO ("Path " << (uint32_t) pathId << " has been removed");
+      return;
+    }
+  // Repeated TLP/RTO expirations with data in flight: let the path manager
+  // fail the path and reinject its data instead of backing off further
+  if (m_pathManager != 0
+      && (m_subflows[pathId]->m_tcb->m_alarmType == 2 || m_subflows[pathId]->m_tcb->m_alarmType == 3)
+      && BytesInFlight (pathId) > 0
+      && m_pathManager->NotifyTimeout (pathId))
+    {
+      NS_LOG_INFO ("Path " << (uint32_t) pathId << " failed on probe timeout");
+      return;
+    }
   // Handshake packets are outstanding)
   if (m_subflows[pathId]->m_tcb->m_alarmType == 0 && (m_socketState == CONNECTING_CLT || m_socketState == CONNECTING_SVR))
     {
@@ -2006,6 +2233,11 @@ uint32_t QuicSocketBase::AvailableWindow (uint8_t pathId)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_DEBUG ("m_max_data " << m_max_data << " m_tcb->m_cWnd.Get () " << m_subflows[pathId]->m_tcb->m_cWnd.Get ());
+  if (!IsPathUsable (pathId))
+    {
+      NS_LOG_INFO ("Path " << (uint32_t) pathId << " has been removed, availWin=0");
+      return 0;
+    }
   // uint32_t win = std::min (m_max_data, m_tcb->m_cWnd.Get ());   // Number of bytes allowed to be outstanding
 
   uint32_t win = std::min (m_max_data, m_subflows[pathId]->m_cWnd.Get());
@@ -2474,18 +2706,8 @@ QuicSocketBase::SendInitialHandshake (uint8_t type,
   else if (type == QuicHeader::INITIAL)
     {
       //client(sender)
-      // Set initial congestion window and Ssthresh
-      m_subflows[0]->m_tcb->m_cWnd = m_subflows[0]->m_tcb->m_initialCWnd;
-      m_subflows[0]->m_tcb->m_ssThresh = m_subflows[0]->m_tcb->m_initialSsThresh;
-      // Set initial congestion window and Ssthresh for sub flow
-      m_subflows[0]->SetInitialCwnd(5840);
-      //m_subflows[0]->InitialRateEvent();
-      if (withMob) m_subflows[0]->RateChangeNotify(owd_0,owd_1,bw_0,bw_1);
-      // m_subflows[0]->m_ssThresh = m_tcb->m_initialSsThresh;
-      bool x = m_subflows[0]->TraceConnectWithoutContext ("SubflowCwnd", MakeCallback (&QuicSocketBase::TraceCwnd0,this));
-      m_subflows[0]->TraceConnectWithoutContext ("Throughput", MakeCallback (&QuicSocketBase::TraceThroughput0,this));
-      m_subflows[0]->TraceConnectWithoutContext ("RTT", MakeCallback (&QuicSocketBase::TraceRTT0, this));
-      NS_LOG_INFO ("Create INITIAL"<<x);
+      InitializeFirstSubflow ();
+      NS_LOG_INFO ("Create INITIAL");
       Ptr<Packet> p = Create<Packet> ();
       p->AddHeader (OnSendingTransportParameters ());
       // the RFC says that
@@ -2529,6 +2751,7 @@ QuicSocketBase::SendInitialHandshake (uint8_t type,
   else if (type == QuicHeader::ZRTT_PROTECTED)
     {
       NS_LOG_INFO ("Create ZRTT_PROTECTED");
+      InitializeFirstSubflow ();
       Ptr<Packet> p = Create<Packet> ();
       p->AddHeader (OnSendingTransportParameters ());
 
@@ -2574,7 +2797,7 @@ QuicSocketBase::SendInitialHandshake (uint8_t type,
       // packetSent->AddAtEnd (p);
       m_subflows[1]->Add(head.GetSeq());
       //m_subflows[1]->InitialRateEvent(bw_1);
-      if (withMob) m_subflows[1]->RateChangeNotify(owd_0,owd_1,bw_0,bw_1);
+      if (m_withMob) m_subflows[1]->RateChangeNotify(m_owd0,m_owd1,m_bw0,m_bw1);
       // Set initial congestion window and Ssthresh for sub flow
       m_subflows[1]->SetInitialCwnd(m_subflows[0]->GetMinPrevLossCwnd());
 
@@ -2638,7 +2861,7 @@ QuicSocketBase::OnReceivedFrame (QuicSubheader &sub)
         break;
 
       case QuicSubheader::PING:
-        // TODO
+        // PING is ACK-eliciting: ReceivedData queues the ACK on the path
         NS_LOG_INFO ("Received PING frame");
         break;
 
@@ -2658,16 +2881,26 @@ QuicSocketBase::OnReceivedFrame (QuicSubheader &sub)
         break;
 
       case QuicSubheader::PATH_CHALLENGE:
-        // TODO reply with a PATH_RESPONSE with the same value
-        // as that carried by the PATH_CHALLENGE
+        // echo the data on the path the challenge came from
         NS_LOG_INFO ("Received PATH_CHALLENGE frame");
+        SendPathFrame (m_rxPathId, QuicSubheader::CreatePathResponse (sub.GetData ()));
         break;
 
       case QuicSubheader::PATH_RESPONSE:
-        // TODO check if it matches what was sent in a PATH_CHALLENGE
-        // otherwise abort with a UNSOLICITED_PATH_RESPONSE error
-        NS_LOG_INFO ("Received PATH_RESPONSE frame");
-        break;
+        {
+          NS_LOG_INFO ("Received PATH_RESPONSE frame");
+          std::map<uint8_t, std::pair<Address, uint8_t> >::iterator it = m_pathValidations.find (m_rxPathId);
+          if (it == m_pathValidations.end () || it->second.second != sub.GetData ())
+            {
+              // the response may belong to a challenge already answered: ignore it
+              NS_LOG_WARN ("Unsolicited PATH_RESPONSE on path " << (uint32_t) m_rxPathId);
+              break;
+            }
+          Address peer = it->second.first;
+          m_pathValidations.erase (it);
+          RebindPath (m_rxPathId, peer);
+          break;
+        }
 
       default:
         AbortConnection (
@@ -2773,6 +3006,11 @@ QuicSocketBase::OnReceivedAckFrame (QuicSubheader &sub)
   Time ackDelay = MicroSeconds (sub.GetAckDelay ());
   uint8_t pathId = sub.GetPathId();
 
+  // the peer received data sent on this path, so the path is alive
+  if (m_pathManager != 0) {
+    m_pathManager->NotifyPathActivity (pathId);
+  }
+
   // ywj: as long as the ack of path0 and path1 are both received, refresh Q
 /*   if(ackedPathList.empty())
     {
@@ -2867,6 +3105,10 @@ QuicSocketBase::OnReceivedAckFrame (QuicSubheader &sub)
 
   // m_subflows[sub.GetPathId()]->UpdateSsThresh(ue_sinr[sub.GetPathId()],ue_Bmin[sub.GetPathId()]);
   m_subflows[pathId]->CwndOnAckReceived(alpha, sum_rate, max_rate, ackedPackets,ackedBytes);
+  if (m_fluidModel != 0 && ackedBytes > 0) {
+    m_fluidModel->NotifyAck (pathId, m_subflows[pathId]->m_cWnd, m_subflows[pathId]->m_ssThresh,
+                             m_subflows[pathId]->lastMeasuredRtt, ackedBytes);
+  }
 
   m_txBuffer->GenerateRateSample ();
   rs->m_packetLoss = std::abs ((int) lostOut - (int) m_txBuffer->GetLost (pathId));
@@ -3182,6 +3424,7 @@ QuicSocketBase::DoFastConnect (void)
 
   else if (m_socketState == IDLE)
     {
+      m_0RTTHandshake = true;
       SetState (OPEN);
       Simulator::ScheduleNow (&QuicSocketBase::ConnectionSucceeded, this);
       m_congestionControl->CongestionStateSet (m_subflows[0]->m_tcb,
@@ -3274,10 +3517,29 @@ void QuicSocketBase::ReceivedData (Ptr<Packet> p, const QuicHeader& quicHeader,
     return;
   }
 
+  if (m_pathManager != 0) {
+    m_pathManager->NotifyPathActivity (pathId);
+  }
+
+  m_rxPathId = pathId;
+  if (pathId < (int) m_subflows.size () && quicHeader.GetPacketNumber () > m_subflows[pathId]->m_largestRxPacket) {
+    m_subflows[pathId]->m_largestRxPacket = quicHeader.GetPacketNumber ();
+    // a reordered packet does not move the path back to an older address
+    if (quicHeader.IsShort () && m_socketState == OPEN) {
+      CheckPeerAddress (pathId, address);
+    }
+  }
+
+  // after a 0-RTT handshake, the first packet of the server confirms the connection
+  if (m_0RTTHandshake and m_socketState == OPEN and m_subflows.size () == 1) {
+    StartMultipath ();
+  }
+
   int onlyAckFrames = 0;
   bool unsupportedVersion = false;
 
-  if (quicHeader.IsORTT () and m_socketState == LISTENING) {
+  // the socket cloned for a 0-RTT connection has already asked the application in DoConnect
+  if (quicHeader.IsORTT () and (m_socketState == LISTENING or m_socketState == CONNECTING_SVR)) {
     if (m_serverBusy)
 /*         {
         AbortConnection (QuicSubheader::TransportErrorCodes_t::SERVER_BUSY,
@@ -3287,7 +3549,7 @@ void QuicSocketBase::ReceivedData (Ptr<Packet> p, const QuicHeader& quicHeader,
     {
       AbortConnection (QuicSubheader::TransportErrorCodes_t::SERVER_BUSY, "Server too busy to accept new connections");
       return;
-    } else if (!NotifyConnectionRequest(address)) {
+    } else if (m_socketState == LISTENING and !NotifyConnectionRequest(address)) {
       NS_LOG_DEBUG("Server application declined connection.");
       return;
     }
@@ -3355,12 +3617,9 @@ void QuicSocketBase::ReceivedData (Ptr<Packet> p, const QuicHeader& quicHeader,
     Simulator::ScheduleNow(&QuicSocketBase::ConnectionSucceeded, this);
     m_congestionControl->CongestionStateSet (m_subflows[0]->m_tcb, TcpSocketState::CA_OPEN);
     m_couldContainTransportParameters = false;
-    //create subflow
+    m_quicl4->AddSessionTicket (address, m_vers);
     SendInitialHandshake (QuicHeader::HANDSHAKE, quicHeader, p);
-    SendInitialHandshake (QuicHeader::ANNOUNCE, quicHeader, p);
-    // m_sendAnnounce = true;
-    // MAMS Extension - Scheduler Created Here
-    CreateScheduler();
+    StartMultipath ();
 
     return;
   } else if (quicHeader.IsHandshake () and m_socketState == CONNECTING_SVR) {
@@ -3378,6 +3637,7 @@ void QuicSocketBase::ReceivedData (Ptr<Packet> p, const QuicHeader& quicHeader,
     m_subflows[pathId]->m_receivedSeqNumbers.push_back (quicHeader.GetSeq ());
 
     SetState (OPEN);
+    m_quicl4->AddSessionTicket (address, quicHeader.GetVersion ());
     // Simulator::ScheduleNow (&QuicSocketBase::ConnectionSucceeded, this);
     NotifyNewConnectionCreated(this, address);
     m_congestionControl->CongestionStateSet (m_subflows[0]->m_tcb,
@@ -3434,6 +3694,8 @@ void QuicSocketBase::ReceivedData (Ptr<Packet> p, const QuicHeader& quicHeader,
     // MAMS Extension - Scheduler Created Here
     NS_LOG_INFO ("Server receives ANNOUNCE");
     CreateScheduler();
+    InitializePathManager ();
+    InitializeFluidModel ();
     return;
   } else if (quicHeader.IsShort () and (m_socketState == OPEN || m_socketState == CONNECTING_SVR)) {
     // ywj: the origin condition is quicHeader.IsShort () and (m_socketState == OPEN)
@@ -3866,6 +4128,12 @@ uint8_t QuicSocketBase::LookUpByAddr (Address &address)
     if (exVarChangeCount == 0) {
       InitialExVar ();
     }
+    if (m_pathManager != 0) {
+      m_pathManager->AddPath (sFlowIdx);
+    }
+    if (m_fluidModel != 0) {
+      m_fluidModel->AddPath (sFlowIdx);
+    }
 
     // Set initial congestion window and Ssthresh for sub flow
     // m_subflows[1]->m_cWnd = m_tcb->m_initialCWnd;
@@ -3877,6 +4145,37 @@ uint8_t QuicSocketBase::LookUpByAddr (Address &address)
   return sFlowIdx;
 }
 
+void
+QuicSocketBase::InitializeFirstSubflow ()
+{
+  NS_LOG_FUNCTION (this);
+  // Set initial congestion window and Ssthresh
+  m_subflows[0]->m_tcb->m_cWnd = m_subflows[0]->m_tcb->m_initialCWnd;
+  m_subflows[0]->m_tcb->m_ssThresh = m_subflows[0]->m_tcb->m_initialSsThresh;
+  // Set initial congestion window and Ssthresh for sub flow
+  m_subflows[0]->SetInitialCwnd(5840);
+  //m_subflows[0]->InitialRateEvent();
+  if (m_withMob) m_subflows[0]->RateChangeNotify(m_owd0,m_owd1,m_bw0,m_bw1);
+  // m_subflows[0]->m_ssThresh = m_tcb->m_initialSsThresh;
+  m_subflows[0]->TraceConnectWithoutContext ("SubflowCwnd", MakeCallback (&QuicSocketBase::TraceCwnd0,this));
+  m_subflows[0]->TraceConnectWithoutContext ("Throughput", MakeCallback (&QuicSocketBase::TraceThroughput0,this));
+  m_subflows[0]->TraceConnectWithoutContext ("RTT", MakeCallback (&QuicSocketBase::TraceRTT0, this));
+}
+
+void
+QuicSocketBase::StartMultipath ()
+{
+  NS_LOG_FUNCTION (this);
+  //create subflow
+  QuicHeader q;
+  SendInitialHandshake (QuicHeader::ANNOUNCE, q, 0);
+  // m_sendAnnounce = true;
+  // MAMS Extension - Scheduler Created Here
+  CreateScheduler();
+  InitializePathManager ();
+  InitializeFluidModel ();
+}
+
 void
 QuicSocketBase::CreateScheduler ()
 {
@@ -3884,15 +4183,458 @@ QuicSocketBase::CreateScheduler ()
   m_scheduler = CreateObject<QuicScheduler> ();
 }
 
+void
+QuicSocketBase::InitializePathManager ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_enablePathManager || m_pathManager != 0)
+    {
+      return;
+    }
+  m_pathManager = CreateObject<MpQuicPathManager> ();
+  m_pathManager->SetSocket (this);
+  for (uint8_t i = 0; i < m_subflows.size (); i++)
+    {
+      m_pathManager->AddPath (i);
+    }
+  m_pathManager->Start ();
+}
+
+void
+QuicSocketBase::InitializeFluidModel ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_enableFluidModel || m_fluidModel != 0)
+    {
+      return;
+    }
+  m_fluidModel = CreateObject<MpQuicFluidModel> ();
+  m_fluidModel->SetSocket (this);
+  for (uint8_t i = 0; i < m_subflows.size (); i++)
+    {
+      m_fluidModel->AddPath (i);
+    }
+  CriticalSection cs (g_fluidEndsMutex);
+  g_fluidEnds.insert (std::make_pair (m_connectionId, this));
+}
+
+Ptr<QuicSocketBase>
+QuicSocketBase::FindPeerSocket (void) const
+{
+  NS_LOG_FUNCTION (this);
+  CriticalSection cs (g_fluidEndsMutex);
+  auto range = g_fluidEnds.equal_range (m_connectionId);
+  for (auto it = range.first; it != range.second; ++it)
+    {
+      if (it->second->m_node != m_node)
+        {
+          return it->second;
+        }
+    }
+  return 0;
+}
+
+void
+QuicSocketBase::UnregisterFluidEnd (void)
+{
+  NS_LOG_FUNCTION (this);
+  CriticalSection cs (g_fluidEndsMutex);
+  auto range = g_fluidEnds.equal_range (m_connectionId);
+  for (auto it = range.first; it != range.second; ++it)
+    {
+      if (it->second == this)
+        {
+          g_fluidEnds.erase (it);
+          return;
+        }
+    }
+}
+
+uint32_t
+QuicSocketBase::FastForwardData (uint8_t pathId, uint32_t numBytes, Time delay)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << numBytes << delay);
+
+  if (m_socketState != OPEN || m_drainingPeriodEvent.IsRunning ()
+      || m_txBuffer->GetNumFrameStream0InBuffer () > 0 || !IsPathUsable (pathId))
+    {
+      return 0;
+    }
+  if (m_fluidPeer == 0)
+    {
+      m_fluidPeer = FindPeerSocket ();
+      if (m_fluidPeer == 0)
+        {
+          NS_LOG_INFO ("No peer socket found, cannot fast-forward");
+          return 0;
+        }
+    }
+  if (m_txBuffer->AppSize () < numBytes and !m_closeOnEmpty)
+    {
+      NotifySend (GetTxAvailable ());
+    }
+  if (m_txBuffer->AppSize () == 0)
+    {
+      return 0;
+    }
+
+  // a fluid round stands for the ACKs of one RTT of the path
+  if (pathId == slowPathId)
+    {
+      m_QUpdate = true;
+    }
+  // the scheduler hands out at most one segment at a time
+  uint32_t sent = 0;
+  while (sent < numBytes)
+    {
+      if (!UpdateScheduleState (pathId))
+        {
+          break;
+        }
+      uint32_t s = std::min (numBytes - sent, GetSegSize ());
+      Ptr<Packet> p = m_txBuffer->NextFluidSequence (s, pathId, IntQ, m_isFast, m_QUpdate, m_scheAlgo);
+      m_QUpdate = false;
+
+      uint32_t sz = p->GetSize ();
+      if (sz == 0)
+        {
+          break;
+        }
+      sent += sz;
+      NotifyDataSent (sz);
+      // in the context of the peer, which the multithreaded simulator may run on another thread
+      Simulator::ScheduleWithContext (m_fluidPeer->GetNode ()->GetId (), delay,
+                                      &QuicSocketBase::ReceivedFluidData, m_fluidPeer, p, pathId);
+    }
+  if (sent > 0)
+    {
+      m_idleTimeoutEvent.Cancel ();
+      m_idleTimeoutEvent = Simulator::Schedule (m_idleTimeout, &QuicSocketBase::Close, this);
+    }
+  return sent;
+}
+
+void
+QuicSocketBase::ReceivedFluidData (Ptr<Packet> p, uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << p->GetSize () << (uint32_t) pathId);
+  if (m_socketState != OPEN || m_drainingPeriodEvent.IsRunning ())
+    {
+      return;
+    }
+  m_idleTimeoutEvent.Cancel ();
+  m_idleTimeoutEvent = Simulator::Schedule (m_idleTimeout, &QuicSocketBase::Close, this);
+
+  Address address = InetSocketAddress (m_subflows[pathId]->sAddr, m_subflows[pathId]->sPort);
+  m_quicl5->DispatchRecv (p, address);
+}
+
+void
+QuicSocketBase::ResumePacketLevel (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint8_t i = 0; i < m_subflows.size (); i++)
+    {
+      if (IsPathUsable (i))
+        {
+          m_subflows[i]->m_cWnd = std::max (m_fluidModel->GetCwnd (i), GetSegSize ());
+        }
+    }
+  m_QUpdate = true;
+  if (m_socketState == OPEN)
+    {
+      SendPendingData (m_connected);
+    }
+}
+
+bool
+QuicSocketBase::IsPathUsable (uint8_t pathId) const
+{
+  return m_pathManager == 0 || m_pathManager->IsPathUsable (pathId);
+}
+
+DataRate
+QuicSocketBase::GetLinkRate (uint8_t pathId) const
+{
+  if (pathId == 0)
+    {
+      return m_bw0;
+    }
+  else if (pathId == 1)
+    {
+      return m_bw1;
+    }
+  return DataRate (0);
+}
+
+bool
+QuicSocketBase::IsPathPreferred (uint8_t pathId) const
+{
+  return IsPathUsable (pathId) && (m_pathManager == 0 || !m_pathManager->IsPathDraining (pathId));
+}
+
+Time
+QuicSocketBase::SeedPathRtt (uint8_t pathId, Time rttChange)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << rttChange);
+  NS_ASSERT (pathId < m_subflows.size ());
+
+  Ptr<MpQuicSubFlow> sFlow = m_subflows[pathId];
+  if (sFlow->lastMeasuredRtt.Get ().IsZero ())
+    {
+      return Time (0);
+    }
+  Ptr<QuicSocketState> tcb = sFlow->m_tcb;
+  sFlow->lastMeasuredRtt = std::max (Time (0), sFlow->lastMeasuredRtt.Get () + rttChange);
+  // the estimates of the congestion control only move if they hold samples
+  if (!tcb->m_smoothedRtt.IsZero ())
+    {
+      tcb->m_latestRtt = std::max (Time (0), tcb->m_latestRtt + rttChange);
+      tcb->m_smoothedRtt = std::max (Time (0), tcb->m_smoothedRtt + rttChange);
+      tcb->m_minRtt = std::max (Time (0), tcb->m_minRtt + rttChange);
+    }
+  if (sFlow->m_rtt->GetNSamples () > 0)
+    {
+      Time estimate = std::max (Time (0), sFlow->m_rtt->GetEstimate () + rttChange);
+      sFlow->m_rtt->Reset ();
+      sFlow->m_rtt->Measurement (estimate);
+    }
+  // the probe and loss timers of the data in flight follow the new RTT
+  if (tcb->m_lossDetectionAlarm.IsRunning ())
+    {
+      tcb->m_lossDetectionAlarm.Cancel ();
+      SetReTxTimeout (pathId);
+    }
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " RTT seeded to " << sFlow->lastMeasuredRtt
+                       << ", loss detection alarm in " << sFlow->m_rto);
+  return sFlow->lastMeasuredRtt;
+}
+
+uint32_t
+QuicSocketBase::RemoveSubflow (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  NS_ASSERT (pathId < m_subflows.size ());
+
+  Ptr<MpQuicSubFlow> sFlow = m_subflows[pathId];
+  sFlow->m_tcb->m_lossDetectionAlarm.Cancel ();
+  sFlow->m_sendAckEvent.Cancel ();
+  sFlow->m_delAckEvent.Cancel ();
+
+  // hand the frames still in flight on the dead path back to the scheduler,
+  // instead of waiting for the RTO backoff to declare them lost one by one
+  uint32_t reinjected = m_txBuffer->ReinjectSubflow (sFlow->m_nextPktNum, pathId);
+  NS_LOG_INFO ("Removed subflow " << (uint32_t) pathId << ", " << reinjected << " bytes reinjected");
+
+  if (m_lastUsedsFlowIdx == pathId)
+    {
+      m_lastUsedsFlowIdx = m_pathManager->GetAlternatePath (pathId);
+    }
+  if (slowPathId == pathId)
+    {
+      blockSlowPath = false;
+    }
+  m_QUpdate = true;
+
+  if (m_socketState == OPEN)
+    {
+      SendPendingData (m_connected);
+    }
+  return reinjected;
+}
+
+void
+QuicSocketBase::SendPing (uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  SendPathFrame (pathId, QuicSubheader::CreatePing ());
+}
+
+void
+QuicSocketBase::SendPathFrame (uint8_t pathId, const QuicSubheader &frame, const Address &to)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << to);
+  NS_ASSERT (pathId < m_subflows.size ());
+
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (frame);
+
+  SequenceNumber32 packetNumber = ++m_subflows[pathId]->m_nextPktNum;
+  QuicHeader head = QuicHeader::CreateShort (m_connectionId, packetNumber,
+                                             !m_omit_connection_id, m_keyPhase);
+  head.SetPathId (pathId);
+  head.SetSeq (packetNumber);
+  m_subflows[pathId]->Add (head.GetSeq ());
+
+  NS_LOG_INFO ("Send frame " << frame << " on path " << (uint32_t) pathId << " with header " << head);
+  if (to.IsInvalid ())
+    {
+      m_quicl4->SendPacket (this, p, head);
+    }
+  else
+    {
+      m_quicl4->SendPacketTo (this, p, head, to);
+    }
+  m_txTrace (p, head, this);
+}
+
+int
+QuicSocketBase::MigratePath (uint8_t pathId, const Address &local)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << local);
+  if (m_socketState != OPEN || pathId >= m_subflows.size ())
+    {
+      return -1;
+    }
+
+  Address oldLocal;
+  Address peer;
+  if (m_quicl4->GetPathSockName (this, pathId, oldLocal) != 0
+      || m_quicl4->GetPathPeerName (this, pathId, peer) != 0)
+    {
+      return -1;
+    }
+  InetSocketAddress oldTransport = InetSocketAddress::ConvertFrom (oldLocal);
+  if (oldTransport.GetIpv4 () == Ipv4Address::GetAny ())
+    {
+      // a socket bound to any address sends from the address of the route to the peer
+      Ipv4Header header;
+      header.SetDestination (InetSocketAddress::ConvertFrom (peer).GetIpv4 ());
+      Socket::SocketErrno errno_;
+      Ptr<Ipv4Route> route = m_node->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (0, header, 0, errno_);
+      if (route != 0)
+        {
+          oldLocal = InetSocketAddress (route->GetSource (), oldTransport.GetPort ());
+        }
+    }
+  if (m_quicl4->UdpRebind (this, pathId, local) != 0)
+    {
+      NS_LOG_WARN ("Cannot move path " << (uint32_t) pathId << " to " << local);
+      return -1;
+    }
+  Address newLocal;
+  m_quicl4->GetPathSockName (this, pathId, newLocal);
+
+  OnPathMigrated (pathId, oldLocal, newLocal);
+  // the peer learns the new address from this packet
+  SendPing (pathId);
+  return 0;
+}
+
+bool
+QuicSocketBase::GetConnectionMigration (void) const
+{
+  return m_connectionMigration;
+}
+
+void
+QuicSocketBase::CheckPeerAddress (uint8_t pathId, const Address &from)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << from);
+  // only clients move, and the server replies from other ports than the ones the client connected to
+  Address peer;
+  if (!m_connectionMigration || !m_quicl4->IsServer () || !InetSocketAddress::IsMatchingType (from)
+      || m_quicl4->GetPathPeerName (this, pathId, peer) != 0 || peer == from)
+    {
+      return;
+    }
+
+  InetSocketAddress oldPeer = InetSocketAddress::ConvertFrom (peer);
+  InetSocketAddress newPeer = InetSocketAddress::ConvertFrom (from);
+  if (oldPeer.GetIpv4 () == newPeer.GetIpv4 ())
+    {
+      // NAT rebinding: the address is already validated, only the port changed
+      NS_LOG_INFO ("Path " << (uint32_t) pathId << " rebound to port " << newPeer.GetPort ());
+      m_pathValidations.erase (pathId);
+      RebindPath (pathId, from);
+      return;
+    }
+
+  std::map<uint8_t, std::pair<Address, uint8_t> >::iterator it = m_pathValidations.find (pathId);
+  if (it != m_pathValidations.end () && it->second.first == from)
+    {
+      return;
+    }
+  if (m_pathChallengeData == 0)
+    {
+      // created on the first migration, so that the other random streams do not change
+      m_pathChallengeData = CreateObject<UniformRandomVariable> ();
+    }
+  uint8_t data = m_pathChallengeData->GetInteger (0, 255);
+  m_pathValidations[pathId] = std::make_pair (from, data);
+  NS_LOG_INFO ("Validate " << newPeer.GetIpv4 () << " for path " << (uint32_t) pathId);
+  SendPathFrame (pathId, QuicSubheader::CreatePathChallenge (data), from);
+}
+
+void
+QuicSocketBase::RebindPath (uint8_t pathId, const Address &peer)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << peer);
+  Address oldPeer;
+  if (m_quicl4->GetPathPeerName (this, pathId, oldPeer) != 0
+      || m_quicl4->UdpReconnect (this, pathId, peer) != 0)
+    {
+      NS_LOG_WARN ("Cannot move path " << (uint32_t) pathId << " to " << peer);
+      return;
+    }
+
+  Ipv4Address oldIpv4 = InetSocketAddress::ConvertFrom (oldPeer).GetIpv4 ();
+  InetSocketAddress transport = InetSocketAddress::ConvertFrom (peer);
+  Ptr<MpQuicSubFlow> sFlow = m_subflows[pathId];
+  // subflows opened by Connect keep the peer in dAddr, those added by LookUpByAddr in sAddr
+  if (sFlow->dAddr == oldIpv4)
+    {
+      sFlow->dAddr = transport.GetIpv4 ();
+      sFlow->dPort = transport.GetPort ();
+    }
+  else
+    {
+      sFlow->sAddr = transport.GetIpv4 ();
+      sFlow->sPort = transport.GetPort ();
+    }
+  std::map<Ipv4Address, uint8_t>::iterator it = m_addrIdPair.find (oldIpv4);
+  if (it != m_addrIdPair.end () && it->second == pathId)
+    {
+      m_addrIdPair.erase (it);
+    }
+  m_addrIdPair[transport.GetIpv4 ()] = pathId;
+
+  OnPathMigrated (pathId, oldPeer, peer);
+}
+
+void
+QuicSocketBase::OnPathMigrated (uint8_t pathId, const Address &oldAddress, const Address &newAddress)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId << oldAddress << newAddress);
+  Ipv4Address oldIpv4 = InetSocketAddress::ConvertFrom (oldAddress).GetIpv4 ();
+  Ipv4Address newIpv4 = InetSocketAddress::ConvertFrom (newAddress).GetIpv4 ();
+  bool keepState = oldIpv4.CombineMask (m_pathClassMask) == newIpv4.CombineMask (m_pathClassMask);
+  if (!keepState)
+    {
+      // another network: what was learnt about the old path does not hold
+      m_subflows[pathId]->ResetCongestionState ();
+    }
+  NS_LOG_INFO ("Path " << (uint32_t) pathId << " moved from " << oldAddress << " to " << newAddress
+                       << (keepState ? ", congestion state kept" : ", congestion state reset"));
+  if (m_pathManager != 0)
+    {
+      m_pathManager->NotifyPathActivity (pathId);
+    }
+  m_pathMigrationTrace (pathId, oldAddress, newAddress, keepState);
+}
+
 int
 QuicSocketBase::FindMinRttPath()
 {
   int min = 0;
-  Time mrtt=m_subflows[0]->lastMeasuredRtt;
+  if (!IsPathUsable (0)) {
+    min = m_pathManager->GetAlternatePath (0);
+  }
+  Time mrtt=m_subflows[min]->lastMeasuredRtt;
   // std::cout<<" rtt1: "<<mrtt<<"\n";
   for (uint i = 1; i < m_subflows.size(); i++) {
     // std::cout<<" rtt2: "<<m_subflows[i]->lastMeasuredRtt<<"\n";
-    if (m_subflows[i]->lastMeasuredRtt< mrtt) {
+    if (IsPathUsable (i) and m_subflows[i]->lastMeasuredRtt< mrtt) {
       mrtt = m_subflows[i]->lastMeasuredRtt;
       min = i;
     }
@@ -4054,7 +4796,7 @@ double QuicSocketBase::TotalData (double T,uint32_t sFlowIdx, double cwnd, int s
       InitialBW();
     for (int i = 0; i < 50; i++) {
       for (int j = 1; j < 5; j++) {
-        if (sFlowIdx == 0 && TimeAtNextRound < start_time + (i * 4 + j) * (owd_0.GetSeconds()*2)) {
+        if (sFlowIdx == 0 && TimeAtNextRound < start_time + (i * 4 + j) * (m_owd0.GetSeconds()*2)) {
           uint64_t bw_O_int = bw_ini0.GetBitRate ();
           //bw_0 = DataRate(std::to_string(5-(j-1)*1.25)+"Mbps");
           bdp = (bw_O_int - (j-2) * (bw_O_int/5)) * (RTT / 1e6) / (8 * 1460);
@@ -4065,12 +4807,12 @@ double QuicSocketBase::TotalData (double T,uint32_t sFlowIdx, double cwnd, int s
                       << "rtt0: "<<(RTT / 1e6)
                       << " TimeAtNextRound: "<<TimeAtNextRound
                       << " i: "<<i<<" j: "<<j
-                      << " start_time + (i * 4 + j) * (owd_0.GetSeconds()*2): "<<start_time + (i * 4 + j) * (owd_0.GetSeconds()*2)
+                      << " start_time + (i * 4 + j) * (m_owd0.GetSeconds()*2): "<<start_time + (i * 4 + j) * (m_owd0.GetSeconds()*2)
                       << std::endl;
           }
           cwnd = std::min(cwnd, bdp);
           goto end;
-        } else if (sFlowIdx == 1 && TimeAtNextRound < start_time + (i * 4 + j) * (owd_1.GetSeconds()*2)) {
+        } else if (sFlowIdx == 1 && TimeAtNextRound < start_time + (i * 4 + j) * (m_owd1.GetSeconds()*2)) {
           //bw_1 = DataRate(std::to_string(2+(j-1)*2)+"Mbps");
           //bdp = bw_1.GetBitRate() * (RTT / 1e6) / (8 * 1460);
 
@@ -4083,7 +4825,7 @@ double QuicSocketBase::TotalData (double T,uint32_t sFlowIdx, double cwnd, int s
                     << "rtt0: " << (RTT / 1e6)
                     << " TimeAtNextRound: " << TimeAtNextRound
                     << " i: "<<i<<" j: "<<j
-                    << " start_time + (i * 4 + j) * (owd_0.GetSeconds()*2): "<<start_time + (i * 4 + j) * (owd_0.GetSeconds()*2)
+                    << " start_time + (i * 4 + j) * (m_owd0.GetSeconds()*2): "<<start_time + (i * 4 + j) * (m_owd0.GetSeconds()*2)
                     << std::endl;
           cwnd = std::min(cwnd, bdp);
           goto end;
@@ -32,8 +32,11 @@
 #include "ns3/timer.h"
 #include "ns3/socket.h"
 #include "ns3/traced-value.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/random-variable-stream.h"
 #include "quic-socket.h"
 #include "ns3/event-id.h"
+#include "ns3/system-mutex.h"
 #include "quic-socket-rx-buffer.h"
 #include "quic-socket-tx-buffer.h"
 #include "quic-header.h"
@@ -46,6 +49,8 @@
 #include "mp-quic-typedefs.h"
 
 #include "quic-scheduler.h"
+#include "mp-quic-path-manager.h"
+#include "mp-quic-fluid-model.h"
 
 #include <iostream>
 #include <fstream>
@@ -219,13 +224,126 @@ public:
   bool IsSubsocket ();
   bool m_isFast = true;
   bool m_QUpdate = true;
-  uint8_t slowPathId;
+  uint8_t slowPathId = 0;
   bool blockSlowPath = false;
+
+  //path management
+  /**
+   * \brief Tear down a subflow whose path has failed
+   *
+   * Cancels the timers of the subflow, reinjects its unacknowledged frames
+   * and tries to send them on the surviving paths. The subflow keeps its
+   * slot in m_subflows, since path identifiers are positional.
+   *
+   * \param pathId the path to tear down
+   * \return the number of bytes reinjected
+   */
+  uint32_t RemoveSubflow (uint8_t pathId);
+  /**
+   * \brief Send an ACK-eliciting PING frame on a path
+   *
+   * \param pathId the path to probe
+   */
+  void SendPing (uint8_t pathId);
+  /**
+   * \brief Check if a path can carry data
+   *
+   * \param pathId the path identifier
+   * \return false if the path manager declared the path failed
+   */
+  bool IsPathUsable (uint8_t pathId) const;
+  /**
+   * \brief Check if the schedulers should put data on a path
+   *
+   * \param pathId the path identifier
+   * \return true if the path is usable and not drained before a handover
+   */
+  bool IsPathPreferred (uint8_t pathId) const;
+  /**
+   * \brief Get the rate of the link of a path, as known to the MAMS schedulers
+   *
+   * \param pathId the path identifier
+   * \return the LinkRate0 or LinkRate1 attribute, 0 for the other paths
+   */
+  DataRate GetLinkRate (uint8_t pathId) const;
+  /**
+   * \brief Move the RTT estimates of a path by a known change
+   *
+   * Used at a handover of the path, when the RTT of the new path is
+   * predicted: the latest RTT sample of the path and the estimates which
+   * already hold samples are moved, and the loss detection alarm of the
+   * data in flight is armed again for the new RTT. A path without RTT
+   * sample is left unchanged.
+   *
+   * \param pathId the path identifier
+   * \param rttChange the change of the RTT
+   * \return the new RTT of the path, zero if it has no sample
+   */
+  Time SeedPathRtt (uint8_t pathId, Time rttChange);
+
+  //connection migration
+  /**
+   * \brief Move a path of this endpoint to a new local address
+   *
+   * The path gets a UDP socket bound to the new address, and a PING is sent
+   * on it: the peer sees the packet come from the new address and validates
+   * it with a PATH_CHALLENGE before moving its end of the path. The
+   * congestion state of the path is kept if the old and the new address are
+   * in the same path class (see the PathClassMask attribute).
+   *
+   * \param pathId the path to move
+   * \param local the new local address
+   * \return 0 on success, -1 if the path cannot be moved
+   */
+  int MigratePath (uint8_t pathId, const Address &local);
+  /**
+   * \brief Check if the peer may move the paths of the connection to new addresses
+   *
+   * \return the value of the ConnectionMigration attribute
+   */
+  bool GetConnectionMigration (void) const;
+  /**
+   * \brief TracedCallback signature for path migrations
+   *
+   * \param [in] pathId the path
+   * \param [in] oldAddress the address the path was bound to
+   * \param [in] newAddress the address the path is bound to now
+   * \param [in] keptState true if the congestion state of the path was kept
+   */
+  typedef void (* PathMigrationTracedCallback)(uint8_t pathId, const Address &oldAddress,
+                                               const Address &newAddress, bool keptState);
+
+  //fluid fast-forward
+  /**
+   * \brief Advance the transfer on a path without sending packets
+   *
+   * Takes up to numBytes of stream frames scheduled on the path out of the tx
+   * buffer and delivers them to the peer socket after the given delay.
+   *
+   * \param pathId the path to advance
+   * \param numBytes the byte budget of the round
+   * \param delay the one-way delay of the path
+   * \return the number of bytes delivered, 0 if nothing could be sent
+   */
+  uint32_t FastForwardData (uint8_t pathId, uint32_t numBytes, Time delay);
+  /**
+   * \brief Go back to packet level at the end of a fluid window
+   *
+   * The subflows take the congestion windows reached by the fluid model.
+   */
+  void ResumePacketLevel (void);
+  /**
+   * \brief Receive stream frames delivered by the fluid model of the peer
+   *
+   * \param p the stream frames
+   * \param pathId the path they were scheduled on
+   */
+  void ReceivedFluidData (Ptr<Packet> p, uint8_t pathId);
   std::vector<uint8_t> ackedPathList;
   std::vector<uint8_t> sentPathList;
 
-  uint32_t m_associatedOffset;
-  uint32_t m_largestInOrderOffset;
+  uint32_t m_associatedOffset = 0;
+  uint32_t m_largestInOrderOffset = 0;
   std::map <SequenceNumber32, uint32_t> m_SeqOffsetPair;    // key: packet number; value: offset
   DataRate bw_ini0;
   DataRate bw_ini1;
@@ -236,10 +354,10 @@ public:
 
   Address m_from;
   //ywj: data of amount Q that fast path can process within certain time period T
-  uint64_t Q;
-  uint64_t IntQ;
+  uint64_t Q = 0;
+  uint64_t IntQ = 0;
 
-  double TDiff;
+  double TDiff = 0;
 
   std::ofstream rttLog0;
   std::ofstream rttLog1; 
@@ -610,7 +728,7 @@ public:
 
   //ywj: a flag to create new udpSocket
   bool m_subSocket;                        //!< If true, this subsocket allowed to be created
-  bool m_sendAnnounce;
+  bool m_sendAnnounce = false;
 
   // Implementation of ns3::Socket virtuals
 
@@ -693,6 +811,12 @@ public:
                                          const Ptr<const QuicSocketBase> socket);
 
 protected:
+  /**
+   * \brief Dispose of the path manager and the fluid model, which hold the
+   * socket back, and release the peer socket of the fluid data
+   */
+  virtual void DoDispose (void);
+
   // Implementation of QuicSocket virtuals
   virtual bool SetAllowBroadcast (bool allowBroadcast);
   virtual bool GetAllowBroadcast (void) const;
@@ -814,6 +938,19 @@ protected:
    */
   void SendAck (uint8_t pathId);
 
+  /**
+   * \brief Attach the ACK frames to a packet about to be sent
+   *
+   * The ACK of the path of the packet is attached if withAck is set. With
+   * PiggybackPendingAcks, the ACK of any path waiting for SendAck is
+   * attached to a short packet too, and SendAck is not called.
+   *
+   * \param p the packet
+   * \param head the header of the packet
+   * \param withAck true to acknowledge the packets received on the path
+   */
+  void PiggybackAcks (Ptr<Packet> p, const QuicHeader &head, bool withAck);
+
   /**
    * \brief Call Socket::NotifyConnectionSucceeded()
    */
@@ -854,6 +991,7 @@ protected:
   bool m_serverBusy;                        //!< If true, server too busy to accept new connections
   mutable enum SocketErrno m_errno;         //!< Socket error code
   bool m_connected;                         //!< Check if connection is established
+  bool m_0RTTHandshake;                     //!< True if the client started the connection with a 0-RTT handshake
   uint64_t m_connectionId;                  //!< Connection id
   uint32_t m_vers;                          //!< Quic protocol version
   QuicHeader::KeyPhase_t m_keyPhase;        //!< Key phase
@@ -944,6 +1082,108 @@ protected:
 
   void CreateScheduler ();
   Ptr<QuicScheduler> m_scheduler;
+  /**
+   * \brief Create and start the path manager, if enabled, once the subflows are set up
+   */
+  void InitializePathManager ();
+  bool m_enablePathManager;                       //!< True if path probing and failover are enabled
+  Ptr<MpQuicPathManager> m_pathManager;           //!< The path manager
+  /**
+   * \brief Validate the source address of a packet received on a path
+   *
+   * Only the server follows the peer. A packet coming from a new port of
+   * the peer address of the path (NAT rebinding) moves the path at once.
+   * A packet coming from a new address triggers a PATH_CHALLENGE to that
+   * address; the path moves when the PATH_RESPONSE arrives. Only the
+   * packet with the highest packet number received so far on the path is
+   * checked, so a reordered packet does not move the path back.
+   *
+   * \param pathId the path the packet was received on
+   * \param from the source address of the packet
+   */
+  void CheckPeerAddress (uint8_t pathId, const Address &from);
+  /**
+   * \brief Move this end of a path to a validated peer address
+   *
+   * \param pathId the path
+   * \param peer the new peer address
+   */
+  void RebindPath (uint8_t pathId, const Address &peer);
+  /**
+   * \brief Keep or reset the congestion state of a path which moved
+   *
+   * \param pathId the path
+   * \param oldAddress the address the path was bound to
+   * \param newAddress the address the path is bound to now
+   */
+  void OnPathMigrated (uint8_t pathId, const Address &oldAddress, const Address &newAddress);
+  /**
+   * \brief Send a control frame in a packet of its own on a path
+   *
+   * \param pathId the path
+   * \param frame the frame
+   * \param to the destination, if it is not the peer address of the path
+   */
+  void SendPathFrame (uint8_t pathId, const QuicSubheader &frame, const Address &to = Address ());
+  bool m_connectionMigration;                     //!< True if the peer may move the paths to new addresses
+  Ipv4Mask m_pathClassMask;                       //!< Addresses in the same subnet under this mask are on the same path class
+  bool m_piggybackAcks;                           //!< True if the pending ACKs ride on the next short packet
+  std::map<uint8_t, std::pair<Address, uint8_t> > m_pathValidations;  //!< Per path, the address being validated and its PATH_CHALLENGE data
+  Ptr<UniformRandomVariable> m_pathChallengeData; //!< Data of the PATH_CHALLENGE frames
+  uint8_t m_rxPathId;                             //!< Path of the packet being processed
+  TracedCallback<uint8_t, const Address &, const Address &, bool> m_pathMigrationTrace; //!< Trace of path migrations
+  /**
+   * \brief Create the fluid model, if enabled, once the subflows are set up
+   */
+  void InitializeFluidModel ();
+  /**
+   * \brief Set the initial window and the traces of path 0 of a client
+   */
+  void InitializeFirstSubflow ();
+  /**
+   * \brief Announce path 1 and create the MAMS scheduler, once the client
+   * knows that the server holds the connection
+   */
+  void StartMultipath ();
+  /**
+   * \brief Find the socket at the other end of the connection
+   *
+   * Only the sockets with a fluid model are found: they are registered
+   * when it is created, so that the socket lists of the other nodes, which
+   * their own threads may change under the multithreaded simulator, are
+   * never read.
+   *
+   * \return the peer socket, or 0 if it is not found
+   */
+  Ptr<QuicSocketBase> FindPeerSocket (void) const;
+  /**
+   * \brief Remove the socket from the ends of the connections with a fluid model
+   */
+  void UnregisterFluidEnd (void);
+  bool m_enableFluidModel;                        //!< True if steady phases are fast-forwarded
+  Ptr<MpQuicFluidModel> m_fluidModel;             //!< The fluid model
+  Ptr<QuicSocketBase> m_fluidPeer;                //!< Receiver of the fluid data
+  static std::multimap<uint64_t, QuicSocketBase *> g_fluidEnds;  //!< Sockets with a fluid model, by connection id
+  static SystemMutex g_fluidEndsMutex;            //!< Guards g_fluidEnds, shared by the threads of the simulator
+
+  // MAMS Extension: scenario of the connection, copied from the QuicEchoClientHelper
+  // settings when the socket is created, so that the sockets never write them
+  Time m_owd0;                                    //!< One-way delay of path 0
+  Time m_owd1;                                    //!< One-way delay of path 1
+  DataRate m_bw0;                                 //!< Rate of the link of path 0
+  DataRate m_bw1;                                 //!< Rate of the link of path 1
+  double m_errorRate;                             //!< Error rate of the links
+  uint8_t m_scheAlgo;                             //!< Packet scheduler: 1. quic-rr, 2. mpquic-rr, 3. mpquic-ofo, 4./5. ACKs on the fastest path
+  bool m_withMob;                                 //!< True if the link rates follow a mobility scenario
+
+  /**
+   * \brief Update the out-of-order control state of the scheduler before
+   * taking data for a path
+   *
+   * \param pathId the path the data will be sent on
+   * \return false if the path is blocked
+   */
+  bool UpdateScheduleState (int pathId);
   int FindMinRttPath();
   double GetOliaApha(int pathId);
   void InitialRTT ();
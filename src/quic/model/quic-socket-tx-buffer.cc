@@ -280,29 +280,38 @@ bool QuicSocketTxBuffer::Add (Ptr<Packet> p)
   return false;
 }
 
-Ptr<Packet> QuicSocketTxBuffer::NextStream0Sequence(const SequenceNumber32 seq)
+Ptr<Packet> QuicSocketTxBuffer::NextStream0Sequence(const SequenceNumber32 seq, uint32_t maxSize)
 {
-  NS_LOG_FUNCTION (this << seq);
-
-  Ptr<QuicSocketTxItem> outItem = CreateObject<QuicSocketTxItem> ();
+  NS_LOG_FUNCTION (this << seq << maxSize);
 
   QuicTxPacketList::iterator it = m_streamZeroList.begin ();
-  if (it != m_streamZeroList.end ()) {
-    Ptr<Packet> currentPacket = (*it)->m_packet;
-    outItem->m_packetNumber = seq;
-    outItem->m_lastSent = Now ();
-    outItem->m_packet = currentPacket;
-    outItem->m_isStream0 = (*it)->m_isStream0;
-    m_streamZeroList.erase (it);
-    m_streamZeroSize -= currentPacket->GetSize ();
-    //m_sentList.insert (m_sentList.end (), outItem);
-    m_subflowSentList[0].insert (m_subflowSentList[0].end (), outItem); //ywj: only use path 0 to deal with stream 0
-    m_sentSize += outItem->m_packet->GetSize ();
+  if (it == m_streamZeroList.end ()) {
+    return 0;
+  }
+
+  Ptr<QuicSocketTxItem> outItem = CreateObject<QuicSocketTxItem> ();
+  outItem->m_packetNumber = seq;
+  outItem->m_lastSent = Now ();
+  outItem->m_isStream0 = (*it)->m_isStream0;
+  // the first frame always goes, the next ones while they fit in maxSize
+  Ptr<Packet> currentPacket = (*it)->m_packet;
+  m_streamZeroSize -= currentPacket->GetSize ();
+  --m_numFrameStream0InBuffer;
+  it = m_streamZeroList.erase (it);
+  while (it != m_streamZeroList.end ()
+         && currentPacket->GetSize () + (*it)->m_packet->GetSize () <= maxSize) {
+    currentPacket->AddAtEnd ((*it)->m_packet);
+    m_streamZeroSize -= (*it)->m_packet->GetSize ();
     --m_numFrameStream0InBuffer;
-    Ptr<Packet> toRet = outItem->m_packet;
-    return toRet;
+    it = m_streamZeroList.erase (it);
   }
-  return 0;
+
+  NS_LOG_INFO ("Coalesced stream 0 frames in " << currentPacket->GetSize () << " bytes");
+  outItem->m_packet = currentPacket;
+  //m_sentList.insert (m_sentList.end (), outItem);
+  m_subflowSentList[0].insert (m_subflowSentList[0].end (), outItem); //ywj: only use path 0 to deal with stream 0
+  m_sentSize += outItem->m_packet->GetSize ();
+  return outItem->m_packet;
 }
 
 // new
@@ -330,6 +339,22 @@ Ptr<Packet> QuicSocketTxBuffer::NextSequence (uint32_t numBytes,
   }
 }
 
+Ptr<Packet> QuicSocketTxBuffer::NextFluidSequence (uint32_t numBytes,
+                                                   uint32_t pathId,
+                                                   uint64_t Q,
+                                                   bool isFast,
+                                                   bool QUpdate,
+                                                   uint8_t algo)
+{
+  NS_LOG_FUNCTION (this << numBytes << pathId);
+
+  Ptr<QuicSocketTxItem> outItem = m_scheduler->GetNewSegment (numBytes,pathId,Q,isFast,QUpdate,m_fileSize,algo);
+
+  NS_LOG_INFO ("Fluid: extracted " << outItem->m_packet->GetSize () << " bytes, remaining App Size " << m_scheduler->AppSize ());
+
+  return outItem->m_packet;
+}
+
 Ptr<QuicSocketTxItem> QuicSocketTxBuffer::GetNewSegment (uint32_t numBytes, uint32_t pathId, uint64_t Q, bool isFast, bool QUpdate, uint8_t algo)
 {
   NS_LOG_FUNCTION (this << numBytes);
@@ -508,16 +533,17 @@ bool QuicSocketTxBuffer::MarkAsLost (const SequenceNumber32 seq)
 {
   NS_LOG_FUNCTION (this << seq);
   bool found = false;
-  //ywj: just comment out the following lines of code, as nowhere use it other than quic/test/quic-tx-buffer-test.cc
-  // for (auto sent_it = m_sentList.begin ();
-  //      sent_it != m_sentList.end () and !m_sentList.empty (); ++sent_it)
-  //   {
-  //     if ((*sent_it)->m_packetNumber == seq)
-  //       {
-  //         found = true;
-  //         (*sent_it)->m_lost = true;
-  //       }
-  //   }
+  for (auto list_it = m_subflowSentList.begin (); list_it != m_subflowSentList.end (); ++list_it)
+    {
+      for (auto sent_it = list_it->begin (); sent_it != list_it->end (); ++sent_it)
+        {
+          if ((*sent_it)->m_packetNumber == seq)
+            {
+              found = true;
+              (*sent_it)->m_lost = true;
+            }
+        }
+    }
   return found;
 }
 
@@ -583,6 +609,35 @@ uint32_t QuicSocketTxBuffer::Retransmission (SequenceNumber32 packetNumber, uint
   return toRetx;
 }
 
+uint32_t QuicSocketTxBuffer::ReinjectSubflow (SequenceNumber32 packetNumber, uint8_t pathId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) pathId);
+  if (pathId >= m_subflowSentList.size ())
+    {
+      return 0;
+    }
+
+  for (auto sent_it = m_subflowSentList[pathId].begin ();
+       sent_it != m_subflowSentList[pathId].end (); ++sent_it)
+    {
+      if (!(*sent_it)->m_sacked)
+        {
+          (*sent_it)->m_lost = true;
+        }
+    }
+  uint32_t reinjected = Retransmission (packetNumber, pathId);
+
+  // what is left has already been acknowledged
+  for (auto sent_it = m_subflowSentList[pathId].begin ();
+       sent_it != m_subflowSentList[pathId].end (); ++sent_it)
+    {
+      (*sent_it)->m_acked = true;
+      m_sentSize -= (*sent_it)->m_packet->GetSize ();
+    }
+  m_subflowSentList[pathId].clear ();
+  return reinjected;
+}
+
 std::vector<Ptr<QuicSocketTxItem> > QuicSocketTxBuffer::DetectLostPackets (uint8_t pathId)
 {
   NS_LOG_FUNCTION (this);
@@ -169,6 +169,19 @@ public:
    */
   Ptr<Packet> NextSequence (uint32_t numBytes, const SequenceNumber32 seq, uint32_t pathId, uint64_t Q, bool isFast, bool QUpdate, uint8_t algo);
 
+  /**
+   * \brief Take the next frames scheduled on a path without sending them
+   *
+   * Used by the fluid model: the frames are considered delivered, so they are
+   * neither added to the sent list nor counted in flight.
+   *
+   * \param numBytes the number of bytes requested
+   * \param pathId the path the frames are scheduled on
+   * \param Q the estimated data amount Q
+   * \return the frames, or an empty packet
+   */
+  Ptr<Packet> NextFluidSequence (uint32_t numBytes, uint32_t pathId, uint64_t Q, bool isFast, bool QUpdate, uint8_t algo);
+
 
   /**
    * \brief Get a block of data not transmitted yet and move it into SentList
@@ -268,13 +281,15 @@ public:
   uint32_t GetNumFrameStream0InBuffer (void) const;
 
   /**
-   * Return the next frame for stream 0 to be sent
+   * Return the next frames for stream 0 to be sent, coalesced in one packet,
    * and add this packet to the sent list
    *
    * \param seq the sequence number of the packet
+   * \param maxSize the size the frames following the first one must fit in,
+   * 0 for a single frame
    * \return a smart pointer to the packet, 0 if there are no packets from stream 0
    */
-  Ptr<Packet> NextStream0Sequence (const SequenceNumber32 seq);
+  Ptr<Packet> NextStream0Sequence (const SequenceNumber32 seq, uint32_t maxSize = 0);
 
   /**
    * \brief Reset the sent list
@@ -291,7 +306,7 @@ public:
   /**
    * Mark a packet as lost
    * \param the sequence number of the packet
-   * \return true if the packet is in the send buffer
+   * \return true if the packet is in the sent list of a path
    */
   bool MarkAsLost (const SequenceNumber32 seq);
 
@@ -302,6 +317,15 @@ public:
    */
   uint32_t Retransmission (SequenceNumber32 packetNumber, uint8_t pathId);
 
+  /**
+   * Put all the unacknowledged packets of a failed path back in the application
+   * buffer, so that they are sent on the surviving paths, and empty its sent list
+   * \param the sequence number of the first reinjected packet
+   * \param the identifier of the failed path
+   * \return the number of reinjected bytes
+   */
+  uint32_t ReinjectSubflow (SequenceNumber32 packetNumber, uint8_t pathId);
+
   /**
    * Set the TcpSocketState (tcb)
    * \param The TcpSocketState object
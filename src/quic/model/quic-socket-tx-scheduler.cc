@@ -840,24 +840,12 @@ QuicSocketTxScheduler::GetNewSegment (uint32_t numBytes, uint32_t pathId, uint64
               // record sending time of each frame. 
               m_offsetSendTimeInfo.push_back (std::make_pair(oldOffset, Simulator::Now ().GetSeconds ()));
 
-                  //open the file for writing with the truncate-option, which means we'll clear the content before writing new data into it
-              sendTimeLog.open ("sendTimeLog.txt", std::ofstream::out | std::ofstream::trunc);
-              sendTimeLog << "FrameOffset\tSending Time (s)\n";
-              if (!m_offsetSendTimeInfo.empty())
+              // the log is written once, when the simulation is destroyed
+              if (!m_sendTimeLogScheduled)
                 {
-                  // sort the pairs of vector based on the first element
-                  std::sort(m_offsetSendTimeInfo.begin(), m_offsetSendTimeInfo.end(), [](const std::pair<int,int> &left, const std::pair<int,int> &right) {return left.first < right.first;});
-                  for (auto osti:m_offsetSendTimeInfo)
-                  {
-                    sendTimeLog << std::setfill (' ') << std::setw (4) << osti.first
-                    << std::setfill (' ') << std::setw (21) << osti.second <<"\n";
-                  }
+                  Simulator::ScheduleDestroy (&QuicSocketTxScheduler::PrintSendTimeLog, Ptr<QuicSocketTxScheduler> (this));
+                  m_sendTimeLogScheduled = true;
                 }
-                else
-                  {
-                    NS_LOG_ERROR ("Error: m_offsetSendTimeInfo is empty");
-                  }
-              sendTimeLog.close();
 
               Ptr<QuicSocketTxItem> toBeBuffered = CreateObject<QuicSocketTxItem> (*currentItem);
               toBeBuffered->m_packet = secondPartPacket;
@@ -868,7 +856,12 @@ QuicSocketTxScheduler::GetNewSegment (uint32_t numBytes, uint32_t pathId, uint64
 
                //m_appList.push (CreateObject<QuicSocketTxScheduleItem> (scheduleItem->GetStreamId (), scheduleItem->GetOffset (), scheduleItem->GetPriority (), toBeBuffered));
                //std::cout<<"--m_appsize ("<<m_appSize<<") + toBeBuffered ("<<toBeBuffered->m_packet->GetSize ()<<") = "<< m_appSize + toBeBuffered->m_packet->GetSize ()<<std::endl;
-               m_appSize += toBeBuffered->m_packet->GetSize ();
+               // a frame that fits exactly leaves no data behind, only a FIN to carry
+               bool putBack = newLength > 0 || qsb.IsStreamFin ();
+               if (putBack)
+                {
+                  m_appSize += toBeBuffered->m_packet->GetSize ();
+                }
 
                // m_leftFileSize would be passed to QuicSocketBase::SendDataPacket, which is used to determine whether freeze the slow path or not,  
                if (isNewData)
@@ -876,7 +869,10 @@ QuicSocketTxScheduler::GetNewSegment (uint32_t numBytes, uint32_t pathId, uint64
                   m_leftFileSize -= sumOfParts;
                   //std::cout<<"---m_leftFileSize: "<<m_leftFileSize<<std::endl;
                 }
-              m_secondPartData[pathId].push (CreateObject<QuicSocketTxScheduleItem> (scheduleItem->GetStreamId (), scheduleItem->GetOffset (), scheduleItem->GetPriority (), toBeBuffered));
+              if (putBack)
+                {
+                  m_secondPartData[pathId].push (CreateObject<QuicSocketTxScheduleItem> (scheduleItem->GetStreamId (), scheduleItem->GetOffset (), scheduleItem->GetPriority (), toBeBuffered));
+                }
 
               NS_LOG_LOGIC ("Buffer size: " << m_appSize << " (put back " << toBeBuffered->m_packet->GetSize () << " bytes)");
               break; // at most one segment
@@ -218,6 +218,7 @@ public:
   // for delay/jitter distribution measurement 
   std::vector<std::pair<uint32_t, double> > m_offsetSendTimeInfo;
   std::ofstream sendTimeLog; //!< Output stream for logging delay information
+  bool m_sendTimeLogScheduled = false;  //!< True once the log is due at the destruction of the simulation
   
 private:
   typedef std::priority_queue<Ptr<QuicSocketTxScheduleItem>, std::vector<Ptr<QuicSocketTxScheduleItem> >, CompareScheduleItems> QuicTxPacketList;        //!< container for data stored in the buffer
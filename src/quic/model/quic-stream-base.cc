@@ -110,6 +110,31 @@ QuicStreamBase::~QuicStreamBase (void)
   NS_LOG_FUNCTION (this);
 }
 
+void
+QuicStreamBase::PrintRecvTimeLogs (void)
+{
+  NS_LOG_FUNCTION (this);
+  arriveTimeLog.open ("arriveTimeLog.txt", std::ofstream::out | std::ofstream::trunc);
+  arriveTimeLog << "FrameOffset\tArrival Time (s)\n";
+  std::sort (m_iniRecvTimeInfo.begin (), m_iniRecvTimeInfo.end (), [](const std::pair<int,int> &left, const std::pair<int,int> &right) {return left.first < right.first;});
+  for (auto irti : m_iniRecvTimeInfo)
+    {
+      arriveTimeLog << std::setfill (' ') << std::setw (4) << irti.first
+                    << std::setfill (' ') << std::setw (21) << irti.second << "\n";
+    }
+  arriveTimeLog.close ();
+
+  recvTimeLog.open ("recvTimeLog.txt", std::ofstream::out | std::ofstream::trunc);
+  recvTimeLog << "FrameOffset\tSending Time (s)\n";
+  std::sort (m_offsetRecvTimeInfo.begin (), m_offsetRecvTimeInfo.end (), [](const std::pair<int,int> &left, const std::pair<int,int> &right) {return left.first < right.first;});
+  for (auto orti : m_offsetRecvTimeInfo)
+    {
+      recvTimeLog << std::setfill (' ') << std::setw (4) << orti.first
+                  << std::setfill (' ') << std::setw (21) << orti.second << "\n";
+    }
+  recvTimeLog.close ();
+}
+
 void
 QuicStreamBase::SetQuicL5 (Ptr<QuicL5Protocol> quicl5)
 {
@@ -489,20 +514,12 @@ QuicStreamBase::Recv (Ptr<Packet> frame, const QuicSubheader& sub, Address &addr
 
           m_iniRecvTimeInfo.push_back (std::make_pair(sub.GetOffset(), Simulator::Now ().GetSeconds ()));
 
-          arriveTimeLog.open("arriveTimeLog.txt", std::ofstream::out | std::ofstream::trunc); 
-          
-          arriveTimeLog << "FrameOffset\tArrival Time (s)\n";
-
-          std::sort(m_iniRecvTimeInfo.begin(), m_iniRecvTimeInfo.end(), [](const std::pair<int,int> &left, const std::pair<int,int> &right) {return left.first < right.first;});
-          for (auto irti:m_iniRecvTimeInfo)
+          // the time logs are written once, when the simulation is destroyed
+          if (!m_timeLogsScheduled)
             {
-              arriveTimeLog << std::setfill (' ') << std::setw (4) << irti.first
-              << std::setfill (' ') << std::setw (21) << irti.second <<"\n";
+              Simulator::ScheduleDestroy (&QuicStreamBase::PrintRecvTimeLogs, Ptr<QuicStreamBase> (this));
+              m_timeLogsScheduled = true;
             }
-
-          arriveTimeLog.close();
-
-
         }  
 
  
@@ -582,20 +599,6 @@ QuicStreamBase::Recv (Ptr<Packet> frame, const QuicSubheader& sub, Address &addr
                 m_offsetRecvTimeInfo.push_back (std::make_pair(sub.GetOffset(), Simulator::Now ().GetSeconds ()));
                 recvList.erase(recvList.begin ());
               }
-            //open the file for writing with the truncate-option, which means we'll clear the content before writing new data into it
-            recvTimeLog.open("recvTimeLog.txt", std::ofstream::out | std::ofstream::trunc); 
-            recvTimeLog << "FrameOffset\tSending Time (s)\n";
-
-            std::sort(m_offsetRecvTimeInfo.begin(), m_offsetRecvTimeInfo.end(), [](const std::pair<int,int> &left, const std::pair<int,int> &right) {return left.first < right.first;});
-            for (auto orti:m_offsetRecvTimeInfo)
-              {
-                recvTimeLog << std::setfill (' ') << std::setw (4) << orti.first
-                << std::setfill (' ') << std::setw (21) << orti.second <<"\n";
-              }
-
-            recvTimeLog.close();
-
-
           }
           
 
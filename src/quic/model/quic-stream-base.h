@@ -220,6 +220,14 @@ public:
   std::ofstream recvTimeLog; //!< Output stream for logging delay information
   std::ofstream arriveTimeLog;
   std::vector<uint32_t> recvList;
+  bool m_timeLogsScheduled = false;  //!< True once the time logs are due at the destruction of the simulation
+
+  /**
+   * \brief Write the arrival and in-order reception times of the frames
+   *
+   * Sorted by offset, in arriveTimeLog.txt and recvTimeLog.txt.
+   */
+  void PrintRecvTimeLogs (void);
 
                             
 
@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/quic-socket-base.h"
+#include "ns3/mp-quic-path-manager.h"
+#include "ns3/mp-quic-typedefs.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Handovers announced to the MP-QUIC path manager
+ *
+ * A path is drained during the HandoverLead before its handover, and
+ * preferred again after it. At the handover, the RTT estimates of a path
+ * with samples are moved by the announced change and its running loss
+ * detection alarm is re-armed for the new RTT, those of a path without
+ * sample are left unchanged, and a later announcement replaces the pending
+ * one.
+ */
+class MpQuicHandoverTestCase : public TestCase
+{
+public:
+  MpQuicHandoverTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check the draining state of a path
+   * \param pathId the path
+   * \param draining true if the path should be drained
+   */
+  void CheckDraining (uint8_t pathId, bool draining);
+  /**
+   * \brief Check the RTT estimates of a path
+   * \param pathId the path
+   * \param rtt the expected smoothed RTT
+   * \param minRtt the expected minimum RTT
+   */
+  void CheckRtt (uint8_t pathId, Time rtt, Time minRtt);
+  /**
+   * \brief Arm the loss detection alarm of a path far in the future
+   * \param pathId the path
+   */
+  void ArmAlarm (uint8_t pathId);
+  /**
+   * \brief Report the expiry of an alarm armed by ArmAlarm
+   * \param pathId the path
+   */
+  void AlarmExpired (uint8_t pathId);
+  /**
+   * \brief Check that the loss detection alarm of a path was re-armed, then cancel it
+   * \param pathId the path
+   * \param rto the expected alarm duration
+   */
+  void CheckAlarm (uint8_t pathId, Time rto);
+  /**
+   * \brief Record a handover
+   * \param pathId the path
+   * \param rtt the RTT the path was seeded with
+   */
+  void Handover (uint8_t pathId, Time rtt);
+
+  Ptr<QuicSocketBase> m_socket;            //!< The socket of the paths
+  Ptr<MpQuicPathManager> m_pathManager;    //!< The path manager
+  std::vector<uint8_t> m_handoverPaths;    //!< Paths of the handovers traced
+  std::vector<Time> m_handoverRtts;        //!< RTTs of the handovers traced
+  std::vector<Time> m_handoverTimes;       //!< Times of the handovers traced
+};
+
+MpQuicHandoverTestCase::MpQuicHandoverTestCase ()
+  : TestCase ("Drain and RTT seeding of the MP-QUIC paths at announced handovers")
+{
+}
+
+void
+MpQuicHandoverTestCase::CheckDraining (uint8_t pathId, bool draining)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_pathManager->IsPathDraining (pathId), draining,
+                         "path " << (uint32_t) pathId << " at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (m_socket->IsPathPreferred (pathId), !draining,
+                         "preference of path " << (uint32_t) pathId << " at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (m_socket->IsPathUsable (pathId), true, "a drained path is still usable");
+}
+
+void
+MpQuicHandoverTestCase::CheckRtt (uint8_t pathId, Time rtt, Time minRtt)
+{
+  Ptr<MpQuicSubFlow> sFlow = m_socket->m_subflows[pathId];
+  NS_TEST_EXPECT_MSG_EQ (sFlow->lastMeasuredRtt.Get (), rtt, "RTT of path " << (uint32_t) pathId);
+  NS_TEST_EXPECT_MSG_EQ (sFlow->m_tcb->m_smoothedRtt, rtt, "smoothed RTT of path " << (uint32_t) pathId);
+  NS_TEST_EXPECT_MSG_EQ (sFlow->m_tcb->m_minRtt, minRtt, "minimum RTT of path " << (uint32_t) pathId);
+  NS_TEST_EXPECT_MSG_EQ (sFlow->m_rtt->GetEstimate (), rtt, "RTT estimator of path " << (uint32_t) pathId);
+}
+
+void
+MpQuicHandoverTestCase::ArmAlarm (uint8_t pathId)
+{
+  Ptr<QuicSocketState> tcb = m_socket->m_subflows[pathId]->m_tcb;
+  tcb->m_lossDetectionAlarm = Simulator::Schedule (Seconds (10), &MpQuicHandoverTestCase::AlarmExpired, this, pathId);
+}
+
+void
+MpQuicHandoverTestCase::AlarmExpired (uint8_t pathId)
+{
+  NS_TEST_EXPECT_MSG_EQ (true, false, "alarm of path " << (uint32_t) pathId << " not re-armed at the handover");
+}
+
+void
+MpQuicHandoverTestCase::CheckAlarm (uint8_t pathId, Time rto)
+{
+  Ptr<MpQuicSubFlow> sFlow = m_socket->m_subflows[pathId];
+  NS_TEST_EXPECT_MSG_EQ (sFlow->m_tcb->m_lossDetectionAlarm.IsRunning (), true, "alarm of path " << (uint32_t) pathId);
+  NS_TEST_EXPECT_MSG_EQ (sFlow->m_rto, rto, "alarm duration of path " << (uint32_t) pathId);
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (sFlow->m_tcb->m_lossDetectionAlarm) + MilliSeconds (1), rto,
+                         "alarm of path " << (uint32_t) pathId << " not re-armed");
+  sFlow->m_tcb->m_lossDetectionAlarm.Cancel ();
+}
+
+void
+MpQuicHandoverTestCase::Handover (uint8_t pathId, Time rtt)
+{
+  m_handoverPaths.push_back (pathId);
+  m_handoverRtts.push_back (rtt);
+  m_handoverTimes.push_back (Simulator::Now ());
+}
+
+void
+MpQuicHandoverTestCase::DoRun (void)
+{
+  // path 0 has RTT samples, path 1 has none
+  m_socket = CreateObject<QuicSocketBase> ();
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      m_socket->m_subflows.push_back (CreateObject<MpQuicSubFlow> ());
+    }
+  Ptr<MpQuicSubFlow> sFlow = m_socket->m_subflows[0];
+  sFlow->lastMeasuredRtt = MilliSeconds (100);
+  sFlow->m_tcb->m_latestRtt = MilliSeconds (100);
+  sFlow->m_tcb->m_smoothedRtt = MilliSeconds (100);
+  sFlow->m_tcb->m_minRtt = MilliSeconds (90);
+  sFlow->m_tcb->m_rttVar = MilliSeconds (5);
+  sFlow->m_rtt->Measurement (MilliSeconds (100));
+
+  m_pathManager = CreateObjectWithAttributes<MpQuicPathManager> ("HandoverLead", TimeValue (MilliSeconds (200)));
+  m_pathManager->SetSocket (m_socket);
+  m_pathManager->AddPath (0);
+  m_pathManager->AddPath (1);
+  m_socket->SetAttribute ("PathManagerObject", PointerValue (m_pathManager));
+  m_pathManager->TraceConnectWithoutContext ("Handover", MakeCallback (&MpQuicHandoverTestCase::Handover, this));
+
+  // handover of path 0 at 1 s, 20 ms longer
+  m_pathManager->NotifyHandover (0, Seconds (1), MilliSeconds (20));
+  CheckDraining (0, false);
+  Simulator::Schedule (MilliSeconds (799), &MpQuicHandoverTestCase::CheckDraining, this, 0, false);
+  Simulator::Schedule (MilliSeconds (800), &MpQuicHandoverTestCase::CheckDraining, this, 0, true);
+  Simulator::Schedule (MilliSeconds (800), &MpQuicHandoverTestCase::CheckDraining, this, 1, false);
+  Simulator::Schedule (MilliSeconds (999), &MpQuicHandoverTestCase::CheckRtt, this, 0, MilliSeconds (100), MilliSeconds (90));
+  Simulator::Schedule (MilliSeconds (999), &MpQuicHandoverTestCase::ArmAlarm, this, 0);
+  Simulator::Schedule (MilliSeconds (1001), &MpQuicHandoverTestCase::CheckDraining, this, 0, false);
+  Simulator::Schedule (MilliSeconds (1001), &MpQuicHandoverTestCase::CheckRtt, this, 0, MilliSeconds (120), MilliSeconds (110));
+  // tail loss probe: 1.5 times the new RTT
+  Simulator::Schedule (MilliSeconds (1001), &MpQuicHandoverTestCase::CheckAlarm, this, 0, MilliSeconds (180));
+
+  // the handover of path 1 at 1.5 s does not seed a path without sample
+  m_pathManager->NotifyHandover (1, MilliSeconds (1500), MilliSeconds (20));
+  Simulator::Schedule (MilliSeconds (1400), &MpQuicHandoverTestCase::CheckDraining, this, 1, true);
+  Simulator::Schedule (MilliSeconds (1501), &MpQuicHandoverTestCase::CheckDraining, this, 1, false);
+  Simulator::Schedule (MilliSeconds (1501), &MpQuicHandoverTestCase::CheckRtt, this, 1, Time (0), Time (0));
+
+  // the handover of path 0 announced at 2 s is moved to 3 s, 40 ms shorter
+  Simulator::Schedule (MilliSeconds (1700), &MpQuicPathManager::NotifyHandover, m_pathManager, 0, Seconds (2), MilliSeconds (-40));
+  Simulator::Schedule (MilliSeconds (1900), &MpQuicHandoverTestCase::CheckDraining, this, 0, true);
+  Simulator::Schedule (MilliSeconds (1900), &MpQuicPathManager::NotifyHandover, m_pathManager, 0, Seconds (3), MilliSeconds (-40));
+  Simulator::Schedule (MilliSeconds (1901), &MpQuicHandoverTestCase::CheckDraining, this, 0, false);
+  Simulator::Schedule (MilliSeconds (2001), &MpQuicHandoverTestCase::CheckRtt, this, 0, MilliSeconds (120), MilliSeconds (110));
+  Simulator::Schedule (MilliSeconds (2900), &MpQuicHandoverTestCase::CheckDraining, this, 0, true);
+  Simulator::Schedule (MilliSeconds (3001), &MpQuicHandoverTestCase::CheckDraining, this, 0, false);
+  Simulator::Schedule (MilliSeconds (3001), &MpQuicHandoverTestCase::CheckRtt, this, 0, MilliSeconds (80), MilliSeconds (70));
+
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_handoverPaths.size (), 3, "wrong number of handovers");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) m_handoverPaths[0], 0, "first handover");
+  NS_TEST_EXPECT_MSG_EQ (m_handoverTimes[0], Seconds (1), "time of the first handover");
+  NS_TEST_EXPECT_MSG_EQ (m_handoverRtts[0], MilliSeconds (120), "RTT seeded at the first handover");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) m_handoverPaths[1], 1, "handover of the path without sample");
+  NS_TEST_EXPECT_MSG_EQ (m_handoverRtts[1], Time (0), "path without sample seeded");
+  NS_TEST_EXPECT_MSG_EQ (m_handoverTimes[2], Seconds (3), "replaced handover");
+  NS_TEST_EXPECT_MSG_EQ (m_handoverRtts[2], MilliSeconds (80), "RTT seeded at the replaced handover");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_subflows[0]->m_tcb->m_rttVar, MilliSeconds (5), "RTT variation moved by the handovers");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_subflows[1]->m_tcb->m_lossDetectionAlarm.IsRunning (), false,
+                         "alarm of a path without data in flight armed");
+
+  m_pathManager->Dispose ();
+  m_pathManager = 0;
+  m_socket = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief MP-QUIC path manager TestSuite
+ */
+class MpQuicPathManagerTestSuite : public TestSuite
+{
+public:
+  MpQuicPathManagerTestSuite ()
+    : TestSuite ("mp-quic-path-manager", UNIT)
+  {
+    AddTestCase (new MpQuicHandoverTestCase, TestCase::QUICK);
+  }
+};
+
+static MpQuicPathManagerTestSuite g_mpQuicPathManagerTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/quic-l4-protocol.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Coalescing of the QUIC packets in UDP datagrams
+ *
+ * Packets of boundary sizes are coalesced and split back. Then two UDP
+ * sockets queue packets: the datagram of the one overflowing
+ * MaxDatagramSize is sent at once, the other one keeps growing until the
+ * end of the event, and the datagrams received split back into the
+ * packets sent, in order.
+ */
+class QuicCoalescingTestCase : public TestCase
+{
+public:
+  QuicCoalescingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Coalesce packets and split them back
+   * \param quic the QUIC stack
+   * \param sizes the sizes of the packets
+   */
+  void CheckRoundTrip (Ptr<QuicL4Protocol> quic, const std::vector<uint32_t> &sizes);
+  /**
+   * \brief Check that a packet holds the bytes it was created with
+   * \param packet the packet
+   * \param size its expected size
+   * \param fill its expected bytes
+   * \param msg the message of a failure
+   */
+  void CheckPacket (Ptr<const Packet> packet, uint32_t size, uint8_t fill, std::string msg);
+  /**
+   * \brief Record the datagrams received on a socket
+   * \param socket the receiving socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  std::vector<Ptr<Packet> > m_received[2]; //!< datagrams received on each receiving socket
+};
+
+QuicCoalescingTestCase::QuicCoalescingTestCase ()
+  : TestCase ("Coalescing of QUIC packets in UDP datagrams")
+{
+}
+
+void
+QuicCoalescingTestCase::CheckPacket (Ptr<const Packet> packet, uint32_t size, uint8_t fill, std::string msg)
+{
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), size, msg << ": wrong size");
+  std::vector<uint8_t> bytes (size);
+  packet->CopyData (bytes.data (), size);
+  uint32_t mismatches = 0;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      mismatches += bytes[i] != fill;
+    }
+  NS_TEST_ASSERT_MSG_EQ (mismatches, 0, msg << ": wrong content");
+}
+
+void
+QuicCoalescingTestCase::CheckRoundTrip (Ptr<QuicL4Protocol> quic, const std::vector<uint32_t> &sizes)
+{
+  // 0x40 and up: short header types, never the coalescing marker
+  std::vector<Ptr<Packet> > packets;
+  uint32_t expected = sizes.size () > 1 ? 1 : 0;
+  for (uint32_t i = 0; i < sizes.size (); i++)
+    {
+      std::vector<uint8_t> bytes (sizes[i], 0x40 + i);
+      packets.push_back (Create<Packet> (bytes.data (), sizes[i]));
+      expected += sizes[i] + (sizes.size () > 1 ? 2 : 0);
+    }
+  Ptr<Packet> datagram = quic->CoalesceDatagram (packets);
+  NS_TEST_ASSERT_MSG_EQ (datagram->GetSize (), expected, "wrong datagram size");
+
+  std::vector<Ptr<Packet> > split = quic->SplitDatagram (datagram);
+  NS_TEST_ASSERT_MSG_EQ (split.size (), sizes.size (), "wrong number of packets split");
+  for (uint32_t i = 0; i < sizes.size (); i++)
+    {
+      CheckPacket (split[i], sizes[i], 0x40 + i, "packet split");
+    }
+}
+
+void
+QuicCoalescingTestCase::Receive (Ptr<Socket> socket)
+{
+  Address from;
+  Address local;
+  socket->GetSockName (local);
+  uint16_t port = InetSocketAddress::ConvertFrom (local).GetPort ();
+  Ptr<Packet> datagram;
+  while ((datagram = socket->RecvFrom (from)))
+    {
+      m_received[port - 9].push_back (datagram);
+    }
+}
+
+void
+QuicCoalescingTestCase::DoRun (void)
+{
+  Ptr<QuicL4Protocol> quic = CreateObject<QuicL4Protocol> ();
+
+  CheckRoundTrip (quic, std::vector<uint32_t> {1});
+  CheckRoundTrip (quic, std::vector<uint32_t> {1, 1});
+  CheckRoundTrip (quic, std::vector<uint32_t> {255, 256, 1});
+  CheckRoundTrip (quic, std::vector<uint32_t> {1200, 65535, 7});
+
+  // two senders and two receivers on the loopback
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<Socket> senders[2];
+  for (uint16_t i = 0; i < 2; i++)
+    {
+      Ptr<Socket> receiver = Socket::CreateSocket (node, UdpSocketFactory::GetTypeId ());
+      receiver->Bind (InetSocketAddress (Ipv4Address::GetLoopback (), 9 + i));
+      receiver->SetRecvCallback (MakeCallback (&QuicCoalescingTestCase::Receive, this));
+      senders[i] = Socket::CreateSocket (node, UdpSocketFactory::GetTypeId ());
+      senders[i]->Bind ();
+      senders[i]->Connect (InetSocketAddress (Ipv4Address::GetLoopback (), 9 + i));
+    }
+
+  quic->SetAttribute ("MaxDatagramSize", UintegerValue (100));
+  // 1 + (2 + 47) + (2 + 48) bytes fill the first datagram exactly
+  Simulator::ScheduleNow (&QuicL4Protocol::QueueDatagram, quic, senders[0], Create<Packet> (std::vector<uint8_t> (47, 0x40).data (), 47));
+  Simulator::ScheduleNow (&QuicL4Protocol::QueueDatagram, quic, senders[1], Create<Packet> (std::vector<uint8_t> (10, 0x50).data (), 10));
+  Simulator::ScheduleNow (&QuicL4Protocol::QueueDatagram, quic, senders[0], Create<Packet> (std::vector<uint8_t> (48, 0x41).data (), 48));
+  Simulator::ScheduleNow (&QuicL4Protocol::QueueDatagram, quic, senders[0], Create<Packet> (std::vector<uint8_t> (1, 0x42).data (), 1));
+  Simulator::ScheduleNow (&QuicL4Protocol::QueueDatagram, quic, senders[1], Create<Packet> (std::vector<uint8_t> (20, 0x51).data (), 20));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[0].size (), 2, "the full datagram was not sent first");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0][0]->GetSize (), 100, "the full datagram was not sent whole");
+  std::vector<Ptr<Packet> > split = quic->SplitDatagram (m_received[0][0]);
+  NS_TEST_ASSERT_MSG_EQ (split.size (), 2, "wrong number of packets in the full datagram");
+  CheckPacket (split[0], 47, 0x40, "first packet of the full datagram");
+  CheckPacket (split[1], 48, 0x41, "second packet of the full datagram");
+  split = quic->SplitDatagram (m_received[0][1]);
+  NS_TEST_ASSERT_MSG_EQ (split.size (), 1, "the overflowing packet was not sent alone");
+  CheckPacket (split[0], 1, 0x42, "overflowing packet");
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[1].size (), 1, "the other socket flushed with the full one");
+  split = quic->SplitDatagram (m_received[1][0]);
+  NS_TEST_ASSERT_MSG_EQ (split.size (), 2, "wrong number of packets of the other socket");
+  CheckPacket (split[0], 10, 0x50, "first packet of the other socket");
+  CheckPacket (split[1], 20, 0x51, "second packet of the other socket");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief QUIC coalescing TestSuite
+ */
+class QuicCoalescingTestSuite : public TestSuite
+{
+public:
+  QuicCoalescingTestSuite ()
+    : TestSuite ("quic-coalescing", UNIT)
+  {
+    AddTestCase (new QuicCoalescingTestCase, TestCase::QUICK);
+  }
+};
+
+static QuicCoalescingTestSuite g_quicCoalescingTestSuite; //!< Static variable for test initialization
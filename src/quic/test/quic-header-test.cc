@@ -149,8 +149,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
               case QuicHeader::VERSION_NEGOTIATION: // TODO: Update when full supported
                   head = QuicHeader::CreateVersionNegotiation (connectionId, version, supportedVersions);
 
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   buffer.AddAtStart (head.GetSerializedSize ());
                   head.Serialize (buffer.Begin ());
@@ -163,8 +163,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different connection id found");
                   NS_TEST_ASSERT_MSG_EQ (version, head.GetVersion (),
                                              "Different version found");
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   copyHead.Deserialize (buffer.Begin ());
 
@@ -176,14 +176,14 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different connection id found in deserialized header");
                   NS_TEST_ASSERT_MSG_EQ (version, copyHead.GetVersion (),
                                              "Different version found in deserialized header");
-                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word in deserialized header"); 
+                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word in deserialized header"); 
                   break;
               case QuicHeader::INITIAL:
                   head = QuicHeader::CreateInitial (connectionId, version, packetNumber);
 
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   buffer.AddAtStart (head.GetSerializedSize ());
                   head.Serialize (buffer.Begin ());
@@ -198,8 +198,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, head.GetPacketNumber (),
                                              "Different packet number found");
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   copyHead.Deserialize (buffer.Begin ());
 
@@ -213,14 +213,14 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found in deserialized header");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, copyHead.GetPacketNumber (),
                                              "Different packet number found in deserialized header");
-                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word in deserialized header"); 
+                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word in deserialized header"); 
                   break;
               case QuicHeader::RETRY:
                   head = QuicHeader::CreateRetry (connectionId, version, packetNumber);
 
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   buffer.AddAtStart (head.GetSerializedSize ());
                   head.Serialize (buffer.Begin ());
@@ -235,8 +235,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, head.GetPacketNumber (),
                                              "Different packet number found");
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   copyHead.Deserialize (buffer.Begin ());
 
@@ -250,14 +250,14 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found in deserialized header");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, copyHead.GetPacketNumber (),
                                              "Different packet number found in deserialized header");
-                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word in deserialized header"); 
+                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word in deserialized header"); 
                   break;
               case QuicHeader::HANDSHAKE:
                   head = QuicHeader::CreateHandshake (connectionId, version, packetNumber);
 
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   buffer.AddAtStart (head.GetSerializedSize ());
                   head.Serialize (buffer.Begin ());
@@ -272,8 +272,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, head.GetPacketNumber (),
                                              "Different packet number found");
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   copyHead.Deserialize (buffer.Begin ());
 
@@ -287,14 +287,14 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found in deserialized header");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, copyHead.GetPacketNumber (),
                                              "Different packet number found in deserialized header");
-                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word in deserialized header"); 
+                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word in deserialized header"); 
                   break;
               case QuicHeader::ZRTT_PROTECTED:
                   head = QuicHeader::Create0RTT (connectionId, version, packetNumber);
 
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   buffer.AddAtStart (head.GetSerializedSize ());
                   head.Serialize (buffer.Begin ());
@@ -309,8 +309,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, head.GetPacketNumber (),
                                              "Different packet number found");
-                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word");
+                  NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word");
 
                   copyHead.Deserialize (buffer.Begin ());
 
@@ -324,8 +324,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
                                              "Different version found in deserialized header");
                   NS_TEST_ASSERT_MSG_EQ (packetNumber, copyHead.GetPacketNumber (),
                                              "Different packet number found in deserialized header");
-                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 17, 
-                    "QuicHeader for Long Packet is not 17 word in deserialized header"); 
+                  NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 22, 
+                    "QuicHeader for Long Packet is not 22 word in deserialized header"); 
                   break;
                default:
                   break;
@@ -337,7 +337,8 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
 
         head = QuicHeader::CreateShort (connectionId, packetNumber, connectionIdFlag, keyPhaseBit);
 
-        NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 1 + 8*connectionIdFlag + head.GetPacketNumLen ()/8, 
+        // the 1-byte path id and the 4-byte path sequence number follow the packet number
+        NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 1 + 8*connectionIdFlag + head.GetPacketNumLen ()/8 + 5, 
           "QuicHeader for Short Packet is not as expected");
 
         buffer.AddAtStart (head.GetSerializedSize ());
@@ -353,7 +354,7 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
           NS_TEST_ASSERT_MSG_EQ (connectionId, head.GetConnectionId (),
                                              "Different connection id found");
         }
-        NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 1 + 8*connectionIdFlag + head.GetPacketNumLen ()/8, 
+        NS_TEST_ASSERT_MSG_EQ (head.GetSerializedSize (), 1 + 8*connectionIdFlag + head.GetPacketNumLen ()/8 + 5, 
           "QuicHeader for Short Packet is not as expected");
 
         copyHead.Deserialize (buffer.Begin ());
@@ -368,7 +369,7 @@ QuicHeaderTestCase::TestQuicHeaderSerializeDeserialize ()
           NS_TEST_ASSERT_MSG_EQ (connectionId, copyHead.GetConnectionId (),
                                              "Different connection id found");
         }
-        NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 1 + 8*connectionIdFlag + copyHead.GetPacketNumLen ()/8, 
+        NS_TEST_ASSERT_MSG_EQ (copyHead.GetSerializedSize (), 1 + 8*connectionIdFlag + copyHead.GetPacketNumLen ()/8 + 5, 
           "QuicHeader for Short Packet is not as expected");
     } 
 }
@@ -804,9 +805,12 @@ QuicSubHeaderTestCase::TestQuicSubHeaderSerializeDeserialize ()
                     "QuicSubHeader for STOP_SENDING frame is not as expected in deserialized subheader");
                   break;
               case QuicSubheader::ACK:
-                  head = QuicSubheader::CreateAck (largestAcknowledged, ackDelay, firstAckBlock, gaps, additionalAckBlocks);
+                  head = QuicSubheader::CreateAck (largestAcknowledged, ackDelay, firstAckBlock, gaps, additionalAckBlocks,
+                                                   0, largestAcknowledged);
 
-                  headSize = 1 + QuicSubheader::GetVarInt64Size(largestAcknowledged)/8 + 
+                  // the frame type, the path id and the largest sequence number of the path come first
+                  headSize = 2 + QuicSubheader::GetVarInt64Size(largestAcknowledged)/8 +
+                    QuicSubheader::GetVarInt64Size(largestAcknowledged)/8 + 
                     QuicSubheader::GetVarInt64Size(ackDelay)/8 + QuicSubheader::GetVarInt64Size(gaps.size ())/8 +
                     QuicSubheader::GetVarInt64Size(firstAckBlock)/8;
                   for (uint64_t j = 0; j < gaps.size (); j++)
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ppp-header.h"
+#include "ns3/applications-module.h"
+#include "ns3/quic-helper.h"
+#include "ns3/quic-socket-base.h"
+#include "ns3/quic-socket-factory.h"
+#include "ns3/quic-l4-protocol.h"
+#include "ns3/quic-header.h"
+#include "ns3/quic-subheader.h"
+#include "ns3/mp-quic-typedefs.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Migration of an MP-QUIC path to new client addresses
+ *
+ * A client sends data to an echo server over the two links of the MAMS
+ * scenarios, then moves path 0 with MigratePath: first to another address
+ * of its subnet, where the server keeps the congestion state of the path,
+ * then to an address of another subnet, where the server resets it. The
+ * server only follows each move once the new address answered its
+ * PATH_CHALLENGE. Last, a packet from a new port of the client carries an
+ * unsolicited PATH_RESPONSE with an old packet number: the server ignores
+ * the frame, and the reordered packet does not rebind the path.
+ */
+class QuicMigrationTestCase : public TestCase
+{
+public:
+  QuicMigrationTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// Send a message on the client socket
+  void Send (void);
+  /**
+   * \brief Move path 0 of the client
+   * \param local the new address of the client
+   */
+  void Migrate (Ipv4Address local);
+  /// Send an unsolicited PATH_RESPONSE from a new port, with an old packet number
+  void SendUnsolicitedResponse (void);
+  /// Find the socket of the connection at the server and connect its traces
+  void ConnectServer (void);
+  /**
+   * \brief Record a migration of a path at the server
+   * \param pathId the path
+   * \param oldAddress the address the path was bound to
+   * \param newAddress the address the path is bound to now
+   * \param keepState true if the congestion state was kept
+   */
+  void ServerMigration (uint8_t pathId, const Address &oldAddress, const Address &newAddress, bool keepState);
+  /**
+   * \brief Record the path frames received by the client
+   * \param packet the frame received
+   */
+  void ClientRx (Ptr<const Packet> packet);
+  /**
+   * \brief Count the bytes received by the server
+   * \param packet the data received
+   */
+  void ServerRx (Ptr<const Packet> packet);
+
+  Ptr<Node> m_client;                         //!< The client node
+  Ptr<Node> m_serverNode;                     //!< The server node
+  Ptr<QuicSocketBase> m_clientSocket;         //!< The client end of the connection
+  Ptr<QuicSocketBase> m_serverSocket;         //!< The server end of the connection
+  InetSocketAddress m_server;                 //!< The address of the server
+  std::vector<Address> m_newAddresses;        //!< Client addresses the server moved path 0 to
+  std::vector<bool> m_keptStates;             //!< Whether the server kept the state, per move
+  std::vector<Time> m_migrationTimes;         //!< Times of the moves at the server
+  std::vector<uint32_t> m_windows;            //!< Window of path 0 at the server just after the moves
+  std::vector<uint32_t> m_windowsBefore;      //!< Window of path 0 at the server when the client moved
+  std::vector<Ipv4Address> m_challenged;      //!< Client addresses the server sent a PATH_CHALLENGE to
+  std::vector<Time> m_moveTimes;              //!< Times of the moves at the client
+  uint32_t m_serverRxBytes;                   //!< Bytes received by the server
+  uint32_t m_serverRxBytesAtUnsolicited;      //!< Bytes received by the server when the unsolicited frame was sent
+};
+
+QuicMigrationTestCase::QuicMigrationTestCase ()
+  : TestCase ("Migration of MP-QUIC paths with PATH_CHALLENGE"),
+    m_server (Ipv4Address::GetAny (), 0),
+    m_serverRxBytes (0),
+    m_serverRxBytesAtUnsolicited (0)
+{
+}
+
+void
+QuicMigrationTestCase::Send (void)
+{
+  m_clientSocket->Send (Create<Packet> (500));
+  Simulator::Schedule (MilliSeconds (20), &QuicMigrationTestCase::Send, this);
+}
+
+void
+QuicMigrationTestCase::Migrate (Ipv4Address local)
+{
+  m_windowsBefore.push_back (m_serverSocket->m_subflows[0]->m_cWnd);
+  m_moveTimes.push_back (Simulator::Now ());
+  int ret = m_clientSocket->MigratePath (0, InetSocketAddress (local, 0));
+  NS_TEST_EXPECT_MSG_EQ (ret, 0, "MigratePath to " << local << " failed");
+}
+
+void
+QuicMigrationTestCase::SendUnsolicitedResponse (void)
+{
+  m_serverRxBytesAtUnsolicited = m_serverRxBytes;
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (QuicSubheader::CreatePathResponse (77));
+  QuicHeader head = QuicHeader::CreateShort (m_clientSocket->GetConnectionId (), SequenceNumber32 (1));
+  head.SetPathId (0);
+  p->AddHeader (head);
+
+  Ptr<Socket> udp = Socket::CreateSocket (m_client, UdpSocketFactory::GetTypeId ());
+  udp->Bind (InetSocketAddress (Ipv4Address ("10.3.1.1"), 0));
+  udp->SendTo (p, 0, m_server);
+}
+
+void
+QuicMigrationTestCase::ConnectServer (void)
+{
+  Ptr<QuicL4Protocol> quic = m_serverNode->GetObject<QuicL4Protocol> ();
+  ObjectVectorValue sockets;
+  quic->GetAttribute ("SocketList", sockets);
+  for (ObjectVectorValue::Iterator it = sockets.Begin (); it != sockets.End (); it++)
+    {
+      Ptr<QuicSocketBase> socket = it->second->GetObject<QuicUdpBinding> ()->m_quicSocket;
+      if (socket->GetConnectionId () == m_clientSocket->GetConnectionId ())
+        {
+          m_serverSocket = socket;
+        }
+    }
+  NS_TEST_ASSERT_MSG_NE (m_serverSocket, 0, "no server socket for the connection");
+  m_serverSocket->TraceConnectWithoutContext ("PathMigration", MakeCallback (&QuicMigrationTestCase::ServerMigration, this));
+}
+
+void
+QuicMigrationTestCase::ServerMigration (uint8_t pathId, const Address &oldAddress, const Address &newAddress, bool keepState)
+{
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) pathId, 0, "the server moved a path which did not move");
+  m_newAddresses.push_back (newAddress);
+  m_keptStates.push_back (keepState);
+  m_migrationTimes.push_back (Simulator::Now ());
+  m_windows.push_back (m_serverSocket->m_subflows[0]->m_cWnd);
+}
+
+void
+QuicMigrationTestCase::ClientRx (Ptr<const Packet> packet)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  PppHeader ppp;
+  Ipv4Header ip;
+  UdpHeader udp;
+  QuicHeader head;
+  copy->RemoveHeader (ppp);
+  copy->RemoveHeader (ip);
+  if (ip.GetProtocol () != UdpL4Protocol::PROT_NUMBER)
+    {
+      return;
+    }
+  copy->RemoveHeader (udp);
+  copy->RemoveHeader (head);
+  if (!head.IsShort () || copy->GetSize () == 0)
+    {
+      return;
+    }
+  QuicSubheader frame;
+  copy->PeekHeader (frame);
+  if (frame.IsPathChallenge ())
+    {
+      m_challenged.push_back (ip.GetDestination ());
+    }
+}
+
+void
+QuicMigrationTestCase::ServerRx (Ptr<const Packet> packet)
+{
+  m_serverRxBytes += packet->GetSize ();
+}
+
+void
+QuicMigrationTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  m_client = nodes.Get (0);
+  m_serverNode = nodes.Get (1);
+  QuicHelper stack;
+  stack.InstallQuic (nodes);
+  NetDeviceContainer path0;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      PointToPointHelper link;
+      link.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+      link.SetChannelAttribute ("Delay", StringValue (i == 0 ? "10ms" : "20ms"));
+      NetDeviceContainer devices = link.Install (nodes);
+      std::ostringstream network;
+      network << "10.1." << i + 1 << ".0";
+      Ipv4AddressHelper address;
+      address.SetBase (network.str ().c_str (), "255.255.255.0");
+      address.Assign (devices);
+      if (i == 0)
+        {
+          path0 = devices;
+        }
+    }
+  // another address in the subnet of path 0, and a subnet of its own on the same link
+  Ptr<Ipv4> clientIp = m_client->GetObject<Ipv4> ();
+  Ptr<Ipv4> serverIp = nodes.Get (1)->GetObject<Ipv4> ();
+  uint32_t clientIf = clientIp->GetInterfaceForDevice (path0.Get (0));
+  uint32_t serverIf = serverIp->GetInterfaceForDevice (path0.Get (1));
+  clientIp->AddAddress (clientIf, Ipv4InterfaceAddress (Ipv4Address ("10.1.1.3"), Ipv4Mask ("255.255.255.0")));
+  clientIp->AddAddress (clientIf, Ipv4InterfaceAddress (Ipv4Address ("10.3.1.1"), Ipv4Mask ("255.255.255.0")));
+  serverIp->AddAddress (serverIf, Ipv4InterfaceAddress (Ipv4Address ("10.3.1.2"), Ipv4Mask ("255.255.255.0")));
+  path0.Get (0)->TraceConnectWithoutContext ("MacRx", MakeCallback (&QuicMigrationTestCase::ClientRx, this));
+
+  QuicEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (nodes.Get (1));
+  serverApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&QuicMigrationTestCase::ServerRx, this));
+  serverApps.Start (Seconds (0));
+
+  m_server = InetSocketAddress (Ipv4Address ("10.1.1.2"), 9);
+  m_clientSocket = DynamicCast<QuicSocketBase> (Socket::CreateSocket (m_client, QuicSocketFactory::GetTypeId ()));
+  m_clientSocket->Bind ();
+  Simulator::Schedule (Seconds (1), &Socket::Connect, m_clientSocket, m_server);
+  Simulator::Schedule (Seconds (1.2), &QuicMigrationTestCase::Send, this);
+  Simulator::Schedule (Seconds (1.5), &QuicMigrationTestCase::ConnectServer, this);
+  Simulator::Schedule (Seconds (2), &QuicMigrationTestCase::Migrate, this, Ipv4Address ("10.1.1.3"));
+  Simulator::Schedule (Seconds (3), &QuicMigrationTestCase::Migrate, this, Ipv4Address ("10.3.1.1"));
+  Simulator::Schedule (Seconds (4), &QuicMigrationTestCase::SendUnsolicitedResponse, this);
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_challenged.size (), 2, "the server did not challenge each new address once");
+  NS_TEST_EXPECT_MSG_EQ (m_challenged[0], Ipv4Address ("10.1.1.3"), "wrong address challenged first");
+  NS_TEST_EXPECT_MSG_EQ (m_challenged[1], Ipv4Address ("10.3.1.1"), "wrong address challenged second");
+
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_newAddresses.size (), 2, "the server did not follow the moves");
+  NS_TEST_EXPECT_MSG_EQ (m_newAddresses.size (), 2, "the server moved path 0 without a move of the client");
+  NS_TEST_EXPECT_MSG_EQ (InetSocketAddress::ConvertFrom (m_newAddresses[0]).GetIpv4 (), Ipv4Address ("10.1.1.3"),
+                         "wrong address after the same-subnet move");
+  NS_TEST_EXPECT_MSG_EQ (InetSocketAddress::ConvertFrom (m_newAddresses[1]).GetIpv4 (), Ipv4Address ("10.3.1.1"),
+                         "wrong address after the cross-subnet move");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      // the PATH_CHALLENGE round trip on the 10 ms link
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (m_migrationTimes[i], m_moveTimes[i] + MilliSeconds (20),
+                                   "the server moved path 0 before the PATH_RESPONSE");
+      NS_TEST_EXPECT_MSG_LT (m_migrationTimes[i], m_moveTimes[i] + MilliSeconds (200),
+                             "the server moved path 0 late");
+    }
+
+  // the window only grows with the ACKs received during the PATH_CHALLENGE
+  // round trip, or restarts from 4 segments
+  NS_TEST_EXPECT_MSG_EQ (m_keptStates[0], true, "the same-subnet move reset the congestion state");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (m_windows[0], m_windowsBefore[0], "the same-subnet move shrank the window");
+  NS_TEST_EXPECT_MSG_EQ (m_keptStates[1], false, "the cross-subnet move kept the congestion state");
+  NS_TEST_EXPECT_MSG_GT (m_windowsBefore[1], 4 * 1460, "the window did not grow before the cross-subnet move");
+  NS_TEST_EXPECT_MSG_EQ (m_windows[1], 4 * 1460, "the cross-subnet move did not reset the window");
+
+  // the unsolicited PATH_RESPONSE moved nothing, and the data kept flowing
+  NS_TEST_EXPECT_MSG_GT (m_serverRxBytes, m_serverRxBytesAtUnsolicited, "the connection stalled after the unsolicited PATH_RESPONSE");
+  Address peer;
+  m_serverNode->GetObject<QuicL4Protocol> ()->GetPathPeerName (m_serverSocket, 0, peer);
+  NS_TEST_EXPECT_MSG_EQ (peer, m_newAddresses[1], "the reordered packet moved path 0 to its port");
+
+  m_clientSocket = 0;
+  m_serverSocket = 0;
+  m_client = 0;
+  m_serverNode = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief QUIC migration TestSuite
+ */
+class QuicMigrationTestSuite : public TestSuite
+{
+public:
+  QuicMigrationTestSuite ()
+    : TestSuite ("quic-migration", UNIT)
+  {
+    AddTestCase (new QuicMigrationTestCase, TestCase::QUICK);
+  }
+};
+
+static QuicMigrationTestSuite g_quicMigrationTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/ppp-header.h"
+#include "ns3/quic-helper.h"
+#include "ns3/quic-l4-protocol.h"
+#include "ns3/quic-header.h"
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Resumption of a QuicEchoClient connection with a session ticket
+ *
+ * A QuicEchoClient connects to an echo server with a 1-RTT handshake at
+ * 1 s, closes at 2 s and restarts at 3 s. If the ticket of the first
+ * handshake is still valid, the new connection starts with a 0-RTT
+ * packet; once it expired, with an Initial packet. Both connections
+ * deliver their message.
+ */
+class QuicSessionTicketTestCase : public TestCase
+{
+public:
+  /**
+   * \param lifetime the SessionTicketLifetime of both ends
+   * \param resume true if the restarted connection should start with a 0-RTT handshake
+   */
+  QuicSessionTicketTestCase (Time lifetime, bool resume);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Record the handshake packets sent by the client
+   * \param packet the frame sent
+   */
+  void ClientTx (Ptr<const Packet> packet);
+  /**
+   * \brief Record the messages received by the server
+   * \param packet the data received
+   */
+  void ServerRx (Ptr<const Packet> packet);
+
+  /// \return a description of the test case
+  static std::string Name (Time lifetime, bool resume);
+
+  Time m_lifetime;                     //!< The SessionTicketLifetime of both ends
+  bool m_resume;                       //!< True if the restarted connection should resume
+  std::vector<Time> m_initialTimes;    //!< Times of the Initial packets sent by the client
+  std::vector<Time> m_0rttTimes;       //!< Times of the 0-RTT packets sent by the client
+  std::vector<uint32_t> m_messages;    //!< Sizes of the messages received by the server
+};
+
+QuicSessionTicketTestCase::QuicSessionTicketTestCase (Time lifetime, bool resume)
+  : TestCase (Name (lifetime, resume)),
+    m_lifetime (lifetime),
+    m_resume (resume)
+{
+}
+
+std::string
+QuicSessionTicketTestCase::Name (Time lifetime, bool resume)
+{
+  std::ostringstream oss;
+  oss << "Restart of a QuicEchoClient with a session ticket of " << lifetime.GetSeconds () << " s: "
+      << (resume ? "0-RTT" : "1-RTT") << " handshake";
+  return oss.str ();
+}
+
+void
+QuicSessionTicketTestCase::ClientTx (Ptr<const Packet> packet)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  PppHeader ppp;
+  Ipv4Header ip;
+  UdpHeader udp;
+  QuicHeader head;
+  copy->RemoveHeader (ppp);
+  copy->RemoveHeader (ip);
+  if (ip.GetProtocol () != UdpL4Protocol::PROT_NUMBER)
+    {
+      return;
+    }
+  copy->RemoveHeader (udp);
+  copy->RemoveHeader (head);
+  if (head.IsInitial ())
+    {
+      m_initialTimes.push_back (Simulator::Now ());
+    }
+  else if (head.IsORTT ())
+    {
+      m_0rttTimes.push_back (Simulator::Now ());
+    }
+}
+
+void
+QuicSessionTicketTestCase::ServerRx (Ptr<const Packet> packet)
+{
+  m_messages.push_back (packet->GetSize ());
+}
+
+void
+QuicSessionTicketTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  QuicHelper stack;
+  stack.InstallQuic (nodes);
+  NetDeviceContainer path0;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      PointToPointHelper link;
+      link.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+      link.SetChannelAttribute ("Delay", StringValue (i == 0 ? "10ms" : "20ms"));
+      NetDeviceContainer devices = link.Install (nodes);
+      std::ostringstream network;
+      network << "10.1." << i + 1 << ".0";
+      Ipv4AddressHelper address;
+      address.SetBase (network.str ().c_str (), "255.255.255.0");
+      address.Assign (devices);
+      if (i == 0)
+        {
+          path0 = devices;
+        }
+    }
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      nodes.Get (i)->GetObject<QuicL4Protocol> ()->SetAttribute ("SessionTicketLifetime", TimeValue (m_lifetime));
+    }
+  path0.Get (0)->TraceConnectWithoutContext ("MacTx", MakeCallback (&QuicSessionTicketTestCase::ClientTx, this));
+
+  QuicEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (nodes.Get (1));
+  serverApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&QuicSessionTicketTestCase::ServerRx, this));
+  serverApps.Start (Seconds (0));
+
+  QuicEchoClientHelper echoClient (Ipv4Address ("10.1.1.2"), 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (1));
+  ApplicationContainer clientApps = echoClient.Install (nodes.Get (0));
+  Ptr<QuicEchoClient> client = DynamicCast<QuicEchoClient> (clientApps.Get (0));
+  client->SetFill ("Hello World");
+  clientApps.Start (Seconds (1));
+  // the restarted client sends "Re-Hello World" 2 s after reconnecting
+  client->ScheduleClosing (Seconds (2));
+  client->ScheduleRestart (Seconds (3));
+  Simulator::Stop (Seconds (7));
+  Simulator::Run ();
+
+  bool firstInitial = !m_initialTimes.empty () && m_initialTimes.front () < Seconds (2);
+  NS_TEST_EXPECT_MSG_EQ (firstInitial, true, "the first connection did not start with an Initial packet");
+  uint32_t initials = 0;
+  for (uint32_t i = 0; i < m_initialTimes.size (); i++)
+    {
+      initials += m_initialTimes[i] >= Seconds (3);
+    }
+  if (m_resume)
+    {
+      bool resumed = !m_0rttTimes.empty () && m_0rttTimes.front () < Seconds (3) + MilliSeconds (1);
+      NS_TEST_EXPECT_MSG_EQ (resumed, true, "the restarted connection did not start with a 0-RTT packet");
+      NS_TEST_EXPECT_MSG_EQ (initials, 0, "the restarted connection sent an Initial packet");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_0rttTimes.size (), 0, "the connection resumed with an expired ticket");
+      NS_TEST_EXPECT_MSG_GT (initials, 0, "the restarted connection did not start with an Initial packet");
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (m_messages.size (), 2, "the server did not receive the message of each connection");
+  // SetFill sends the terminating null character too
+  NS_TEST_EXPECT_MSG_EQ (m_messages[0], std::string ("Hello World").size () + 1, "wrong first message");
+  NS_TEST_EXPECT_MSG_EQ (m_messages[1], std::string ("Re-Hello World").size () + 1, "wrong message after the restart");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief QUIC session ticket TestSuite
+ */
+class QuicSessionTicketTestSuite : public TestSuite
+{
+public:
+  QuicSessionTicketTestSuite ()
+    : TestSuite ("quic-session-ticket", UNIT)
+  {
+    AddTestCase (new QuicSessionTicketTestCase (Seconds (10), true), TestCase::QUICK);
+    AddTestCase (new QuicSessionTicketTestCase (Seconds (1), false), TestCase::QUICK);
+  }
+};
+
+static QuicSessionTicketTestSuite g_quicSessionTicketTestSuite; //!< Static variable for test initialization
@@ -207,7 +207,7 @@ QuicTxBufferTestCase::TestRetransmission ()
 
   tcbd = CreateObject<QuicSocketState> ();
 
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 0, "TxBuf miscalculates initial size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 0, "TxBuf miscalculates initial size of in flight segments");
 
   // send a packet from socket tx buffer
   Ptr<Packet> p1 = Create<Packet> (1196);
@@ -216,9 +216,9 @@ QuicTxBufferTestCase::TestRetransmission ()
   p1->AddHeader (sub);
   txBuf.Add (p1);
 
-  Ptr<Packet> ptx = txBuf.NextSequence (1200, SequenceNumber32 (1));
+  Ptr<Packet> ptx = txBuf.NextSequence (1200, SequenceNumber32 (1), 0, 0, false, false, 0);
   NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200, "TxBuf miscalculates size");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200, "TxBuf miscalculates size of in flight segments");
 
   // ack the packet sent
   std::vector<uint32_t> additionalAckBlocks;
@@ -230,12 +230,13 @@ QuicTxBufferTestCase::TestRetransmission ()
   std::vector<Ptr<QuicSocketTxItem>> acked = txBuf.OnAckUpdate (tcbd,
                                                             largestAcknowledged,
                                                             additionalAckBlocks,
-                                                            gaps);
+                                                            gaps,
+                                                            0);
   NS_TEST_ASSERT_MSG_EQ(acked.size (), 1, "Wrong acked packet vector size");
   NS_TEST_ASSERT_MSG_EQ(acked.at (0)->m_packet->GetSize (), 1200, "TxBuf miscalculates size");
   NS_TEST_ASSERT_MSG_EQ(acked.at (0)->m_packetNumber, SequenceNumber32 (1),
                         "TxBuf gets the wrong lost packet ID");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 0, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 0, "TxBuf miscalculates size of in flight segments");
 
   // send other two packets from socket tx buffer but mark them as lost on ack
   Ptr<Packet> p2 = Create<Packet> (1196);
@@ -244,9 +245,9 @@ QuicTxBufferTestCase::TestRetransmission ()
   p2->AddHeader (sub);
   txBuf.Add (p2);
 
-  ptx = txBuf.NextSequence (1200, SequenceNumber32 (2));
+  ptx = txBuf.NextSequence (1200, SequenceNumber32 (2), 0, 0, false, false, 0);
   NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200, "TxBuf miscalculates size");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200, "TxBuf miscalculates size of in flight segments");
 
   Ptr<Packet> p3 = Create<Packet> (1196);
   sub = QuicSubheader::CreateStreamSubHeader (1, 2400, p3->GetSize (), 
@@ -254,58 +255,61 @@ QuicTxBufferTestCase::TestRetransmission ()
   p3->AddHeader (sub);
   txBuf.Add (p3);
 
-  ptx = txBuf.NextSequence (1200, SequenceNumber32 (3));
+  ptx = txBuf.NextSequence (1200, SequenceNumber32 (3), 0, 0, false, false, 0);
   NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200, "TxBuf miscalculates size");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 2400, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 2400, "TxBuf miscalculates size of in flight segments");
 
   acked = txBuf.OnAckUpdate (tcbd,
                              largestAcknowledged,
                              additionalAckBlocks,
-                             gaps);
+                             gaps,
+                             0);
   NS_TEST_ASSERT_MSG_EQ(acked.size (), 0, "Wrong acked packet vector size");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 2400, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 2400, "TxBuf miscalculates size of in flight segments");
 
   // retransmit the first of the two packets
   uint32_t newPackets = 1;
-  txBuf.ResetSentList (newPackets);
-  std::vector<Ptr<QuicSocketTxItem>> lostPackets = txBuf.DetectLostPackets ();
+  txBuf.ResetSentList (0, newPackets);
+  std::vector<Ptr<QuicSocketTxItem>> lostPackets = txBuf.DetectLostPackets (0);
   NS_TEST_ASSERT_MSG_EQ(lostPackets.size (), 1, "Wrong lost packet vector size");
   NS_TEST_ASSERT_MSG_EQ(lostPackets.at (0)->m_packet->GetSize (), 1200, "TxBuf miscalculates size");
   NS_TEST_ASSERT_MSG_EQ(lostPackets.at (0)->m_packetNumber, SequenceNumber32 (2),
                         "TxBuf gets the wrong lost packet ID");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 2400, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 2400, "TxBuf miscalculates size of in flight segments");
 
-  uint32_t toRetx = txBuf.Retransmission (SequenceNumber32(2));
+  uint32_t toRetx = txBuf.Retransmission (SequenceNumber32 (2), 0);
   NS_TEST_ASSERT_MSG_EQ(toRetx, 1200, "wrong number of lost bytes");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200, "TxBuf miscalculates size of in flight segments");
 
-  ptx = txBuf.NextSequence (toRetx, SequenceNumber32 (4));
+  ptx = txBuf.NextSequence (toRetx, SequenceNumber32 (4), 0, 0, false, false, 0);
   NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200, "TxBuf miscalculates size");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 2400, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 2400, "TxBuf miscalculates size of in flight segments");
 
   // ack the previous packet but not the retransmitted one
   largestAcknowledged = 3;
   acked = txBuf.OnAckUpdate (tcbd,
                              largestAcknowledged,
                              additionalAckBlocks,
-                             gaps);
+                             gaps,
+                             0);
   NS_TEST_ASSERT_MSG_EQ(acked.size (), 1, "Wrong acked packet vector size");
   NS_TEST_ASSERT_MSG_EQ(acked.at (0)->m_packet->GetSize (), 1200, "TxBuf miscalculates size");
   NS_TEST_ASSERT_MSG_EQ(acked.at (0)->m_packetNumber, SequenceNumber32 (3),
                         "TxBuf gets the wrong lost packet ID");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200, "TxBuf miscalculates size of in flight segments");
 
   // ack also the retransmitted packet
   largestAcknowledged = 4;
   acked = txBuf.OnAckUpdate (tcbd,
                              largestAcknowledged,
                              additionalAckBlocks,
-                             gaps);
+                             gaps,
+                             0);
   NS_TEST_ASSERT_MSG_EQ(acked.size (), 1, "Wrong acked packet vector size");
   NS_TEST_ASSERT_MSG_EQ(acked.at (0)->m_packet->GetSize (), 1200, "TxBuf miscalculates size");
   NS_TEST_ASSERT_MSG_EQ(acked.at (0)->m_packetNumber, SequenceNumber32 (4),
                         "TxBuf gets the wrong lost packet ID");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 0, "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 0, "TxBuf miscalculates size of in flight segments");
 }
 
 void
@@ -492,7 +496,7 @@ QuicTxBufferTestCase::TestNewBlock ()
   tcbd = CreateObject<QuicSocketState> ();
 
   NS_TEST_ASSERT_MSG_EQ(
-      txBuf.BytesInFlight (), 0,
+      txBuf.BytesInFlight (0), 0,
       "TxBuf miscalculates initial size of in flight segments");
 
   // get a packet which is exactly the same stored
@@ -504,10 +508,10 @@ QuicTxBufferTestCase::TestNewBlock ()
   NS_TEST_ASSERT_MSG_EQ(p1->GetSize (), 1200, "Wrong header size");
 
   
-  Ptr<Packet> ptx = txBuf.NextSequence (1200, SequenceNumber32 (1));
+  Ptr<Packet> ptx = txBuf.NextSequence (1200, SequenceNumber32 (1), 0, 0, false, false, 0);
   
   NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200, "TxBuf miscalculates size");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
   
   std::vector<uint32_t> additionalAckBlocks;
@@ -518,11 +522,12 @@ QuicTxBufferTestCase::TestNewBlock ()
   std::vector<Ptr<QuicSocketTxItem>> acked = txBuf.OnAckUpdate (tcbd,
                                                                 largestAcknowledged,
                                                                 additionalAckBlocks,
-                                                                gaps);
+                                                                gaps,
+                                                                0);
   NS_TEST_ASSERT_MSG_EQ(acked.size (), 1, "Wrong acked packet vector size");
   NS_TEST_ASSERT_MSG_EQ(acked.at (0)->m_packet->GetSize (), 1200,
                         "TxBuf miscalculates size");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 0,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 0,
                         "TxBuf miscalculates size of in flight segments");
   
   // starts over the boundary, but ends earlier
@@ -533,18 +538,18 @@ QuicTxBufferTestCase::TestNewBlock ()
   p2->AddHeader (sub);
   txBuf.Add (p2);
   
-  ptx = txBuf.NextSequence (1200, SequenceNumber32 (2));
+  ptx = txBuf.NextSequence (1200, SequenceNumber32 (2), 0, 0, false, false, 0);
   NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200,
                         "Returned packet has different size than requested");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
   
-  ptx = txBuf.NextSequence (3000, SequenceNumber32 (3));
+  ptx = txBuf.NextSequence (3000, SequenceNumber32 (3), 0, 0, false, false, 0);
   // Expecting 3000 (added, including QuicSubheader 4) - 1200 (extracted, including QuicSubheader 4)
   // + 6 (QuicSubheader of the new packet, with both the length and the offset)
   NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1806, 
                         "Returned packet has different size than requested");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 3006,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 3006,
                         "TxBuf miscalculates size of in flight segments");
   
   // starts over the boundary, but ends after
@@ -558,18 +563,24 @@ QuicTxBufferTestCase::TestNewBlock ()
                                               true, false);
   p4->AddHeader (sub);
   txBuf.Add (p4);
-  ptx = txBuf.NextSequence (2400, SequenceNumber32 (4));
-  NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 2400,
+  // the multipath scheduler takes at most one new frame per packet, p4 waits for the next one
+  ptx = txBuf.NextSequence (2400, SequenceNumber32 (4), 0, 0, false, false, 0);
+  NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200,
                         "Returned packet has different size than requested");
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 5406,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 4206,
+                        "TxBuf miscalculates size of in flight segments");
+  ptx = txBuf.NextSequence (2400, SequenceNumber32 (5), 0, 0, false, false, 0);
+  NS_TEST_ASSERT_MSG_EQ(ptx->GetSize (), 1200,
+                        "Returned packet has different size than requested");
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 5406,
                         "TxBuf miscalculates size of in flight segments");
   
   additionalAckBlocks.pop_back ();
-  largestAcknowledged = 4;
+  largestAcknowledged = 5;
   // Clear everything
   acked = txBuf.OnAckUpdate (tcbd, largestAcknowledged, additionalAckBlocks,
-                             gaps);
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 0,
+                             gaps, 0);
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 0,
                         "TxBuf miscalculates size of in flight segments");
   
 }
@@ -607,14 +618,14 @@ QuicTxBufferTestCase::TestPartialAck ()
   txBuf.Add (p6);
 
   // send the packets with successive sequence numbers
-  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1));
-  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2));
-  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3));
-  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4));
-  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5));
-  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6));
-
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 7200,
+  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1), 0, 0, false, false, 0);
+  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2), 0, 0, false, false, 0);
+  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3), 0, 0, false, false, 0);
+  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4), 0, 0, false, false, 0);
+  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5), 0, 0, false, false, 0);
+  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6), 0, 0, false, false, 0);
+
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 7200,
                         "TxBuf miscalculates size of in flight segments");
 
   std::vector<uint32_t> additionalAckBlocks;
@@ -627,9 +638,10 @@ QuicTxBufferTestCase::TestPartialAck ()
   std::vector<Ptr<QuicSocketTxItem>> acked = txBuf.OnAckUpdate (tcbd,
                                                             largestAcknowledged,
                                                             additionalAckBlocks,
-                                                            gaps);
+                                                            gaps,
+                                                            0);
 
-  std::vector<Ptr<QuicSocketTxItem>> lost = txBuf.DetectLostPackets ();
+  std::vector<Ptr<QuicSocketTxItem>> lost = txBuf.DetectLostPackets (0);
   NS_TEST_ASSERT_MSG_EQ(lost.empty (), true,
                         "TxBuf detects a non-existent loss");
   //NS_TEST_ASSERT_MSG_EQ(
@@ -653,7 +665,7 @@ QuicTxBufferTestCase::TestPartialAck ()
           "TxBuf does not correctly detect the IDs of ACKed packets");
     }
 
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
 }
 
@@ -690,14 +702,14 @@ QuicTxBufferTestCase::TestAckLoss ()
   txBuf.Add (p6);
 
   // send the packets with successive sequence numbers
-  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1));
-  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2));
-  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3));
-  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4));
-  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5));
-  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6));
-
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 7200,
+  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1), 0, 0, false, false, 0);
+  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2), 0, 0, false, false, 0);
+  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3), 0, 0, false, false, 0);
+  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4), 0, 0, false, false, 0);
+  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5), 0, 0, false, false, 0);
+  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6), 0, 0, false, false, 0);
+
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 7200,
                         "TxBuf miscalculates size of in flight segments");
 
   std::vector<uint32_t> additionalAckBlocks;
@@ -710,9 +722,10 @@ QuicTxBufferTestCase::TestAckLoss ()
   std::vector<Ptr<QuicSocketTxItem>> acked = txBuf.OnAckUpdate (tcbd,
                                                             largestAcknowledged,
                                                             additionalAckBlocks,
-                                                            gaps);
+                                                            gaps,
+                                                            0);
 
-  std::vector<Ptr<QuicSocketTxItem>> lost = txBuf.DetectLostPackets ();
+  std::vector<Ptr<QuicSocketTxItem>> lost = txBuf.DetectLostPackets (0);
   NS_TEST_ASSERT_MSG_EQ(
       acked.size(), 5,
       "TxBuf does not correctly detect the number of ACKed packets");
@@ -740,7 +753,7 @@ QuicTxBufferTestCase::TestAckLoss ()
       lost.at (0)->m_packetNumber.GetValue (), 2,
       "TxBuf does not correctly detect the IDs of lost packets");
 
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
 }
 
@@ -777,21 +790,21 @@ QuicTxBufferTestCase::TestSetLoss ()
   txBuf.Add (p6);
 
   // send the packets with successive sequence numbers
-  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1));
-  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2));
-  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3));
-  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4));
-  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5));
-  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6));
-
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 7200,
+  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1), 0, 0, false, false, 0);
+  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2), 0, 0, false, false, 0);
+  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3), 0, 0, false, false, 0);
+  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4), 0, 0, false, false, 0);
+  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5), 0, 0, false, false, 0);
+  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6), 0, 0, false, false, 0);
+
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 7200,
                         "TxBuf miscalculates size of in flight segments");
   bool found = txBuf.MarkAsLost (SequenceNumber32 (4));
 
   NS_TEST_ASSERT_MSG_EQ(found, true, "TxBuf misses lost packet");
 
   // mark packet 4 as lost
-  std::vector<Ptr<QuicSocketTxItem>> lost = txBuf.DetectLostPackets ();
+  std::vector<Ptr<QuicSocketTxItem>> lost = txBuf.DetectLostPackets (0);
 
   NS_TEST_ASSERT_MSG_EQ(lost.size (), 1,
                         "TxBuf cannot set the correct number of lost packets");
@@ -799,9 +812,9 @@ QuicTxBufferTestCase::TestSetLoss ()
                         "TxBuf gets the wrong lost packet ID");
 
   // mark packets 1 and 2 as lost (all except the last 4)
-  txBuf.ResetSentList (4);
+  txBuf.ResetSentList (0, 4);
 
-  lost = txBuf.DetectLostPackets ();
+  lost = txBuf.DetectLostPackets (0);
 
   NS_TEST_ASSERT_MSG_EQ(lost.size (), 3,
                         "TxBuf cannot set the correct number of lost packets");
@@ -812,7 +825,7 @@ QuicTxBufferTestCase::TestSetLoss ()
   NS_TEST_ASSERT_MSG_EQ(lost.at (2)->m_packetNumber, SequenceNumber32 (4),
                         "TxBuf gets the wrong lost packet ID");
 
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 7200,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 7200,
                         "TxBuf miscalculates size of in flight segments");
 }
 
@@ -855,14 +868,14 @@ QuicTxBufferTestCase::TestAddBlocks ()
   NS_TEST_ASSERT_MSG_EQ(extra, false, "TxBuf adds a packet in overflow");
 
   // send the packets with successive sequence numbers
-  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1));
-  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2));
-  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3));
-  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4));
-  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5));
-  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6));
-
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 6000,
+  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1), 0, 0, false, false, 0);
+  Ptr<Packet> ptx2 = txBuf.NextSequence (1200, SequenceNumber32 (2), 0, 0, false, false, 0);
+  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3), 0, 0, false, false, 0);
+  Ptr<Packet> ptx4 = txBuf.NextSequence (1200, SequenceNumber32 (4), 0, 0, false, false, 0);
+  Ptr<Packet> ptx5 = txBuf.NextSequence (1200, SequenceNumber32 (5), 0, 0, false, false, 0);
+  Ptr<Packet> ptx6 = txBuf.NextSequence (1200, SequenceNumber32 (6), 0, 0, false, false, 0);
+
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 6000,
                         "TxBuf miscalculates size of in flight segments");
 }
 
@@ -896,16 +909,16 @@ QuicTxBufferTestCase::TestStream0 ()
   txBuf.Add (p3);
 
   // send the packets with successive sequence numbers
-  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1));
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+  Ptr<Packet> ptx1 = txBuf.NextSequence (1200, SequenceNumber32 (1), 0, 0, false, false, 0);
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
 
   Ptr<Packet> ptx2 = txBuf.NextStream0Sequence (SequenceNumber32 (2));
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
 
-  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3));
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 2400,
+  Ptr<Packet> ptx3 = txBuf.NextSequence (1200, SequenceNumber32 (3), 0, 0, false, false, 0);
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 2400,
                         "TxBuf miscalculates size of in flight segments");
 
   std::vector<uint32_t> additionalAckBlocks;
@@ -917,8 +930,9 @@ QuicTxBufferTestCase::TestStream0 ()
   std::vector<Ptr<QuicSocketTxItem>> acked = txBuf.OnAckUpdate (tcbd,
                                                             largestAcknowledged,
                                                             additionalAckBlocks,
-                                                            gaps);
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+                                                            gaps,
+                                                            0);
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
 
   largestAcknowledged = 2;
@@ -928,8 +942,9 @@ QuicTxBufferTestCase::TestStream0 ()
   acked = txBuf.OnAckUpdate (tcbd,
                                                             largestAcknowledged,
                                                             additionalAckBlocks,
-                                                            gaps);
-  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (), 1200,
+                                                            gaps,
+                                                            0);
+  NS_TEST_ASSERT_MSG_EQ(txBuf.BytesInFlight (0), 1200,
                         "TxBuf miscalculates size of in flight segments");
 }
 
@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the setup of short QUIC connections. A client
+// opens connections to a QuicEchoServer at a fixed rate over the two links
+// of the MAMS scenarios; each connection sends one small message, then
+// closes. With session tickets, the connections opened once a first
+// handshake is over resume with a 0-RTT handshake. The program prints the
+// mean setup latency (Connect to connection succeeded, zero for a 0-RTT
+// connection), the mean latency of the first byte at the server and the
+// simulator CPU time per connection, and the number of datagrams sent on
+// the links, which piggybacking the pending ACKs and coalescing the packets
+// sent together lower.
+// Sample usage:  ./waf --run 'bench-quic-churn --connections=5000 --tickets=1'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/quic-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * One short connection: connect, send a message, close
+ */
+class BenchQuicConnection
+{
+public:
+  /**
+   * \param node the node of the client
+   * \param server the address of the server
+   * \param id the id of the connection, written in its message
+   * \param size the size of the message, in bytes
+   */
+  BenchQuicConnection (Ptr<Node> node, InetSocketAddress server, uint32_t id, uint32_t size)
+    : m_node (node),
+      m_server (server),
+      m_id (id),
+      m_size (size),
+      m_setup (Seconds (-1))
+  {
+  }
+
+  /// Open the connection
+  void Start (void)
+  {
+    m_socket = Socket::CreateSocket (m_node, QuicSocketFactory::GetTypeId ());
+    m_socket->Bind ();
+    m_socket->SetConnectCallback (MakeCallback (&BenchQuicConnection::Connected, this),
+                                  MakeNullCallback<void, Ptr<Socket> > ());
+    m_start = Simulator::Now ();
+    m_socket->Connect (m_server);
+  }
+
+  /// \return the time Connect was called at
+  Time GetStart (void) const
+  {
+    return m_start;
+  }
+
+  /// \return the setup latency, negative if the connection did not succeed
+  Time GetSetup (void) const
+  {
+    return m_setup;
+  }
+
+private:
+  /// \param socket the connected socket
+  void Connected (Ptr<Socket> socket)
+  {
+    m_setup = Simulator::Now () - m_start;
+    // the id in the first bytes identifies the connection at the server
+    std::vector<uint8_t> data (std::max (m_size, 4U), 0);
+    for (uint32_t i = 0; i < 4; i++)
+      {
+        data[i] = (m_id >> (8 * i)) & 0xff;
+      }
+    socket->Send (Create<Packet> (data.data (), data.size ()));
+    Simulator::Schedule (Seconds (1), &BenchQuicConnection::Close, this);
+  }
+  /// Close the connection
+  void Close (void)
+  {
+    m_socket->Close ();
+  }
+
+  Ptr<Node> m_node;             //!< node of the client
+  InetSocketAddress m_server;   //!< address of the server
+  uint32_t m_id;                //!< id of the connection
+  uint32_t m_size;              //!< size of the message
+  Ptr<Socket> m_socket;         //!< the connection
+  Time m_start;                 //!< time Connect was called at
+  Time m_setup;                 //!< setup latency
+};
+
+/// Stream buffer discarding everything
+class NullBuffer : public std::streambuf
+{
+protected:
+  virtual int overflow (int c)
+  {
+    return c;
+  }
+};
+
+/// The connections of the benchmark
+static std::vector<BenchQuicConnection *> g_connections;
+/// Latency of the first byte at the server, per connection
+static std::vector<Time> g_firstByte;
+/// Datagrams sent on the links
+static uint64_t g_datagrams = 0;
+
+/**
+ * Count a datagram sent on a link
+ * \param packet the datagram
+ */
+static void
+PhyTxEnd (Ptr<const Packet> packet)
+{
+  g_datagrams++;
+}
+
+/**
+ * Record the first message of a connection received by the server
+ * \param packet the data received
+ */
+static void
+ServerRx (Ptr<const Packet> packet)
+{
+  uint8_t id[4];
+  if (packet->CopyData (id, 4) < 4)
+    {
+      return;
+    }
+  uint32_t i = id[0] | (id[1] << 8) | (id[2] << 16) | ((uint32_t) id[3] << 24);
+  if (i < g_firstByte.size () && g_firstByte[i].IsStrictlyNegative ())
+    {
+      g_firstByte[i] = Simulator::Now () - g_connections[i]->GetStart ();
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nConnections = 1000;
+  double rate = 1000;
+  uint32_t size = 1000;
+  bool tickets = true;
+  bool coalesce = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("connections", "number of connections", nConnections);
+  cmd.AddValue ("rate", "connections opened per second", rate);
+  cmd.AddValue ("size", "size of the message of a connection in bytes, one packet at most", size);
+  cmd.AddValue ("tickets", "resume with a 0-RTT handshake after the first handshake", tickets);
+  cmd.AddValue ("coalesce", "piggyback the pending ACKs and send the packets sent together in one datagram", coalesce);
+  cmd.Parse (argc, argv);
+
+  if (tickets)
+    {
+      Config::SetDefault ("ns3::QuicL4Protocol::SessionTicketLifetime", TimeValue (Seconds (3600)));
+    }
+  Config::SetDefault ("ns3::QuicSocketBase::PiggybackPendingAcks", BooleanValue (coalesce));
+  Config::SetDefault ("ns3::QuicL4Protocol::CoalescePackets", BooleanValue (coalesce));
+
+  // client and server joined by the two links of the MAMS scenarios, the
+  // server at 10.1.1.2 and 10.1.2.2
+  NodeContainer nodes;
+  nodes.Create (2);
+  QuicHelper stack;
+  stack.InstallQuic (nodes);
+  Ipv4InterfaceContainer path0;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      PointToPointHelper link;
+      link.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+      link.SetChannelAttribute ("Delay", StringValue (i == 0 ? "10ms" : "20ms"));
+      std::ostringstream network;
+      network << "10.1." << i + 1 << ".0";
+      Ipv4AddressHelper address;
+      address.SetBase (network.str ().c_str (), "255.255.255.0");
+      Ipv4InterfaceContainer interfaces = address.Assign (link.Install (nodes));
+      if (i == 0)
+        {
+          path0 = interfaces;
+        }
+    }
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::PointToPointNetDevice/PhyTxEnd",
+                                 MakeCallback (&PhyTxEnd));
+
+  QuicEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (nodes.Get (1));
+  serverApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&ServerRx));
+  serverApps.Start (Seconds (0));
+
+  g_firstByte.assign (nConnections, Seconds (-1));
+  for (uint32_t i = 0; i < nConnections; i++)
+    {
+      BenchQuicConnection *connection = new BenchQuicConnection (nodes.Get (0), InetSocketAddress (path0.GetAddress (1), 9),
+                                                                 i, size);
+      g_connections.push_back (connection);
+      Simulator::Schedule (Seconds (1 + i / rate), &BenchQuicConnection::Start, connection);
+    }
+
+  // the sockets print on std::cout
+  std::streambuf *out = std::cout.rdbuf ();
+  NullBuffer null;
+  std::cout.rdbuf (&null);
+
+  SystemWallClockMs wall;
+  std::clock_t cpuStart = std::clock ();
+  wall.Start ();
+  Simulator::Stop (Seconds (1 + nConnections / rate + 3));
+  Simulator::Run ();
+  int64_t wallMs = wall.End ();
+  double cpu = double (std::clock () - cpuStart) / CLOCKS_PER_SEC;
+  Time end = Simulator::Now ();
+  Simulator::Destroy ();
+  std::cout.rdbuf (out);
+
+  uint32_t connected = 0;
+  uint32_t resumed = 0;
+  uint32_t delivered = 0;
+  double setup = 0;
+  double firstByte = 0;
+  for (uint32_t i = 0; i < nConnections; i++)
+    {
+      if (!g_connections[i]->GetSetup ().IsStrictlyNegative ())
+        {
+          connected++;
+          resumed += g_connections[i]->GetSetup ().IsZero ();
+          setup += g_connections[i]->GetSetup ().GetSeconds ();
+        }
+      if (!g_firstByte[i].IsStrictlyNegative ())
+        {
+          delivered++;
+          firstByte += g_firstByte[i].GetSeconds ();
+        }
+      delete g_connections[i];
+    }
+  std::cout << "tickets,coalesce,connections,connected,resumed,delivered,datagrams,setup_ms,first_byte_ms,sim_s,wall_s,cpu_s,cpu_ms_per_conn" << std::endl;
+  std::cout << tickets << "," << coalesce << "," << nConnections << "," << connected << "," << resumed << ","
+            << delivered << "," << g_datagrams << ","
+            << (connected ? 1000 * setup / connected : 0) << ","
+            << (delivered ? 1000 * firstByte / delivered : 0) << ","
+            << end.GetSeconds () << "," << wallMs / 1000.0 << "," << cpu << ","
+            << (nConnections ? 1000 * cpu / nConnections : 0) << std::endl;
+  return 0;
+}
@@ -145,12 +145,87 @@ Bench::Cb (void)
 }
 
 
+/**
+ * Event intervals of a QUIC transfer: ACK timers and events scheduled
+ * one time step ahead, packet pacing, RTT scale timers (delayed ACKs,
+ * loss detection, probes) and a tail of idle and handshake timeouts.
+ */
+class QuicIntervals : public RandomVariableStream
+{
+public:
+  QuicIntervals ()
+  {
+    m_choice = CreateObject<UniformRandomVariable> ();
+    m_pacing = CreateObject<UniformRandomVariable> ();
+    m_pacing->SetAttribute ("Min", DoubleValue (1000));
+    m_pacing->SetAttribute ("Max", DoubleValue (120000));
+    m_rtt = CreateObject<ExponentialRandomVariable> ();
+    m_rtt->SetAttribute ("Mean", DoubleValue (50e6));
+    m_rtt->SetAttribute ("Bound", DoubleValue (1e9));
+    m_timeout = CreateObject<UniformRandomVariable> ();
+    m_timeout->SetAttribute ("Min", DoubleValue (5e9));
+    m_timeout->SetAttribute ("Max", DoubleValue (30e9));
+  }
+
+  /**
+   * 
+eturn an interval in ns
+   */
+  virtual double GetValue (void)
+  {
+    double choice = m_choice->GetValue ();
+    if (choice < 0.4)
+      {
+        return 1;
+      }
+    if (choice < 0.8)
+      {
+        return m_pacing->GetValue ();
+      }
+    if (choice < 0.95)
+      {
+        return m_rtt->GetValue ();
+      }
+    return m_timeout->GetValue ();
+  }
+
+  /**
+   * 
+eturn an interval in ns
+   */
+  virtual uint32_t GetInteger (void)
+  {
+    return (uint32_t)GetValue ();
+  }
+
+private:
+  Ptr<UniformRandomVariable> m_choice; ///< picks the kind of event
+  Ptr<UniformRandomVariable> m_pacing; ///< pacing intervals
+  Ptr<ExponentialRandomVariable> m_rtt; ///< RTT scale timers
+  Ptr<UniformRandomVariable> m_timeout; ///< idle timeouts
+};
+
+
 Ptr<RandomVariableStream>
-GetRandomStream (std::string filename)
+GetRandomStream (std::string filename, std::string dist)
 {
   Ptr<RandomVariableStream> stream = 0;
 
-  if (filename == "")
+  if (filename == "" && dist == "quic")
+    {
+      LOGME ("using QUIC-like distribution: 40% 1 ns, 40% pacing in [1, 120] us, "
+             "15% exponential with mean 50 ms, 5% timeouts in [5, 30] s");
+      stream = CreateObject<QuicIntervals> ();
+    }
+  else if (filename == "" && dist == "bimodal")
+    {
+      LOGME ("using bimodal distribution: 90% 1 ns, 10% 10 s");
+      Ptr<EmpiricalRandomVariable> erv = CreateObject<EmpiricalRandomVariable> ();
+      erv->CDF (1, 0.9);
+      erv->CDF (10e9, 1.0);
+      stream = erv;
+    }
+  else if (filename == "")
     {
       LOGME ("using default exponential distribution");
       Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
@@ -208,11 +283,14 @@ int main (int argc, char *argv[])
   bool schedList          = false;
   bool schedMap           = true;
   bool schedPriorityQueue = false;
+  bool schedLadder        = false;
+  bool schedAll           = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
   uint32_t runs  =       1;
   std::string filename = "";
+  std::string dist = "exp";
   bool calRev = false;
 
   CommandLine cmd (__FILE__);
@@ -220,6 +298,9 @@ int main (int argc, char *argv[])
              "\n"
              "Event intervals are taken from one of:\n"
              "  an exponential distribution, with mean 100 ns,\n"
+             "  a QUIC-like mix of 1 ns timers, pacing, RTT scale timers\n"
+             "  and timeouts, by the argument --dist=quic,\n"
+             "  a mix of 1 ns and 10 s intervals, by the argument --dist=bimodal,\n"
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
@@ -230,15 +311,20 @@ int main (int argc, char *argv[])
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("pri",   "use PriorityQueue",             schedPriorityQueue);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
+  cmd.AddValue ("all",   "run all the schedulers but the ListScheduler in turn", schedAll);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
   cmd.AddValue ("file",  "file of relative event times",  filename);
+  cmd.AddValue ("dist",  "distribution of the event intervals: exp, quic or bimodal", dist);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
   cmd.Parse (argc, argv);
   g_me = cmd.GetName () + ": ";
   g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+  NS_ABORT_MSG_UNLESS (dist == "exp" || dist == "quic" || dist == "bimodal",
+                       "Unknown distribution " << dist);
 
   ObjectFactory factory ("ns3::MapScheduler");
   if (schedCal)
@@ -258,60 +344,86 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::PriorityQueueScheduler");
     }
-      
-  Simulator::SetScheduler (factory);
+  if (schedLadder)
+    {
+      factory.SetTypeId ("ns3::LadderScheduler");
+    }
+
+  std::vector<ObjectFactory> factories;
+  if (schedAll)
+    {
+      // the insertion in the ListScheduler is linear in the population
+      const char *names[] = {"ns3::MapScheduler", "ns3::HeapScheduler", "ns3::CalendarScheduler",
+                             "ns3::PriorityQueueScheduler", "ns3::LadderScheduler"};
+      for (uint32_t i = 0; i < sizeof (names) / sizeof (names[0]); i++)
+        {
+          factories.push_back (ObjectFactory (names[i]));
+        }
+      factories[2].Set ("Reverse", BooleanValue (calRev));
+    }
+  else
+    {
+      factories.push_back (factory);
+    }
 
   LOGME (std::setprecision (g_fwidth - 6));
   DEB ("debugging is ON");
 
-  std::string order;
-  if (schedCal)
-    {
-      order = ": insertion order: " + std::string (calRev ? "reverse" : "normal");
-    }
-  LOGME ("scheduler: " << factory.GetTypeId ().GetName () << order);
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
 
   Bench *bench = new Bench (pop, total);
-  bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetRandomStream (GetRandomStream (filename, dist));
 
-  // table header
-  LOG ("");
-  LOG (std::left << std::setw (g_fwidth) << "Run #" <<
-       std::left << std::setw (3 * g_fwidth) << "Initialization:" <<
-       std::left << std::setw (3 * g_fwidth) << "Simulation:");
-  LOG (std::left << std::setw (g_fwidth) << "" <<
-       std::left << std::setw (g_fwidth) << "Time (s)" <<
-       std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
-       std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
-       std::left << std::setw (g_fwidth) << "Time (s)" <<
-       std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
-       std::left << std::setw (g_fwidth) << "Per (s/ev)" );
-  LOG (std::setfill ('-') <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::setfill (' ')
-       );
-
-  // prime
-  DEB ("priming");
-  std::cout << std::left << std::setw (g_fwidth) << "(prime)";
-  bench->RunBench ();
-
-  bench->SetPopulation (pop);
-  bench->SetTotal (total);
-  for (uint32_t i = 0; i < runs; i++)
+  for (uint32_t f = 0; f < factories.size (); f++)
     {
-      std::cout << std::setw (g_fwidth) << i;
+      Simulator::SetScheduler (factories[f]);
 
+      std::string order;
+      if (factories[f].GetTypeId ().GetName () == "ns3::CalendarScheduler")
+        {
+          order = ": insertion order: " + std::string (calRev ? "reverse" : "normal");
+        }
+      LOG ("");
+      LOGME ("scheduler: " << factories[f].GetTypeId ().GetName () << order);
+
+      // table header
+      LOG ("");
+      LOG (std::left << std::setw (g_fwidth) << "Run #" <<
+           std::left << std::setw (3 * g_fwidth) << "Initialization:" <<
+           std::left << std::setw (3 * g_fwidth) << "Simulation:");
+      LOG (std::left << std::setw (g_fwidth) << "" <<
+           std::left << std::setw (g_fwidth) << "Time (s)" <<
+           std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
+           std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+           std::left << std::setw (g_fwidth) << "Time (s)" <<
+           std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
+           std::left << std::setw (g_fwidth) << "Per (s/ev)" );
+      LOG (std::setfill ('-') <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::setfill (' ')
+           );
+
+      // prime
+      DEB ("priming");
+      std::cout << std::left << std::setw (g_fwidth) << "(prime)";
       bench->RunBench ();
+
+      bench->SetPopulation (pop);
+      bench->SetTotal (total);
+      for (uint32_t i = 0; i < runs; i++)
+        {
+          std::cout << std::setw (g_fwidth) << i;
+
+          bench->RunBench ();
+        }
     }
 
   LOG ("");
@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the DASH StreamServer with many clients. Each
+// client requests a number of segments over TCP, one after the other,
+// through a router connecting it to the server. The clients are bare
+// request loops rather than StreamClient applications. The program prints
+// the time spent in the handlers of the server, which includes the sends
+// they trigger down the server's TCP stack, per delivered MB, next to the
+// CPU time of the whole process. The rest of the process, the clients, the
+// router and the events of the stacks, is linear in the number of clients:
+// compare the server time of builds with the same number of clients.
+// Sample usage:  ./waf --run 'bench-stream-server --clients=1000'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/stream-server.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * Requests segments from the server one after the other
+ */
+class BenchStreamClient
+{
+public:
+  /**
+   * \param node the node of the client
+   * \param server the address of the server
+   * \param segments the number of segments to request
+   * \param segmentSize the size of a segment, in bytes
+   */
+  BenchStreamClient (Ptr<Node> node, InetSocketAddress server, uint32_t segments, uint32_t segmentSize)
+    : m_node (node),
+      m_server (server),
+      m_segments (segments),
+      m_segmentSize (segmentSize),
+      m_requested (0),
+      m_received (0),
+      m_total (0)
+  {
+  }
+
+  /// Connect to the server
+  void Start (void)
+  {
+    m_socket = Socket::CreateSocket (m_node, TcpSocketFactory::GetTypeId ());
+    m_socket->Connect (m_server);
+    m_socket->SetConnectCallback (MakeCallback (&BenchStreamClient::Connected, this),
+                                  MakeNullCallback<void, Ptr<Socket> > ());
+    m_socket->SetRecvCallback (MakeCallback (&BenchStreamClient::Receive, this));
+  }
+
+  /// \return the number of bytes received
+  uint64_t GetTotal (void) const
+  {
+    return m_total;
+  }
+
+private:
+  /// Request the next segment
+  void Request (void)
+  {
+    // NUL-terminated size, as StreamClient sends it
+    std::ostringstream oss;
+    oss << m_segmentSize;
+    std::string request = oss.str ();
+    m_socket->Send (Create<Packet> (reinterpret_cast<const uint8_t *> (request.c_str ()),
+                                    request.size () + 1));
+    m_requested++;
+    m_received = 0;
+  }
+  /// \param socket the connected socket
+  void Connected (Ptr<Socket> socket)
+  {
+    Request ();
+  }
+  /// \param socket the socket with data to read
+  void Receive (Ptr<Socket> socket)
+  {
+    Ptr<Packet> packet;
+    while ((packet = socket->Recv ()))
+      {
+        m_received += packet->GetSize ();
+        m_total += packet->GetSize ();
+      }
+    if (m_received < m_segmentSize)
+      {
+        return;
+      }
+    if (m_requested < m_segments)
+      {
+        Request ();
+      }
+    else
+      {
+        m_socket->Close ();
+      }
+  }
+
+  Ptr<Node> m_node;             //!< node of the client
+  InetSocketAddress m_server;   //!< address of the server
+  Ptr<Socket> m_socket;         //!< connection to the server
+  uint32_t m_segments;          //!< segments to request
+  uint32_t m_segmentSize;       //!< size of a segment
+  uint32_t m_requested;         //!< segments requested so far
+  uint32_t m_received;          //!< bytes received of the current segment
+  uint64_t m_total;             //!< bytes received so far
+};
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nClients = 1000;
+  uint32_t segments = 5;
+  uint32_t segmentSize = 100000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("clients", "number of clients", nClients);
+  cmd.AddValue ("segments", "segments requested by each client", segments);
+  cmd.AddValue ("segmentSize", "size of a segment in bytes", segmentSize);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  // clients -- router -- server
+  Ptr<Node> server = CreateObject<Node> ();
+  Ptr<Node> router = CreateObject<Node> ();
+  NodeContainer clients;
+  clients.Create (nClients);
+  InternetStackHelper stack;
+  stack.Install (server);
+  stack.Install (router);
+  stack.Install (clients);
+
+  PointToPointHelper core;
+  core.SetDeviceAttribute ("DataRate", StringValue ("100Gbps"));
+  core.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  PointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue ("20Mbps"));
+  access.SetChannelAttribute ("Delay", StringValue ("10ms"));
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer serverLink = address.Assign (core.Install (server, router));
+  address.SetBase ("10.1.0.0", "255.255.255.252");
+  Ipv4StaticRoutingHelper routing;
+  routing.GetStaticRouting (server->GetObject<Ipv4> ())->SetDefaultRoute (serverLink.GetAddress (1), 1);
+  for (uint32_t i = 0; i < nClients; i++)
+    {
+      Ipv4InterfaceContainer link = address.Assign (access.Install (clients.Get (i), router));
+      address.NewNetwork ();
+      routing.GetStaticRouting (clients.Get (i)->GetObject<Ipv4> ())->SetDefaultRoute (link.GetAddress (1), 1);
+    }
+
+  Ptr<StreamServer> app = CreateObject<StreamServer> ();
+  app->SetAttribute ("Port", UintegerValue (80));
+  app->SetAttribute ("TransportProtocol", StringValue ("TCP"));
+  app->SetAttribute ("TimeHandlers", BooleanValue (true));
+  server->AddApplication (app);
+  app->SetStartTime (Seconds (0));
+
+  std::vector<BenchStreamClient *> streams;
+  for (uint32_t i = 0; i < nClients; i++)
+    {
+      BenchStreamClient *client = new BenchStreamClient (clients.Get (i), InetSocketAddress (serverLink.GetAddress (0), 80),
+                                                         segments, segmentSize);
+      streams.push_back (client);
+      Simulator::Schedule (Seconds (0.1) + MilliSeconds (i % 1000), &BenchStreamClient::Start, client);
+    }
+
+  SystemWallClockMs wall;
+  std::clock_t cpuStart = std::clock ();
+  wall.Start ();
+  Simulator::Stop (Seconds (3600));
+  Simulator::Run ();
+  int64_t wallMs = wall.End ();
+  double cpu = double (std::clock () - cpuStart) / CLOCKS_PER_SEC;
+  Time end = Simulator::Now ();
+  double serverTime = app->GetHandlerTime ();
+  Simulator::Destroy ();
+
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < nClients; i++)
+    {
+      total += streams[i]->GetTotal ();
+      delete streams[i];
+    }
+  double mb = total / 1e6;
+  std::cout << "clients,MB,sim_s,wall_s,cpu_s,server_s,server_ms_per_MB" << std::endl;
+  std::cout << nClients << "," << mb << "," << end.GetSeconds () << "," << wallMs / 1000.0 << ","
+            << cpu << "," << serverTime << "," << (mb > 0 ? 1000 * serverTime / mb : 0) << std::endl;
+  return 0;
+}
@@ -0,0 +1,338 @@
+#!/usr/bin/env python3
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""! Parameter sweep of the MAMS scenarios.
+
+Runs every combination of the parameter grid, for every seed, as an
+independent simulation process; as many processes as cores run at once.
+Each run has its own working directory, so the files the scenarios write
+with fixed names (goodputLog.txt, rttLog0.txt, the cwnd and rtt traces,
+the pcaps, wmp*.txt...) do not collide. The figures printed by each run
+are gathered in one table per run and one table averaged over the seeds.
+
+Sample usage:
+
+  ./utils/sweep.py -p MAMS-test-2 -p MAMS-test-rr \\
+      -g schAlgo=2,3,5 -g errorRate=0,0.0001 -a isMob=0 -s 1-10
+
+writes sweep/runs.csv and sweep/summary.csv. When fluid is one of the
+grid parameters of MAMS-test-2, sweep/fluid.csv compares each fluid
+point with the packet-level point of the same other parameters: the
+wall-clock speedup, the error on the completion time and the fraction
+of the file fast-forwarded.
+"""
+
+import concurrent.futures
+import csv
+import itertools
+import math
+import multiprocessing
+import optparse
+import os
+import re
+import subprocess
+import sys
+import time
+
+TOP_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+## "  Throughput: 4.2 Mbps", one line per flow
+THROUGHPUT_RE = re.compile(r'^\s*Throughput:\s*([-+0-9.eE]+) Mbps')
+## "fluid 0 completion_s 3.1 rx_bytes 5000000 ...", printed by MAMS-test-2
+SUMMARY_RE = re.compile(r'^fluid \S+( \S+ \S+)*$')
+
+
+def get_build_dir():
+    """! Find the build directory of the last configure
+    @return the build directory
+    """
+    for name in os.listdir(TOP_DIR):
+        if name.startswith('.lock-waf_') and name.endswith('_build'):
+            with open(os.path.join(TOP_DIR, name)) as lock:
+                for line in lock:
+                    key, _, value = line.partition(' = ')
+                    if key == 'out_dir':
+                        return eval(value)
+    sys.exit('sweep.py: not configured, run ./waf configure first')
+
+
+def find_program(build_dir, program):
+    """! Find the executable of a scratch program or example
+    @param build_dir the build directory
+    @param program the name of the program
+    @return the path of the executable
+    """
+    candidates = [os.path.join(build_dir, 'scratch', program),
+                  os.path.join(build_dir, 'scratch', program, program)]
+    for root, _, files in os.walk(os.path.join(build_dir, 'examples')):
+        for f in files:
+            if f.startswith('ns3-') and ('-' + program + '-') in f:
+                candidates.append(os.path.join(root, f))
+    for path in candidates:
+        if os.path.isfile(path) and os.access(path, os.X_OK):
+            return path
+    sys.exit('sweep.py: program %s not built' % program)
+
+
+def parse_seeds(text):
+    """! Parse a seed list
+    @param text comma separated seeds or ranges, e.g. "1-5,10"
+    @return the list of seeds
+    """
+    seeds = []
+    for part in text.split(','):
+        if '-' in part:
+            first, last = part.split('-')
+            seeds.extend(range(int(first), int(last) + 1))
+        else:
+            seeds.append(int(part))
+    return seeds
+
+
+def parse_assignment(text):
+    """! Parse a name=value[,value...] option
+    @param text the option
+    @return the name and the list of values
+    """
+    name, sep, values = text.partition('=')
+    if not sep or not name:
+        sys.exit('sweep.py: expected name=value, got %s' % text)
+    result = []
+    for value in values.split(','):
+        # input files are given relative to where the sweep is started
+        if value and os.path.exists(value) and not os.path.isabs(value):
+            value = os.path.abspath(value)
+        result.append(value)
+    return name, result
+
+
+def run_name(params):
+    """! Name of the directory of a run
+    @param params the parameters of the run, as (name, value) pairs
+    @return the name
+    """
+    name = '_'.join('%s=%s' % (k, os.path.basename(v)) for k, v in params)
+    return re.sub(r'[^A-Za-z0-9_.=+-]', '-', name) or 'default'
+
+
+def parse_output(stdout_path):
+    """! Gather the figures printed by a run
+    @param stdout_path the file holding the output of the run
+    @return a dict of figures
+    """
+    figures = {}
+    flow = 0
+    with open(stdout_path, errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            m = THROUGHPUT_RE.match(line)
+            if m:
+                flow += 1
+                figures['flow%d_Mbps' % flow] = float(m.group(1))
+            elif SUMMARY_RE.match(line):
+                words = line.split()
+                for key, value in zip(words[0::2], words[1::2]):
+                    try:
+                        figures[key] = float(value)
+                    except ValueError:
+                        pass
+    return figures
+
+
+def run_one(job):
+    """! Run one simulation in its own directory
+    @param job a dict describing the run
+    @return the row of the run
+    """
+    os.makedirs(job['dir'], exist_ok=True)
+    argv = [job['binary']] + ['--%s=%s' % (k, v) for k, v in job['args']]
+    argv.append('--RngRun=%d' % job['seed'])
+    stdout_path = os.path.join(job['dir'], 'stdout.txt')
+    start = time.time()
+    with open(stdout_path, 'w') as out:
+        status = subprocess.call(argv, cwd=job['dir'], env=job['env'],
+                                 stdout=out, stderr=subprocess.STDOUT)
+    row = {'program': job['program'], 'seed': job['seed']}
+    row.update(dict(job['params']))
+    row['status'] = status
+    row['wall_s'] = round(time.time() - start, 3)
+    row.update(parse_output(stdout_path))
+    return row
+
+
+def write_table(path, rows, columns):
+    """! Write rows to a CSV file
+    @param path the file
+    @param rows the rows, as dicts
+    @param columns the columns
+    """
+    with open(path, 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=columns, restval='')
+        writer.writeheader()
+        for row in rows:
+            writer.writerow(row)
+
+
+def summarize(rows, keys, figures):
+    """! Average the figures of the runs over the seeds
+    @param rows the rows of the runs
+    @param keys the columns identifying a grid point
+    @param figures the numeric columns
+    @return the rows of the summary
+    """
+    groups = {}
+    for row in rows:
+        groups.setdefault(tuple(row.get(k, '') for k in keys), []).append(row)
+    summary = []
+    for point, group in groups.items():
+        out = dict(zip(keys, point))
+        out['runs'] = len(group)
+        out['failed'] = sum(1 for r in group if r['status'] != 0)
+        for name in figures:
+            values = [r[name] for r in group if r['status'] == 0 and name in r]
+            if not values:
+                continue
+            mean = sum(values) / len(values)
+            out[name] = round(mean, 6)
+            if len(values) > 1:
+                var = sum((v - mean) ** 2 for v in values) / (len(values) - 1)
+                out[name + '_sd'] = round(math.sqrt(var), 6)
+        summary.append(out)
+    return summary
+
+
+def compare_fluid(summary, keys):
+    """! Compare the fluid points of the summary with their packet-level point
+    @param summary the rows of the summary
+    @param keys the columns identifying a grid point, fluid among them
+    @return the rows of the comparison
+    """
+    others = [k for k in keys if k != 'fluid']
+    baselines = {}
+    for row in summary:
+        if str(row.get('fluid')) in ('0', '0.0', 'false', 'False') and 'wallclock_s' in row:
+            baselines[tuple(row.get(k) for k in others)] = row
+    comparison = []
+    for row in summary:
+        base = baselines.get(tuple(row.get(k) for k in others))
+        if base is None or base is row or 'wallclock_s' not in row:
+            continue
+        out = dict((k, row.get(k)) for k in keys)
+        out['packet_wallclock_s'] = base['wallclock_s']
+        out['fluid_wallclock_s'] = row['wallclock_s']
+        out['speedup'] = round(base['wallclock_s'] / row['wallclock_s'], 3) if row['wallclock_s'] else ''
+        out['packet_completion_s'] = base.get('completion_s', '')
+        out['fluid_completion_s'] = row.get('completion_s', '')
+        if base.get('completion_s', 0) > 0 and row.get('completion_s', 0) > 0:
+            out['completion_error'] = round(row['completion_s'] / base['completion_s'] - 1, 6)
+        out['fluid_fraction'] = row.get('fluid_fraction', '')
+        comparison.append(out)
+    return comparison
+
+
+def main(argv):
+    parser = optparse.OptionParser(usage='%prog [options]', description=__doc__.split('\n')[0])
+    parser.add_option('-p', '--program', action='append', dest='programs', default=[],
+                      metavar='NAME', help='scenario to run, can be repeated')
+    parser.add_option('-g', '--grid', action='append', default=[], metavar='NAME=V1,V2,...',
+                      help='values of a command line parameter to sweep, can be repeated')
+    parser.add_option('-a', '--arg', action='append', default=[], metavar='NAME=VALUE',
+                      help='command line parameter passed unchanged to every run')
+    parser.add_option('-s', '--seeds', default='1', metavar='LIST',
+                      help='RngRun values, e.g. 1-10 or 1,4,7 [default: %default]')
+    parser.add_option('-j', '--jobs', type='int', default=multiprocessing.cpu_count(),
+                      help='simulations run at once [default: %default]')
+    parser.add_option('-o', '--out', default='sweep', metavar='DIR',
+                      help='directory of the runs and of the tables [default: %default]')
+    parser.add_option('--nowaf', action='store_true', default=False,
+                      help='do not build before the sweep')
+    options, _ = parser.parse_args(argv)
+
+    if not options.programs:
+        parser.error('no program given')
+    grid = [parse_assignment(g) for g in options.grid]
+    fixed = []
+    for a in options.arg:
+        name, values = parse_assignment(a)
+        fixed.append((name, values[0]))
+    seeds = parse_seeds(options.seeds)
+
+    if not options.nowaf:
+        if subprocess.call([sys.executable, os.path.join(TOP_DIR, 'waf'), 'build'], cwd=TOP_DIR):
+            sys.exit('sweep.py: build failed')
+    build_dir = get_build_dir()
+    env = dict(os.environ)
+    env['LD_LIBRARY_PATH'] = os.pathsep.join(filter(None, [os.path.join(build_dir, 'lib'),
+                                                           env.get('LD_LIBRARY_PATH')]))
+
+    out_dir = os.path.abspath(options.out)
+    names = [name for name, _ in grid]
+    jobs = []
+    for program in options.programs:
+        binary = find_program(build_dir, program)
+        for values in itertools.product(*[v for _, v in grid]):
+            params = list(zip(names, values))
+            for seed in seeds:
+                jobs.append({'program': program, 'binary': binary, 'env': env,
+                             'params': params, 'args': fixed + params, 'seed': seed,
+                             'dir': os.path.join(out_dir, program, run_name(params), 'seed%d' % seed)})
+
+    print('sweep.py: %d runs on %d processes' % (len(jobs), options.jobs))
+    rows = []
+    start = time.time()
+    # the workers only wait for their simulation process
+    with concurrent.futures.ThreadPoolExecutor(max_workers=options.jobs) as pool:
+        futures = [pool.submit(run_one, job) for job in jobs]
+        for future in concurrent.futures.as_completed(futures):
+            row = future.result()
+            rows.append(row)
+            print('[%d/%d] %s %s seed %d: %s in %.1f s' %
+                  (len(rows), len(jobs), row['program'],
+                   ' '.join('%s=%s' % (k, row[k]) for k in names), row['seed'],
+                   'ok' if row['status'] == 0 else 'status %d' % row['status'], row['wall_s']))
+
+    rows.sort(key=lambda r: [str(r.get(k)) for k in ['program'] + names] + [r['seed']])
+    keys = ['program'] + names
+    figures = ['wall_s']
+    for row in rows:
+        for name in sorted(row):
+            if name not in figures and name not in keys and name not in ('seed', 'status'):
+                figures.append(name)
+    write_table(os.path.join(out_dir, 'runs.csv'), rows, keys + ['seed', 'status'] + figures)
+    summary = summarize(rows, keys, figures)
+    columns = keys + ['runs', 'failed']
+    for name in figures:
+        columns += [name, name + '_sd']
+    write_table(os.path.join(out_dir, 'summary.csv'), summary, columns)
+    if 'fluid' in names:
+        comparison = compare_fluid(summary, keys)
+        write_table(os.path.join(out_dir, 'fluid.csv'), comparison,
+                    keys + ['packet_wallclock_s', 'fluid_wallclock_s', 'speedup',
+                            'packet_completion_s', 'fluid_completion_s', 'completion_error',
+                            'fluid_fraction'])
+        for row in comparison:
+            print('sweep.py: %s: speedup %s, completion error %s, %s of the file fast-forwarded' %
+                  (' '.join('%s=%s' % (k, row[k]) for k in names), row['speedup'],
+                   row.get('completion_error', '?'), row['fluid_fraction']))
+
+    failed = sum(1 for r in rows if r['status'] != 0)
+    print('sweep.py: %d runs, %d failed, %.1f s; tables in %s' %
+          (len(rows), failed, time.time() - start, out_dir))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))